@@ -8,12 +8,32 @@
 
 #include "base/notification_observer.h"
 
+namespace {
+
+// Set by NotificationService::ScopedOverride on the threads that use one.
+thread_local NotificationService* g_override = NULL;
+
+}  // namespace
+
 // static
 NotificationService* NotificationService::current() {
+  if (g_override)
+    return g_override;
+
   static NotificationService service;
   return &service;
 }
 
+NotificationService::ScopedOverride::ScopedOverride(
+    NotificationService* service)
+    : previous_(g_override) {
+  g_override = service;
+}
+
+NotificationService::ScopedOverride::~ScopedOverride() {
+  g_override = previous_;
+}
+
 // static
 bool NotificationService::HasKey(const NotificationSourceMap& map,
                                  const NotificationSource& source) {
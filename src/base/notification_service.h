@@ -49,6 +49,19 @@ class NotificationService {
   // associated with a notification.  (This is effectively a null pointer.)
   static Details<void> NoDetails() { return Details<void>(NULL); }
 
+  // Makes current() return |service| on the calling thread for as long as
+  // this object lives. Only meant for tests that run several machines on
+  // threads of their own; everything else shares the one process wide
+  // service.
+  class ScopedOverride {
+   public:
+    explicit ScopedOverride(NotificationService* service);
+    ~ScopedOverride();
+
+   private:
+    NotificationService* previous_;
+  };
+
  private:
   friend class NotificationRegistrar;
 
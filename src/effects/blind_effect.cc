@@ -48,6 +48,7 @@ BlindEffect::~BlindEffect() {}
 void BlindEffect::ComputeGrowing(RLMachine& machine,
                                  int maxSize,
                                  int currentTime) {
+  blinds_.clear();
   int num_blinds = maxSize / blind_size() + 1;
   int rows_to_display =
       int((float(currentTime) / duration()) * (blind_size() + num_blinds));
@@ -62,11 +63,14 @@ void BlindEffect::ComputeGrowing(RLMachine& machine,
       RenderPolygon(polygonStart, polygonStart + currentlyDisplayed);
     }
   }
+
+  RenderBlinds();
 }
 
 void BlindEffect::ComputeDecreasing(RLMachine& machine,
                                     int maxSize,
                                     int currentTime) {
+  blinds_.clear();
   int num_blinds = maxSize / blind_size() + 1;
   int rows_to_display =
       int((float(currentTime) / duration()) * (blind_size() + num_blinds));
@@ -83,6 +87,16 @@ void BlindEffect::ComputeDecreasing(RLMachine& machine,
       RenderPolygon(bottomOfPolygon, bottomOfPolygon - currentlyDisplayed);
     }
   }
+
+  RenderBlinds();
+}
+
+void BlindEffect::AddBlind(const Rect& area) {
+  blinds_.push_back(Surface::Quad{area, area, 255});
+}
+
+void BlindEffect::RenderBlinds() {
+  src_surface().RenderQuadsToScreen(blinds_);
 }
 
 bool BlindEffect::BlitOriginalImage() const { return true; }
@@ -107,9 +121,7 @@ void BlindTopToBottomEffect::PerformEffectForTime(RLMachine& machine,
 }
 
 void BlindTopToBottomEffect::RenderPolygon(int polyStart, int polyEnd) {
-  src_surface().RenderToScreen(Rect::GRP(0, polyStart, width(), polyEnd),
-                               Rect::GRP(0, polyStart, width(), polyEnd),
-                               255);
+  AddBlind(Rect::GRP(0, polyStart, width(), polyEnd));
 }
 
 // -----------------------------------------------------------------------
@@ -132,10 +144,7 @@ void BlindBottomToTopEffect::PerformEffectForTime(RLMachine& machine,
 }
 
 void BlindBottomToTopEffect::RenderPolygon(int polyStart, int polyEnd) {
-  // Render polygon
-  src_surface().RenderToScreen(Rect::GRP(0, polyEnd, width(), polyStart),
-                               Rect::GRP(0, polyEnd, width(), polyStart),
-                               255);
+  AddBlind(Rect::GRP(0, polyEnd, width(), polyStart));
 }
 
 // -----------------------------------------------------------------------
@@ -158,9 +167,7 @@ void BlindLeftToRightEffect::PerformEffectForTime(RLMachine& machine,
 }
 
 void BlindLeftToRightEffect::RenderPolygon(int polyStart, int polyEnd) {
-  src_surface().RenderToScreen(Rect::GRP(polyStart, 0, polyEnd, height()),
-                               Rect::GRP(polyStart, 0, polyEnd, height()),
-                               255);
+  AddBlind(Rect::GRP(polyStart, 0, polyEnd, height()));
 }
 
 // -----------------------------------------------------------------------
@@ -183,7 +190,5 @@ void BlindRightToLeftEffect::PerformEffectForTime(RLMachine& machine,
 }
 
 void BlindRightToLeftEffect::RenderPolygon(int polyStart, int polyEnd) {
-  src_surface().RenderToScreen(Rect::GRP(polyEnd, 0, polyStart, height()),
-                               Rect::GRP(polyEnd, 0, polyStart, height()),
-                               255);
+  AddBlind(Rect::GRP(polyEnd, 0, polyStart, height()));
 }
@@ -28,7 +28,10 @@
 #ifndef SRC_EFFECTS_BLIND_EFFECT_H_
 #define SRC_EFFECTS_BLIND_EFFECT_H_
 
+#include <vector>
+
 #include "effects/effect.h"
+#include "systems/base/surface.h"
 
 // Base class for implementing \#SEL transition style \#10, Blind.
 class BlindEffect : public Effect {
@@ -47,12 +50,24 @@ class BlindEffect : public Effect {
   void ComputeGrowing(RLMachine& machine, int maxSize, int currentTime);
   void ComputeDecreasing(RLMachine& machine, int maxSize, int currentTime);
 
+  // Called by ComputeGrowing() and ComputeDecreasing() for each blind. The
+  // subclasses pass the area it covers to AddBlind().
   virtual void RenderPolygon(int polyStart, int polyEnd) = 0;
 
+  // Queues |area| of the source surface to be drawn along with the other
+  // blinds this frame.
+  void AddBlind(const Rect& area);
+
  private:
   virtual bool BlitOriginalImage() const final;
 
+  // Draws all the blinds queued this frame in one batch.
+  void RenderBlinds();
+
   int blind_size_;
+
+  // The blinds queued by AddBlind() this frame.
+  std::vector<Surface::Quad> blinds_;
 };
 
 class BlindTopToBottomEffect : public BlindEffect {
@@ -85,27 +85,23 @@ bool Codepage::DbcsDelim(char* str) const { return false; }
 
 bool Codepage::IsItalic(uint16_t ch) const { return false; }
 
-std::unique_ptr<Codepage> Cp::instance_;
-int Cp::codepage = -1;
-int Cp::scenario = -1;
-
 Codepage& Cp::instance(int desired) {
-  // Desired codepage known.
-  if (desired != codepage) {
-    codepage = desired;
-    switch (desired) {
-      case 1:
-        instance_.reset(new Cp936());
-        break;
-      case 2:
-        instance_.reset(new Cp1252());
-        break;
-      case 3:
-        instance_.reset(new Cp949());
-        break;
-      default:
-        instance_.reset(new Cp932());
+  switch (desired) {
+    case 1: {
+      static Cp936 cp936;
+      return cp936;
+    }
+    case 2: {
+      static Cp1252 cp1252;
+      return cp1252;
+    }
+    case 3: {
+      static Cp949 cp949;
+      return cp949;
+    }
+    default: {
+      static Cp932 cp932;
+      return cp932;
     }
   }
-  return *instance_;
 }
@@ -37,6 +37,8 @@
 #ifndef SRC_ENCODINGS_CODEPAGE_H_
 #define SRC_ENCODINGS_CODEPAGE_H_
 
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -47,6 +49,8 @@ struct Codepage {
   virtual void JisEncodeString(const char* s, char* buf, size_t buflen) const;
   virtual unsigned short Convert(unsigned short ch) const = 0;
   virtual std::wstring ConvertString(const std::string& s) const = 0;
+  // Like ConvertString(), but goes straight to UTF-8 in a single pass.
+  virtual std::string ConvertToUTF8(const std::string& s) const = 0;
   virtual bool DbcsDelim(char* str) const;
   virtual bool IsItalic(unsigned short ch) const;
 
@@ -55,14 +59,69 @@ struct Codepage {
   bool NoTransforms;
 };
 
+// Appends the BMP code point |ch| to |out| as UTF-8.
+inline void AppendUTF8(uint16_t ch, std::string& out) {
+  if (ch < 0x80) {
+    out += static_cast<char>(ch);
+  } else if (ch < 0x800) {
+    out += static_cast<char>(0xc0 | (ch >> 6));
+    out += static_cast<char>(0x80 | (ch & 0x3f));
+  } else {
+    out += static_cast<char>(0xe0 | (ch >> 12));
+    out += static_cast<char>(0x80 | ((ch >> 6) & 0x3f));
+    out += static_cast<char>(0x80 | (ch & 0x3f));
+  }
+}
+
+// Shared implementation of Codepage::ConvertToUTF8(). Every codepage we
+// support maps 0x00-0x7f to itself, so runs of ASCII are found eight bytes at
+// a time and copied over in bulk. Everything else goes through |convert|;
+// |is_lead_byte| decides which bytes start a double byte character. Like
+// ConvertString(), this stops at the first NUL.
+template <typename IsLeadByte, typename ConvertChar>
+std::string TranscodeToUTF8(const std::string& in,
+                            IsLeadByte is_lead_byte,
+                            ConvertChar convert) {
+  std::string out;
+  const unsigned char* s =
+      reinterpret_cast<const unsigned char*>(in.c_str());
+  const unsigned char* end = s + std::strlen(in.c_str());
+  out.reserve(end - s);
+
+  while (s != end) {
+    const unsigned char* run = s;
+    uint64_t word;
+    while (end - s >= 8) {
+      std::memcpy(&word, s, sizeof(word));
+      if (word & 0x8080808080808080ull)
+        break;
+      s += 8;
+    }
+    while (s != end && *s < 0x80)
+      ++s;
+    out.append(reinterpret_cast<const char*>(run), s - run);
+    if (s == end)
+      break;
+
+    if (is_lead_byte(*s)) {
+      uint16_t ch = *s++ << 8;
+      if (s != end)
+        ch |= *s++;
+      AppendUTF8(convert(ch), out);
+    } else {
+      AppendUTF8(convert(*s++), out);
+    }
+  }
+
+  return out;
+}
+
 class Cp {
  public:
-  // Singleton constructor
+  // Returns the shared, immutable converter for |desired|. Each codepage has
+  // its own instance so that machines using different encodings can run side
+  // by side.
   static Codepage& instance(int desired);
- private:
-  static std::unique_ptr<Codepage> instance_;
-  static int codepage;
-  static int scenario;
 };
 
 #endif  // SRC_ENCODINGS_CODEPAGE_H_
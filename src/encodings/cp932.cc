@@ -1277,6 +1277,13 @@ std::wstring Cp932::ConvertString(const std::string& in_string) const {
   return rv;
 }
 
+std::string Cp932::ConvertToUTF8(const std::string& in_string) const {
+  return TranscodeToUTF8(
+      in_string,
+      [](unsigned char c) { return shiftjis_lead_byte(c); },
+      [this](uint16_t ch) { return Cp932::Convert(ch); });
+}
+
 #else
 
 uint16_t Cp932::Convert(uint16_t ch) const {
@@ -1290,4 +1297,8 @@ std::wstring Cp932::ConvertString(const std::string& s) const {
   return std::wstring();
 }
 
+std::string Cp932::ConvertToUTF8(const std::string& s) const {
+  return std::string();
+}
+
 #endif
@@ -44,6 +44,7 @@
 struct Cp932 : public Codepage {
   virtual unsigned short Convert(unsigned short ch) const;
   virtual std::wstring ConvertString(const std::string& s) const;
+  virtual std::string ConvertToUTF8(const std::string& s) const;
   Cp932();
 };
 
@@ -2836,6 +2836,13 @@ std::wstring Cp936::ConvertString(const std::string& in_string) const {
   return rv;
 }
 
+std::string Cp936::ConvertToUTF8(const std::string& in_string) const {
+  // Every byte outside ASCII starts a two byte GBK sequence.
+  return TranscodeToUTF8(in_string,
+                         [](unsigned char c) { return true; },
+                         [this](uint16_t ch) { return Cp936::Convert(ch); });
+}
+
 #else
 uint16_t Cp936::Convert(uint16_t ch) const { return ch; }
 
@@ -2843,4 +2850,8 @@ std::wstring Cp936::ConvertString(const std::string& s) const {
   return std::wstring();
 }
 
+std::string Cp936::ConvertToUTF8(const std::string& s) const {
+  return std::string();
+}
+
 #endif
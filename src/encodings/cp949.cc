@@ -1766,6 +1766,13 @@ std::wstring Cp949::ConvertString(const std::string& in_string) const {
   return rv;
 }
 
+std::string Cp949::ConvertToUTF8(const std::string& in_string) const {
+  // Every byte outside ASCII starts a two byte UHC sequence.
+  return TranscodeToUTF8(in_string,
+                         [](unsigned char c) { return true; },
+                         [this](uint16_t ch) { return Cp949::Convert(ch); });
+}
+
 #else
 
 uint16_t Cp949::JisDecode(uint16_t ch) const { return ch; }
@@ -1778,4 +1785,8 @@ uint16_t Cp949::Convert(uint16_t ch) const { return ch; }
 
 std::wstring Cp949::ConvertString(const std::string& s) const { return NULL; }
 
+std::string Cp949::ConvertToUTF8(const std::string& s) const {
+  return std::string();
+}
+
 #endif
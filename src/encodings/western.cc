@@ -132,3 +132,9 @@ std::wstring Cp1252::ConvertString(const std::string& in_string) const {
 
   return rv;
 }
+
+std::string Cp1252::ConvertToUTF8(const std::string& in_string) const {
+  return TranscodeToUTF8(in_string,
+                         [](unsigned char c) { return false; },
+                         [this](uint16_t ch) { return Cp1252::Convert(ch); });
+}
@@ -42,6 +42,7 @@ struct Cp1252 : public Codepage {
   void JisEncodeString(const char* s, char* buf, size_t buflen) const;
   unsigned short Convert(unsigned short ch) const;
   std::wstring ConvertString(const std::string& s) const;
+  std::string ConvertToUTF8(const std::string& s) const;
   bool DbcsDelim(char* str) const;
   bool IsItalic(unsigned short ch) const;
   Cp1252();
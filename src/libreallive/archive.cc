@@ -108,6 +108,14 @@ Scenario* Archive::GetScenario(int index) {
   return NULL;
 }
 
+std::unique_ptr<Scenario> Archive::ParseScenario(int index) const {
+  scenarios_t::const_iterator st = scenarios_.find(index);
+  if (st == scenarios_.end())
+    return nullptr;
+  return std::unique_ptr<Scenario>(
+      new Scenario(st->second, index, regname_, second_level_xor_key_));
+}
+
 int Archive::GetProbableEncodingType() const {
   // Directly create Header objects instead of Scenarios. We don't want to
   // parse the entire SEEN file here.
@@ -120,6 +128,15 @@ int Archive::GetProbableEncodingType() const {
   return 0;
 }
 
+std::map<int, int> Archive::GetKidokuTableSizes() const {
+  std::map<int, int> sizes;
+  for (auto it = scenarios_.cbegin(); it != scenarios_.cend(); ++it) {
+    if (it->second.length >= 0x10)
+      sizes[it->first] = read_i32(it->second.data + 0x0c);
+  }
+  return sizes;
+}
+
 void Archive::ReadTOC() {
   const char* idx = info_.get();
   for (int i = 0; i < 10000; ++i, idx += 8) {
@@ -67,10 +67,19 @@ class Archive {
   // Returns a specific scenario by |index| number or NULL if none exist.
   Scenario* GetScenario(int index);
 
+  // Parses scenario |index| without caching it, or returns NULL if it doesn't
+  // exist. Unlike GetScenario(), this may be called from several threads at
+  // once.
+  std::unique_ptr<Scenario> ParseScenario(int index) const;
+
   // Does a quick pass through all scenarios in the archive, looking for any
   // with non-default encoding. This short circuits when it finds one.
   int GetProbableEncodingType() const;
 
+  // Returns the number of kidoku markers in each scenario, keyed by scenario
+  // number. Only reads the scenario headers.
+  std::map<int, int> GetKidokuTableSizes() const;
+
  private:
   typedef std::map<int, FilePos> scenarios_t;
   typedef std::map<int, std::unique_ptr<Scenario>> accessed_t;
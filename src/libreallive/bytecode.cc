@@ -33,7 +33,9 @@
 
 #include "libreallive/bytecode.h"
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cstring>
 #include <exception>
 #include <iomanip>
@@ -46,6 +48,7 @@
 #include "libreallive/expression.h"
 
 #include "machine/rlmachine.h"
+#include "utilities/exception.h"
 
 namespace libreallive {
 
@@ -108,8 +111,6 @@ inline BytecodeElement* ReadFunction(const char* stream,
 
 }  // namespace
 
-char BytecodeElement::entrypoint_marker = '@';
-
 CommandElement* BuildFunctionElement(const char* stream) {
   const char* ptr = stream;
   ptr += 8;
@@ -160,7 +161,7 @@ void PrintParameterString(std::ostream& oss,
 // -----------------------------------------------------------------------
 
 ConstructionData::ConstructionData(size_t kt, pointer_t pt)
-    : kidoku_table(kt), null(pt) {}
+    : kidoku_table(kt), null(pt), entrypoint_marker('@') {}
 
 // -----------------------------------------------------------------------
 
@@ -219,7 +220,7 @@ BytecodeElement* BytecodeElement::Read(const char* stream,
                                        ConstructionData& cdata) {
   const char c = *stream;
   if (c == '!')
-    entrypoint_marker = '!';
+    cdata.entrypoint_marker = '!';
   switch (c) {
     case 0:
     case ',':
@@ -234,7 +235,7 @@ BytecodeElement* BytecodeElement::Read(const char* stream,
     case '#':
       return ReadFunction(stream, cdata);
     default:
-      return new TextoutElement(stream, end);
+      return new TextoutElement(stream, end, cdata.entrypoint_marker);
   }
 }
 
@@ -301,7 +302,10 @@ void MetaElement::RunOnMachine(RLMachine& machine) const {
 // TextoutElement
 // -----------------------------------------------------------------------
 
-TextoutElement::TextoutElement(const char* src, const char* file_end) {
+TextoutElement::TextoutElement(const char* src,
+                               const char* file_end,
+                               char entrypoint_marker)
+    : utf8_encoding_(-1) {
   const char* end = src;
   bool quoted = false;
   while (true && end < file_end) {
@@ -352,6 +356,15 @@ const string TextoutElement::GetText() const {
   return rv;
 }
 
+const string* TextoutElement::GetCachedUTF8Text(int encoding) const {
+  return utf8_encoding_ == encoding ? &utf8_text_ : NULL;
+}
+
+void TextoutElement::SetCachedUTF8Text(int encoding, const string& utf8) const {
+  utf8_encoding_ = encoding;
+  utf8_text_ = utf8;
+}
+
 void TextoutElement::PrintSourceRepresentation(RLMachine* machine,
                                                std::ostream& oss) const {
   oss << "\"" << GetText() << "\"" << std::endl;
@@ -441,6 +454,10 @@ const size_t CommandElement::GetCaseCount() const { return 0; }
 
 const string CommandElement::GetCase(int i) const { return ""; }
 
+int CommandElement::FindCase(RLMachine& machine, int value) const {
+  return -1;
+}
+
 void CommandElement::PrintSourceRepresentation(RLMachine* machine,
                                                std::ostream& oss) const {
   std::string name = machine->GetCommandName(*this);
@@ -787,6 +804,122 @@ void GotoIfElement::SetPointers(ConstructionData& cdata) {
   pointer_ = it->second;
 }
 
+// -----------------------------------------------------------------------
+// CaseTable
+// -----------------------------------------------------------------------
+
+namespace {
+
+// Checks that |label| is a parenthesized expression and parses it. The "()"
+// default case must be handled by the caller.
+ExpressionPiece ParseCaseLabel(const string& label) {
+  // Check for bytecode wellformedness. All cases should be surrounded by
+  // parens.
+  if (label.size() < 2 || label.front() != '(' || label.back() != ')')
+    throw rlvm::Exception("Malformed bytecode in goto_case statment");
+
+  // Strip the parens for parsing.
+  const char* e = label.c_str() + 1;
+  return GetExpression(e);
+}
+
+}  // namespace
+
+CaseTable::DynamicCase::DynamicCase(int index, const string& label)
+    : index(index), label(label) {}
+
+CaseTable::DynamicCase::DynamicCase(int index, ExpressionPiece expression)
+    : index(index), expression(new ExpressionPiece(std::move(expression))) {}
+
+CaseTable::CaseTable(RLMachine& machine, const std::vector<string>& cases)
+    : default_index_(INT_MAX), use_dense_(false), dense_base_(0) {
+  std::vector<std::pair<int, int>> constants;
+  for (size_t i = 0; i < cases.size(); ++i) {
+    // In the case of an empty set of parens, always accept. It is the
+    // bytecode representation for the default case.
+    if (cases[i] == "()") {
+      default_index_ = std::min(default_index_, static_cast<int>(i));
+      continue;
+    }
+
+    // A malformed label only matters if nothing before it matches, so leave
+    // it to throw from Find() once it's reached.
+    std::unique_ptr<ExpressionPiece> expression;
+    try {
+      expression.reset(new ExpressionPiece(ParseCaseLabel(cases[i])));
+    } catch (std::exception&) {
+      dynamic_cases_.emplace_back(i, cases[i]);
+      continue;
+    }
+
+    if (expression->IsConstant()) {
+      try {
+        constants.emplace_back(expression->GetIntegerValue(machine), i);
+        continue;
+      } catch (Error&) {
+        // Leave malformed expressions to throw when they're reached.
+      }
+    }
+    dynamic_cases_.emplace_back(i, std::move(*expression));
+  }
+
+  if (constants.empty())
+    return;
+
+  int64_t min_key = constants[0].first, max_key = constants[0].first;
+  for (auto const& constant : constants) {
+    min_key = std::min<int64_t>(min_key, constant.first);
+    max_key = std::max<int64_t>(max_key, constant.first);
+  }
+
+  use_dense_ = max_key - min_key <= 2 * int64_t(constants.size()) + 16;
+  if (use_dense_) {
+    dense_base_ = static_cast<int>(min_key);
+    dense_.assign(max_key - min_key + 1, -1);
+    for (auto const& constant : constants) {
+      int& slot = dense_[constant.first - min_key];
+      if (slot == -1)
+        slot = constant.second;
+    }
+  } else {
+    // emplace() keeps the first case for a duplicated key.
+    for (auto const& constant : constants)
+      sparse_.emplace(constant.first, constant.second);
+  }
+}
+
+CaseTable::~CaseTable() {}
+
+int CaseTable::Find(RLMachine& machine, int value) const {
+  int best = default_index_;
+  int constant = FindConstant(value);
+  if (constant != -1 && constant < best)
+    best = constant;
+
+  for (auto const& dynamic_case : dynamic_cases_) {
+    if (dynamic_case.index >= best)
+      break;
+    if (!dynamic_case.expression)
+      ParseCaseLabel(dynamic_case.label);
+    if (dynamic_case.expression->GetIntegerValue(machine) == value)
+      return dynamic_case.index;
+  }
+
+  return best == INT_MAX ? -1 : best;
+}
+
+int CaseTable::FindConstant(int value) const {
+  if (use_dense_) {
+    int64_t offset = int64_t(value) - dense_base_;
+    if (offset < 0 || offset >= int64_t(dense_.size()))
+      return -1;
+    return dense_[offset];
+  }
+
+  auto it = sparse_.find(value);
+  return it != sparse_.end() ? it->second : -1;
+}
+
 // -----------------------------------------------------------------------
 // GotoCaseElement
 // -----------------------------------------------------------------------
@@ -840,6 +973,12 @@ const size_t GotoCaseElement::GetCaseCount() const { return cases.size(); }
 
 const string GotoCaseElement::GetCase(int i) const { return cases[i]; }
 
+int GotoCaseElement::FindCase(RLMachine& machine, int value) const {
+  if (!case_table_)
+    case_table_.reset(new CaseTable(machine, cases));
+  return case_table_->Find(machine, value);
+}
+
 const size_t GotoCaseElement::GetBytecodeLength() const {
   size_t rv = repr.size() + 2;
   for (unsigned int i = 0; i < cases.size(); ++i)
@@ -36,7 +36,10 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "libreallive/bytecode_fwd.h"
@@ -63,6 +66,10 @@ struct ConstructionData {
   pointer_t null;
   typedef std::map<unsigned long, pointer_t> offsets_t;
   offsets_t offsets;
+
+  // The character that marks an entrypoint in this scenario. Switches from
+  // '@' to '!' once we've seen the first '!' entrypoint.
+  char entrypoint_marker;
 };
 
 class Pointers {
@@ -126,7 +133,6 @@ class BytecodeElement {
                                ConstructionData& cdata);
 
  protected:
-  static char entrypoint_marker;
   BytecodeElement(const BytecodeElement& c);
 
  private:
@@ -170,11 +176,18 @@ class MetaElement : public BytecodeElement {
 // Display-text elements.
 class TextoutElement : public BytecodeElement {
  public:
-  TextoutElement(const char* src, const char* file_end);
+  TextoutElement(const char* src, const char* file_end, char entrypoint_marker);
   virtual ~TextoutElement();
 
   const string GetText() const;
 
+  // The UTF-8 version of this text in |encoding|, if it was cached by
+  // SetCachedUTF8Text(). Only text that doesn't depend on machine state (name
+  // variables) gets cached, so replaying a line or going back through the
+  // backlog doesn't transcode it again.
+  const string* GetCachedUTF8Text(int encoding) const;
+  void SetCachedUTF8Text(int encoding, const string& utf8) const;
+
   // Overridden from BytecodeElement::
   virtual void PrintSourceRepresentation(RLMachine* machine,
                                          std::ostream& oss) const final;
@@ -183,6 +196,9 @@ class TextoutElement : public BytecodeElement {
 
  private:
   string repr;
+
+  mutable int utf8_encoding_;
+  mutable string utf8_text_;
 };
 
 // Expression elements.
@@ -249,6 +265,10 @@ class CommandElement : public BytecodeElement {
   virtual const size_t GetCaseCount() const;
   virtual const string GetCase(int i) const;
 
+  // Returns the index of the first case that matches |value|, or -1 if no
+  // case (including the default case) matches.
+  virtual int FindCase(RLMachine& machine, int value) const;
+
   // Overridden from BytecodeElement:
   virtual void PrintSourceRepresentation(RLMachine* machine,
                                          std::ostream& oss) const final;
@@ -420,6 +440,51 @@ class GotoIfElement : public CommandElement {
   string repr;
 };
 
+// The compiled form of a goto_case/gosub_case case list. Case labels which
+// are constant expressions are parsed once and stored in a dense or hashed
+// jump table. The remaining labels are kept as parsed expressions and are
+// only evaluated when they come before the constant match, which keeps the
+// first-match-in-bytecode-order semantics of the linear walk. Labels which
+// don't parse are kept as text and only throw once a lookup reaches them.
+class CaseTable {
+ public:
+  CaseTable(RLMachine& machine, const std::vector<string>& cases);
+  ~CaseTable();
+
+  // Returns the index of the case that matches |value|, or -1.
+  int Find(RLMachine& machine, int value) const;
+
+ private:
+  // A case label that depends on machine state or that failed to parse.
+  struct DynamicCase {
+    DynamicCase(int index, const string& label);
+    DynamicCase(int index, ExpressionPiece expression);
+
+    int index;
+
+    // Null when |label| is malformed.
+    std::unique_ptr<ExpressionPiece> expression;
+    string label;
+  };
+
+  // Returns the index of the first constant case equal to |value|, or -1.
+  int FindConstant(int value) const;
+
+  // Index of the "()" default case, or INT_MAX if there isn't one.
+  int default_index_;
+
+  // When the constant keys are close together, |dense_| maps (key -
+  // |dense_base_|) to a case index, with -1 for holes. Otherwise we fall back
+  // to |sparse_|.
+  bool use_dense_;
+  int dense_base_;
+  std::vector<int> dense_;
+  std::unordered_map<int, int> sparse_;
+
+  // Case labels that depend on machine state, in bytecode order.
+  std::vector<DynamicCase> dynamic_cases_;
+};
+
 class GotoCaseElement : public PointerElement {
  public:
   GotoCaseElement(const char* src, ConstructionData& cdata);
@@ -430,6 +495,7 @@ class GotoCaseElement : public PointerElement {
   virtual string GetParam(int i) const final;
   virtual const size_t GetCaseCount() const final;
   virtual const string GetCase(int i) const final;
+  virtual int FindCase(RLMachine& machine, int value) const final;
 
   // Overridden from BytecodeElement:
   virtual const size_t GetBytecodeLength() const final;
@@ -437,6 +503,9 @@ class GotoCaseElement : public PointerElement {
  private:
   string repr;
   std::vector<string> cases;
+
+  // Built the first time this element is executed.
+  mutable std::unique_ptr<CaseTable> case_table_;
 };
 
 class GotoOnElement : public PointerElement {
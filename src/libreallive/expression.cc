@@ -889,6 +889,50 @@ bool ExpressionPiece::IsSpecialParameter() const {
   return piece_type == TYPE_SPECIAL_EXPRESSION;
 }
 
+bool ExpressionPiece::IsConstant() const {
+  switch (piece_type) {
+    case TYPE_INT_CONSTANT:
+      return true;
+    case TYPE_UNIARY_EXPRESSION:
+      return uniary_expression.operand->IsConstant();
+    case TYPE_BINARY_EXPRESSION:
+      // Operations 20 through 30 are assignments.
+      return (binary_expression.operation < 20 ||
+              binary_expression.operation > 30) &&
+             binary_expression.left_operand->IsConstant() &&
+             binary_expression.right_operand->IsConstant();
+    default:
+      return false;
+  }
+}
+
+int ExpressionPiece::GetConstantIntegerValue() const {
+  switch (piece_type) {
+    case TYPE_INT_CONSTANT:
+      return int_constant;
+    case TYPE_UNIARY_EXPRESSION:
+      return PerformUniaryOperationOn(
+          uniary_expression.operand->GetConstantIntegerValue());
+    case TYPE_BINARY_EXPRESSION:
+      if (IsConstant()) {
+        return PerformBinaryOperationOn(
+            binary_expression.operation,
+            binary_expression.left_operand->GetConstantIntegerValue(),
+            binary_expression.right_operand->GetConstantIntegerValue());
+      }
+      break;
+    default:
+      break;
+  }
+
+  throw libreallive::Error(
+      "ExpressionPiece::GetConstantIntegerValue() on a non constant");
+}
+
+const std::string* ExpressionPiece::GetStringConstant() const {
+  return piece_type == TYPE_STRING_CONSTANT ? &str_constant : NULL;
+}
+
 ExpressionValueType ExpressionPiece::GetExpressionValueType() const {
   switch (piece_type) {
     case TYPE_STRING_CONSTANT:
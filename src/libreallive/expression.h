@@ -133,6 +133,17 @@ class ExpressionPiece {
   // @see Special_T
   bool IsSpecialParameter() const;
 
+  // Whether this is an integer expression built only out of constants, so
+  // that GetIntegerValue() neither reads nor writes machine state.
+  bool IsConstant() const;
+
+  // Computes the value of an expression for which IsConstant() is true
+  // without a machine. Throws for anything else.
+  int GetConstantIntegerValue() const;
+
+  // The string, if this is a string constant. Otherwise NULL.
+  const std::string* GetStringConstant() const;
+
   // Returns the value type of this expression (i.e. string or
   // integer)
   ExpressionValueType GetExpressionValueType() const;
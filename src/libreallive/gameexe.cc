@@ -38,14 +38,23 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <future>
 #include <iomanip>
+#include <thread>
 
 #include "libreallive/defs.h"
 
 namespace fs = boost::filesystem;
 
+// Files shorter than twice this are parsed on the calling thread.
+static const size_t kMinLinesPerThread = 2048;
+
 #define is_space(c) (c == '\r' || c == '\n' || c == ' ' || c == '\t')
 #define is_num(c) (c == '-' || (c >= '0' && c <= '9'))
 #define is_data(c) (c == '"' || is_num(c))
@@ -109,11 +118,12 @@ class gameexe_token_extractor {
 
 // -----------------------------------------------------------------------
 
-Gameexe::Gameexe() {}
+Gameexe::Gameexe() : hash_collision_(false), prefix_index_valid_(false) {}
 
 // -----------------------------------------------------------------------
 
-Gameexe::Gameexe(const fs::path& gameexefile) : data_(), cdata_() {
+Gameexe::Gameexe(const fs::path& gameexefile)
+    : data_(), cdata_(), hash_collision_(false), prefix_index_valid_(false) {
   fs::ifstream ifs(gameexefile);
   if (!ifs) {
     std::ostringstream oss;
@@ -122,9 +132,36 @@ Gameexe::Gameexe(const fs::path& gameexefile) : data_(), cdata_() {
     throw libreallive::Error(oss.str());
   }
 
+  std::vector<std::string> lines;
   std::string line;
-  while (std::getline(ifs, line)) {
-    parseLine(line);
+  while (std::getline(ifs, line))
+    lines.push_back(line);
+
+  // Tokenizing dominates, and lines don't depend on each other, so big files
+  // are split between threads. The results are added in file order so that
+  // duplicate keys come out the same as a serial parse.
+  size_t thread_count = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()),
+      lines.size() / kMinLinesPerThread);
+  if (thread_count <= 1) {
+    for (ParsedLine& parsed : ParseLines(lines, 0, lines.size()))
+      AddParsedLine(&parsed);
+    return;
+  }
+
+  size_t chunk = (lines.size() + thread_count - 1) / thread_count;
+  std::vector<std::future<std::vector<ParsedLine>>> workers;
+  for (size_t begin = chunk; begin < lines.size(); begin += chunk) {
+    workers.push_back(std::async(std::launch::async, &Gameexe::ParseLines,
+                                 std::cref(lines), begin,
+                                 std::min(begin + chunk, lines.size())));
+  }
+
+  for (ParsedLine& parsed : ParseLines(lines, 0, chunk))
+    AddParsedLine(&parsed);
+  for (auto& worker : workers) {
+    for (ParsedLine& parsed : worker.get())
+      AddParsedLine(&parsed);
   }
 }
 
@@ -133,39 +170,74 @@ Gameexe::~Gameexe() {}
 // -----------------------------------------------------------------------
 
 void Gameexe::parseLine(const std::string& line) {
+  ParsedLine parsed;
+  if (ParseLine(line, &parsed))
+    AddParsedLine(&parsed);
+}
+
+// -----------------------------------------------------------------------
+
+// static
+bool Gameexe::ParseLine(const std::string& line, ParsedLine* out) {
   size_t firstHash = line.find_first_of('#');
-  if (firstHash != std::string::npos) {
-    // Extract what's the key and value
-    size_t firstEqual = line.find_first_of('=');
-    std::string key = line.substr(firstHash + 1, firstEqual - firstHash - 1);
-    std::string value = line.substr(firstEqual + 1);
-
-    // Get rid of extra whitespace
-    boost::trim(key);
-    boost::trim(value);
-
-    Gameexe_vec_type vec;
-
-    // Extract all numeric and data values from the value
-    typedef boost::tokenizer<gameexe_token_extractor> ValueTokenizer;
-    ValueTokenizer tokenizer(value);
-    for (const std::string& tok : tokenizer) {
-      if (tok[0] == '"') {
-        std::string unquoted = tok.substr(1, tok.size() - 2);
-        cdata_.push_back(unquoted);
-        vec.push_back(cdata_.size() - 1);
-      } else if (tok != "-") {
-        try {
-          vec.push_back(std::stoi(tok));
-        }
-        catch (...) {
-          std::cerr << "Couldn't int-ify '" << tok << "'" << std::endl;
-          vec.push_back(0);
-        }
+  if (firstHash == std::string::npos)
+    return false;
+
+  // Extract what's the key and value
+  size_t firstEqual = line.find_first_of('=');
+  out->key = line.substr(firstHash + 1, firstEqual - firstHash - 1);
+  std::string value = line.substr(firstEqual + 1);
+
+  // Get rid of extra whitespace
+  boost::trim(out->key);
+  boost::trim(value);
+
+  // Extract all numeric and data values from the value
+  typedef boost::tokenizer<gameexe_token_extractor> ValueTokenizer;
+  ValueTokenizer tokenizer(value);
+  for (const std::string& tok : tokenizer) {
+    if (tok[0] == '"') {
+      out->strings.push_back(tok.substr(1, tok.size() - 2));
+      out->string_slots.push_back(out->values.size());
+      out->values.push_back(0);
+    } else if (tok != "-") {
+      try {
+        out->values.push_back(std::stoi(tok));
+      }
+      catch (...) {
+        std::cerr << "Couldn't int-ify '" << tok << "'" << std::endl;
+        out->values.push_back(0);
       }
     }
-    data_.emplace(key, vec);
   }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------
+
+// static
+std::vector<Gameexe::ParsedLine> Gameexe::ParseLines(
+    const std::vector<std::string>& lines, size_t begin, size_t end) {
+  std::vector<ParsedLine> parsed;
+  parsed.reserve(end - begin);
+  for (size_t i = begin; i < end; ++i) {
+    parsed.emplace_back();
+    if (!ParseLine(lines[i], &parsed.back()))
+      parsed.pop_back();
+  }
+  return parsed;
+}
+
+// -----------------------------------------------------------------------
+
+void Gameexe::AddParsedLine(ParsedLine* parsed) {
+  for (size_t i = 0; i < parsed->strings.size(); ++i) {
+    parsed->values[parsed->string_slots[i]] = cdata_.size();
+    cdata_.push_back(std::move(parsed->strings[i]));
+  }
+  IndexEntryAt(
+      data_.emplace(std::move(parsed->key), std::move(parsed->values)));
 }
 
 // -----------------------------------------------------------------------
@@ -192,7 +264,7 @@ int Gameexe::GetIntAt(GameexeData_t::const_iterator key, int index) {
 // -----------------------------------------------------------------------
 
 bool Gameexe::Exists(const std::string& key) {
-  return data_.find(key) != data_.end();
+  return Find(HashKey(key), &key) != data_.end();
 }
 
 // -----------------------------------------------------------------------
@@ -208,8 +280,8 @@ void Gameexe::SetStringAt(const std::string& key, const std::string& value) {
   Gameexe_vec_type toStore;
   cdata_.push_back(value);
   toStore.push_back(cdata_.size() - 1);
-  data_.erase(key);
-  data_.emplace(key, toStore);
+  RemoveKey(key);
+  IndexEntryAt(data_.emplace(key, toStore));
 }
 
 // -----------------------------------------------------------------------
@@ -217,14 +289,162 @@ void Gameexe::SetStringAt(const std::string& key, const std::string& value) {
 void Gameexe::SetIntAt(const std::string& key, const int value) {
   Gameexe_vec_type toStore;
   toStore.push_back(value);
+  RemoveKey(key);
+  IndexEntryAt(data_.emplace(key, toStore));
+}
+
+// -----------------------------------------------------------------------
+
+GameexeData_t::const_iterator Gameexe::Find(uint64_t hash,
+                                            const std::string* key) {
+  if (hash_collision_ && key)
+    return data_.find(*key);
+
+  auto it = index_.find(hash);
+  if (it == index_.end() || (key && it->second.it->first != *key))
+    return data_.end();
+  return it->second.it;
+}
+
+// -----------------------------------------------------------------------
+
+const std::vector<std::string>* Gameexe::GetKeyParts(uint64_t hash) {
+  if (hash_collision_)
+    return NULL;
+
+  auto it = index_.find(hash);
+  return it == index_.end() ? NULL : &it->second.parts;
+}
+
+// -----------------------------------------------------------------------
+
+void Gameexe::IndexEntryAt(GameexeData_t::const_iterator it) {
+  prefix_index_valid_ = false;
+
+  uint64_t hash = HashKey(it->first);
+  auto existing = index_.find(hash);
+  if (existing != index_.end()) {
+    // Duplicate keys keep pointing at the first value, like
+    // std::multimap::find().
+    if (existing->second.it->first != it->first)
+      hash_collision_ = true;
+    return;
+  }
+
+  IndexEntry& entry = index_[hash];
+  entry.it = it;
+  boost::split(entry.parts, it->first, boost::is_any_of("."));
+}
+
+// -----------------------------------------------------------------------
+
+void Gameexe::RemoveKey(const std::string& key) {
+  auto existing = index_.find(HashKey(key));
+  if (existing != index_.end() && existing->second.it->first == key)
+    index_.erase(existing);
   data_.erase(key);
-  data_.emplace(key, toStore);
+  prefix_index_valid_ = false;
+}
+
+// -----------------------------------------------------------------------
+
+void Gameexe::BuildPrefixIndex() {
+  if (prefix_index_valid_)
+    return;
+
+  // |data_| is already sorted by key, so a stable sort only has to deal
+  // with keys that differ in case.
+  prefix_index_.clear();
+  prefix_index_.reserve(data_.size());
+  for (auto it = data_.cbegin(); it != data_.cend(); ++it)
+    prefix_index_.push_back({boost::to_upper_copy(it->first), 0, it});
+  std::stable_sort(prefix_index_.begin(), prefix_index_.end(),
+                   [](const PrefixEntry& lhs, const PrefixEntry& rhs) {
+                     return lhs.folded_key < rhs.folded_key;
+                   });
+  for (PrefixEntry& entry : prefix_index_)
+    entry.hash = HashKey(entry.it->first);
+
+  prefix_index_valid_ = true;
+}
+
+// -----------------------------------------------------------------------
+
+uint64_t Gameexe::AppendToHash(uint64_t hash, const std::string& x) {
+  for (char c : x)
+    hash = hash * GameexeKey::kMultiplier + static_cast<unsigned char>(c);
+  return hash;
+}
+
+// -----------------------------------------------------------------------
+
+uint64_t Gameexe::AppendToHash(uint64_t hash, const char* x) {
+  for (; *x; ++x)
+    hash = hash * GameexeKey::kMultiplier + static_cast<unsigned char>(*x);
+  return hash;
+}
+
+// -----------------------------------------------------------------------
+
+uint64_t Gameexe::AppendToHash(uint64_t hash, const int& x) {
+  // Must match what AddToStream() writes.
+  char buf[16];
+  int length = snprintf(buf, sizeof(buf), "%d", x);
+  for (int i = length; i < 3; ++i)
+    hash = hash * GameexeKey::kMultiplier + '0';
+  return AppendToHash(hash, buf);
 }
 
 // -----------------------------------------------------------------------
 
-GameexeData_t::const_iterator Gameexe::Find(const std::string& key) {
-  return data_.find(key);
+bool Gameexe::MatchPiece(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const std::string& x) {
+  return MatchChars(key, pos, need_dot, x.data(), x.size());
+}
+
+// -----------------------------------------------------------------------
+
+bool Gameexe::MatchPiece(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const char* x) {
+  return MatchChars(key, pos, need_dot, x, strlen(x));
+}
+
+// -----------------------------------------------------------------------
+
+bool Gameexe::MatchPiece(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const int& x) {
+  // Must match what AddToStream() writes.
+  char buf[16] = "000";
+  char* digits = buf + 3;
+  int length = snprintf(digits, sizeof(buf) - 3, "%d", x);
+  int padding = length < 3 ? 3 - length : 0;
+  return MatchChars(key, pos, need_dot, digits - padding, length + padding);
+}
+
+// -----------------------------------------------------------------------
+
+bool Gameexe::MatchChars(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const char* x,
+                         size_t size) {
+  if (need_dot) {
+    if (pos >= key.size() || key[pos] != '.')
+      return false;
+    ++pos;
+  }
+  need_dot = true;
+
+  if (key.compare(pos, size, x, size) != 0)
+    return false;
+  pos += size;
+  return true;
 }
 
 // -----------------------------------------------------------------------
@@ -235,6 +455,18 @@ void Gameexe::AddToStream(const std::string& x, std::ostringstream& ss) {
 
 // -----------------------------------------------------------------------
 
+void Gameexe::AddToStream(const char* x, std::ostringstream& ss) {
+  ss << x;
+}
+
+// -----------------------------------------------------------------------
+
+void Gameexe::AddToStream(const GameexeKey& x, std::ostringstream& ss) {
+  ss << x.str();
+}
+
+// -----------------------------------------------------------------------
+
 void Gameexe::AddToStream(const int& x, std::ostringstream& ss) {
   ss << std::setw(3) << std::setfill('0') << x;
 }
@@ -250,33 +482,37 @@ void Gameexe::ThrowUnknownKey(const std::string& key) {
 // -----------------------------------------------------------------------
 
 GameexeFilteringIterator Gameexe::filtering_begin(const std::string& filter) {
-  return GameexeFilteringIterator(filter, *this, data_.begin());
+  BuildPrefixIndex();
+  std::string folded = boost::to_upper_copy(filter);
+  auto it = std::lower_bound(
+      prefix_index_.begin(), prefix_index_.end(), folded,
+      [](const PrefixEntry& entry, const std::string& value) {
+        return entry.folded_key < value;
+      });
+  return GameexeFilteringIterator(folded, *this, it - prefix_index_.begin());
 }
 
 // -----------------------------------------------------------------------
 
 GameexeFilteringIterator Gameexe::filtering_end() {
-  return GameexeFilteringIterator("", *this, data_.end());
+  BuildPrefixIndex();
+  return GameexeFilteringIterator("", *this, prefix_index_.size());
 }
 
 // -----------------------------------------------------------------------
 // GameexeInterpretObject
 // -----------------------------------------------------------------------
 GameexeInterpretObject::GameexeInterpretObject(const std::string& key,
+                                               uint64_t hash,
+                                               GameexeData_t::const_iterator it,
                                                Gameexe& objectToLookupOn)
     : key_(key),
-      iterator_(objectToLookupOn.Find(key)),
+      hash_(hash),
+      iterator_(it),
       object_to_lookup_on_(objectToLookupOn) {}
 
 // -----------------------------------------------------------------------
 
-GameexeInterpretObject::GameexeInterpretObject(const std::string& key,
-                                               GameexeData_t::const_iterator it,
-                                               Gameexe& objectToLookupOn)
-    : key_(key), iterator_(it), object_to_lookup_on_(objectToLookupOn) {}
-
-// -----------------------------------------------------------------------
-
 GameexeInterpretObject::~GameexeInterpretObject() {}
 
 // -----------------------------------------------------------------------
@@ -350,14 +586,27 @@ const std::vector<int>& GameexeInterpretObject::ToIntVector() const {
 // -----------------------------------------------------------------------
 
 bool GameexeInterpretObject::Exists() const {
-  return object_to_lookup_on_.Exists(key_);
+  return iterator_ != object_to_lookup_on_.data_.end();
+}
+
+// -----------------------------------------------------------------------
+
+const std::string& GameexeInterpretObject::key() const {
+  return Exists() ? iterator_->first : key_;
 }
 
 // -----------------------------------------------------------------------
 
 const std::vector<std::string> GameexeInterpretObject::GetKeyParts() const {
+  if (Exists()) {
+    const std::vector<std::string>* parts =
+        object_to_lookup_on_.GetKeyParts(hash_);
+    if (parts)
+      return *parts;
+  }
+
   std::vector<std::string> keyparts;
-  boost::split(keyparts, key_, boost::is_any_of("."));
+  boost::split(keyparts, key(), boost::is_any_of("."));
   return keyparts;
 }
 
@@ -365,16 +614,20 @@ const std::vector<std::string> GameexeInterpretObject::GetKeyParts() const {
 
 GameexeInterpretObject& GameexeInterpretObject::operator=(
     const std::string& value) {
-  // Set the key to incoming int
+  // Setting the value replaces the entry |iterator_| points to.
+  key_ = key();
   object_to_lookup_on_.SetStringAt(key_, value);
+  iterator_ = object_to_lookup_on_.Find(hash_, &key_);
   return *this;
 }
 
 // -----------------------------------------------------------------------
 
 GameexeInterpretObject& GameexeInterpretObject::operator=(const int value) {
-  // Set the key to incoming int
+  // Setting the value replaces the entry |iterator_| points to.
+  key_ = key();
   object_to_lookup_on_.SetIntAt(key_, value);
+  iterator_ = object_to_lookup_on_.Find(hash_, &key_);
   return *this;
 }
 
@@ -382,9 +635,29 @@ GameexeInterpretObject& GameexeInterpretObject::operator=(const int value) {
 // GameexeFilteringIterator
 // -----------------------------------------------------------------------
 
+GameexeFilteringIterator::GameexeFilteringIterator(
+    const std::string& inFilterKeys,
+    Gameexe& inGexe,
+    size_t position)
+    : filterKeys(inFilterKeys), gexe(inGexe), position(position) {
+  incrementUntilValid();
+}
+
+// -----------------------------------------------------------------------
+
+GameexeInterpretObject GameexeFilteringIterator::dereference() const {
+  const Gameexe::PrefixEntry& entry = gexe.prefix_index_[position];
+  return GameexeInterpretObject(std::string(), entry.hash, entry.it, gexe);
+}
+
+// -----------------------------------------------------------------------
+
 void GameexeFilteringIterator::incrementUntilValid() {
-  while (currentKey != gexe.data_.end() &&
-         !boost::istarts_with(currentKey->first, filterKeys)) {
-    currentKey++;
+  // Matching keys are contiguous in the prefix index, so once we step past
+  // them we're done.
+  if (position < gexe.prefix_index_.size() &&
+      !boost::starts_with(gexe.prefix_index_[position].folded_key,
+                          filterKeys)) {
+    position = gexe.prefix_index_.size();
   }
 }
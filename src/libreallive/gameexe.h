@@ -38,9 +38,11 @@
 #include <boost/iterator/iterator_facade.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include <cstdint>
 #include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class Gameexe;
@@ -54,6 +56,42 @@ typedef std::multimap<std::string, Gameexe_vec_type> GameexeData_t;
 
 // -----------------------------------------------------------------------
 
+// A piece of a Gameexe key with its hash precomputed. Keys are hashed one
+// piece at a time as they are looked up, so the key string is never built
+// unless the lookup misses. Declaring literal pieces constexpr moves even the
+// hashing to compile time:
+//
+//   static constexpr GameexeKey kColorTable("COLOR_TABLE");
+//   std::vector<int> colour = gexe(kColorTable, index);
+class GameexeKey {
+ public:
+  // Polynomial hash, so that the hash of a dotted key can be computed from
+  // the hashes of its pieces.
+  static constexpr uint64_t kMultiplier = 0x100000001b3ull;
+
+  constexpr GameexeKey(const char* str)  // NOLINT
+      : str_(str), hash_(0), power_(1) {
+    for (const char* c = str; *c; ++c) {
+      hash_ = hash_ * kMultiplier + static_cast<unsigned char>(*c);
+      power_ *= kMultiplier;
+    }
+  }
+
+  constexpr const char* str() const { return str_; }
+
+  // Returns |hash| with this piece appended.
+  constexpr uint64_t AppendTo(uint64_t hash) const {
+    return hash * power_ + hash_;
+  }
+
+ private:
+  const char* str_;
+  uint64_t hash_;
+  uint64_t power_;
+};
+
+// -----------------------------------------------------------------------
+
 // Encapsulates a line of the Gameexe file that's passed to the
 // user. This is a temporary class, which should hopefully be inlined
 // away from the target implementation.
@@ -77,9 +115,7 @@ class GameexeInterpretObject {
 
   // Extend a key by one key piece
   template<typename A>
-  GameexeInterpretObject operator()(const A& nextKey) {
-    return object_to_lookup_on_(key_, nextKey);
-  }
+  GameexeInterpretObject operator()(const A& nextKey);
 
   // Finds an int value, returning a default if non-existant.
   const int ToInt(const int defaultValue) const;
@@ -113,9 +149,7 @@ class GameexeInterpretObject {
   // Checks to see if the key exists.
   bool Exists() const;
 
-  const std::string& key() const {
-    return key_;
-  }
+  const std::string& key() const;
 
   // Returns the key splitted on periods.
   const std::vector<std::string> GetKeyParts() const;
@@ -132,13 +166,15 @@ class GameexeInterpretObject {
   friend class Gameexe;
   friend class GameexeFilteringIterator;
 
-  const std::string key_;
+  // Only filled in when |iterator_| doesn't point at the key.
+  std::string key_;
+  uint64_t hash_;
   GameexeData_t::const_iterator iterator_;
   Gameexe& object_to_lookup_on_;
 
   // Private; only allow construction by Gameexe
-  GameexeInterpretObject(const std::string& key, Gameexe& objectToLookupOn);
   GameexeInterpretObject(const std::string& key,
+                         uint64_t hash,
                          GameexeData_t::const_iterator it,
                          Gameexe& objectToLookupOn);
 };
@@ -157,16 +193,22 @@ class Gameexe {
 
   // Access the key "firstKey"
   template<typename A>
-  GameexeInterpretObject operator()(const A& firstKey);
+  GameexeInterpretObject operator()(const A& firstKey) {
+    return Lookup(0, std::string(), false, firstKey);
+  }
 
   // Access the key "firstKey"."secondKey"
   template<typename A, typename B>
-  GameexeInterpretObject operator()(const A& firstKey, const B& secondKey);
+  GameexeInterpretObject operator()(const A& firstKey, const B& secondKey) {
+    return Lookup(0, std::string(), false, firstKey, secondKey);
+  }
 
   // Access the key "firstKey"."secondKey"
   template<typename A, typename B, typename C>
   GameexeInterpretObject operator()(const A& firstKey, const B& secondKey,
-                                    const C& thirdKey);
+                                    const C& thirdKey) {
+    return Lookup(0, std::string(), false, firstKey, secondKey, thirdKey);
+  }
 
   // Returns iterators that filter on a possible value.
   GameexeFilteringIterator filtering_begin(const std::string& filter);
@@ -185,21 +227,148 @@ class Gameexe {
   void SetIntAt(const std::string& key, const int value);
 
  private:
+  // One parsed line whose strings haven't been given indices in |cdata_|
+  // yet, so that lines can be parsed on several threads.
+  struct ParsedLine {
+    std::string key;
+    Gameexe_vec_type values;
+
+    // Quoted strings in order, and which entries of |values| refer to them.
+    std::vector<std::string> strings;
+    std::vector<size_t> string_slots;
+  };
+
+  // Splits |line| into |out|. Returns false if |line| isn't a key.
+  static bool ParseLine(const std::string& line, ParsedLine* out);
+
+  // Parses [begin, end) of |lines|. Only touches its own output.
+  static std::vector<ParsedLine> ParseLines(
+      const std::vector<std::string>& lines, size_t begin, size_t end);
+
+  // Stores a parsed line; lines must be added in file order.
+  void AddParsedLine(ParsedLine* parsed);
+
+  // What the hash index stores about each distinct key.
+  struct IndexEntry {
+    // The first value stored under this key.
+    GameexeData_t::const_iterator it;
+
+    // The key split on periods, for GetKeyParts().
+    std::vector<std::string> parts;
+  };
+
+  // One key in case insensitive sorted order, for filtering_begin().
+  struct PrefixEntry {
+    std::string folded_key;
+    uint64_t hash;
+    GameexeData_t::const_iterator it;
+  };
+
   const std::vector<int>& GetIntArray(GameexeData_t::const_iterator key);
   int GetIntAt(GameexeData_t::const_iterator key, int index);
   std::string GetStringAt(GameexeData_t::const_iterator key, int index);
 
-  // Returns an iterator for the incoming key. May not be valid. This
-  // is a function only for tight coupling with
-  // GameexeInterpretObject.
-  GameexeData_t::const_iterator Find(const std::string& key);
+  // Looks up the key formed by appending |pieces| (separated by periods) to
+  // the key |prefix| with hash |hash|. The key string is only built if the
+  // lookup misses.
+  template<typename... Pieces>
+  GameexeInterpretObject Lookup(uint64_t hash,
+                                const std::string& prefix,
+                                bool need_dot,
+                                const Pieces&... pieces);
+
+  // Returns an iterator for the key with |hash|, or data_.end(). When |key|
+  // is given, an entry whose key differs is treated as missing; without it,
+  // the caller has to check the key of what's returned.
+  GameexeData_t::const_iterator Find(uint64_t hash, const std::string* key);
+
+  // Returns the precomputed key parts of |key|, or NULL.
+  const std::vector<std::string>* GetKeyParts(uint64_t hash);
+
+  // Adds a freshly inserted value to the hash index.
+  void IndexEntryAt(GameexeData_t::const_iterator it);
+
+  // Removes all values stored under |key|.
+  void RemoveKey(const std::string& key);
+
+  // Builds |prefix_index_| if needed.
+  void BuildPrefixIndex();
+
+  // Appends one piece of a key to a hash or to a key string.
+  template<typename Piece>
+  static void AppendPiece(uint64_t& hash, bool& need_dot, const Piece& piece) {
+    if (need_dot)
+      hash = hash * GameexeKey::kMultiplier + '.';
+    hash = AppendToHash(hash, piece);
+    need_dot = true;
+  }
+  template<typename Piece>
+  static void AppendPiece(std::ostringstream& ss,
+                          bool& need_dot,
+                          const Piece& piece) {
+    if (need_dot)
+      ss << '.';
+    AddToStream(piece, ss);
+    need_dot = true;
+  }
+
+  static uint64_t AppendToHash(uint64_t hash, const std::string& x);
+  static uint64_t AppendToHash(uint64_t hash, const char* x);
+  static uint64_t AppendToHash(uint64_t hash, const int& x);
+  static uint64_t AppendToHash(uint64_t hash, const GameexeKey& x) {
+    return x.AppendTo(hash);
+  }
+  static uint64_t HashKey(const std::string& key) {
+    return AppendToHash(0, key);
+  }
+
+  // Whether |key| is |prefix| with |pieces| appended, compared in place
+  // instead of building the string.
+  template<typename... Pieces>
+  static bool KeyMatches(const std::string& key,
+                         const std::string& prefix,
+                         bool need_dot,
+                         const Pieces&... pieces) {
+    if (key.compare(0, prefix.size(), prefix) != 0)
+      return false;
+    size_t pos = prefix.size();
+    return (MatchPiece(key, pos, need_dot, pieces) && ...) &&
+           pos == key.size();
+  }
+
+  // Checks one piece of a key at |pos| in |key| and advances past it.
+  static bool MatchPiece(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const std::string& x);
+  static bool MatchPiece(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const char* x);
+  static bool MatchPiece(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const int& x);
+  static bool MatchPiece(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const GameexeKey& x) {
+    return MatchPiece(key, pos, need_dot, x.str());
+  }
+  static bool MatchChars(const std::string& key,
+                         size_t& pos,
+                         bool& need_dot,
+                         const char* x,
+                         size_t size);
 
   // Regrettable artifact of hack to get all integers in streams to
   // have setw(3).
-  void AddToStream(const std::string& x, std::ostringstream& ss);
+  static void AddToStream(const std::string& x, std::ostringstream& ss);
+  static void AddToStream(const char* x, std::ostringstream& ss);
+  static void AddToStream(const GameexeKey& x, std::ostringstream& ss);
 
   // Hack to get all integers in streams to have setw(3).
-  void AddToStream(const int& x, std::ostringstream& ss);
+  static void AddToStream(const int& x, std::ostringstream& ss);
 
   void ThrowUnknownKey(const std::string& key);
 
@@ -215,49 +384,50 @@ class Gameexe {
   // that int is an index into a vector of strings on the side.
   GameexeData_t data_;
   std::vector<std::string> cdata_;
-};
 
-// -----------------------------------------------------------------------
+  // Hash of the full key to its entry. Hits are checked against the stored
+  // key; when |hash_collision_| is set, keys are looked up in |data_|
+  // instead.
+  std::unordered_map<uint64_t, IndexEntry> index_;
+  bool hash_collision_;
 
-template<typename A>
-GameexeInterpretObject Gameexe::operator()(const A& firstKey) {
-  std::ostringstream ss;
-  AddToStream(firstKey, ss);
-  return GameexeInterpretObject(ss.str(), *this);
-}
+  // Every value sorted by upper cased key, so that filtering_begin() can
+  // binary search for its prefix. Rebuilt lazily after modifications.
+  std::vector<PrefixEntry> prefix_index_;
+  bool prefix_index_valid_;
+};
 
 // -----------------------------------------------------------------------
 
-template<>
-inline GameexeInterpretObject Gameexe::operator()(const std::string& firstKey) {
-  return GameexeInterpretObject(firstKey, *this);
-}
-
-// -----------------------------------------------------------------------
+template<typename... Pieces>
+GameexeInterpretObject Gameexe::Lookup(uint64_t hash,
+                                       const std::string& prefix,
+                                       bool need_dot,
+                                       const Pieces&... pieces) {
+  bool dot = need_dot;
+  (AppendPiece(hash, dot, pieces), ...);
+
+  if (!hash_collision_) {
+    GameexeData_t::const_iterator it = Find(hash, NULL);
+    if (it != data_.end() && KeyMatches(it->first, prefix, need_dot, pieces...))
+      return GameexeInterpretObject(std::string(), hash, it, *this);
+  }
 
-template<typename A, typename B>
-GameexeInterpretObject Gameexe::operator()(const A& firstKey,
-                                           const B& secondKey) {
+  // Either the key doesn't exist, or we need the full string to tell keys
+  // apart.
   std::ostringstream ss;
-  AddToStream(firstKey, ss);
-  ss << ".";
-  AddToStream(secondKey, ss);
-  return GameexeInterpretObject(ss.str(), *this);
+  ss << prefix;
+  dot = need_dot;
+  (AppendPiece(ss, dot, pieces), ...);
+  std::string key = ss.str();
+  return GameexeInterpretObject(key, hash, Find(hash, &key), *this);
 }
 
 // -----------------------------------------------------------------------
 
-template<typename A, typename B, typename C>
-GameexeInterpretObject Gameexe::operator()(const A& firstKey,
-                                           const B& secondKey,
-                                           const C& thirdKey) {
-  std::ostringstream ss;
-  AddToStream(firstKey, ss);
-  ss << ".";
-  AddToStream(secondKey, ss);
-  ss << ".";
-  AddToStream(thirdKey, ss);
-  return GameexeInterpretObject(ss.str(), *this);
+template<typename A>
+GameexeInterpretObject GameexeInterpretObject::operator()(const A& nextKey) {
+  return object_to_lookup_on_.Lookup(hash_, key(), true, nextKey);
 }
 
 // -----------------------------------------------------------------------
@@ -268,16 +438,13 @@ class GameexeFilteringIterator
   GameexeInterpretObject,
   boost::forward_traversal_tag, GameexeInterpretObject> {
  public:
-  explicit GameexeFilteringIterator(const std::string& inFilterKeys,
-                                    Gameexe& inGexe,
-                                    GameexeData_t::const_iterator it)
-      : filterKeys(inFilterKeys), gexe(inGexe), currentKey(it) {
-    incrementUntilValid();
-  }
+  GameexeFilteringIterator(const std::string& inFilterKeys,
+                           Gameexe& inGexe,
+                           size_t position);
 
   GameexeFilteringIterator(GameexeFilteringIterator const& other)
       : filterKeys(other.filterKeys), gexe(other.gexe),
-        currentKey(other.currentKey) {
+        position(other.position) {
   }
 
  private:
@@ -287,23 +454,24 @@ class GameexeFilteringIterator
   bool equal(GameexeFilteringIterator const& other) const {
     // It is deliberate that we only compare the current keys. This
     // means you don't need to
-    return currentKey == other.currentKey;
+    return position == other.position;
   }
 
   void increment() {
-    currentKey++;
+    position++;
     incrementUntilValid();
   }
 
-  GameexeInterpretObject dereference() const {
-    return GameexeInterpretObject(currentKey->first, currentKey, gexe);
-  }
+  GameexeInterpretObject dereference() const;
 
   void incrementUntilValid();
 
+  // Upper cased filter.
   const std::string filterKeys;
   Gameexe& gexe;
-  GameexeData_t::const_iterator currentKey;
+
+  // Position in the Gameexe's prefix index.
+  size_t position;
 };
 
 // -----------------------------------------------------------------------
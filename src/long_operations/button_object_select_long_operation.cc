@@ -43,18 +43,28 @@ ButtonObjectSelectLongOperation::ButtonObjectSelectLongOperation(
       gameexe_(machine.system().gameexe()),
       currently_hovering_button_(NULL),
       currently_pressed_button_(NULL) {
+  // Only the buttons get changed (by their overrides), so look through the
+  // layer without journaling it and only fetch the buttons for writing.
   GraphicsSystem& graphics = machine.system().graphics();
-  for (GraphicsObject& obj : graphics.GetForegroundObjects()) {
-    if (obj.IsButton() && obj.GetButtonGroup() == group_) {
-      buttons_.emplace_back(&obj, static_cast<GraphicsObject*>(NULL));
-    } else if (obj.has_object_data()) {
-      ParentGraphicsObjectData* parent =
-          dynamic_cast<ParentGraphicsObjectData*>(&obj.GetObjectData());
+  const LazyArray<GraphicsObject>& objects =
+      static_cast<const GraphicsSystem&>(graphics).GetForegroundObjects();
+  for (auto it = objects.begin(); it != objects.end(); ++it) {
+    if (it->IsButton() && it->GetButtonGroup() == group_) {
+      buttons_.emplace_back(&graphics.GetObject(OBJ_FG, it.pos()),
+                            static_cast<GraphicsObject*>(NULL));
+    } else if (it->has_object_data()) {
+      const ParentGraphicsObjectData* parent =
+          dynamic_cast<const ParentGraphicsObjectData*>(&it->GetObjectData());
 
       if (parent) {
-        for (GraphicsObject& child : parent->objects()) {
-          if (child.IsButton() && child.GetButtonGroup() == group_) {
-            buttons_.emplace_back(&child, &obj);
+        const LazyArray<GraphicsObject>& children = parent->objects();
+        for (auto child = children.begin(); child != children.end(); ++child) {
+          if (child->IsButton() && child->GetButtonGroup() == group_) {
+            GraphicsObject& obj = graphics.GetObject(OBJ_FG, it.pos());
+            buttons_.emplace_back(
+                &static_cast<ParentGraphicsObjectData&>(obj.GetObjectData())
+                     .GetObject(child.pos()),
+                &obj);
           }
         }
       }
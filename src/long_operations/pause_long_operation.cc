@@ -27,6 +27,7 @@
 
 #include "long_operations/pause_long_operation.h"
 
+#include <climits>
 #include <vector>
 
 #include "machine/rlmachine.h"
@@ -189,6 +190,17 @@ bool PauseLongOperation::operator()(RLMachine& machine) {
   return is_done_;
 }
 
+unsigned int PauseLongOperation::NextWakeupTime(RLMachine& machine) const {
+  // The auto mode timer only advances while we're being called.
+  if (is_done_ || machine.system().text().auto_mode() ||
+      machine.system().ShouldFastForward()) {
+    return 0;
+  }
+
+  // Otherwise we're waiting for a click or a key press.
+  return UINT_MAX;
+}
+
 bool PauseLongOperation::AutomodeTimerFired() {
   int current_time = machine_.system().event().GetTicks();
   int time_since_last_pass = current_time - time_at_last_pass_;
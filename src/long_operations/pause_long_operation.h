@@ -45,6 +45,7 @@ class PauseLongOperation : public LongOperation {
 
   // Overridden from LongOperation:
   virtual bool operator()(RLMachine& machine);
+  virtual unsigned int NextWakeupTime(RLMachine& machine) const;
 
  private:
   // Has this pause timed out?
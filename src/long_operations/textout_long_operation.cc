@@ -39,13 +39,6 @@
 #include "systems/base/text_page.h"
 #include "systems/base/text_system.h"
 #include "utilities/exception.h"
-#include "utf8cpp/utf8.h"
-
-// Timing information must stay the same between individual
-// TextoutLongOperations. rlBabel compiled games will always display one
-// character per TextoutLongOperation.
-unsigned int TextoutLongOperation::time_at_last_pass_ = 0;
-int TextoutLongOperation::next_character_countdown_ = 0;
 
 // -----------------------------------------------------------------------
 // TextoutLongOperation
@@ -53,18 +46,15 @@ int TextoutLongOperation::next_character_countdown_ = 0;
 
 TextoutLongOperation::TextoutLongOperation(RLMachine& machine,
                                            const std::string& utf8string)
-    : utf8_string_(utf8string),
+    : layout_(utf8string),
       current_codepoint_(0),
-      current_position_(utf8_string_.begin()),
+      current_(0),
+      next_(0),
       no_wait_(false) {
   // Retrieve the first character (prime the loop in operator())
-  string::iterator tmp = current_position_;
-  if (tmp == utf8_string_.end()) {
-    current_char_ = "";
-  } else {
-    current_codepoint_ = utf8::next(tmp, utf8_string_.end());
-    current_char_ = string(current_position_, tmp);
-    current_position_ = tmp;
+  if (!layout_.empty()) {
+    current_codepoint_ = layout_.codepoint(0);
+    next_ = 1;
   }
 
   // If we are inside a ruby gloss right now, don't delay at
@@ -108,41 +98,34 @@ bool TextoutLongOperation::DisplayName(RLMachine& machine) {
   // name, even though character names are one of the places where that's
   // evaluated.
 
-  // Ignore the starting bracket
-  string::iterator it = current_position_;
-  string::iterator curend = it;
-  string::iterator strend = utf8_string_.end();
-  int codepoint = utf8::next(it, strend);
-
   // Eat all characters between the name brackets
-  while (codepoint != 0x3011 && it != strend) {
-    curend = it;
-    codepoint = utf8::next(it, strend);
-  }
+  size_t close = next_;
+  while (close < layout_.size() && layout_.codepoint(close) != 0x3011)
+    ++close;
 
-  if (codepoint != 0x3011 && it == strend) {
+  if (close == layout_.size()) {
     throw SystemError(
         "Malformed string code. Opening bracket in \\{name}"
         " construct,  but missing closing bracket.");
   }
 
   // Grab the name
-  string name(current_position_, curend);
+  string name = layout_.Slice(next_, close);
 
   // Consume the next character
-  current_position_ = it;
-
-  if (it != strend) {
-    current_codepoint_ = utf8::next(it, strend);
-    current_char_ = string(current_position_, it);
-    current_position_ = it;
+  if (close + 1 < layout_.size()) {
+    current_ = close + 1;
+    current_codepoint_ = layout_.codepoint(current_);
+    next_ = current_ + 1;
+  } else {
+    next_ = layout_.size();
   }
 
   TextPage& page = machine.system().text().GetCurrentPage();
-  page.Name(name, current_char_);
+  page.Name(name, CurrentCharacter());
 
   // Stop if this was the end of input
-  return it == strend;
+  return next_ >= layout_.size();
 }
 
 bool TextoutLongOperation::DisplayOneMoreCharacter(RLMachine& machine,
@@ -152,28 +135,23 @@ bool TextoutLongOperation::DisplayOneMoreCharacter(RLMachine& machine,
     // treat names as a single display operation
     return DisplayName(machine);
   } else {
-    // Isolate the next character
-    string::iterator it = current_position_;
-    string::iterator strend = utf8_string_.end();
-
-    if (it != strend) {
-      int codepoint = utf8::next(it, strend);
-      TextPage& page = machine.system().text().GetCurrentPage();
-      if (codepoint) {
-        string rest(current_position_, strend);
-        bool rendered = page.Character(current_char_, rest);
+    TextPage& page = machine.system().text().GetCurrentPage();
+    if (next_ < layout_.size()) {
+      if (layout_.codepoint(next_)) {
+        bool rendered =
+            page.Character(CurrentCharacter(), layout_.Lookahead(current_));
 
         // Check to see if this character was rendered to the screen. If
         // this is false, then the page is probably full and the check
         // later on will do something about that.
         if (rendered) {
-          current_char_ = std::string(current_position_, it);
-          current_position_ = it;
+          current_ = next_;
+          next_++;
         }
       } else {
         // advance to the next character if we've somehow hit an
         // embedded NULL that isn't the end of the string
-        current_position_ = it;
+        next_++;
       }
 
       // Call the pause operation if we've filled up the current page.
@@ -186,13 +164,17 @@ bool TextoutLongOperation::DisplayOneMoreCharacter(RLMachine& machine,
 
       return false;
     } else {
-      machine.system().text().GetCurrentPage().Character(current_char_, "");
+      page.Character(CurrentCharacter(), "");
 
       return true;
     }
   }
 }
 
+std::string TextoutLongOperation::CurrentCharacter() const {
+  return layout_.empty() ? std::string() : layout_.Character(current_);
+}
+
 bool TextoutLongOperation::operator()(RLMachine& machine) {
   // Check to make sure we're not trying to do a textout (impossible!)
   if (!machine.system().text().system_visible())
@@ -201,14 +183,17 @@ bool TextoutLongOperation::operator()(RLMachine& machine) {
   if (no_wait_) {
     return DisplayAsMuchAsWeCanThenPause(machine);
   } else {
+    TextSystem::TextoutTiming& timing =
+        machine.system().text().textout_timing();
     int current_time = machine.system().event().GetTicks();
-    int time_since_last_pass = current_time - time_at_last_pass_;
-    time_at_last_pass_ = current_time;
+    int time_since_last_pass = current_time - timing.time_at_last_pass;
+    timing.time_at_last_pass = current_time;
 
-    next_character_countdown_ -= time_since_last_pass;
-    if (next_character_countdown_ <= 0) {
+    timing.next_character_countdown -= time_since_last_pass;
+    if (timing.next_character_countdown <= 0) {
       bool paused = false;
-      next_character_countdown_ = machine.system().text().message_speed();
+      timing.next_character_countdown =
+          machine.system().text().message_speed();
       return DisplayOneMoreCharacter(machine, paused);
     } else {
       // Let's sleep a bit and then try again.
@@ -216,3 +201,15 @@ bool TextoutLongOperation::operator()(RLMachine& machine) {
     }
   }
 }
+
+unsigned int TextoutLongOperation::NextWakeupTime(RLMachine& machine) const {
+  if (no_wait_ || machine.system().ShouldFastForward())
+    return 0;
+
+  const TextSystem::TextoutTiming& timing =
+      machine.system().text().textout_timing();
+  if (timing.next_character_countdown <= 0)
+    return 0;
+
+  return timing.time_at_last_pass + timing.next_character_countdown;
+}
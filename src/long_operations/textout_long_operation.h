@@ -32,6 +32,7 @@
 
 #include "machine/long_operation.h"
 #include "systems/base/event_listener.h"
+#include "utilities/text_layout.h"
 
 class RLMachine;
 
@@ -48,6 +49,7 @@ class TextoutLongOperation : public LongOperation {
 
   // Overriden from LongOperation:
   virtual bool operator()(RLMachine& machine);
+  virtual unsigned int NextWakeupTime(RLMachine& machine) const;
 
  private:
   bool DisplayAsMuchAsWeCanThenPause(RLMachine& machine);
@@ -57,20 +59,22 @@ class TextoutLongOperation : public LongOperation {
   bool DisplayName(RLMachine& machine);
   bool DisplayOneMoreCharacter(RLMachine& machine, bool& paused);
 
-  std::string utf8_string_;
+  // The character we display next, or "" if the string was empty.
+  std::string CurrentCharacter() const;
+
+  // The string to display, decoded once up front.
+  TextLayout layout_;
 
   int current_codepoint_;
-  std::string current_char_;
-  std::string::iterator current_position_;
 
-  // Sets whether we should display as much text as we can immediately.
-  bool no_wait_;
+  // Index in |layout_| of the character waiting to be displayed.
+  size_t current_;
 
-  // How long it's been since the last time we've added time to |total_time_|.
-  static unsigned int time_at_last_pass_;
+  // Index in |layout_| of the character after that one.
+  size_t next_;
 
-  // A countdown in milliseconds until we display the next character.
-  static int next_character_countdown_;
+  // Sets whether we should display as much text as we can immediately.
+  bool no_wait_;
 };
 
 #endif  // SRC_LONG_OPERATIONS_TEXTOUT_LONG_OPERATION_H_
@@ -26,6 +26,8 @@
 
 #include "long_operations/wait_long_operation.h"
 
+#include <climits>
+
 #include "machine/rlmachine.h"
 #include "systems/base/event_listener.h"
 #include "systems/base/event_system.h"
@@ -142,3 +144,17 @@ bool WaitLongOperation::operator()(RLMachine& machine) {
 
   return done;
 }
+
+unsigned int WaitLongOperation::NextWakeupTime(RLMachine& machine) const {
+  // Arbitrary break conditions and redraw requests have to be polled.
+  if (break_on_event_ || mouse_moved_ || ctrl_pressed_ ||
+      machine.system().ShouldFastForward() ||
+      machine.system().graphics().object_state_dirty()) {
+    return 0;
+  }
+
+  if (wait_until_target_time_)
+    return target_time_ + 1;
+
+  return UINT_MAX;
+}
@@ -64,6 +64,7 @@ class WaitLongOperation : public LongOperation {
 
   // Overridden from LongOperation:
   virtual bool operator()(RLMachine& machine);
+  virtual unsigned int NextWakeupTime(RLMachine& machine) const;
 
  private:
   RLMachine& machine_;
@@ -0,0 +1,203 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#include "machine/kidoku_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "libreallive/filemap.h"
+#include "utilities/exception.h"
+
+namespace {
+
+const char kMagic[4] = {'R', 'L', 'K', 'D'};
+const uint32_t kVersion = 1;
+
+// magic, version, scenario count, word count.
+const size_t kHeaderSize = 4 * sizeof(uint32_t);
+
+size_t WordsFor(uint32_t bits) { return (bits + 63) / 64; }
+
+// ORs the first |bits| bits of |src| into |dest|.
+void OrBits(uint64_t* dest, const uint64_t* src, uint32_t bits) {
+  size_t words = WordsFor(bits);
+  for (size_t i = 0; i < words; ++i) {
+    uint64_t word = src[i];
+    if (i == words - 1 && bits % 64)
+      word &= (uint64_t(1) << (bits % 64)) - 1;
+    dest[i] |= word;
+  }
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+// KidokuTable
+// -----------------------------------------------------------------------
+KidokuTable::KidokuTable() : word_count_(0), words_(NULL) {}
+
+KidokuTable::~KidokuTable() {}
+
+void KidokuTable::SetLayout(const std::map<int, int>& sizes) {
+  std::vector<Extent> extents;
+  size_t word_count = 0;
+  if (!sizes.empty())
+    extents.resize(sizes.rbegin()->first + 1, Extent{0, 0});
+  for (auto const& entry : sizes) {
+    if (entry.first < 0 || entry.second <= 0)
+      continue;
+    extents[entry.first] = Extent{static_cast<uint32_t>(word_count),
+                                  static_cast<uint32_t>(entry.second)};
+    word_count += WordsFor(entry.second);
+  }
+
+  std::vector<uint64_t> memory(word_count, 0);
+  size_t common = std::min(extents.size(), extents_.size());
+  for (size_t i = 0; i < common; ++i) {
+    OrBits(memory.data() + extents[i].first_word, words_ + extents_[i].first_word,
+           std::min(extents[i].size, extents_[i].size));
+  }
+
+  extents_.swap(extents);
+  word_count_ = word_count;
+  memory_.swap(memory);
+  words_ = memory_.data();
+
+  if (attached()) {
+    mapping_.reset();
+    WriteAndMapFile();
+  }
+}
+
+void KidokuTable::AttachFile(const std::string& path, bool merge) {
+  if (mapping_) {
+    // Pull the bits back out of the old file before we unmap it.
+    memory_.assign(words_, words_ + word_count_);
+    words_ = memory_.data();
+    mapping_.reset();
+  }
+  path_ = path;
+  if (!merge) {
+    WriteAndMapFile();
+    return;
+  }
+
+  std::ifstream file(path.c_str(), std::ios::binary);
+  std::vector<char> data((std::istreambuf_iterator<char>(file)),
+                         std::istreambuf_iterator<char>());
+  uint32_t header[4];
+  if (data.size() >= kHeaderSize) {
+    memcpy(header, data.data(), kHeaderSize);
+    size_t directory_size = header[2] * 2 * sizeof(uint32_t);
+    if (memcmp(header, kMagic, sizeof(kMagic)) == 0 &&
+        header[1] == kVersion &&
+        data.size() == kHeaderSize + directory_size +
+                           header[3] * sizeof(uint64_t)) {
+      std::vector<uint32_t> directory(header[2] * 2);
+      memcpy(directory.data(), data.data() + kHeaderSize, directory_size);
+      std::vector<uint64_t> words(header[3]);
+      memcpy(words.data(), data.data() + kHeaderSize + directory_size,
+             words.size() * sizeof(uint64_t));
+
+      size_t first_word = 0;
+      for (size_t i = 0; i < directory.size(); i += 2) {
+        uint32_t scenario = directory[i];
+        uint32_t size = directory[i + 1];
+        if (first_word + WordsFor(size) > words.size())
+          break;
+        if (scenario < extents_.size()) {
+          OrBits(words_ + extents_[scenario].first_word,
+                 &words[first_word],
+                 std::min(size, extents_[scenario].size));
+        }
+        first_word += WordsFor(size);
+      }
+    }
+  }
+
+  WriteAndMapFile();
+}
+
+void KidokuTable::Absorb(std::map<int, boost::dynamic_bitset<>>* bitsets) {
+  for (auto it = bitsets->begin(); it != bitsets->end();) {
+    boost::dynamic_bitset<>& bits = it->second;
+    for (size_t i = bits.find_first(); i != bits.npos; i = bits.find_next(i)) {
+      if (Contains(it->first, i)) {
+        Set(it->first, i);
+        bits.reset(i);
+      }
+    }
+
+    if (bits.none())
+      it = bitsets->erase(it);
+    else
+      ++it;
+  }
+}
+
+void KidokuTable::WriteAndMapFile() {
+  std::vector<uint32_t> directory;
+  for (size_t i = 0; i < extents_.size(); ++i) {
+    if (extents_[i].size) {
+      directory.push_back(i);
+      directory.push_back(extents_[i].size);
+    }
+  }
+
+  uint32_t header[4];
+  memcpy(header, kMagic, sizeof(kMagic));
+  header[1] = kVersion;
+  header[2] = directory.size() / 2;
+  header[3] = word_count_;
+
+  {
+    std::ofstream file(path_.c_str(), std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(header), kHeaderSize);
+    file.write(reinterpret_cast<const char*>(directory.data()),
+               directory.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(words_),
+               word_count_ * sizeof(uint64_t));
+    if (!file)
+      throw rlvm::Exception("Could not write kidoku table to " + path_);
+  }
+
+  // An empty table has nothing to map; it stays in |memory_|.
+  if (word_count_ == 0)
+    return;
+
+  mapping_.reset(new libreallive::Mapping(path_, libreallive::Write));
+  words_ = reinterpret_cast<uint64_t*>(mapping_->get() + kHeaderSize +
+                                       directory.size() * sizeof(uint32_t));
+  std::vector<uint64_t>().swap(memory_);
+}
@@ -0,0 +1,122 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_MACHINE_KIDOKU_TABLE_H_
+#define SRC_MACHINE_KIDOKU_TABLE_H_
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libreallive {
+class Mapping;
+}  // namespace libreallive
+
+// Dense record of which kidoku markers have been read, with one run of bits
+// per scenario sized from that scenario's kidoku table. Skip mode asks
+// whether a marker was read every time it passes one, so a lookup is a
+// shift and a mask.
+//
+// Once AttachFile() has been called, the bits live in a small memory mapped
+// file that is updated in place; there is nothing more to do to save them.
+// The file is a local cache in native byte order:
+//
+//   "RLKD", version, scenario count, word count     (4 x uint32_t)
+//   scenario number, number of markers              (2 x uint32_t each)
+//   the bits                                        (uint64_t words)
+class KidokuTable {
+ public:
+  KidokuTable();
+  ~KidokuTable();
+
+  // Lays the table out for the scenarios in |sizes|, a map from scenario
+  // number to the number of kidoku markers in it. Read state for markers
+  // that exist in both the old and the new layout is kept.
+  void SetLayout(const std::map<int, int>& sizes);
+
+  // Moves the table into the file at |path|. Unless |merge| is false, read
+  // state already recorded in that file is merged into the table; the file
+  // is then rewritten in the current layout and mapped. Throws if the file
+  // can't be written.
+  void AttachFile(const std::string& path, bool merge = true);
+
+  bool attached() const { return !path_.empty(); }
+  const std::string& path() const { return path_; }
+
+  // Whether |kidoku| in |scenario| has a bit in this table.
+  bool Contains(int scenario, int kidoku) const {
+    return scenario >= 0 && static_cast<size_t>(scenario) < extents_.size() &&
+           kidoku >= 0 &&
+           static_cast<uint32_t>(kidoku) < extents_[scenario].size;
+  }
+
+  // Both of these require Contains(scenario, kidoku).
+  bool Test(int scenario, int kidoku) const {
+    return (words_[extents_[scenario].first_word + (kidoku >> 6)] >>
+            (kidoku & 63)) & 1;
+  }
+  void Set(int scenario, int kidoku) {
+    words_[extents_[scenario].first_word + (kidoku >> 6)] |= uint64_t(1)
+                                                             << (kidoku & 63);
+  }
+
+  // Moves every set bit in |bitsets| which has a place in this table into
+  // it. Only the bits (and scenarios) that don't fit are left behind.
+  void Absorb(std::map<int, boost::dynamic_bitset<>>* bitsets);
+
+ private:
+  // Where one scenario's bits are.
+  struct Extent {
+    uint32_t first_word;
+    uint32_t size;
+  };
+
+  // Writes the table to |path_| and maps it.
+  void WriteAndMapFile();
+
+  // Indexed by scenario number. Scenarios that aren't in the archive have
+  // an empty extent.
+  std::vector<Extent> extents_;
+  size_t word_count_;
+
+  // Backing store until a file is attached.
+  std::vector<uint64_t> memory_;
+
+  // The attached file, if any. |mapping_| is NULL for an empty table.
+  std::unique_ptr<libreallive::Mapping> mapping_;
+  std::string path_;
+
+  // Points into |memory_| or |mapping_|.
+  uint64_t* words_;
+};
+
+#endif  // SRC_MACHINE_KIDOKU_TABLE_H_
@@ -39,6 +39,10 @@ LongOperation::LongOperation() : EventListener() {}
 
 LongOperation::~LongOperation() {}
 
+unsigned int LongOperation::NextWakeupTime(RLMachine& machine) const {
+  return 0;
+}
+
 // -----------------------------------------------------------------------
 // PerformAfterLongOperationDecorator
 // -----------------------------------------------------------------------
@@ -72,3 +76,8 @@ bool PerformAfterLongOperationDecorator::operator()(RLMachine& machine) {
 
   return ret_val;
 }
+
+unsigned int PerformAfterLongOperationDecorator::NextWakeupTime(
+    RLMachine& machine) const {
+  return operation_->NextWakeupTime(machine);
+}
@@ -55,6 +55,11 @@ class LongOperation : public EventListener {
   // Executes the current LongOperation. Returns true if the command has
   // completed, and normal interpretation should be resumed, false otherwise.
   virtual bool operator()(RLMachine& machine) = 0;
+
+  // The tick at which this operation next needs to run, if no input arrives
+  // in the meantime. Operations that only react to input return UINT_MAX.
+  // The default of 0 polls on every trip through the game loop.
+  virtual unsigned int NextWakeupTime(RLMachine& machine) const;
 };
 
 // LongOperator decorator that simply invokes the included
@@ -74,6 +79,7 @@ class PerformAfterLongOperationDecorator : public LongOperation {
 
   // Overridden from LongOperation:
   virtual bool operator()(RLMachine& machine);
+  virtual unsigned int NextWakeupTime(RLMachine& machine) const;
 
  private:
   // Payload of decorator implemented by subclasses
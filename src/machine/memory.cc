@@ -27,18 +27,92 @@
 
 #include "machine/memory.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <map>
+#include <numeric>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "libreallive/gameexe.h"
 #include "libreallive/intmemref.h"
 #include "machine/rlmachine.h"
+#include "machine/stack_frame.h"
 #include "utilities/exception.h"
 #include "utilities/string_utilities.h"
 
 using std::make_pair;
 
+namespace {
+
+// Reads location |location| out of a bank viewed |bits| bits at a time.
+inline int GetPacked(const int* bank, int bits, int location) {
+  int per_word = 32 / bits;
+  uint32_t word = bank[location / per_word];
+  return (word >> ((location % per_word) * bits)) & ((1u << bits) - 1);
+}
+
+inline void SetPacked(int* bank, int bits, int location, int value) {
+  int per_word = 32 / bits;
+  uint32_t mask = (1u << bits) - 1;
+  int shift = (location % per_word) * bits;
+  uint32_t word = bank[location / per_word];
+  word = (word & ~(mask << shift)) | ((uint32_t(value) & mask) << shift);
+  bank[location / per_word] = word;
+}
+
+// Repeats the low |bits| bits of |value| across a whole word.
+inline uint32_t ReplicatePacked(int bits, int value) {
+  uint32_t pattern = uint32_t(value) & ((1u << bits) - 1);
+  for (int width = bits; width < 32; width *= 2)
+    pattern |= pattern << width;
+  return pattern;
+}
+
+// Sums every |bits| wide field in |word|.
+inline uint32_t SumPackedWord(int bits, uint32_t word) {
+  switch (bits) {
+    case 1:
+      return __builtin_popcount(word);
+    case 8:
+      return (word & 0xff) + ((word >> 8) & 0xff) + ((word >> 16) & 0xff) +
+             (word >> 24);
+    default: {
+      uint32_t mask = (1u << bits) - 1;
+      uint32_t total = 0;
+      for (int shift = 0; shift < 32; shift += bits)
+        total += (word >> shift) & mask;
+      return total;
+    }
+  }
+}
+
+// Logs the current value of each word in [first_word, last_word], stepping by
+// |word_step|, that doesn't already have an entry. The log is walked once in
+// order instead of being searched per word.
+void RecordOriginalWords(const int* bank,
+                         std::map<int, int>* original,
+                         int first_word,
+                         int last_word,
+                         int word_step) {
+  if (!original)
+    return;
+
+  auto it = original->lower_bound(first_word);
+  for (int word = first_word; word <= last_word; word += word_step) {
+    while (it != original->end() && it->first < word)
+      ++it;
+    if (it != original->end() && it->first == word)
+      continue;
+    it = ++original->emplace_hint(it, word, bank[word]);
+  }
+}
+
+}  // namespace
+
 const IntegerBank_t LOCAL_INTEGER_BANKS = {
     make_pair(libreallive::INTA_LOCATION, 'A'),
     make_pair(libreallive::INTB_LOCATION, 'B'),
@@ -125,10 +199,13 @@ const std::string& Memory::GetStringValue(int type, int location) {
         "Invalid range access in RLMachine::set_string_value");
 
   switch (type) {
-    case libreallive::STRK_LOCATION:
-      if ((location + 1) > machine_.CurrentStrKBank().size())
-        machine_.CurrentStrKBank().resize(location + 1);
-      return machine_.CurrentStrKBank()[location];
+    case libreallive::STRK_LOCATION: {
+      // Unwritten entries read as empty; don't grow (and unshare) the bank
+      // just to read them.
+      static const std::string empty_string;
+      const StackFrame::StrKBank& strK = machine_.CurrentStrKBank();
+      return static_cast<size_t>(location) < strK.size() ? strK[location] : empty_string;
+    }
     case libreallive::STRM_LOCATION:
       return global_->strM[location];
     case libreallive::STRS_LOCATION:
@@ -144,11 +221,13 @@ void Memory::SetStringValue(int type, int number, const std::string& value) {
         "Invalid range access in RLMachine::set_string_value");
 
   switch (type) {
-    case libreallive::STRK_LOCATION:
-      if ((number + 1) > machine_.CurrentStrKBank().size())
-        machine_.CurrentStrKBank().resize(number + 1);
-      machine_.CurrentStrKBank()[number] = value;
+    case libreallive::STRK_LOCATION: {
+      StackFrame::StrKBank& strK = machine_.MutableCurrentStrKBank();
+      if ((number + 1) > strK.size())
+        strK.resize(number + 1);
+      strK[number] = value;
       break;
+    }
     case libreallive::STRM_LOCATION:
       global_->strM[number] = value;
       break;
@@ -197,6 +276,10 @@ const std::string& Memory::GetLocalName(int index) const {
 }
 
 bool Memory::HasBeenRead(int scenario, int kidoku) const {
+  const KidokuTable& table = global_->kidoku_table;
+  if (table.Contains(scenario, kidoku))
+    return table.Test(scenario, kidoku);
+
   std::map<int, boost::dynamic_bitset<>>::const_iterator it =
       global_->kidoku_data.find(scenario);
 
@@ -208,6 +291,12 @@ bool Memory::HasBeenRead(int scenario, int kidoku) const {
 }
 
 void Memory::RecordKidoku(int scenario, int kidoku) {
+  KidokuTable& table = global_->kidoku_table;
+  if (table.Contains(scenario, kidoku)) {
+    table.Set(scenario, kidoku);
+    return;
+  }
+
   boost::dynamic_bitset<>& bitset = global_->kidoku_data[scenario];
   if (bitset.size() <= static_cast<size_t>(kidoku))
     bitset.resize(kidoku + 1, false);
@@ -215,6 +304,172 @@ void Memory::RecordKidoku(int scenario, int kidoku) {
   bitset[kidoku] = true;
 }
 
+void Memory::FillIntRange(const libreallive::IntMemRef& first,
+                          int count,
+                          int step,
+                          int value) {
+  if (count <= 0)
+    return;
+
+  IntRange range =
+      ResolveIntRange(first, count, step, true, "Memory::FillIntRange()");
+  int location = first.location();
+  if (range.bits == 32) {
+    if (step == 1) {
+      std::fill_n(range.mutable_bank + location, count, value);
+    } else {
+      for (int i = 0; i < count; ++i, location += step)
+        range.mutable_bank[location] = value;
+    }
+    return;
+  }
+
+  if (step != 1) {
+    for (int i = 0; i < count; ++i, location += step)
+      SetPacked(range.mutable_bank, range.bits, location, value);
+    return;
+  }
+
+  // Contiguous bit packed fill: do the partial words at either end one
+  // location at a time and the whole words in between with a pattern.
+  int per_word = 32 / range.bits;
+  int end = location + count;
+  for (; location < end && location % per_word; ++location)
+    SetPacked(range.mutable_bank, range.bits, location, value);
+  int whole_words = (end - location) / per_word;
+  std::fill_n(range.mutable_bank + location / per_word, whole_words,
+              static_cast<int>(ReplicatePacked(range.bits, value)));
+  location += whole_words * per_word;
+  for (; location < end; ++location)
+    SetPacked(range.mutable_bank, range.bits, location, value);
+}
+
+void Memory::SetIntRange(const libreallive::IntMemRef& first,
+                         int step,
+                         const int* values,
+                         int count) {
+  if (count <= 0)
+    return;
+
+  IntRange range =
+      ResolveIntRange(first, count, step, true, "Memory::SetIntRange()");
+  int location = first.location();
+  if (range.bits == 32 && step == 1) {
+    std::copy(values, values + count, range.mutable_bank + location);
+  } else if (range.bits == 32) {
+    for (int i = 0; i < count; ++i, location += step)
+      range.mutable_bank[location] = values[i];
+  } else {
+    for (int i = 0; i < count; ++i, location += step)
+      SetPacked(range.mutable_bank, range.bits, location, values[i]);
+  }
+}
+
+void Memory::GetIntRange(const libreallive::IntMemRef& first,
+                         int count,
+                         int* out) {
+  if (count <= 0)
+    return;
+
+  IntRange range =
+      ResolveIntRange(first, count, 1, false, "Memory::GetIntRange()");
+  if (range.bits == 32) {
+    std::copy(range.bank + range.low, range.bank + range.high + 1, out);
+  } else {
+    for (int location = range.low; location <= range.high; ++location)
+      *out++ = GetPacked(range.bank, range.bits, location);
+  }
+}
+
+int Memory::SumIntRange(const libreallive::IntMemRef& first, int count) {
+  if (count <= 0)
+    return 0;
+
+  IntRange range =
+      ResolveIntRange(first, count, 1, false, "Memory::SumIntRange()");
+  // Sum unsigned so that overflow wraps the same way the old int loop did in
+  // practice, without being undefined.
+  uint32_t total = 0;
+  if (range.bits == 32) {
+    total = std::accumulate(range.bank + range.low,
+                            range.bank + range.high + 1, uint32_t(0));
+    return static_cast<int>(total);
+  }
+
+  int per_word = 32 / range.bits;
+  int location = range.low;
+  int end = range.high + 1;
+  for (; location < end && location % per_word; ++location)
+    total += GetPacked(range.bank, range.bits, location);
+  for (; location + per_word <= end; location += per_word)
+    total += SumPackedWord(range.bits, range.bank[location / per_word]);
+  for (; location < end; ++location)
+    total += GetPacked(range.bank, range.bits, location);
+  return static_cast<int>(total);
+}
+
+void Memory::CopyIntRange(const libreallive::IntMemRef& source,
+                          const libreallive::IntMemRef& dest,
+                          int count) {
+  if (count <= 0)
+    return;
+
+  std::vector<int> buffer(count);
+  GetIntRange(source, count, buffer.data());
+  SetIntRange(dest, 1, buffer.data(), count);
+}
+
+Memory::IntRange Memory::ResolveIntRange(const libreallive::IntMemRef& first,
+                                         int count,
+                                         int step,
+                                         bool for_write,
+                                         const char* function) {
+  IntRange range;
+  int index = first.bank();
+  int words = SIZE_OF_MEM_BANK;
+  range.mutable_bank = NULL;
+  if (index == libreallive::INTL_LOCATION) {
+    if (for_write) {
+      range.mutable_bank = machine_.MutableCurrentIntLBank();
+      range.bank = range.mutable_bank;
+    } else {
+      range.bank = machine_.CurrentIntLBank();
+    }
+    range.original = NULL;
+    words = SIZE_OF_INT_PASSING_MEM;
+  } else if (index >= 0 && index < NUMBER_OF_INT_LOCATIONS) {
+    range.bank = int_var[index];
+    if (for_write)
+      range.mutable_bank = int_var[index];
+    range.original = original_int_var[index];
+  } else {
+    range.bank = NULL;
+  }
+
+  range.bits = first.type() == 0 ? 32 : 1 << (first.type() - 1);
+  int64_t last = first.location() + int64_t(count - 1) * step;
+  int64_t low = std::min<int64_t>(first.location(), last);
+  int64_t high = std::max<int64_t>(first.location(), last);
+  int64_t limit = int64_t(words) * 32 / range.bits;
+  if (!range.bank || range.bits > 32 || low < 0 || high >= limit) {
+    std::ostringstream ss;
+    ss << "Invalid memory access " << first << " (" << count
+       << " locations) in " << function;
+    throw rlvm::Exception(ss.str());
+  }
+  range.low = static_cast<int>(low);
+  range.high = static_cast<int>(high);
+
+  if (for_write) {
+    int per_word = 32 / range.bits;
+    int word_step = (range.bits == 32 && step != 0) ? std::abs(step) : 1;
+    RecordOriginalWords(range.bank, range.original, range.low / per_word,
+                        range.high / per_word, word_step);
+  }
+
+  return range;
+}
+
 void Memory::TakeSavepointSnapshot() {
   local_.original_intA.clear();
   local_.original_intB.clear();
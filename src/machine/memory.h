@@ -40,6 +40,7 @@
 #include <vector>
 
 #include "libreallive/intmemref.h"
+#include "machine/kidoku_table.h"
 
 const int NUMBER_OF_INT_LOCATIONS = 8;
 const int SIZE_OF_MEM_BANK = 2000;
@@ -66,8 +67,13 @@ struct GlobalMemory {
 
   std::string global_names[SIZE_OF_NAME_BANK];
 
+  // Which kidoku markers in the current archive have been read. Kept in its
+  // own file rather than serialized with the rest of global memory.
+  KidokuTable kidoku_table;
+
   // A mapping from a scenario number to a dynamic bitset, where each bit
-  // represents a specific kidoku bit.
+  // represents a specific kidoku bit. Only holds markers that don't fit in
+  // |kidoku_table| (and, right after loading an old save, everything).
   std::map<int, boost::dynamic_bitset<>> kidoku_data;
 
   // boost::serialization
@@ -218,6 +224,29 @@ class Memory {
   // Sets the string value of one of the string banks
   void SetStringValue(int type, int number, const std::string& value);
 
+  // Range operations on integer memory, used by the Mem module. Each touches
+  // |count| locations starting at |first| and going forward |step| locations
+  // at a time. Unlike looping over Get/SetIntValue(), the whole range is
+  // bounds checked once, plain and bit packed banks each get their own
+  // kernel, and the savepoint log is updated in one pass. Nothing is written
+  // if any location is out of bounds.
+  void FillIntRange(const libreallive::IntMemRef& first,
+                    int count,
+                    int step,
+                    int value);
+  void SetIntRange(const libreallive::IntMemRef& first,
+                   int step,
+                   const int* values,
+                   int count);
+  void GetIntRange(const libreallive::IntMemRef& first, int count, int* out);
+  int SumIntRange(const libreallive::IntMemRef& first, int count);
+
+  // Copies |count| values from |source| to |dest|. Overlapping ranges copy as
+  // if through a temporary buffer.
+  void CopyIntRange(const libreallive::IntMemRef& source,
+                    const libreallive::IntMemRef& dest,
+                    int count);
+
   // Name table functions:
 
   // Sets the local name slot index to name.
@@ -254,6 +283,35 @@ class Memory {
   static int ConvertLetterIndexToInt(const std::string& value);
 
  private:
+  // A bounds checked run of integer memory, as handed out by
+  // ResolveIntRange().
+  struct IntRange {
+    const int* bank;
+
+    // The same bank, if the range was resolved for writing; otherwise NULL,
+    // so that reads don't unshare a copy on write intL bank.
+    int* mutable_bank;
+
+    // Where to log original values; NULL for banks that aren't saved.
+    std::map<int, int>* original;
+
+    // Bits per location: 32 for plain access, or 1, 2, 4 or 8 for the bit
+    // packed views of a bank.
+    int bits;
+
+    // The lowest and highest locations touched.
+    int low;
+    int high;
+  };
+
+  // Validates every location in a range and logs the original values of the
+  // words it covers for the next savepoint, if |for_write|.
+  IntRange ResolveIntRange(const libreallive::IntMemRef& first,
+                           int count,
+                           int step,
+                           bool for_write,
+                           const char* function);
+
   // Connects the memory banks in local_ and in global_ into int_var.
   void ConnectIntVarPointers();
 
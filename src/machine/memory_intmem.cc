@@ -78,7 +78,7 @@ int Memory::GetIntValue(const IntMemRef& ref) {
   int index = ref.bank();
   int location = ref.location();
 
-  int* bank = NULL;
+  const int* bank = NULL;
   if (index == 8) {
     bank = machine_.CurrentIntLBank();
   } else if (index < 0 || index > NUMBER_OF_INT_LOCATIONS) {
@@ -113,7 +113,7 @@ void Memory::SetIntValue(const IntMemRef& ref, int value) {
   int* bank = NULL;
   std::map<int, int>* original_bank = NULL;
   if (index == 8) {
-    bank = machine_.CurrentIntLBank();
+    bank = machine_.MutableCurrentIntLBank();
   } else if (index < 0 || index > NUMBER_OF_INT_LOCATIONS) {
     throwIllegalIndex(ref, "RLMachine::SetIntValue()");
   } else {
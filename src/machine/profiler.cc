@@ -0,0 +1,244 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#include "machine/profiler.h"
+
+#include <boost/core/demangle.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#include "machine/long_operation.h"
+
+namespace {
+
+const std::string kSubsystemNames[] = {"Event", "Text", "Sound", "Graphics"};
+
+void WriteJSONString(std::ostream& os, const std::string& str) {
+  os << '"';
+  for (char c : str) {
+    unsigned char uc = static_cast<unsigned char>(c);
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (uc < 0x20 || uc >= 0x80) {
+      // Names may contain raw cp932 bytes; keep the output valid JSON.
+      os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+         << static_cast<int>(uc) << std::dec << std::setfill(' ');
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+void WriteCounterHeader(std::ostream& os, const std::string& title,
+                        int name_width) {
+  os << std::endl << title << std::endl;
+  os << std::setw(name_width) << std::left << "Name" << std::right
+     << std::setw(12) << "Count" << std::setw(14) << "Total (ms)"
+     << std::setw(12) << "Avg (us)" << std::setw(12) << "Max (us)"
+     << std::endl;
+  os << std::string(name_width + 50, '-') << std::endl;
+}
+
+void WriteCounterRow(std::ostream& os, const std::string& name,
+                     const Profiler::Counter& counter, int name_width) {
+  os << std::setw(name_width) << std::left << name << std::right
+     << std::setw(12) << counter.count << std::setw(14) << std::fixed
+     << std::setprecision(3) << counter.total_us / 1000.0 << std::setw(12)
+     << std::setprecision(1)
+     << (counter.count ? double(counter.total_us) / counter.count : 0.0)
+     << std::setw(12) << counter.max_us << std::endl;
+}
+
+// Prints the |top_n| most expensive entries of |rows|.
+void WriteCounterTable(
+    std::ostream& os, const std::string& title,
+    std::vector<std::pair<std::string, Profiler::Counter>> rows,
+    size_t top_n) {
+  std::sort(rows.begin(), rows.end(),
+            [](const std::pair<std::string, Profiler::Counter>& lhs,
+               const std::pair<std::string, Profiler::Counter>& rhs) {
+              return lhs.second.total_us > rhs.second.total_us;
+            });
+  if (rows.size() > top_n)
+    rows.resize(top_n);
+
+  int name_width = 4;
+  for (auto const& row : rows)
+    name_width = std::max(name_width, static_cast<int>(row.first.size()));
+  name_width += 2;
+
+  WriteCounterHeader(os, title, name_width);
+  for (auto const& row : rows)
+    WriteCounterRow(os, row.first, row.second, name_width);
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+// Profiler::Counter
+// -----------------------------------------------------------------------
+void Profiler::Counter::Add(int64_t duration_us) {
+  count++;
+  total_us += duration_us;
+  max_us = std::max(max_us, duration_us);
+}
+
+// -----------------------------------------------------------------------
+// Profiler
+// -----------------------------------------------------------------------
+Profiler::Profiler() : start_us_(NowMicros()), trace_truncated_(false) {}
+
+Profiler::~Profiler() {}
+
+// static
+bool Profiler::IsCompiledIn() {
+#if defined(RLVM_ENABLE_PROFILER)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// static
+int64_t Profiler::NowMicros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Profiler::RecordOpcode(uint64_t packed_opcode,
+                            const std::string& module_name,
+                            const std::string& opcode_name,
+                            int64_t start_us,
+                            int64_t duration_us) {
+  OpcodeEntry& entry = opcodes_[packed_opcode];
+  if (entry.name.empty())
+    entry.name = module_name + "::" + opcode_name;
+  entry.counter.Add(duration_us);
+  AddTraceEvent(&entry.name, "opcode", start_us, duration_us);
+}
+
+void Profiler::RecordLine(int scene, int line, int64_t duration_us) {
+  lines_[std::make_pair(scene, line)].Add(duration_us);
+}
+
+void Profiler::LongOperationStarted(const LongOperation* op) {
+  live_long_operations_[op] = NowMicros();
+}
+
+void Profiler::LongOperationFinished(const LongOperation* op) {
+  auto it = live_long_operations_.find(op);
+  if (it == live_long_operations_.end())
+    return;
+
+  int64_t now = NowMicros();
+  auto entry = long_operations_.emplace(
+      boost::core::demangle(typeid(*op).name()), Counter()).first;
+  entry->second.Add(now - it->second);
+  AddTraceEvent(&entry->first, "long_operation", it->second, now - it->second);
+  live_long_operations_.erase(it);
+}
+
+void Profiler::RecordSubsystem(Subsystem subsystem,
+                               int64_t start_us,
+                               int64_t duration_us) {
+  subsystems_[subsystem].Add(duration_us);
+  AddTraceEvent(&kSubsystemNames[subsystem], "subsystem", start_us,
+                duration_us);
+}
+
+void Profiler::AddTraceEvent(const std::string* name,
+                             const char* category,
+                             int64_t start_us,
+                             int64_t duration_us) {
+  if (trace_events_.size() >= kMaxTraceEvents) {
+    trace_truncated_ = true;
+    return;
+  }
+
+  trace_events_.push_back(
+      TraceEvent{name, category, start_us - start_us_, duration_us});
+}
+
+void Profiler::WriteChromeTrace(std::ostream& os) const {
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  bool first = true;
+  for (auto const& event : trace_events_) {
+    if (!first)
+      os << ",";
+    first = false;
+
+    // Long operations overlap the opcodes and subsystems that run them, so
+    // put them on their own track.
+    int tid = std::string(event.category) == "long_operation" ? 2 : 1;
+    os << "\n{\"name\":";
+    WriteJSONString(os, *event.name);
+    os << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\",\"ts\":"
+       << event.start_us << ",\"dur\":" << event.duration_us
+       << ",\"pid\":1,\"tid\":" << tid << "}";
+  }
+  os << "\n]}" << std::endl;
+}
+
+void Profiler::WriteSummary(std::ostream& os, size_t top_n) const {
+  os << "Profile over " << std::fixed << std::setprecision(3)
+     << (NowMicros() - start_us_) / 1000000.0 << " seconds";
+  if (trace_truncated_)
+    os << " (trace truncated at " << kMaxTraceEvents << " events)";
+  os << std::endl;
+
+  std::vector<std::pair<std::string, Counter>> rows;
+  for (auto const& entry : opcodes_)
+    rows.emplace_back(entry.second.name, entry.second.counter);
+  WriteCounterTable(os, "Opcodes", rows, top_n);
+
+  rows.clear();
+  for (auto const& entry : lines_) {
+    std::ostringstream oss;
+    oss << "SEEN" << std::setw(4) << std::setfill('0') << entry.first.first
+        << "(" << entry.first.second << ")";
+    rows.emplace_back(oss.str(), entry.second);
+  }
+  WriteCounterTable(os, "Hot lines", rows, top_n);
+
+  rows.clear();
+  for (auto const& entry : long_operations_)
+    rows.emplace_back(entry.first, entry.second);
+  WriteCounterTable(os, "Long operations", rows, top_n);
+
+  rows.clear();
+  for (int i = 0; i < SUBSYSTEM_COUNT; ++i)
+    rows.emplace_back(kSubsystemNames[i], subsystems_[i]);
+  WriteCounterTable(os, "Subsystems (per frame)", rows, top_n);
+}
@@ -0,0 +1,172 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#ifndef SRC_MACHINE_PROFILER_H_
+#define SRC_MACHINE_PROFILER_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class LongOperation;
+
+// An optional component to an RLMachine which records where wall time goes:
+// per opcode call counts and cumulative time, per SEEN/line hot spots,
+// LongOperation lifetimes and per subsystem frame times. The results can be
+// written out as a summary table or as a Chrome trace event file (loadable in
+// chrome://tracing or Perfetto).
+//
+// The hooks that feed the profiler only exist when rlvm is built with
+// RLVM_ENABLE_PROFILER (scons --profiler); otherwise they compile to
+// nothing. When compiled in, the profiler is still off until
+// RLMachine::StartProfiling() is called.
+class Profiler {
+ public:
+  enum Subsystem {
+    SUBSYSTEM_EVENT = 0,
+    SUBSYSTEM_TEXT,
+    SUBSYSTEM_SOUND,
+    SUBSYSTEM_GRAPHICS,
+    SUBSYSTEM_COUNT
+  };
+
+  // Aggregated counts for one kind of thing being measured.
+  struct Counter {
+    int64_t count = 0;
+    int64_t total_us = 0;
+    int64_t max_us = 0;
+
+    void Add(int64_t duration_us);
+  };
+
+  Profiler();
+  ~Profiler();
+
+  // Whether this binary was built with the profiler hooks in place.
+  static bool IsCompiledIn();
+
+  // Monotonic timestamp in microseconds.
+  static int64_t NowMicros();
+
+  // Records one call to an opcode. |packed_opcode| uniquely identifies the
+  // (module type, module, opcode, overload) tuple; the names are only used
+  // the first time we see it.
+  void RecordOpcode(uint64_t packed_opcode,
+                    const std::string& module_name,
+                    const std::string& opcode_name,
+                    int64_t start_us,
+                    int64_t duration_us);
+
+  // Records time spent executing the instruction at |scene|:|line|.
+  void RecordLine(int scene, int line, int64_t duration_us);
+
+  // Brackets the lifetime of a LongOperation on the call stack.
+  void LongOperationStarted(const LongOperation* op);
+  void LongOperationFinished(const LongOperation* op);
+
+  // Records one pass through a subsystem in the game loop.
+  void RecordSubsystem(Subsystem subsystem,
+                       int64_t start_us,
+                       int64_t duration_us);
+
+  // Writes all recorded trace events as Chrome trace event JSON.
+  void WriteChromeTrace(std::ostream& os) const;
+
+  // Pretty prints the aggregated numbers, limited to the |top_n| most
+  // expensive entries per table.
+  void WriteSummary(std::ostream& os, size_t top_n = 25) const;
+
+ private:
+  // |name| points into one of the (node stable) maps below.
+  struct TraceEvent {
+    const std::string* name;
+    const char* category;
+    int64_t start_us;
+    int64_t duration_us;
+  };
+
+  void AddTraceEvent(const std::string* name,
+                     const char* category,
+                     int64_t start_us,
+                     int64_t duration_us);
+
+  // Stop collecting individual trace events after this many; the aggregate
+  // counters keep working.
+  static const size_t kMaxTraceEvents = 1000000;
+
+  int64_t start_us_;
+
+  struct OpcodeEntry {
+    std::string name;
+    Counter counter;
+  };
+  std::unordered_map<uint64_t, OpcodeEntry> opcodes_;
+
+  std::map<std::pair<int, int>, Counter> lines_;
+
+  std::map<std::string, Counter> long_operations_;
+  std::unordered_map<const LongOperation*, int64_t> live_long_operations_;
+
+  Counter subsystems_[SUBSYSTEM_COUNT];
+
+  std::vector<TraceEvent> trace_events_;
+  bool trace_truncated_;
+};
+
+// Times the enclosing scope as one pass through |subsystem|.
+class ScopedSubsystemProfile {
+ public:
+  ScopedSubsystemProfile(Profiler* profiler, Profiler::Subsystem subsystem)
+      : profiler_(profiler),
+        subsystem_(subsystem),
+        start_us_(profiler ? Profiler::NowMicros() : 0) {}
+  ~ScopedSubsystemProfile() {
+    if (profiler_) {
+      profiler_->RecordSubsystem(subsystem_, start_us_,
+                                 Profiler::NowMicros() - start_us_);
+    }
+  }
+
+ private:
+  Profiler* profiler_;
+  Profiler::Subsystem subsystem_;
+  int64_t start_us_;
+};
+
+#if defined(RLVM_ENABLE_PROFILER)
+#define PROFILE_SUBSYSTEM(machine, subsystem)             \
+  ScopedSubsystemProfile profile_subsystem_##subsystem( \
+      (machine).profiler(), Profiler::subsystem)
+#else
+#define PROFILE_SUBSYSTEM(machine, subsystem)
+#endif
+
+#endif  // SRC_MACHINE_PROFILER_H_
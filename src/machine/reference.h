@@ -109,6 +109,10 @@ class MemoryReferenceIterator {
   int type() const { return type_; }
   int location() const { return location_; }
 
+  // The Memory this iterator points into, or NULL if it points at the store
+  // register.
+  Memory* memory() const { return memory_; }
+
   // -------------------------------------------------------- Iterated Interface
   ACCESS operator*() { return ACCESS(this); }
 
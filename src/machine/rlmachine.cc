@@ -53,6 +53,7 @@
 #include "machine/long_operation.h"
 #include "machine/memory.h"
 #include "machine/opcode_log.h"
+#include "machine/profiler.h"
 #include "machine/reallive_dll.h"
 #include "machine/rlmodule.h"
 #include "machine/rloperation.h"
@@ -90,10 +91,6 @@ const char seen_end[] = {130, 114,  // S
 
 const std::string SeenEnd(seen_end, 14);
 
-bool IsNotLongOp(StackFrame& frame) {
-  return frame.frame_type != StackFrame::TYPE_LONGOP;
-}
-
 }  // namespace
 
 // -----------------------------------------------------------------------
@@ -104,6 +101,13 @@ RLMachine::RLMachine(System& in_system, libreallive::Archive& in_archive)
     : memory_(new Memory(*this, in_system.gameexe())),
       archive_(in_archive),
       system_(in_system) {
+  // LongOperations come and go for every textout, pause and effect; keep
+  // enough room that pushing them never reallocates the stack.
+  call_stack_.reserve(kInitialStackCapacity);
+  script_frames_.reserve(kInitialStackCapacity);
+
+  memory_->global().kidoku_table.SetLayout(archive_.GetKidokuTableSizes());
+
   // Search in the Gameexe for #SEEN_START and place us there
   Gameexe& gameexe = in_system.gameexe();
   libreallive::Scenario* scenario = NULL;
@@ -188,10 +192,27 @@ void RLMachine::SetStringValue(int type, int number, const std::string& value) {
 }
 
 void RLMachine::HardResetMemory() {
+  std::string kidoku_path = memory_->global().kidoku_table.path();
   memory_.reset(new Memory(*this, system().gameexe()));
+  KidokuTable& kidoku_table = memory_->global().kidoku_table;
+  kidoku_table.SetLayout(archive_.GetKidokuTableSizes());
+
+  // Take over the old table's file, throwing away its contents; otherwise the
+  // next save would merge the read state we just reset back in.
+  if (!kidoku_path.empty()) {
+    try {
+      kidoku_table.AttachFile(kidoku_path, false);
+    }
+    catch (std::exception& e) {
+      cerr << "WARNING: Unable to reset read text in " << kidoku_path << ": "
+           << e.what() << endl;
+    }
+  }
 }
 
 void RLMachine::MarkSavepoint() {
+  // StackFrames share their parameter banks, so this only copies a handful of
+  // pointers per frame into storage we've already allocated.
   savepoint_call_stack_ = call_stack_;
   memory_->TakeSavepointSnapshot();
   system().graphics().TakeSavepointSnapshot();
@@ -261,7 +282,19 @@ void RLMachine::ExecuteNextInstruction() {
         }
         delayed_modifications_.clear();
       } else {
+#if defined(RLVM_ENABLE_PROFILER)
+        if (profiler_) {
+          int scene = SceneNumber();
+          int line = line_;
+          int64_t start = Profiler::NowMicros();
+          (*(call_stack_.back().ip))->RunOnMachine(*this);
+          profiler_->RecordLine(scene, line, Profiler::NowMicros() - start);
+        } else {
+          (*(call_stack_.back().ip))->RunOnMachine(*this);
+        }
+#else
         (*(call_stack_.back().ip))->RunOnMachine(*this);
+#endif
       }
     }
     catch (rlvm::UnimplementedOpcode& e) {
@@ -318,12 +351,10 @@ void RLMachine::ExecuteUntilHalted() {
 
 void RLMachine::AdvanceInstructionPointer() {
   if (!replaying_graphics_stack()) {
-    std::vector<StackFrame>::reverse_iterator it =
-        find_if(call_stack_.rbegin(), call_stack_.rend(), IsNotLongOp);
-
-    if (it != call_stack_.rend()) {
-      it->ip++;
-      if (it->ip == it->scenario->end())
+    StackFrame* frame = CurrentScriptFrame();
+    if (frame) {
+      frame->ip++;
+      if (frame->ip == frame->scenario->end())
         halted_ = true;
     }
   }
@@ -358,22 +389,10 @@ void RLMachine::Jump(int scenario_num, int entrypoint) {
     throw rlvm::Exception(oss.str());
   }
 
-  if (call_stack_.back().frame_type == StackFrame::TYPE_LONGOP) {
-    // For some reason this is slow; REALLY slow, so for now I'm trying to
-    // optimize the common case (no long operations on the back of the stack. I
-    // assume there's some weird speed issue with reverse_iterator?
-    //
-    // The lag is noticeable on the CLANNAD menu, without profiling tools.
-    std::vector<StackFrame>::reverse_iterator it =
-        find_if(call_stack_.rbegin(), call_stack_.rend(), IsNotLongOp);
-
-    if (it != call_stack_.rend()) {
-      it->scenario = scenario;
-      it->ip = scenario->FindEntrypoint(entrypoint);
-    }
-  } else {
-    call_stack_.back().scenario = scenario;
-    call_stack_.back().ip = scenario->FindEntrypoint(entrypoint);
+  StackFrame* frame = CurrentScriptFrame();
+  if (frame) {
+    frame->scenario = scenario;
+    frame->ip = scenario->FindEntrypoint(entrypoint);
   }
 }
 
@@ -428,19 +447,13 @@ void RLMachine::PushStringValueUp(int index, const std::string& val) {
     throw rlvm::Exception("Invalid index in pushStringValue");
   }
 
-  // Find the first real stack frame.
-  std::vector<StackFrame>::reverse_iterator it =
-      find_if(call_stack_.rbegin(), call_stack_.rend(), IsNotLongOp);
-  if (it != call_stack_.rend()) {
-    // Now try to move one stack frame up.
-    it++;
-    it = find_if(it, call_stack_.rend(), IsNotLongOp);
-
-    if (it != call_stack_.rend()) {
-      if ((index + 1) > it->strK.size())
-        it->strK.resize(index + 1);
-      it->strK[index] = val;
-    }
+  // The caller's frame is the real stack frame below the current one.
+  if (script_frames_.size() >= 2) {
+    StackFrame& frame = call_stack_[script_frames_[script_frames_.size() - 2]];
+    StackFrame::StrKBank& strK = frame.mutable_strK();
+    if ((index + 1) > strK.size())
+      strK.resize(index + 1);
+    strK[index] = val;
   }
 }
 
@@ -456,8 +469,15 @@ void RLMachine::PushStackFrame(const StackFrame& frame) {
     return;
   }
 
+  if (frame.frame_type != StackFrame::TYPE_LONGOP)
+    script_frames_.push_back(call_stack_.size());
   call_stack_.push_back(frame);
 
+#if defined(RLVM_ENABLE_PROFILER)
+  if (profiler_ && frame.frame_type == StackFrame::TYPE_LONGOP)
+    profiler_->LongOperationStarted(frame.long_op.get());
+#endif
+
   // Font hack. Try using a western font if we haven't already loaded a font.
   if (GetTextEncoding() == 2)
     system().set_use_western_font();
@@ -470,6 +490,13 @@ void RLMachine::PopStackFrame() {
     return;
   }
 
+#if defined(RLVM_ENABLE_PROFILER)
+  if (profiler_ && call_stack_.back().frame_type == StackFrame::TYPE_LONGOP)
+    profiler_->LongOperationFinished(call_stack_.back().long_op.get());
+#endif
+
+  if (call_stack_.back().frame_type != StackFrame::TYPE_LONGOP)
+    script_frames_.pop_back();
   call_stack_.pop_back();
 }
 
@@ -477,26 +504,46 @@ int RLMachine::GetStackSize() {
   return call_stack_.size();
 }
 
-int* RLMachine::CurrentIntLBank() {
-  std::vector<StackFrame>::reverse_iterator it =
-      find_if(call_stack_.rbegin(), call_stack_.rend(), IsNotLongOp);
-  if (it != call_stack_.rend()) {
-    return it->intL;
-  }
+const int* RLMachine::CurrentIntLBank() const {
+  const StackFrame* frame = CurrentScriptFrame();
+  if (frame)
+    return frame->intL();
 
   throw rlvm::Exception("No valid intL bank");
 }
 
-std::vector<std::string>& RLMachine::CurrentStrKBank() {
-  std::vector<StackFrame>::reverse_iterator it =
-      find_if(call_stack_.rbegin(), call_stack_.rend(), IsNotLongOp);
-  if (it != call_stack_.rend()) {
-    return it->strK;
-  }
+int* RLMachine::MutableCurrentIntLBank() {
+  StackFrame* frame = CurrentScriptFrame();
+  if (frame)
+    return frame->mutable_intL();
+
+  throw rlvm::Exception("No valid intL bank");
+}
+
+const StackFrame::StrKBank& RLMachine::CurrentStrKBank() const {
+  const StackFrame* frame = CurrentScriptFrame();
+  if (frame)
+    return frame->strK();
 
   throw rlvm::Exception("No valid strK bank");
 }
 
+StackFrame::StrKBank& RLMachine::MutableCurrentStrKBank() {
+  StackFrame* frame = CurrentScriptFrame();
+  if (frame)
+    return frame->mutable_strK();
+
+  throw rlvm::Exception("No valid strK bank");
+}
+
+StackFrame* RLMachine::CurrentScriptFrame() {
+  return script_frames_.empty() ? NULL : &call_stack_[script_frames_.back()];
+}
+
+const StackFrame* RLMachine::CurrentScriptFrame() const {
+  return script_frames_.empty() ? NULL : &call_stack_[script_frames_.back()];
+}
+
 void RLMachine::ClearLongOperationsOffBackOfStack() {
   if (delay_stack_modifications_) {
     delayed_modifications_.push_back(
@@ -507,12 +554,18 @@ void RLMachine::ClearLongOperationsOffBackOfStack() {
   // Need to do stuff here...
   while (call_stack_.size() &&
          call_stack_.back().frame_type == StackFrame::TYPE_LONGOP) {
+#if defined(RLVM_ENABLE_PROFILER)
+    if (profiler_)
+      profiler_->LongOperationFinished(call_stack_.back().long_op.get());
+#endif
     call_stack_.pop_back();
   }
 }
 
 void RLMachine::Reset() {
+  FinishProfiledLongOperations();
   call_stack_.clear();
+  script_frames_.clear();
   savepoint_call_stack_.clear();
   system().Reset();
 }
@@ -523,6 +576,18 @@ void RLMachine::LocalReset() {
   system().Reset();
 }
 
+void RLMachine::FinishProfiledLongOperations() {
+#if defined(RLVM_ENABLE_PROFILER)
+  if (!profiler_)
+    return;
+
+  for (auto it = call_stack_.rbegin(); it != call_stack_.rend(); ++it) {
+    if (it->frame_type == StackFrame::TYPE_LONGOP)
+      profiler_->LongOperationFinished(it->long_op.get());
+  }
+#endif
+}
+
 std::shared_ptr<LongOperation> RLMachine::CurrentLongOperation() const {
   if (call_stack_.size() &&
       call_stack_.back().frame_type == StackFrame::TYPE_LONGOP) {
@@ -559,13 +624,34 @@ int RLMachine::GetProbableEncodingType() const {
 }
 
 void RLMachine::PerformTextout(const libreallive::TextoutElement& e) {
+  int encoding = GetTextEncoding();
+  const std::string* cached = e.GetCachedUTF8Text(encoding);
+  if (cached) {
+    PerformUTF8Textout(*cached);
+    return;
+  }
+
   std::string unparsed_text = e.GetText();
   if (boost::starts_with(unparsed_text, SeenEnd)) {
     unparsed_text = SeenEnd;
     Halt();
+    PerformTextout(unparsed_text);
+    return;
   }
 
-  PerformTextout(unparsed_text);
+  std::string name_parsed_text;
+  bool has_names = true;
+  try {
+    has_names = parseNames(*memory_, unparsed_text, name_parsed_text);
+  }
+  catch (rlvm::Exception& e) {
+    name_parsed_text = unparsed_text;
+  }
+
+  std::string utf8str = cp932toUTF8(name_parsed_text, encoding);
+  if (!has_names)
+    e.SetCachedUTF8Text(encoding, utf8str);
+  PerformUTF8Textout(utf8str);
 }
 
 void RLMachine::PerformTextout(const std::string& cp932str) {
@@ -580,7 +666,10 @@ void RLMachine::PerformTextout(const std::string& cp932str) {
     name_parsed_text = cp932str;
   }
 
-  std::string utf8str = cp932toUTF8(name_parsed_text, GetTextEncoding());
+  PerformUTF8Textout(cp932toUTF8(name_parsed_text, GetTextEncoding()));
+}
+
+void RLMachine::PerformUTF8Textout(const std::string& utf8str) {
   TextSystem& ts = system().text();
 
   // Display UTF-8 characters
@@ -666,6 +755,20 @@ void RLMachine::RecordUndefinedOpcodeCounts() {
   undefined_log_.reset(new OpcodeLog);
 }
 
+void RLMachine::StartProfiling() {
+  if (!Profiler::IsCompiledIn()) {
+    cerr << "WARNING: Profiling requested, but rlvm was built without the "
+         << "profiler. (Rebuild with scons --profiler.)" << endl;
+    return;
+  }
+
+  profiler_.reset(new Profiler);
+}
+
+std::unique_ptr<Profiler> RLMachine::StopProfiling() {
+  return std::move(profiler_);
+}
+
 void RLMachine::Halt() { halted_ = true; }
 
 void RLMachine::SetHaltOnException(bool halt_on_exception) {
@@ -709,7 +812,14 @@ void RLMachine::load(Archive& ar, unsigned int version) {
   // Just thaw the call_stack_; all preprocessing was done at freeze
   // time.
   // assert(call_stack_.size() == 0);
+  FinishProfiledLongOperations();
   ar& call_stack_;
+
+  script_frames_.clear();
+  for (size_t i = 0; i < call_stack_.size(); ++i) {
+    if (call_stack_[i].frame_type != StackFrame::TYPE_LONGOP)
+      script_frames_.push_back(i);
+  }
 }
 
 // -----------------------------------------------------------------------
@@ -40,6 +40,7 @@
 
 #include "libreallive/bytecode_fwd.h"
 #include "libreallive/scenario.h"
+#include "machine/stack_frame.h"
 
 namespace libreallive {
 class Archive;
@@ -49,10 +50,10 @@ class IntMemRef;
 class LongOperation;
 class Memory;
 class OpcodeLog;
+class Profiler;
 class RLModule;
 class RealLiveDLL;
 class System;
-struct StackFrame;
 
 // The RealLive virtual machine implementation. This class is the main user
 // facing class which contains all state regarding integer/string memory, flow
@@ -239,6 +240,7 @@ class RLMachine {
   void ExecuteExpression(const libreallive::ExpressionElement& e);
   void PerformTextout(const libreallive::TextoutElement& e);
   void PerformTextout(const std::string& cp932str);
+  void PerformUTF8Textout(const std::string& utf8str);
 
   // Marks a kidoku marker as visited.
   void SetKidokuMarker(int kidoku_number);
@@ -303,6 +305,16 @@ class RLMachine {
   // results to stderr on machine destruction.
   void RecordUndefinedOpcodeCounts();
 
+  // Starts and stops recording where time is spent (see
+  // machine/profiler.h). Nothing is recorded unless rlvm was built with the
+  // profiler compiled in. StopProfiling() returns the collected data, or NULL
+  // if we weren't profiling.
+  void StartProfiling();
+  std::unique_ptr<Profiler> StopProfiling();
+
+  // The active profiler, or NULL if we aren't profiling.
+  Profiler* profiler() { return profiler_.get(); }
+
   // ---------------------------------------------------------------------
 
   // Force the machine to halt. This should terminate the execution of
@@ -327,11 +339,14 @@ class RLMachine {
   // Returns the current stack size.
   int GetStackSize();
 
-  // Returns the intL bank of the current stack frame.
-  int* CurrentIntLBank();
+  // Returns the intL bank of the current stack frame. The Mutable version
+  // unshares the bank from the savepoint call stack before returning it.
+  const int* CurrentIntLBank() const;
+  int* MutableCurrentIntLBank();
 
   // Returns the strK bank of the current stack frame.
-  std::vector<std::string>& CurrentStrKBank();
+  const StackFrame::StrKBank& CurrentStrKBank() const;
+  StackFrame::StrKBank& MutableCurrentStrKBank();
 
   // Clears all LongOperations from the back of the stack.
   void ClearLongOperationsOffBackOfStack();
@@ -351,6 +366,18 @@ class RLMachine {
   void AddLineAction(const int seen, const int line, std::function<void(void)>);
 
  private:
+  // Initial capacity of the call stack.
+  static const size_t kInitialStackCapacity = 32;
+
+  // Returns the topmost frame that isn't a LongOperation, or NULL if the
+  // stack is empty.
+  StackFrame* CurrentScriptFrame();
+  const StackFrame* CurrentScriptFrame() const;
+
+  // Tells the profiler that every LongOperation on the call stack is done,
+  // ahead of the whole stack being thrown away or replaced.
+  void FinishProfiledLongOperations();
+
   // The Reallive VM's integer and string memory
   std::unique_ptr<Memory> memory_;
 
@@ -379,6 +406,12 @@ class RLMachine {
   // The actual call stack.
   std::vector<StackFrame> call_stack_;
 
+  // Indexes into |call_stack_| of every frame that isn't a LongOperation,
+  // bottom to top. LongOperations get pushed and popped constantly on top of
+  // the script frame that's executing, so this lets us find that frame
+  // without walking past them.
+  std::vector<size_t> script_frames_;
+
   // The state of the call stack the last time a savepoint was called
   std::vector<StackFrame> savepoint_call_stack_;
 
@@ -393,6 +426,9 @@ class RLMachine {
   // undefined opcodes.
   std::unique_ptr<OpcodeLog> undefined_log_;
 
+  // (Optional) Timing data collected while profiling.
+  std::unique_ptr<Profiler> profiler_;
+
   // Override defaults
   bool mark_savepoints_ = true;
 
@@ -36,6 +36,8 @@
 
 #include "libreallive/bytecode.h"
 #include "machine/general_operations.h"
+#include "machine/profiler.h"
+#include "machine/rlmachine.h"
 #include "machine/rloperation.h"
 #include "utilities/exception.h"
 
@@ -152,7 +154,23 @@ void RLModule::DispatchFunction(RLMachine& machine,
                                           f.GetUnparsedParameters());
         std::cerr << std::endl;
       }
+#if defined(RLVM_ENABLE_PROFILER)
+      if (Profiler* profiler = machine.profiler()) {
+        int64_t start = Profiler::NowMicros();
+        it->second->DispatchFunction(machine, f);
+        profiler->RecordOpcode(
+            (uint64_t(machine.PackModuleNumber(module_type(), module_number()))
+             << 32) | it->first,
+            module_name(),
+            it->second->name(),
+            start,
+            Profiler::NowMicros() - start);
+      } else {
+        it->second->DispatchFunction(machine, f);
+      }
+#else
       it->second->DispatchFunction(machine, f);
+#endif
     }
     catch (rlvm::Exception& e) {
       e.setOperation(it->second.get());
@@ -26,7 +26,11 @@
 
 #include "machine/rlvm_instance.h"
 
+#include <algorithm>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <memory>
 #include <string>
 
 #include "libreallive/gameexe.h"
@@ -34,8 +38,11 @@
 #include "machine/dump_scenario.h"
 #include "machine/game_hacks.h"
 #include "machine/memory.h"
+#include "machine/profiler.h"
 #include "machine/rlmachine.h"
+#include "machine/scenario_cfg.h"
 #include "machine/serialization.h"
+#include "machine/startup_profile.h"
 #include "modules/module_sys_save.h"
 #include "modules/modules.h"
 #include "platforms/gcn/gcn_platform.h"
@@ -60,20 +67,36 @@ const char* siglus_exes[] = {"siglus.exe",       "siglusengine-ch.exe",
                              "siglusengine.exe", "siglusenginechs.exe",
                              NULL};
 
+// The longest we'll idle while a LongOperation waits on input. Bounds the
+// latency of anything that doesn't report through NextWakeupTime(), like the
+// window manager asking us to redraw.
+const unsigned int kMaxIdleSleepMs = 100;
+
 RLVMInstance::RLVMInstance()
     : seen_start_(-1),
       memory_(false),
       undefined_opcodes_(false),
       count_undefined_copcodes_(false),
       tracing_(false),
+      startup_profile_(false),
       load_save_(-1),
-      dump_seen_(-1) {
+      se_bank_size_(-1),
+      image_cache_size_(-1),
+      compress_image_cache_(false),
+      dump_seen_(-1),
+      dump_cfg_(-1) {
   srand(time(NULL));
 }
 
 RLVMInstance::~RLVMInstance() {}
 
 void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
+  std::unique_ptr<StartupProfile> startup_profile;
+  if (startup_profile_) {
+    startup_profile.reset(new StartupProfile);
+    StartupProfile::set_current(startup_profile.get());
+  }
+
   try {
     fs::path gameexePath = FindGameFile(gamerootPath, "Gameexe.ini");
     fs::path seenPath = FindGameFile(gamerootPath, "Seen.txt");
@@ -82,7 +105,12 @@ void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
     CheckBadEngine(gamerootPath, avg32_exes, _("Can't run AVG32 games"));
     CheckBadEngine(gamerootPath, siglus_exes, _("Can't run Siglus games"));
 
-    Gameexe gameexe(gameexePath);
+    std::unique_ptr<Gameexe> gameexe_storage;
+    {
+      ScopedStartupStage stage("Gameexe.ini");
+      gameexe_storage.reset(new Gameexe(gameexePath));
+    }
+    Gameexe& gameexe = *gameexe_storage;
     gameexe("__GAMEPATH") = gamerootPath.string();
 
     // Possibly force starting at a different seen
@@ -103,11 +131,38 @@ void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
       gameexe("__GAMEFONT") = custom_font_;
     }
 
-    libreallive::Archive arc(seenPath.string(), gameexe("REGNAME"));
+    if (se_bank_size_ != -1)
+      gameexe("__SE_BANK_SIZE") = se_bank_size_;
+
+    if (image_cache_size_ != -1)
+      gameexe("__IMAGE_CACHE_SIZE") = image_cache_size_;
+
+    if (compress_image_cache_)
+      gameexe("__IMAGE_CACHE_COMPRESS") = 1;
+
+    // Startup is a small dependency graph: everything needs the Gameexe, but
+    // the SEEN.TXT table of contents only needs the REGNAME, so read it while
+    // SDL comes up. SDLSystem overlaps its own file index and sound effect
+    // decoding the same way.
+    std::string regname = gameexe("REGNAME");
+    std::future<std::unique_ptr<libreallive::Archive>> archive_loader =
+        std::async(std::launch::async, [seenPath, regname]() {
+          ScopedStartupStage stage("Seen.txt");
+          return std::unique_ptr<libreallive::Archive>(
+              new libreallive::Archive(seenPath.string(), regname));
+        });
+
+    std::unique_ptr<libreallive::Archive> archive;
     SDLSystem sdlSystem(gameexe);
+    archive = archive_loader.get();
+    libreallive::Archive& arc = *archive;
+
     RLMachine rlmachine(sdlSystem, arc);
-    AddAllModules(rlmachine);
-    AddGameHacks(rlmachine);
+    {
+      ScopedStartupStage stage("Modules");
+      AddAllModules(rlmachine);
+      AddGameHacks(rlmachine);
+    }
 
     if (dump_seen_ != -1) {
       libreallive::Scenario* scenario = arc.GetScenario(dump_seen_);
@@ -115,9 +170,23 @@ void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
       return;
     }
 
+    if (dump_cfg_ != -1) {
+      ArchiveCFG cfg(arc, sdlSystem.GameSaveDirectory() / "scenario_cfg.cache");
+      const ScenarioCFG* scenario = cfg.GetScenario(dump_cfg_);
+      if (scenario)
+        scenario->Dump(std::cout);
+      else
+        std::cout << "Invalid scenario number." << std::endl;
+      return;
+    }
+
     // Validate our font file
     // TODO(erg): Remove this when we switch to native font selection dialogs.
-    fs::path fontFile = FindFontFile(sdlSystem);
+    fs::path fontFile;
+    {
+      ScopedStartupStage stage("Font lookup");
+      fontFile = FindFontFile(sdlSystem);
+    }
     if (fontFile.empty() || !fs::exists(fontFile)) {
       throw rlvm::UserPresentableError(
           _("Could not find msgothic.ttc or a suitable fallback font."),
@@ -127,9 +196,12 @@ void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
 
     // Initialize our platform dialogs (we have to do this after
     // looking for a font because we use that font internally).
-    std::shared_ptr<GCNPlatform> platform(
-        new GCNPlatform(sdlSystem, sdlSystem.graphics().screen_rect()));
-    sdlSystem.SetPlatform(platform);
+    {
+      ScopedStartupStage stage("Platform");
+      std::shared_ptr<GCNPlatform> platform(
+          new GCNPlatform(sdlSystem, sdlSystem.graphics().screen_rect()));
+      sdlSystem.SetPlatform(platform);
+    }
 
     if (undefined_opcodes_)
       rlmachine.SetPrintUndefinedOpcodes(true);
@@ -140,7 +212,13 @@ void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
     if (tracing_)
       rlmachine.set_tracing_on();
 
-    Serialization::loadGlobalMemory(rlmachine);
+    if (!profile_output_.empty())
+      rlmachine.StartProfiling();
+
+    {
+      ScopedStartupStage stage("Global memory");
+      Serialization::loadGlobalMemory(rlmachine);
+    }
 
     // Now to preform a quick integrity check. If the user opened the Japanese
     // version of CLANNAD (or any other game), and then installed a patch, our
@@ -157,6 +235,12 @@ void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
       // etc.
       sdlSystem.Run(rlmachine);
 
+      if (startup_profile && !startup_profile->first_frame_drawn()) {
+        startup_profile->FirstFrameDrawn();
+        startup_profile->WriteReport(std::cerr);
+        StartupProfile::set_current(nullptr);
+      }
+
       // Run the rlmachine through as many instructions as we can in a 10ms time
       // slice. Bail out if we switch to long operation mode, or if the screen
       // is marked as dirty.
@@ -175,13 +259,30 @@ void RLVMInstance::Run(const boost::filesystem::path& gamerootPath) {
         int real_sleep_time = 10 - (end_ticks - start_ticks);
         if (real_sleep_time < 1)
           real_sleep_time = 1;
-        sdlSystem.event().Wait(real_sleep_time);
+
+        // If we're blocked on a LongOperation and nothing is animating,
+        // there's no point in running the loop every 10ms.
+        unsigned int wakeup = sdlSystem.NextWakeupTime(rlmachine);
+        unsigned int now = sdlSystem.event().GetTicks();
+        if (wakeup > now + real_sleep_time) {
+          sdlSystem.event().WaitForInput(
+              std::min(wakeup - now, kMaxIdleSleepMs));
+        } else {
+          sdlSystem.event().Wait(real_sleep_time);
+        }
       }
 
       sdlSystem.set_force_wait(false);
     }
 
     Serialization::saveGlobalMemory(rlmachine);
+
+    std::unique_ptr<Profiler> profiler = rlmachine.StopProfiling();
+    if (profiler) {
+      std::ofstream trace(profile_output_.c_str());
+      profiler->WriteChromeTrace(trace);
+      profiler->WriteSummary(std::cerr);
+    }
   }
   catch (rlvm::UserPresentableError& e) {
     ReportFatalError(e.message_text(), e.informative_text());
@@ -49,10 +49,16 @@ class RLVMInstance {
   void set_undefined_opcodes() { undefined_opcodes_ = true; }
   void set_count_undefined() { count_undefined_copcodes_ = true; }
   void set_tracing() { tracing_ = true; }
+  void set_profile_output(const std::string& in) { profile_output_ = in; }
+  void set_startup_profile() { startup_profile_ = true; }
   void set_load_save(int in) { load_save_ = in; }
   void set_custom_font(const std::string& font) { custom_font_ = font; }
+  void set_se_bank_size(int megabytes) { se_bank_size_ = megabytes; }
+  void set_image_cache_size(int megabytes) { image_cache_size_ = megabytes; }
+  void set_image_cache_compression() { compress_image_cache_ = true; }
 
   void set_dump_seen(int in) { dump_seen_ = in; }
+  void set_dump_cfg(int in) { dump_cfg_ = in; }
 
   // Optionally brings up a file selection dialog to get the game directory. In
   // case this isn't implemented or the user clicks cancel, returns an empty
@@ -105,11 +111,33 @@ class RLVMInstance {
   // Whether we should print out the opcodes as they are running.
   bool tracing_;
 
+  // If not empty, profile the game and write a Chrome trace to this file on
+  // exit.
+  std::string profile_output_;
+
+  // Whether to print how long each stage of startup took once the first
+  // frame is drawn.
+  bool startup_profile_;
+
   // Loads the specified save file as soon as emulation starts if not -1.
   int load_save_;
 
+  // Overrides how many megabytes of decoded sound effects are kept in memory
+  // if not -1.
+  int se_bank_size_;
+
+  // Keeps up to this many megabytes of decoded images in the save directory
+  // between sessions if not -1.
+  int image_cache_size_;
+
+  // Whether entries in the image cache are zlib compressed.
+  bool compress_image_cache_;
+
   // Dumps pseudo-kepago of the current seen to stdout and exit if not -1.
   int dump_seen_;
+
+  // Dumps the control flow graph of this seen to stdout and exit if not -1.
+  int dump_cfg_;
 };
 
 #endif  // SRC_MACHINE_RLVM_INSTANCE_H_
@@ -0,0 +1,577 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#include "machine/scenario_cfg.h"
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "libreallive/archive.h"
+#include "libreallive/bytecode.h"
+#include "libreallive/expression.h"
+#include "libreallive/scenario.h"
+
+using libreallive::BytecodeElement;
+using libreallive::CommandElement;
+using libreallive::ExpressionPiece;
+
+namespace {
+
+// Bump this whenever the analysis or the serialized format changes.
+const int kCacheVersion = 1;
+
+// What a command does to the flow of control.
+enum Flow {
+  FLOW_NONE,
+  FLOW_GOTO,
+  FLOW_BRANCH,
+  FLOW_GOSUB,
+  FLOW_RETURN,
+  FLOW_JUMP,
+  FLOW_FARCALL
+};
+
+// Classifies the commands of the Jmp (0:1) module and its 0:5 and 0:6
+// variants, which swap goto and goto_if.
+Flow GetFlow(const CommandElement& command) {
+  if (command.modtype() != 0 ||
+      (command.module() != 1 && command.module() != 5 &&
+       command.module() != 6))
+    return FLOW_NONE;
+
+  int opcode = command.opcode();
+  if (command.module() != 1 && opcode <= 1)
+    opcode ^= 1;
+
+  switch (opcode) {
+    case 0:
+      return FLOW_GOTO;
+    case 1:   // goto_if
+    case 2:   // goto_unless
+    case 3:   // goto_on
+    case 4:   // goto_case
+      return FLOW_BRANCH;
+    case 5:   // gosub
+    case 6:   // gosub_if
+    case 7:   // gosub_unless
+    case 8:   // gosub_on
+    case 9:   // gosub_case
+    case 16:  // gosub_with
+      return FLOW_GOSUB;
+    case 10:  // ret
+    case 13:  // rtl
+    case 17:  // ret_with
+    case 19:  // rtl_with
+      return FLOW_RETURN;
+    case 11:
+      return FLOW_JUMP;
+    case 12:  // farcall
+    case 18:  // farcall_with
+      return FLOW_FARCALL;
+    default:
+      return FLOW_NONE;
+  }
+}
+
+// Parses the parameters of |command|, skipping ones that don't parse.
+std::vector<ExpressionPiece> ParseParameters(const CommandElement& command) {
+  std::vector<ExpressionPiece> pieces;
+  for (const std::string& param : command.GetUnparsedParameters()) {
+    try {
+      const char* src = param.c_str();
+      pieces.push_back(libreallive::GetData(src));
+    } catch (std::exception&) {
+      pieces.push_back(ExpressionPiece(libreallive::invalid_expression_piece_t()));
+    }
+  }
+  return pieces;
+}
+
+// Returns the value of |pieces[i]| when it's a constant, or -1.
+int GetConstantParameter(const std::vector<ExpressionPiece>& pieces,
+                         size_t i) {
+  if (i < pieces.size() && pieces[i].IsConstant()) {
+    try {
+      return pieces[i].GetConstantIntegerValue();
+    } catch (std::exception&) {
+    }
+  }
+  return -1;
+}
+
+void AddStringConstants(const ExpressionPiece& piece,
+                        ScenarioCFG::ResourceType type,
+                        std::vector<ScenarioCFG::Resource>* resources) {
+  const std::string* str = piece.GetStringConstant();
+  if (str) {
+    // "???" stands for whatever is already in the DC.
+    if (!str->empty() && *str != "???")
+      resources->push_back(ScenarioCFG::Resource{type, *str});
+  } else if (piece.IsComplexParameter() || piece.IsSpecialParameter()) {
+    for (const ExpressionPiece& contained : piece.GetContainedPieces())
+      AddStringConstants(contained, type, resources);
+  }
+}
+
+bool IsObjectFileOpcode(int opcode) {
+  // objOfFile, objOfFile2, objOfFileGan, objDriftOfFile and objOfDigits.
+  return opcode == 1000 || opcode == 1001 || opcode == 1003 ||
+         opcode == 1300 || opcode == 1400;
+}
+
+bool IsKoePlayOpcode(int opcode) {
+  // koePlay, koePlayEx, koePlayExC and their koeDoPlay versions.
+  return opcode == 0 || opcode == 1 || (opcode >= 7 && opcode <= 10);
+}
+
+// Adds the files and voices that |command| will load to |resources|.
+void AddResources(const CommandElement& command,
+                  std::vector<ScenarioCFG::Resource>* resources) {
+  if (command.modtype() != 1)
+    return;
+
+  ScenarioCFG::ResourceType type;
+  switch (command.module()) {
+    case 14:  // G00
+    case 33:  // Grp
+      type = ScenarioCFG::RESOURCE_IMAGE;
+      break;
+    case 71:  // ObjFgCreation
+    case 72:  // ObjBgCreation
+      if (!IsObjectFileOpcode(command.opcode()))
+        return;
+      type = ScenarioCFG::RESOURCE_IMAGE;
+      break;
+    case 20:  // Bgm
+      type = ScenarioCFG::RESOURCE_BGM;
+      break;
+    case 21:  // Pcm
+      type = ScenarioCFG::RESOURCE_SOUND;
+      break;
+    case 26:  // Mov
+      type = ScenarioCFG::RESOURCE_MOVIE;
+      break;
+    case 23: {  // Koe
+      if (!IsKoePlayOpcode(command.opcode()))
+        return;
+      int id = GetConstantParameter(ParseParameters(command), 0);
+      if (id >= 0) {
+        resources->push_back(
+            ScenarioCFG::Resource{ScenarioCFG::RESOURCE_KOE,
+                                  std::to_string(id)});
+      }
+      return;
+    }
+    default:
+      return;
+  }
+
+  for (const ExpressionPiece& piece : ParseParameters(command))
+    AddStringConstants(piece, type, resources);
+}
+
+const char* EdgeName(ScenarioCFG::EdgeType type) {
+  static const char* const kNames[] = {"fallthrough", "goto", "gosub",
+                                       "jump", "farcall"};
+  return kNames[type];
+}
+
+const char* ResourceName(ScenarioCFG::ResourceType type) {
+  static const char* const kNames[] = {"image", "bgm", "sound", "movie",
+                                       "koe"};
+  return kNames[type];
+}
+
+// FNV-1a; only used to notice when a scenario's bytecode changes.
+uint64_t HashBytes(const char* data, size_t length) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (size_t i = 0; i < length; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+struct CacheEntry {
+  uint64_t hash;
+  ScenarioCFG cfg;
+
+  template <class Archive>
+  void serialize(Archive& ar, unsigned int version) {
+    ar& hash& cfg;
+  }
+};
+
+typedef std::map<int, CacheEntry> Cache;
+
+Cache ReadCache(const boost::filesystem::path& cache_file) {
+  Cache cache;
+  boost::filesystem::ifstream file(cache_file);
+  if (!file)
+    return cache;
+
+  try {
+    boost::archive::text_iarchive ia(file);
+    int version;
+    ia >> version;
+    if (version == kCacheVersion)
+      ia >> cache;
+  } catch (std::exception&) {
+    // A stale or damaged cache just means rebuilding everything.
+    cache.clear();
+  }
+  return cache;
+}
+
+void WriteCache(const boost::filesystem::path& cache_file,
+                const Cache& cache) {
+  boost::filesystem::ofstream file(cache_file);
+  if (!file)
+    return;
+
+  boost::archive::text_oarchive oa(file);
+  oa << kCacheVersion << cache;
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+// ScenarioCFG
+// -----------------------------------------------------------------------
+ScenarioCFG::ScenarioCFG() : scenario_number_(-1) {}
+
+ScenarioCFG::ScenarioCFG(const libreallive::Scenario& scenario)
+    : scenario_number_(scenario.scene_number()) {
+  std::vector<const BytecodeElement*> elements;
+  std::unordered_map<const BytecodeElement*, int> index_of;
+  for (auto it = scenario.begin(); it != scenario.end(); ++it) {
+    index_of[it->get()] = elements.size();
+    elements.push_back(it->get());
+  }
+  if (elements.empty())
+    return;
+
+  // Per element: how it affects control flow and where it can go locally.
+  std::vector<Flow> flows(elements.size(), FLOW_NONE);
+  std::vector<std::vector<int>> targets(elements.size());
+  std::set<int> leaders = {0};
+  for (size_t i = 0; i < elements.size(); ++i) {
+    if (elements[i]->GetEntrypoint() != BytecodeElement::kInvalidEntrypoint)
+      leaders.insert(i);
+
+    const CommandElement* command =
+        dynamic_cast<const CommandElement*>(elements[i]);
+    if (!command)
+      continue;
+
+    flows[i] = GetFlow(*command);
+    if (flows[i] == FLOW_NONE)
+      continue;
+
+    for (size_t j = 0; j < command->GetPointersCount(); ++j) {
+      libreallive::Scenario::const_iterator target = command->GetPointer(j);
+      if (target == scenario.end())
+        continue;
+      int index = index_of[target->get()];
+      targets[i].push_back(index);
+      leaders.insert(index);
+    }
+    if (i + 1 < elements.size())
+      leaders.insert(i + 1);
+  }
+
+  std::vector<int> block_of(elements.size());
+  std::vector<int> starts(leaders.begin(), leaders.end());
+  for (size_t b = 0; b < starts.size(); ++b) {
+    int end = b + 1 < starts.size() ? starts[b + 1] : elements.size();
+    std::fill(block_of.begin() + starts[b], block_of.begin() + end, b);
+    blocks_.push_back(Block{starts[b], end, false, {}, {}});
+  }
+
+  for (size_t b = 0; b < blocks_.size(); ++b) {
+    Block& block = blocks_[b];
+    for (int i = block.first_element; i < block.end_element; ++i) {
+      int entrypoint = elements[i]->GetEntrypoint();
+      if (entrypoint != BytecodeElement::kInvalidEntrypoint)
+        entrypoints_[entrypoint] = b;
+
+      const CommandElement* command =
+          dynamic_cast<const CommandElement*>(elements[i]);
+      if (command)
+        AddResources(*command, &block.resources);
+    }
+
+    int last = block.end_element - 1;
+    bool falls_through = true;
+    switch (flows[last]) {
+      case FLOW_GOTO:
+        falls_through = false;
+        [[fallthrough]];
+      case FLOW_BRANCH:
+        for (int target : targets[last])
+          block.successors.push_back(
+              Edge{EDGE_GOTO, scenario_number_, block_of[target]});
+        break;
+      case FLOW_GOSUB:
+        for (int target : targets[last])
+          block.successors.push_back(
+              Edge{EDGE_GOSUB, scenario_number_, block_of[target]});
+        break;
+      case FLOW_RETURN:
+        block.returns = true;
+        falls_through = false;
+        break;
+      case FLOW_JUMP:
+      case FLOW_FARCALL: {
+        const CommandElement& command =
+            static_cast<const CommandElement&>(*elements[last]);
+        std::vector<ExpressionPiece> params = ParseParameters(command);
+        // The one argument forms go to the top of the scenario.
+        int entrypoint =
+            command.argc() > 1 ? GetConstantParameter(params, 1) : 0;
+        block.successors.push_back(
+            Edge{flows[last] == FLOW_JUMP ? EDGE_JUMP : EDGE_FARCALL,
+                 GetConstantParameter(params, 0), entrypoint});
+        falls_through = flows[last] == FLOW_FARCALL;
+        break;
+      }
+      case FLOW_NONE:
+        break;
+    }
+
+    if (falls_through && b + 1 < blocks_.size())
+      block.successors.push_back(Edge{EDGE_FALLTHROUGH, scenario_number_,
+                                      static_cast<int>(b + 1)});
+  }
+}
+
+ScenarioCFG::~ScenarioCFG() {}
+
+int ScenarioCFG::GetEntrypointBlock(int entrypoint) const {
+  auto it = entrypoints_.find(entrypoint);
+  return it != entrypoints_.end() ? it->second : -1;
+}
+
+int ScenarioCFG::GetBlockContaining(int element) const {
+  auto it = std::upper_bound(
+      blocks_.begin(), blocks_.end(), element,
+      [](int element, const Block& block) {
+        return element < block.first_element;
+      });
+  if (it == blocks_.begin() || element >= (it - 1)->end_element)
+    return -1;
+  return (it - blocks_.begin()) - 1;
+}
+
+std::vector<ScenarioCFG::Resource> ScenarioCFG::GetResourcesReachableFrom(
+    int block,
+    size_t max_blocks) const {
+  std::vector<Resource> resources;
+  if (block < 0 || static_cast<size_t>(block) >= blocks_.size())
+    return resources;
+
+  std::vector<bool> seen(blocks_.size(), false);
+  std::deque<int> queue = {block};
+  seen[block] = true;
+  size_t visited = 0;
+  while (!queue.empty() && visited < max_blocks) {
+    const Block& current = blocks_[queue.front()];
+    queue.pop_front();
+    visited++;
+
+    for (const Resource& resource : current.resources) {
+      if (std::find(resources.begin(), resources.end(), resource) ==
+          resources.end())
+        resources.push_back(resource);
+    }
+
+    for (const Edge& edge : current.successors) {
+      if (edge.type == EDGE_JUMP || edge.type == EDGE_FARCALL ||
+          seen[edge.target])
+        continue;
+      seen[edge.target] = true;
+      queue.push_back(edge.target);
+    }
+  }
+
+  return resources;
+}
+
+void ScenarioCFG::Dump(std::ostream& oss) const {
+  oss << "SEEN" << scenario_number_ << ": " << blocks_.size() << " blocks, "
+      << entrypoints_.size() << " entrypoints" << std::endl;
+
+  std::map<int, int> entrypoint_at;
+  for (auto const& entrypoint : entrypoints_)
+    entrypoint_at[entrypoint.second] = entrypoint.first;
+
+  for (size_t b = 0; b < blocks_.size(); ++b) {
+    const Block& block = blocks_[b];
+    oss << "  block " << b << ": elements " << block.first_element << "-"
+        << block.end_element - 1;
+    auto entrypoint = entrypoint_at.find(b);
+    if (entrypoint != entrypoint_at.end())
+      oss << " (#ENTRYPOINT " << entrypoint->second << ")";
+    if (block.returns)
+      oss << " returns";
+    oss << std::endl;
+
+    for (const Edge& edge : block.successors) {
+      oss << "    -> " << EdgeName(edge.type) << " ";
+      if (edge.type == EDGE_JUMP || edge.type == EDGE_FARCALL) {
+        oss << "SEEN";
+        if (edge.scenario >= 0)
+          oss << edge.scenario;
+        else
+          oss << "?";
+        oss << " entrypoint ";
+        if (edge.target >= 0)
+          oss << edge.target;
+        else
+          oss << "?";
+      } else {
+        oss << "block " << edge.target;
+      }
+      oss << std::endl;
+    }
+
+    for (const Resource& resource : block.resources)
+      oss << "    uses " << ResourceName(resource.type) << " "
+          << resource.name << std::endl;
+  }
+}
+
+template <class Archive>
+void ScenarioCFG::Edge::serialize(Archive& ar, unsigned int version) {
+  ar& type& scenario& target;
+}
+
+template <class Archive>
+void ScenarioCFG::Resource::serialize(Archive& ar, unsigned int version) {
+  ar& type& name;
+}
+
+template <class Archive>
+void ScenarioCFG::Block::serialize(Archive& ar, unsigned int version) {
+  ar& first_element& end_element& returns& successors& resources;
+}
+
+template <class Archive>
+void ScenarioCFG::serialize(Archive& ar, unsigned int version) {
+  ar& scenario_number_& blocks_& entrypoints_;
+}
+
+// -----------------------------------------------------------------------
+// ArchiveCFG
+// -----------------------------------------------------------------------
+ArchiveCFG::ArchiveCFG(libreallive::Archive& archive,
+                       const boost::filesystem::path& cache_file)
+    : cache_hits_(0) {
+  Cache cache;
+  if (!cache_file.empty())
+    cache = ReadCache(cache_file);
+
+  std::map<int, uint64_t> hashes;
+  std::vector<int> to_build;
+  for (auto it = archive.begin(); it != archive.end(); ++it) {
+    uint64_t hash = HashBytes(it->second.data, it->second.length);
+    hashes[it->first] = hash;
+
+    auto cached = cache.find(it->first);
+    if (cached != cache.end() && cached->second.hash == hash) {
+      scenarios_[it->first] = std::move(cached->second.cfg);
+      cache_hits_++;
+    } else {
+      to_build.push_back(it->first);
+    }
+  }
+
+  if (to_build.empty())
+    return;
+
+  // Each scenario is parsed on its own, so split them between threads.
+  std::vector<std::unique_ptr<ScenarioCFG>> built(to_build.size());
+  std::atomic<size_t> next(0);
+  auto worker = [&]() {
+    for (size_t i = next++; i < to_build.size(); i = next++) {
+      try {
+        std::unique_ptr<libreallive::Scenario> scenario =
+            archive.ParseScenario(to_build[i]);
+        if (scenario)
+          built[i].reset(new ScenarioCFG(*scenario));
+      } catch (std::exception&) {
+        // Leave scenarios we can't parse out of the graph.
+      }
+    }
+  };
+
+  size_t thread_count = std::min<size_t>(
+      std::max(1u, std::thread::hardware_concurrency()), to_build.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < thread_count; ++i)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  for (size_t i = 0; i < to_build.size(); ++i) {
+    if (built[i])
+      scenarios_[to_build[i]] = std::move(*built[i]);
+  }
+
+  if (!cache_file.empty()) {
+    Cache updated;
+    for (auto& entry : scenarios_)
+      updated[entry.first] = CacheEntry{hashes[entry.first], entry.second};
+    WriteCache(cache_file, updated);
+  }
+}
+
+ArchiveCFG::~ArchiveCFG() {}
+
+const ScenarioCFG* ArchiveCFG::GetScenario(int scenario) const {
+  auto it = scenarios_.find(scenario);
+  return it != scenarios_.end() ? &it->second : NULL;
+}
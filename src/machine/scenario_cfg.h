@@ -0,0 +1,176 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_MACHINE_SCENARIO_CFG_H_
+#define SRC_MACHINE_SCENARIO_CFG_H_
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace libreallive {
+class Archive;
+class Scenario;
+}  // namespace libreallive
+
+// A static control flow graph of one scenario: its basic blocks, the edges
+// between them and out to other scenarios, and the resources (images, music,
+// sounds and voices) each block names. It's built from the bytecode alone,
+// so only constant jump targets and resource names are known; for
+// everything else it records that the target is computed at runtime.
+class ScenarioCFG {
+ public:
+  enum EdgeType {
+    // Into the next block.
+    EDGE_FALLTHROUGH = 0,
+    // goto and its conditional, goto_on and goto_case forms.
+    EDGE_GOTO,
+    // gosub and its conditional, gosub_on, gosub_case and gosub_with forms.
+    EDGE_GOSUB,
+    // jump into another scenario.
+    EDGE_JUMP,
+    // farcall into another scenario.
+    EDGE_FARCALL
+  };
+
+  enum ResourceType {
+    RESOURCE_IMAGE = 0,
+    RESOURCE_BGM,
+    RESOURCE_SOUND,
+    RESOURCE_MOVIE,
+    RESOURCE_KOE
+  };
+
+  struct Edge {
+    EdgeType type;
+
+    // For EDGE_JUMP and EDGE_FARCALL, the scenario (or -1 if computed) and
+    // entrypoint (or -1 if computed) jumped to. For local edges, |scenario|
+    // is this scenario and |target| is a block index.
+    int scenario;
+    int target;
+
+    template <class Archive>
+    void serialize(Archive& ar, unsigned int version);
+  };
+
+  struct Resource {
+    ResourceType type;
+
+    // The file name as written in the script, or the voice id for
+    // RESOURCE_KOE.
+    std::string name;
+
+    bool operator==(const Resource& rhs) const {
+      return type == rhs.type && name == rhs.name;
+    }
+
+    template <class Archive>
+    void serialize(Archive& ar, unsigned int version);
+  };
+
+  struct Block {
+    // The block is bytecode elements [first_element, end_element) of the
+    // scenario, counted from the start of the script.
+    int first_element;
+    int end_element;
+
+    // Whether the block ends in ret/rtl.
+    bool returns;
+
+    std::vector<Edge> successors;
+    std::vector<Resource> resources;
+
+    template <class Archive>
+    void serialize(Archive& ar, unsigned int version);
+  };
+
+  ScenarioCFG();
+  explicit ScenarioCFG(const libreallive::Scenario& scenario);
+  ~ScenarioCFG();
+
+  int scenario_number() const { return scenario_number_; }
+  const std::vector<Block>& blocks() const { return blocks_; }
+
+  // Returns the block that starts at |entrypoint|, or -1.
+  int GetEntrypointBlock(int entrypoint) const;
+
+  // Returns the block that holds the |element|th bytecode element, or -1.
+  int GetBlockContaining(int element) const;
+
+  // Returns the resources named in the blocks reachable from |block| inside
+  // this scenario, visiting at most |max_blocks| blocks closest first. Each
+  // resource is listed once, in the order it was found.
+  std::vector<Resource> GetResourcesReachableFrom(int block,
+                                                  size_t max_blocks) const;
+
+  // Prints the graph in a human readable form.
+  void Dump(std::ostream& oss) const;
+
+  template <class Archive>
+  void serialize(Archive& ar, unsigned int version);
+
+ private:
+  int scenario_number_;
+  std::vector<Block> blocks_;
+
+  // Maps entrypoint numbers to blocks.
+  std::map<int, int> entrypoints_;
+};
+
+// The ScenarioCFGs of every scenario in an archive.
+class ArchiveCFG {
+ public:
+  // Builds the graph of every scenario in |archive|, parsing and analyzing
+  // the scenarios in parallel. Graphs are read back from |cache_file| for
+  // scenarios whose bytecode hasn't changed since it was written, and the
+  // cache is rewritten when anything had to be rebuilt. Pass an empty path
+  // to skip the cache.
+  ArchiveCFG(libreallive::Archive& archive,
+             const boost::filesystem::path& cache_file);
+  ~ArchiveCFG();
+
+  // Returns the graph of |scenario|, or NULL if it doesn't exist or couldn't
+  // be parsed.
+  const ScenarioCFG* GetScenario(int scenario) const;
+
+  size_t size() const { return scenarios_.size(); }
+
+  // How many graphs came out of the cache.
+  int cache_hits() const { return cache_hits_; }
+
+ private:
+  std::map<int, ScenarioCFG> scenarios_;
+  int cache_hits_;
+};
+
+#endif  // SRC_MACHINE_SCENARIO_CFG_H_
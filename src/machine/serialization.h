@@ -42,6 +42,9 @@ namespace Serialization {
 // like a closure around, which is frustrating because many pieces of
 // data rely on looking things up on the machine.
 //
+// saveGameTo() and loadGameFrom() hold a process wide lock while they use
+// this, so machines on different threads take turns saving and loading.
+//
 // @warning We're using what is essentially a piece of static data
 //          here; this is a likely location for errors
 extern RLMachine* g_current_machine;
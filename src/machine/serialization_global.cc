@@ -70,7 +70,30 @@ fs::path buildGlobalMemoryFilename(RLMachine& machine) {
   return machine.system().GameSaveDirectory() / "global.sav.gz";
 }
 
+fs::path buildKidokuFilename(RLMachine& machine) {
+  return machine.system().GameSaveDirectory() / "kidoku.dat";
+}
+
+// Moves the kidoku table into its file in the save directory, after which
+// read state is written out as it's recorded.
+void attachKidokuFile(RLMachine& machine) {
+  KidokuTable& table = machine.memory().global().kidoku_table;
+  if (table.attached())
+    return;
+
+  try {
+    table.AttachFile(buildKidokuFilename(machine).string());
+  }
+  catch (std::exception& e) {
+    std::cerr << "WARNING: Unable to keep read text in "
+              << buildKidokuFilename(machine) << ": " << e.what()
+              << std::endl;
+  }
+}
+
 void saveGlobalMemory(RLMachine& machine) {
+  attachKidokuFile(machine);
+
   fs::path home = buildGlobalMemoryFilename(machine);
   fs::ofstream file(home, std::ios::binary);
   if (!file) {
@@ -126,6 +149,8 @@ void loadGlobalMemory(RLMachine& machine) {
                 << save_dir << " to " << dest_save_dir << std::endl;
     }
   }
+
+  attachKidokuFile(machine);
 }
 
 void loadGlobalMemoryFrom(std::istream& iss, RLMachine& machine) {
@@ -139,7 +164,12 @@ void loadGlobalMemoryFrom(std::istream& iss, RLMachine& machine) {
   ia >> version;
 
   // Load global memory.
-  ia >> machine.memory().global();
+  GlobalMemory& global = machine.memory().global();
+  ia >> global;
+
+  // Saves from before the kidoku table carry all read state in
+  // |kidoku_data|.
+  global.kidoku_table.Absorb(&global.kidoku_data);
 
   // When Karmic Koala came out, support for all boost earlier than 1.36 was
   // dropped. For years, I had used boost 1.35 on Ubuntu. It turns out that
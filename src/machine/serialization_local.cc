@@ -39,6 +39,7 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <mutex>
 #include <exception>
 #include <stdexcept>
 #include <string>
@@ -75,6 +76,9 @@ const int CURRENT_LOCAL_VERSION = 2;
 
 namespace {
 
+// Held while |g_current_machine| is in use.
+std::mutex g_current_machine_mutex;
+
 template <typename TYPE>
 void checkInFileOpened(TYPE& file, const fs::path& home) {
   if (!file) {
@@ -102,6 +106,7 @@ void saveGameTo(std::ostream& oss, RLMachine& machine) {
 
   const SaveGameHeader header(machine.system().graphics().window_subtitle());
 
+  std::lock_guard<std::mutex> lock(g_current_machine_mutex);
   g_current_machine = &machine;
 
   try {
@@ -192,6 +197,7 @@ void loadGameFrom(std::istream& iss, RLMachine& machine) {
   int version;
   SaveGameHeader header;
 
+  std::lock_guard<std::mutex> lock(g_current_machine_mutex);
   g_current_machine = &machine;
 
   try {
@@ -39,29 +39,41 @@
 #include "machine/serialization.h"
 #include "utilities/exception.h"
 
+// -----------------------------------------------------------------------
+// StackFrame::Locals
+// -----------------------------------------------------------------------
+StackFrame::Locals::Locals() { memset(intL, 0, sizeof(intL)); }
+
 // -----------------------------------------------------------------------
 // StackFrame
 // -----------------------------------------------------------------------
-StackFrame::StackFrame() : scenario(NULL), ip(), frame_type() {
-  memset(intL, 0, sizeof(intL));
-}
+StackFrame::StackFrame() : scenario(NULL), ip(), frame_type() {}
 
 StackFrame::StackFrame(libreallive::Scenario const* s,
                        const libreallive::Scenario::const_iterator& i,
                        FrameType t)
-    : scenario(s), ip(i), frame_type(t) {
-  memset(intL, 0, sizeof(intL));
-}
+    : scenario(s), ip(i), frame_type(t) {}
 
 StackFrame::StackFrame(libreallive::Scenario const* s,
                        const libreallive::Scenario::const_iterator& i,
                        LongOperation* op)
-    : scenario(s), ip(i), long_op(op), frame_type(TYPE_LONGOP) {
-  memset(intL, 0, sizeof(intL));
-}
+    : scenario(s), ip(i), long_op(op), frame_type(TYPE_LONGOP) {}
 
 StackFrame::~StackFrame() {}
 
+const StackFrame::Locals& StackFrame::GetLocals() const {
+  static const Locals empty_locals;
+  return locals ? *locals : empty_locals;
+}
+
+StackFrame::Locals& StackFrame::MutableLocals() {
+  if (!locals)
+    locals = std::make_shared<Locals>();
+  else if (locals.use_count() > 1)
+    locals = std::make_shared<Locals>(*locals);
+  return *locals;
+}
+
 std::ostream& operator<<(std::ostream& os, const StackFrame& frame) {
   os << "{seen=" << frame.scenario->scene_number()
      << ", offset=" << distance(frame.scenario->begin(), frame.ip);
@@ -78,7 +90,10 @@ template <class Archive>
 void StackFrame::save(Archive& ar, unsigned int version) const {
   int scene_number = scenario->scene_number();
   int position = distance(scenario->begin(), ip);
-  ar& scene_number& position& frame_type& intL& strK;
+  const Locals& banks = GetLocals();
+  // Written as a std::vector so the format doesn't depend on the inline size.
+  std::vector<std::string> strK(banks.strK.begin(), banks.strK.end());
+  ar& scene_number& position& frame_type& banks.intL& strK;
 }
 
 template <class Archive>
@@ -107,20 +122,24 @@ void StackFrame::load(Archive& ar, unsigned int version) {
 
   *this = StackFrame(scenario, position_it, type);
 
-  if (version >= 1) {
-    ar& intL;
-  }
+  if (version == 0)
+    return;
+
+  Locals& banks = MutableLocals();
+  ar& banks.intL;
 
   if (version == 1) {
     std::string old_strk[3];
     ar & old_strk;
 
-    strK.resize(3);
-    strK[0] = old_strk[0];
-    strK[1] = old_strk[1];
-    strK[2] = old_strk[2];
-  } else if (version > 1) {
+    banks.strK.resize(3);
+    banks.strK[0] = old_strk[0];
+    banks.strK[1] = old_strk[1];
+    banks.strK[2] = old_strk[2];
+  } else {
+    std::vector<std::string> strK;
     ar & strK;
+    banks.strK.assign(strK.begin(), strK.end());
   }
 }
 
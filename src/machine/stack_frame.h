@@ -28,11 +28,13 @@
 #ifndef SRC_MACHINE_STACK_FRAME_H_
 #define SRC_MACHINE_STACK_FRAME_H_
 
+#include <boost/container/small_vector.hpp>
 #include <boost/serialization/split_member.hpp>
 #include <boost/serialization/version.hpp>
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "libreallive/scenario.h"
 
@@ -60,12 +62,26 @@ struct StackFrame {
   // Pointer to the owned LongOperation if this is of TYPE_LONGOP.
   std::shared_ptr<LongOperation> long_op;
 
-  // Parameter passing integer bank
-  int intL[40];
-
   // Parameter passing string bank. I have no idea how large this should
-  // actually be, so accept any number and grow to fit.
-  std::vector<std::string> strK;
+  // actually be, so accept any number and grow to fit. Scripts almost never
+  // pass more than three strings, so those are kept inline.
+  typedef boost::container::small_vector<std::string, 3> StrKBank;
+
+  // The parameter passing banks of a frame.
+  struct Locals {
+    Locals();
+
+    // Parameter passing integer bank
+    int intL[40];
+
+    // Parameter passing string bank.
+    StrKBank strK;
+  };
+
+  // Shared copy-on-write with the copies of this frame in the savepoint call
+  // stack, so marking a savepoint doesn't copy the banks. NULL until a bank
+  // is first written to, which is the common case for LongOperation frames.
+  std::shared_ptr<Locals> locals;
 
   // The function that pushed the current frame onto the
   // stack. Used in error checking.
@@ -91,6 +107,17 @@ struct StackFrame {
 
   ~StackFrame();
 
+  // Read only access to the parameter passing banks.
+  const int* intL() const { return GetLocals().intL; }
+  const StrKBank& strK() const { return GetLocals().strK; }
+
+  // Write access to the parameter passing banks. Unshares them first.
+  int* mutable_intL() { return MutableLocals().intL; }
+  StrKBank& mutable_strK() { return MutableLocals().strK; }
+
+  const Locals& GetLocals() const;
+  Locals& MutableLocals();
+
   template <class Archive>
   void save(Archive& ar, const unsigned int file_version) const;
 
@@ -0,0 +1,133 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#include "machine/startup_profile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+#include "machine/profiler.h"
+
+namespace {
+
+std::atomic<StartupProfile*> g_current_profile(nullptr);
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+// StartupProfile
+// -----------------------------------------------------------------------
+StartupProfile::StartupProfile()
+    : start_us_(Profiler::NowMicros()), first_frame_us_(0) {
+  threads_.push_back(std::this_thread::get_id());
+}
+
+StartupProfile::~StartupProfile() {
+  if (current() == this)
+    set_current(nullptr);
+}
+
+// static
+StartupProfile* StartupProfile::current() { return g_current_profile; }
+
+// static
+void StartupProfile::set_current(StartupProfile* profile) {
+  g_current_profile = profile;
+}
+
+void StartupProfile::Record(const std::string& stage,
+                            int64_t start_us,
+                            int64_t duration_us) {
+  std::lock_guard<std::mutex> lock(lock_);
+  stages_.push_back(Stage{stage, ThreadNumber(std::this_thread::get_id()),
+                          start_us - start_us_, duration_us});
+}
+
+void StartupProfile::FirstFrameDrawn() {
+  std::lock_guard<std::mutex> lock(lock_);
+  if (first_frame_us_ == 0)
+    first_frame_us_ = Profiler::NowMicros();
+}
+
+void StartupProfile::WriteReport(std::ostream& os) const {
+  std::lock_guard<std::mutex> lock(lock_);
+
+  std::vector<Stage> stages = stages_;
+  std::stable_sort(stages.begin(), stages.end(),
+                   [](const Stage& lhs, const Stage& rhs) {
+                     return lhs.start_us < rhs.start_us;
+                   });
+
+  int name_width = 5;
+  for (auto const& stage : stages)
+    name_width = std::max(name_width, static_cast<int>(stage.name.size()));
+  name_width += 2;
+
+  os << "Startup profile" << std::endl;
+  os << std::setw(name_width) << std::left << "Stage" << std::right
+     << std::setw(8) << "Thread" << std::setw(14) << "Start (ms)"
+     << std::setw(14) << "Time (ms)" << std::endl;
+  os << std::string(name_width + 36, '-') << std::endl;
+  for (auto const& stage : stages) {
+    os << std::setw(name_width) << std::left << stage.name << std::right
+       << std::setw(8) << stage.thread << std::setw(14) << std::fixed
+       << std::setprecision(3) << stage.start_us / 1000.0 << std::setw(14)
+       << stage.duration_us / 1000.0 << std::endl;
+  }
+
+  if (first_frame_us_) {
+    os << "Time to first frame: " << std::fixed << std::setprecision(3)
+       << (first_frame_us_ - start_us_) / 1000.0 << " ms" << std::endl;
+  }
+}
+
+int StartupProfile::ThreadNumber(std::thread::id id) {
+  auto it = std::find(threads_.begin(), threads_.end(), id);
+  if (it != threads_.end())
+    return it - threads_.begin();
+
+  threads_.push_back(id);
+  return threads_.size() - 1;
+}
+
+// -----------------------------------------------------------------------
+// ScopedStartupStage
+// -----------------------------------------------------------------------
+ScopedStartupStage::ScopedStartupStage(const char* stage)
+    : profile_(StartupProfile::current()),
+      stage_(stage),
+      start_us_(profile_ ? Profiler::NowMicros() : 0) {}
+
+ScopedStartupStage::~ScopedStartupStage() {
+  if (profile_) {
+    profile_->Record(stage_, start_us_, Profiler::NowMicros() - start_us_);
+  }
+}
@@ -0,0 +1,100 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_MACHINE_STARTUP_PROFILE_H_
+#define SRC_MACHINE_STARTUP_PROFILE_H_
+
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Records how long each stage of startup takes and on which thread, from
+// launch until the first frame is drawn. Enabled with --startup-profile.
+//
+// Startup is spread over the main thread and a few workers, so rather than
+// threading a profile object through every constructor, stages report to
+// whichever StartupProfile is current. When there is none, which is the
+// normal case, recording a stage costs one pointer check.
+class StartupProfile {
+ public:
+  StartupProfile();
+  ~StartupProfile();
+
+  // Returns the profile that stages report to, or NULL if startup isn't being
+  // profiled.
+  static StartupProfile* current();
+  static void set_current(StartupProfile* profile);
+
+  // Records that |stage| ran on the calling thread for |duration_us|
+  // microseconds, starting at |start_us| (see Profiler::NowMicros()).
+  void Record(const std::string& stage, int64_t start_us, int64_t duration_us);
+
+  // Marks the end of startup.
+  void FirstFrameDrawn();
+  bool first_frame_drawn() const { return first_frame_us_ != 0; }
+
+  // Prints every stage in the order it started, with its thread, followed by
+  // the time to first frame.
+  void WriteReport(std::ostream& os) const;
+
+ private:
+  struct Stage {
+    std::string name;
+    int thread;
+    int64_t start_us;
+    int64_t duration_us;
+  };
+
+  // Small stable numbers for threads, in the order they report. The main
+  // thread is always 0.
+  int ThreadNumber(std::thread::id id);
+
+  mutable std::mutex lock_;
+  int64_t start_us_;
+  int64_t first_frame_us_;
+  std::vector<Stage> stages_;
+  std::vector<std::thread::id> threads_;
+};
+
+// Times the enclosing scope as one startup stage, if startup is being
+// profiled.
+class ScopedStartupStage {
+ public:
+  explicit ScopedStartupStage(const char* stage);
+  ~ScopedStartupStage();
+
+ private:
+  StartupProfile* profile_;
+  const char* stage_;
+  int64_t start_us_;
+};
+
+#endif  // SRC_MACHINE_STARTUP_PROFILE_H_
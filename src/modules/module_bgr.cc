@@ -60,6 +60,19 @@ using boost::iends_with;
 
 namespace {
 
+void PerformBgrEffect(RLMachine& machine,
+                      const std::shared_ptr<Surface>& src,
+                      const std::shared_ptr<Surface>& dst,
+                      int selnum) {
+  // RenderForEffect() already decided to skip the effect.
+  if (!src || !dst)
+    return;
+
+  LongOperation* effect =
+      EffectFactory::BuildFromSEL(machine, src, dst, selnum);
+  machine.PushLongOperation(effect);
+}
+
 struct bgrLoadHaikei_blank : public RLOpcode<IntConstant_T> {
   void operator()(RLMachine& machine, int sel) {
     GraphicsSystem& graphics = machine.system().graphics();
@@ -67,17 +80,14 @@ struct bgrLoadHaikei_blank : public RLOpcode<IntConstant_T> {
     graphics.SetHikRenderer(NULL);
     graphics.set_graphics_background(BACKGROUND_HIK);
 
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
     graphics.GetHaikei()->Fill(RGBAColour::Clear());
 
     if (!machine.replaying_graphics_stack())
       graphics.ClearAndPromoteObjects();
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
-
-    LongOperation* effect =
-        EffectFactory::BuildFromSEL(machine, after, before, sel);
-    machine.PushLongOperation(effect);
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
+    PerformBgrEffect(machine, after, before, sel);
   }
 };
 
@@ -99,7 +109,7 @@ struct bgrLoadHaikei_main : RLOpcode<StrConstant_T, IntConstant_T> {
       graphics.SetHikRenderer(new HIKRenderer(
           system, graphics.GetHIKScript(system, filename, path)));
     } else {
-      std::shared_ptr<Surface> before = graphics.RenderToSurface();
+      std::shared_ptr<Surface> before = RenderForEffect(machine);
 
       if (!path.empty()) {
         std::shared_ptr<const Surface> source(
@@ -114,11 +124,8 @@ struct bgrLoadHaikei_main : RLOpcode<StrConstant_T, IntConstant_T> {
       if (!machine.replaying_graphics_stack())
         graphics.ClearAndPromoteObjects();
 
-      std::shared_ptr<Surface> after = graphics.RenderToSurface();
-
-      LongOperation* effect =
-          EffectFactory::BuildFromSEL(machine, after, before, sel);
-      machine.PushLongOperation(effect);
+      std::shared_ptr<Surface> after = RenderForEffect(machine);
+      PerformBgrEffect(machine, after, before, sel);
     }
   }
 };
@@ -180,7 +187,7 @@ struct bgrMulti_1
     GraphicsSystem& graphics = machine.system().graphics();
 
     // Get the state of the world before we do any processing.
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     graphics.set_graphics_background(BACKGROUND_HIK);
 
@@ -236,10 +243,8 @@ struct bgrMulti_1
     if (!machine.replaying_graphics_stack())
       graphics.ClearAndPromoteObjects();
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
-    LongOperation* effect =
-        EffectFactory::BuildFromSEL(machine, after, before, effectNum);
-    machine.PushLongOperation(effect);
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
+    PerformBgrEffect(machine, after, before, effectNum);
   }
 };
 
@@ -81,7 +81,7 @@ struct WaitForGanToFinish : public LongOperation {
   }
 
   bool operator()(RLMachine& machine) {
-    GraphicsObject& obj = GetObject(machine);
+    const GraphicsObject& obj = GetObject(machine);
     bool done = true;
 
     if (obj.has_object_data()) {
@@ -98,7 +98,7 @@ struct WaitForGanToFinish : public LongOperation {
     return done;
   }
 
-  GraphicsObject& GetObject(RLMachine& machine) {
+  const GraphicsObject& GetObject(RLMachine& machine) {
     GraphicsSystem& graphics = machine.system().graphics();
 
     if (parent_ != -1) {
@@ -107,7 +107,9 @@ struct WaitForGanToFinish : public LongOperation {
       return static_cast<ParentGraphicsObjectData&>(parent.GetObjectData())
           .GetObject(buf_);
     } else {
-      return graphics.GetObject(fgbg_, buf_);
+      // Polled every frame until the animation ends; don't journal it.
+      return static_cast<const GraphicsSystem&>(graphics)
+          .GetObject(fgbg_, buf_);
     }
   }
 
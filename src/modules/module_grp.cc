@@ -146,10 +146,12 @@ void performEffect(RLMachine& machine,
                    const std::shared_ptr<Surface>& src,
                    const std::shared_ptr<Surface>& dst,
                    int selnum) {
-  if (!machine.replaying_graphics_stack()) {
-    LongOperation* lop = EffectFactory::BuildFromSEL(machine, src, dst, selnum);
-    machine.PushLongOperation(lop);
-  }
+  // RenderForEffect() already decided to skip the effect.
+  if (!src || !dst)
+    return;
+
+  LongOperation* lop = EffectFactory::BuildFromSEL(machine, src, dst, selnum);
+  machine.PushLongOperation(lop);
 }
 
 void performEffect(RLMachine& machine,
@@ -164,21 +166,23 @@ void performEffect(RLMachine& machine,
                    int a,
                    int b,
                    int c) {
-  if (!machine.replaying_graphics_stack()) {
-    LongOperation* lop = EffectFactory::Build(machine,
-                                              src,
-                                              dst,
-                                              time,
-                                              style,
-                                              direction,
-                                              interpolation,
-                                              xsize,
-                                              ysize,
-                                              a,
-                                              b,
-                                              c);
-    machine.PushLongOperation(lop);
-  }
+  // RenderForEffect() already decided to skip the effect.
+  if (!src || !dst)
+    return;
+
+  LongOperation* lop = EffectFactory::Build(machine,
+                                            src,
+                                            dst,
+                                            time,
+                                            style,
+                                            direction,
+                                            interpolation,
+                                            xsize,
+                                            ysize,
+                                            a,
+                                            b,
+                                            c);
+  machine.PushLongOperation(lop);
 }
 
 // We don't hide text windows when replaying the stack because hiding the
@@ -318,14 +322,12 @@ struct display_1
     Point dest;
     GetSELPointAndRect(machine, effectNum, src, dest);
 
-    GraphicsSystem& graphics = machine.system().graphics();
-
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     loadDCToDC1(machine, dc, src, dest, opacity);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine, after, before, effectNum);
   }
 };
@@ -351,14 +353,12 @@ struct display_3 : public RLOpcode<IntConstant_T,
                   Rect srcRect,
                   Point dest,
                   int opacity) {
-    GraphicsSystem& graphics = machine.system().graphics();
-
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     loadDCToDC1(machine, dc, srcRect, dest, opacity);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine, after, before, effectNum);
   }
 };
@@ -404,14 +404,12 @@ struct display_4 : public RLOpcode<IntConstant_T,
                   int b,
                   int opacity,
                   int c) {
-    GraphicsSystem& graphics = machine.system().graphics();
-
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     loadDCToDC1(machine, dc, srcRect, dest, opacity);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine,
                   after,
                   before,
@@ -452,13 +450,12 @@ struct open_1
     Point dest;
     GetSELPointAndRect(machine, effectNum, src, dest);
 
-    GraphicsSystem& graphics = machine.system().graphics();
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     loadImageToDC1(machine, filename, src, dest, opacity, use_alpha_);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine, after, before, effectNum);
     performHideAllTextWindows(machine);
   }
@@ -494,16 +491,14 @@ struct open_3 : public RLOpcode<StrConstant_T,
                   Rect srcRect,
                   Point dest,
                   int opacity) {
-    GraphicsSystem& graphics = machine.system().graphics();
-
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     // Kanon uses the recOpen('?', ...) form for rendering Last Regrets. This
     // isn't documented in the rldev manual.
     loadImageToDC1(machine, filename, srcRect, dest, opacity, use_alpha_);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine, after, before, effectNum);
     performHideAllTextWindows(machine);
   }
@@ -562,16 +557,14 @@ struct open_4 : public RLOpcode<StrConstant_T,
                   int b,
                   int opacity,
                   int c) {
-    GraphicsSystem& graphics = machine.system().graphics();
-
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     // Kanon uses the recOpen('?', ...) form for rendering Last Regrets. This
     // isn't documented in the rldev manual.
     loadImageToDC1(machine, fileName, srcRect, dest, opacity, use_alpha_);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine,
                   after,
                   before,
@@ -594,19 +587,18 @@ struct openBg_1
                   string fileName,
                   int effectNum,
                   int opacity) {
-    GraphicsSystem& graphics = machine.system().graphics();
     Rect srcRect;
     Point destPoint;
     GetSELPointAndRect(machine, effectNum, srcRect, destPoint);
 
     OpenBgPrelude(machine, fileName);
 
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     loadImageToDC1(machine, fileName, srcRect, destPoint, opacity, false);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine, after, before, effectNum);
     performHideAllTextWindows(machine);
   }
@@ -636,16 +628,15 @@ struct openBg_3 : public RLOpcode<StrConstant_T,
                   Rect srcRect,
                   Point destPt,
                   int opacity) {
-    GraphicsSystem& graphics = machine.system().graphics();
     OpenBgPrelude(machine, fileName);
 
     // Set the long operation for the correct transition long operation
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     loadImageToDC1(machine, fileName, srcRect, destPt, opacity, use_alpha_);
     blitDC1toDC0(machine);
 
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine, after, before, effectNum);
     performHideAllTextWindows(machine);
   }
@@ -698,17 +689,16 @@ struct openBg_4 : public RLOpcode<StrConstant_T,
                   int b,
                   int opacity,
                   int c) {
-    GraphicsSystem& graphics = machine.system().graphics();
     OpenBgPrelude(machine, fileName);
 
     // Set the long operation for the correct transition long operation
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
 
     loadImageToDC1(machine, fileName, srcRect, destPt, opacity, use_alpha_);
     blitDC1toDC0(machine);
 
     // Render the screen to a temporary
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
     performEffect(machine,
                   after,
                   before,
@@ -890,9 +880,9 @@ struct fade_7
     : public RLOpcode<Rect_T<SPACE>, RGBColour_T, DefaultIntValue_T<0>> {
   void operator()(RLMachine& machine, Rect rect, RGBAColour colour, int time) {
     GraphicsSystem& graphics = machine.system().graphics();
-    std::shared_ptr<Surface> before = graphics.RenderToSurface();
+    std::shared_ptr<Surface> before = RenderForEffect(machine);
     graphics.GetDC(0)->Fill(colour, rect);
-    std::shared_ptr<Surface> after = graphics.RenderToSurface();
+    std::shared_ptr<Surface> after = RenderForEffect(machine);
 
     if (time > 0) {
       performEffect(machine, after, before, time, 0, 0, 0, 0, 0, 0, 0, 0);
@@ -1196,6 +1186,23 @@ class GrpStackAdapter : public RLOp_SpecialCase {
 
 }  // namespace
 
+// -----------------------------------------------------------------------
+
+bool ShouldSkipEffect(RLMachine& machine) {
+  return machine.replaying_graphics_stack() ||
+         machine.system().ShouldFastForward();
+}
+
+// -----------------------------------------------------------------------
+
+std::shared_ptr<Surface> RenderForEffect(RLMachine& machine) {
+  if (ShouldSkipEffect(machine))
+    return std::shared_ptr<Surface>();
+  return machine.system().graphics().RenderToSurface();
+}
+
+// -----------------------------------------------------------------------
+
 RLOperation* GraphicsStackMappingFun(RLOperation* op) {
   return new GrpStackAdapter(op);
 }
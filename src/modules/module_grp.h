@@ -29,6 +29,7 @@
 #define SRC_MODULES_MODULE_GRP_H_
 
 #include <deque>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -36,6 +37,7 @@
 #include "machine/rloperation.h"
 
 class GraphicsStackFrame;
+class Surface;
 
 // Contains functions for mod<1:33>, Grp.
 class GrpModule : public MappedRLModule {
@@ -49,6 +51,16 @@ RLOperation* GraphicsStackMappingFun(RLOperation* op);
 
 // -----------------------------------------------------------------------
 
+// Whether a transition effect won't be shown: while replaying the graphics
+// stack, or while fast forwarding, where it would end on its first frame.
+bool ShouldSkipEffect(RLMachine& machine);
+
+// Renders the screen as one end of a transition effect. Returns NULL instead
+// of doing two full screen renders per transition when the effect is going to
+// be skipped. The effect helpers skip any effect that is missing either end,
+// so this is the only place that decides.
+std::shared_ptr<Surface> RenderForEffect(RLMachine& machine);
+
 // Replays the new Graphics stack, string representations of reallive bytecode.
 void ReplayGraphicsStackCommand(RLMachine& machine,
                                 const std::deque<std::string>& stack);
@@ -60,34 +60,12 @@ int EvaluateCase(RLMachine& machine, const CommandElement& goto_element) {
   const ExpressionPiecesVector& conditions = goto_element.GetParsedParameters();
   int value = conditions[0].GetIntegerValue(machine);
 
-  // Walk linearly through the output cases, executing the first
-  // match against value.
-  int cases = goto_element.GetCaseCount();
-  for (int i = 0; i < cases; ++i) {
-    std::string caseUnparsed = goto_element.GetCase(i);
-
-    // Check for bytecode wellformedness. All cases should be
-    // surrounded by parens
-    if (caseUnparsed[0] != '(' || caseUnparsed[caseUnparsed.size() - 1] != ')')
-      throw rlvm::Exception("Malformed bytecode in goto_case statment");
-
-    // In the case of an empty set of parens, always accept. It is
-    // the bytecode representation for the default case.
-    if (caseUnparsed == "()")
-      return i;
-
-    // Strip the parens for parsing
-    caseUnparsed = caseUnparsed.substr(1, caseUnparsed.size() - 2);
-
-    // Parse this expression, and goto the corresponding label if
-    // it's equal to the value we're searching for
-    const char* e = (const char*)caseUnparsed.c_str();
-    libreallive::ExpressionPiece output(libreallive::GetExpression(e));
-    if (output.GetIntegerValue(machine) == value)
-      return i;
-  }
-
-  throw rlvm::Exception("Malformed bytecode: no default case");
+  // The element compiles its case labels into a jump table the first time
+  // through, so this doesn't reparse them.
+  int i = goto_element.FindCase(machine, value);
+  if (i == -1)
+    throw rlvm::Exception("Malformed bytecode: no default case");
+  return i;
 }
 
 // -----------------------------------------------------------------------
@@ -30,18 +30,73 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <sstream>
 #include <vector>
 
+#include "libreallive/intmemref.h"
+#include "machine/memory.h"
 #include "machine/rloperation.h"
 #include "machine/rloperation/argc_t.h"
 #include "machine/rloperation/complex_t.h"
 #include "machine/rloperation/rlop_store.h"
 #include "machine/rloperation/references.h"
+#include "utilities/exception.h"
 
 // -----------------------------------------------------------------------
 
 namespace {
 
+// The Mem opcodes work on whole ranges, so hand them to Memory's range
+// kernels instead of going through an IntAccessor per element. The fallback
+// loops only run for the store register.
+
+libreallive::IntMemRef RefOf(const IntReferenceIterator& it) {
+  return libreallive::IntMemRef(it.type(), it.location());
+}
+
+// Returns the number of locations in the inclusive RealLive range [first,
+// last].
+int InclusiveCount(const IntReferenceIterator& first,
+                   const IntReferenceIterator& last) {
+  if (first.memory() != last.memory() || first.type() != last.type() ||
+      last.location() < first.location() - 1) {
+    std::ostringstream ss;
+    ss << "Invalid memory range " << RefOf(first) << " to " << RefOf(last);
+    throw rlvm::Exception(ss.str());
+  }
+  return last.location() - first.location() + 1;
+}
+
+void FillRange(IntReferenceIterator first, int count, int step, int value) {
+  if (first.memory()) {
+    first.memory()->FillIntRange(RefOf(first), count, step, value);
+  } else {
+    for (int i = 0; i < count; ++i, first += step)
+      *first = value;
+  }
+}
+
+void SetRange(IntReferenceIterator first,
+              int step,
+              const std::vector<int>& values) {
+  if (first.memory()) {
+    first.memory()->SetIntRange(RefOf(first), step, values.data(),
+                                values.size());
+  } else {
+    for (int value : values) {
+      *first = value;
+      first += step;
+    }
+  }
+}
+
+int SumRange(IntReferenceIterator first, IntReferenceIterator last) {
+  int count = InclusiveCount(first, last);
+  if (first.memory())
+    return first.memory()->SumIntRange(RefOf(first), count);
+  return std::accumulate(first, first + count, 0);
+}
+
 // Implement op<1:Mem:00000, 0>, fun setarray(int, intC+).
 //
 // Sets a block of integers, starting with origin, to the given values. values
@@ -51,7 +106,7 @@ struct setarray : public RLOpcode<IntReference_T, Argc_T<IntConstant_T>> {
   void operator()(RLMachine& machine,
                   IntReferenceIterator origin,
                   std::vector<int> values) {
-    copy(values.begin(), values.end(), origin);
+    SetRange(origin, 1, values);
   }
 };
 
@@ -62,8 +117,8 @@ struct setrng_0 : public RLOpcode<IntReference_T, IntReference_T> {
   void operator()(RLMachine& machine,
                   IntReferenceIterator first,
                   IntReferenceIterator last) {
-    ++last;  // RealLive ranges are inclusive
-    std::fill(first, last, 0);
+    // RealLive ranges are inclusive
+    FillRange(first, InclusiveCount(first, last), 1, 0);
   }
 };
 
@@ -76,8 +131,8 @@ struct setrng_1
                   IntReferenceIterator first,
                   IntReferenceIterator last,
                   int value) {
-    ++last;  // RealLive ranges are inclusive
-    std::fill(first, last, value);
+    // RealLive ranges are inclusive
+    FillRange(first, InclusiveCount(first, last), 1, value);
   }
 };
 
@@ -91,9 +146,13 @@ struct cpyrng
                   IntReferenceIterator source,
                   IntReferenceIterator dest,
                   int count) {
-    std::vector<int> tmpCopy;
-    std::copy_n(source, count, std::back_inserter(tmpCopy));
-    std::copy(tmpCopy.begin(), tmpCopy.end(), dest);
+    if (source.memory() && source.memory() == dest.memory()) {
+      source.memory()->CopyIntRange(RefOf(source), RefOf(dest), count);
+    } else {
+      std::vector<int> tmpCopy;
+      std::copy_n(source, count, std::back_inserter(tmpCopy));
+      std::copy(tmpCopy.begin(), tmpCopy.end(), dest);
+    }
   }
 };
 
@@ -107,13 +166,7 @@ struct setarray_stepped
                   IntReferenceIterator origin,
                   int step,
                   std::vector<int> values) {
-    // Sigh. No more simple STL statements
-    for (std::vector<int>::iterator it = values.begin();
-         it != values.end();
-         ++it) {
-      *origin = *it;
-      std::advance(origin, step);
-    }
+    SetRange(origin, step, values);
   }
 };
 
@@ -127,10 +180,7 @@ struct setrng_stepped_0
                   IntReferenceIterator origin,
                   int step,
                   int count) {
-    for (int i = 0; i < count; ++i) {
-      *origin = 0;
-      std::advance(origin, step);
-    }
+    FillRange(origin, count, step, 0);
   }
 };
 
@@ -147,10 +197,7 @@ struct setrng_stepped_1 : public RLOpcode<IntReference_T,
                   int step,
                   int count,
                   int value) {
-    for (int i = 0; i < count; ++i) {
-      *origin = value;
-      std::advance(origin, step);
-    }
+    FillRange(origin, count, step, value);
   }
 };
 
@@ -181,8 +228,7 @@ struct sum : public RLStoreOpcode<IntReference_T, IntReference_T> {
   int operator()(RLMachine& machine,
                  IntReferenceIterator first,
                  IntReferenceIterator last) {
-    last++;
-    return std::accumulate(first, last, 0);
+    return SumRange(first, last);
   }
 };
 
@@ -196,11 +242,8 @@ struct sums
       std::vector<std::tuple<IntReferenceIterator,
       IntReferenceIterator>> ranges) {
     int total = 0;
-    for (auto it = ranges.cbegin(); it != ranges.cend(); ++it) {
-      IntReferenceIterator last = std::get<1>(*it);
-      ++last;
-      total += std::accumulate(std::get<0>(*it), last, 0);
-    }
+    for (auto it = ranges.cbegin(); it != ranges.cend(); ++it)
+      total += SumRange(std::get<0>(*it), std::get<1>(*it));
     return total;
   }
 };
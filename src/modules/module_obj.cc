@@ -68,6 +68,30 @@ GraphicsObject& GetGraphicsObject(RLMachine& machine,
   }
 }
 
+const GraphicsObject& GetGraphicsObjectForReading(RLMachine& machine,
+                                                  RLOperation* op,
+                                                  int obj) {
+  const GraphicsSystem& graphics = machine.system().graphics();
+
+  int fgbg;
+  if (!op->GetProperty(P_FGBG, fgbg))
+    fgbg = OBJ_FG;
+
+  int parentobj;
+  if (op->GetProperty(P_PARENTOBJ, parentobj)) {
+    const GraphicsObject& parent = graphics.GetObject(fgbg, parentobj);
+    if (!parent.has_object_data() ||
+        !parent.GetObjectData().IsParentLayer()) {
+      // Looking inside a non parent object turns it into one.
+      return GetGraphicsObject(machine, op, obj);
+    }
+    return static_cast<const ParentGraphicsObjectData&>(
+               parent.GetObjectData()).objects()[obj];
+  } else {
+    return graphics.GetObject(fgbg, obj);
+  }
+}
+
 LazyArray<GraphicsObject>& GetGraphicsObjects(RLMachine& machine,
                                               RLOperation* op) {
   GraphicsSystem& graphics = machine.system().graphics();
@@ -41,6 +41,12 @@ void EnsureIsParentObject(GraphicsObject& parent, int size);
 
 GraphicsObject& GetGraphicsObject(RLMachine& machine, RLOperation* op, int obj);
 
+// Like GetGraphicsObject(), but for opcodes that only look at the object, so
+// it isn't copied into the savepoint journal.
+const GraphicsObject& GetGraphicsObjectForReading(RLMachine& machine,
+                                                  RLOperation* op,
+                                                  int obj);
+
 LazyArray<GraphicsObject>& GetGraphicsObjects(RLMachine& machine,
                                               RLOperation* op);
 
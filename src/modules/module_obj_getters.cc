@@ -47,7 +47,8 @@ class Obj_GetInt : public RLStoreOpcode<IntConstant_T> {
   virtual ~Obj_GetInt() {}
 
   virtual int operator()(RLMachine& machine, int buf) {
-    GraphicsObject& obj = GetGraphicsObject(machine, this, buf);
+    const GraphicsObject& obj =
+        GetGraphicsObjectForReading(machine, this, buf);
     return ((obj).*(getter_))();
   }
 
@@ -67,7 +68,8 @@ struct objGetPos
                   int objNum,
                   IntReferenceIterator xIt,
                   IntReferenceIterator yIt) {
-    GraphicsObject& obj = GetGraphicsObject(machine, this, objNum);
+    const GraphicsObject& obj =
+        GetGraphicsObjectForReading(machine, this, objNum);
     *xIt = obj.x();
     *yIt = obj.y();
   }
@@ -78,7 +80,8 @@ struct objGetAdjust : public RLOpcode<IntConstant_T, IntConstant_T,
   void operator()(RLMachine& machine, int objNum, int repno,
                   IntReferenceIterator xIt,
                   IntReferenceIterator yIt) {
-    GraphicsObject& obj = GetGraphicsObject(machine, this, objNum);
+    const GraphicsObject& obj =
+        GetGraphicsObjectForReading(machine, this, objNum);
     *xIt = obj.x_adjustment(repno);
     *yIt = obj.y_adjustment(repno);
   }
@@ -86,14 +89,16 @@ struct objGetAdjust : public RLOpcode<IntConstant_T, IntConstant_T,
 
 struct objGetAdjustX : public RLStoreOpcode<IntConstant_T, IntConstant_T> {
   int operator()(RLMachine& machine, int objNum, int repno) {
-    GraphicsObject& obj = GetGraphicsObject(machine, this, objNum);
+    const GraphicsObject& obj =
+        GetGraphicsObjectForReading(machine, this, objNum);
     return obj.x_adjustment(repno);
   }
 };
 
 struct objGetAdjustY : public RLStoreOpcode<IntConstant_T, IntConstant_T> {
   int operator()(RLMachine& machine, int objNum, int repno) {
-    GraphicsObject& obj = GetGraphicsObject(machine, this, objNum);
+    const GraphicsObject& obj =
+        GetGraphicsObjectForReading(machine, this, objNum);
     return obj.y_adjustment(repno);
   }
 };
@@ -110,7 +115,8 @@ struct objGetDims : public RLOpcode<IntConstant_T,
                   IntReferenceIterator widthIt,
                   IntReferenceIterator heightIt,
                   int unknown) {
-    GraphicsObject& obj = GetGraphicsObject(machine, this, objNum);
+    const GraphicsObject& obj =
+        GetGraphicsObjectForReading(machine, this, objNum);
     *widthIt = obj.PixelWidth();
     *heightIt = obj.PixelHeight();
   }
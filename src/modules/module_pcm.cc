@@ -42,6 +42,13 @@ bool NoLongerPlaying(RLMachine& machine, int channel) {
   return !machine.system().sound().WavPlaying(channel);
 }
 
+// One shot sound effects are dropped while fast forwarding; nobody will hear
+// them and decoding them is most of the cost of playing them. Loops are still
+// started since they outlive the skipped section.
+bool ShouldSkipOneShot(RLMachine& machine) {
+  return machine.system().ShouldFastForward();
+}
+
 void addPcmWait(RLMachine& machine, int channel) {
   WaitLongOperation* wait_op = new WaitLongOperation(machine);
   wait_op->BreakOnEvent(std::bind(NoLongerPlaying, std::ref(machine), channel));
@@ -50,12 +57,16 @@ void addPcmWait(RLMachine& machine, int channel) {
 
 struct wavPlay_0 : public RLOpcode<StrConstant_T> {
   void operator()(RLMachine& machine, std::string fileName) {
+    if (ShouldSkipOneShot(machine))
+      return;
     machine.system().sound().WavPlay(fileName, false);
   }
 };
 
 struct wavPlay_1 : public RLOpcode<StrConstant_T, IntConstant_T> {
   void operator()(RLMachine& machine, std::string fileName, int channel) {
+    if (ShouldSkipOneShot(machine))
+      return;
     machine.system().sound().WavPlay(fileName, false, channel);
   }
 };
@@ -66,12 +77,16 @@ struct wavPlay_2
                   std::string fileName,
                   int channel,
                   int fadein) {
+    if (ShouldSkipOneShot(machine))
+      return;
     machine.system().sound().WavPlay(fileName, false, channel, fadein);
   }
 };
 
 struct wavPlayEx_0 : public RLOpcode<StrConstant_T, IntConstant_T> {
   void operator()(RLMachine& machine, std::string fileName, int channel) {
+    if (ShouldSkipOneShot(machine))
+      return;
     machine.system().sound().WavPlay(fileName, false, channel);
     addPcmWait(machine, channel);
   }
@@ -83,6 +98,8 @@ struct wavPlayEx_1
                   std::string fileName,
                   int channel,
                   int fadein) {
+    if (ShouldSkipOneShot(machine))
+      return;
     machine.system().sound().WavPlay(fileName, false, channel, fadein);
     addPcmWait(machine, channel);
   }
@@ -43,7 +43,7 @@ bool MutatorIsDone(RLMachine& machine,
                    int obj,
                    int repno,
                    const std::string& name) {
-  return GetGraphicsObject(machine, op, obj)
+  return GetGraphicsObjectForReading(machine, op, obj)
              .IsMutatorRunningMatching(repno, name) == false;
 }
 
@@ -52,7 +52,7 @@ bool ObjectMutatorIsWorking(RLMachine& machine,
                             int obj,
                             int repno,
                             const std::string& name) {
-  return GetGraphicsObject(machine, op, obj)
+  return GetGraphicsObjectForReading(machine, op, obj)
              .IsMutatorRunningMatching(repno, name) == false;
 }
 
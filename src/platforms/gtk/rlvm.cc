@@ -87,18 +87,33 @@ int main(int argc, char* argv[]) {
   opts.add_options()("help", "Produce help message")(
       "help-debug", "Print help message for people working on rlvm")(
       "version", "Display version and license information")(
-      "font", po::value<string>(), "Specifies TrueType font to use.");
+      "font", po::value<string>(), "Specifies TrueType font to use.")(
+      "se-bank-size", po::value<int>(),
+      "Megabytes of decoded sound effects to keep in memory (default 16)")(
+      "image-cache", po::value<int>(),
+      "Megabytes of decoded images to keep on disk between sessions "
+      "(off by default)")(
+      "compress-image-cache",
+      "Compress the image cache; smaller, but slower to read back");
 
   po::options_description debugOpts("Debugging Options");
   debugOpts.add_options()(
       "start-seen", po::value<int>(), "Force start at SEEN#")(
       "dump-seen", po::value<int>(), "Dumps rlvm's internal parsing of SEEN#")(
+      "dump-cfg", po::value<int>(),
+      "Dumps the control flow graph and resources of SEEN#")(
       "load-save", po::value<int>(), "Load a saved game on start")(
       "memory", "Forces debug mode (Sets #MEMORY=1 in the Gameexe.ini file)")(
       "undefined-opcodes", "Display a message on undefined opcodes")(
       "count-undefined",
       "On exit, present a summary table about how many times each undefined "
-      "opcode was called")("trace", "Prints opcodes as they are run)");
+      "opcode was called")("trace", "Prints opcodes as they are run)")(
+      "profile", po::value<string>(),
+      "Profile opcodes, lines and long operations; on exit, write a Chrome "
+      "trace to this file and a summary to stderr (needs scons --profiler)")(
+      "startup-profile",
+      "Print how long each startup stage took, and the time to the first "
+      "frame, to stderr");
 
   // Declare the final option to be game-root
   po::options_description hidden("Hidden");
@@ -198,6 +213,9 @@ int main(int argc, char* argv[]) {
   if (vm.count("dump-seen"))
     instance.set_dump_seen(vm["dump-seen"].as<int>());
 
+  if (vm.count("dump-cfg"))
+    instance.set_dump_cfg(vm["dump-cfg"].as<int>());
+
   if (vm.count("memory"))
     instance.set_memory();
 
@@ -210,12 +228,27 @@ int main(int argc, char* argv[]) {
   if (vm.count("trace"))
     instance.set_tracing();
 
+  if (vm.count("profile"))
+    instance.set_profile_output(vm["profile"].as<string>());
+
+  if (vm.count("startup-profile"))
+    instance.set_startup_profile();
+
   if (vm.count("load-save"))
     instance.set_load_save(vm["load-save"].as<int>());
 
   if (vm.count("font"))
     instance.set_custom_font(vm["font"].as<string>());
 
+  if (vm.count("se-bank-size"))
+    instance.set_se_bank_size(vm["se-bank-size"].as<int>());
+
+  if (vm.count("image-cache"))
+    instance.set_image_cache_size(vm["image-cache"].as<int>());
+
+  if (vm.count("compress-image-cache"))
+    instance.set_image_cache_compression();
+
   instance.Run(gamerootPath);
 
   return 0;
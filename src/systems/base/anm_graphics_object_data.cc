@@ -36,6 +36,7 @@
 #include "machine/serialization.h"
 #include "systems/base/anm_graphics_object_data.h"
 
+#include <climits>
 #include <iterator>
 #include <fstream>
 #include <string>
@@ -196,6 +197,13 @@ void AnmGraphicsObjectData::Execute(RLMachine& machine) {
     AdvanceFrame();
 }
 
+unsigned int AnmGraphicsObjectData::NextWakeupTime() const {
+  if (!is_currently_playing())
+    return UINT_MAX;
+
+  return time_at_last_frame_change_ + frames[current_frame_].time + 1;
+}
+
 bool AnmGraphicsObjectData::IsAnimation() const {
   return true;
 }
@@ -57,6 +57,7 @@ class AnmGraphicsObjectData : public GraphicsObjectData {
 
   virtual GraphicsObjectData* Clone() const override;
   virtual void Execute(RLMachine& machine) override;
+  virtual unsigned int NextWakeupTime() const override;
 
   virtual bool IsAnimation() const override;
   virtual void PlaySet(int set) override;
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
 #include "systems/base/colour.h"
 #include "systems/base/system.h"
@@ -40,14 +41,15 @@
 #include "systems/base/surface.h"
 
 DigitsGraphicsObject::DigitsGraphicsObject(System& system)
-    : system_(system), value_(0) {}
+    : system_(system), value_(0), digit_pixel_width_(0) {}
 
 DigitsGraphicsObject::DigitsGraphicsObject(System& system,
                                            const std::string& font)
     : system_(system),
       value_(0),
       font_name_(font),
-      font_(system.graphics().GetSurfaceNamed(font)) {}
+      font_(system.graphics().GetSurfaceNamed(font)),
+      digit_pixel_width_(0) {}
 
 DigitsGraphicsObject::~DigitsGraphicsObject() {}
 
@@ -98,50 +100,84 @@ void DigitsGraphicsObject::UpdateSurface(const GraphicsObject& rp) {
   if (value_ < 0 || rp.GetDigitSign())
     num_extra++;
 
-  int total_pixel_width = (num_chars + num_extra) * digit_pixel_width;
+  int num_cells = num_chars + num_extra;
+  Size size(num_cells * digit_pixel_width,
+            font_->GetPattern(0).rect.size().height());
 
-  surface_ = system_.graphics().BuildSurface(
-      Size(total_pixel_width, font_->GetPattern(0).rect.size().height()));
-  surface_->Fill(RGBAColour::Clear());
-
-  // We draw glyphs onto the canvas from right to left so we can use the
-  // obvious div/mod method to get the current digit to display.
-  int printed_number = std::abs(value_);
-  int x_offset = total_pixel_width - digit_pixel_width;
-  int i = printed_number;
+  // Work out which glyph goes in each cell. We fill the cells from right to
+  // left so we can use the obvious div/mod method to get the current digit to
+  // display.
+  std::vector<int> cells(num_cells, -1);
+  int cell = num_cells - 1;
+  int i = std::abs(value_);
   int printed = 0;
   do {
-    int digit = i % 10;
-    const Surface::GrpRect& grp = font_->GetPattern(digit);
-
-    font_->BlitToSurface(
-        *surface_, grp.rect, Rect(x_offset, 0, grp.rect.size()), 255, false);
+    if (cell >= 0)
+      cells[cell] = i % 10;
 
     i = i / 10;
     printed++;
-    x_offset -= digit_pixel_width;
+    cell--;
   } while (i > 0);
 
-  const Surface::GrpRect& zero_grp = font_->GetPattern(0);
   bool print_zeros = rp.GetDigitZero();
   while (printed < num_chars) {
-    if (print_zeros) {
-      font_->BlitToSurface(*surface_,
-                           zero_grp.rect,
-                           Rect(x_offset, 0, zero_grp.rect.size()),
-                           255,
-                           false);
-    }
+    if (print_zeros && cell >= 0)
+      cells[cell] = 0;
     printed++;
-    x_offset -= digit_pixel_width;
+    cell--;
   }
 
+  // When the layout hasn't changed, only redraw the cells whose digit did.
+  // That isn't safe if a clone of this object shares our surface, or if
+  // glyphs spill over into their neighbours' cells.
+  bool incremental = surface_ && surface_.use_count() == 1 &&
+                     surface_->GetSize() == size &&
+                     digit_pixel_width == digit_pixel_width_;
+  for (int digit = 0; incremental && digit < 10; ++digit) {
+    incremental =
+        font_->GetPattern(digit).rect.size().width() <= digit_pixel_width;
+  }
+
+  if (incremental) {
+    for (int c = 0; c < num_cells; ++c) {
+      if (cells[c] != cells_[c])
+        DrawCell(c, cells[c], true);
+    }
+  } else {
+    GraphicsSystem& graphics = system_.graphics();
+    graphics.RecycleSurface(std::move(surface_));
+    surface_ = graphics.BuildPooledSurface(size);
+    surface_->Fill(RGBAColour::Clear());
+
+    digit_pixel_width_ = digit_pixel_width;
+    for (int c = 0; c < num_cells; ++c)
+      DrawCell(c, cells[c], false);
+  }
+  cells_.swap(cells);
+
   if (value_ < 0 || rp.GetDigitSign()) {
     std::cerr << "We don't support negative numbers in objOfDigits() yet."
               << std::endl;
   }
 }
 
+void DigitsGraphicsObject::DrawCell(int cell, int glyph, bool clear) {
+  int x_offset = cell * digit_pixel_width_;
+  if (clear) {
+    surface_->Fill(RGBAColour::Clear(),
+                   Rect(x_offset, 0, Size(digit_pixel_width_,
+                                          surface_->GetSize().height())));
+  }
+
+  if (glyph == -1)
+    return;
+
+  const Surface::GrpRect& grp = font_->GetPattern(glyph);
+  font_->BlitToSurface(
+      *surface_, grp.rect, Rect(x_offset, 0, grp.rect.size()), 255, false);
+}
+
 bool DigitsGraphicsObject::NeedsUpdate(const GraphicsObject& rp) {
   return !surface_ || rp.GetDigitValue() != value_;
 }
@@ -154,6 +190,7 @@ void DigitsGraphicsObject::load(Archive& ar, unsigned int version) {
 
   value_ = 0;
   surface_.reset();
+  cells_.clear();
   font_ = system_.graphics().GetSurfaceNamed(font_name_);
 }
 
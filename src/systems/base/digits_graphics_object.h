@@ -31,6 +31,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "machine/rlmachine.h"
 #include "machine/serialization.h"
@@ -61,6 +62,10 @@ class DigitsGraphicsObject : public GraphicsObjectData {
   void UpdateSurface(const GraphicsObject& rp);
   bool NeedsUpdate(const GraphicsObject& rendering_properties);
 
+  // Draws the pattern |glyph| (or nothing, for -1) into digit cell |cell| of
+  // |surface_|, counting from the left.
+  void DrawCell(int cell, int glyph, bool clear);
+
   System& system_;
 
   // The actual numerical value to display.
@@ -73,6 +78,13 @@ class DigitsGraphicsObject : public GraphicsObjectData {
   // The current composited surface.
   std::shared_ptr<Surface> surface_;
 
+  // The width of one digit cell in |surface_|.
+  int digit_pixel_width_;
+
+  // The pattern drawn in each cell of |surface_|, left to right, or -1 for
+  // an empty cell. Lets UpdateSurface() redraw only the digits that changed.
+  std::vector<int> cells_;
+
   // boost::serialization support
   friend class boost::serialization::access;
 
@@ -30,6 +30,9 @@
 
 #include "systems/base/drift_graphics_object.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <string>
 #include <vector>
 
@@ -56,6 +59,22 @@ double ScaleAmplitude(int amplitude) {
 
 }  // namespace
 
+// -----------------------------------------------------------------------
+// DriftGraphicsObject::Particles
+// -----------------------------------------------------------------------
+void DriftGraphicsObject::Particles::Add(int x,
+                                         int y,
+                                         int alpha,
+                                         int start_time) {
+  this->x.push_back(x);
+  this->y.push_back(y);
+  this->alpha.push_back(alpha);
+  this->start_time.push_back(start_time);
+}
+
+// -----------------------------------------------------------------------
+// DriftGraphicsObject
+// -----------------------------------------------------------------------
 DriftGraphicsObject::DriftGraphicsObject(System& system)
     : system_(system), filename_(), surface_(), last_rendered_time_(0) {}
 
@@ -101,71 +120,84 @@ void DriftGraphicsObject::Render(const GraphicsObject& go,
     double scaled_amplitude =
         bounding_box.size().width() * ScaleAmplitude(amplitude);
 
+    int area_width = bounding_box.size().width();
+    int area_height = bounding_box.size().height();
+
     // Grab the drift object
     if (particles_.size() < count) {
-      Particle p;
-      p.x = rand() % bounding_box.size().width();   // NOLINT
-      p.y = rand() % bounding_box.size().height();  // NOLINT
-      p.alpha = 255;
-      p.start_time = current_time;
-
-      particles_.push_back(p);
+      particles_.Add(rand() % area_width,   // NOLINT
+                     rand() % area_height,  // NOLINT
+                     255,
+                     current_time);
     }
 
-    // Now that we have all the particles, update state and render each
-    // particle.
-    for (const Particle& particle : particles_) {
-      int pattern = start_pattern;
-      if (use_animation && end_pattern > start_pattern) {
-        int number_of_patterns = end_pattern - start_pattern + 1;
-        int frame_time = animation_time / number_of_patterns;
-        int frame_number = ((current_time - particle.start_time) / frame_time) %
-                           number_of_patterns;
-        pattern = start_pattern + frame_number;
-      }
-      Rect src = surface->GetPattern(pattern).rect;
+    // Now that we have all the particles, update their positions.
+    size_t n = particles_.size();
+    ages_.resize(n);
+    dest_x_.resize(n);
+    dest_y_.resize(n);
+    for (size_t i = 0; i < n; ++i)
+      ages_[i] = current_time - particles_.start_time[i];
+
+    // Add the base yspeed.
+    for (size_t i = 0; i < n; ++i) {
+      dest_y_[i] =
+          particles_.y[i] +
+          area_height * (static_cast<double>(ages_[i] % yspeed) /
+                         static_cast<double>(yspeed));
+    }
 
-      int dest_x = particle.x;
-      int dest_y = particle.y;
-
-      // Add the base yspeed.
-      dest_y +=
-          bounding_box.size().height() *
-          (static_cast<double>((current_time - particle.start_time) % yspeed) /
-           static_cast<double>(yspeed));
-
-      // Add the sine wave that defines how the particle moves back and forth.
-      if (period != 0 && amplitude != 0) {
-        double result = sin(
-            (static_cast<double>(current_time - particle.start_time) / period) *
-            (2 * 3.14));
-        dest_x += scaled_amplitude * result;
+    // Add the sine wave that defines how the particle moves back and forth.
+    std::copy(particles_.x.begin(), particles_.x.end(), dest_x_.begin());
+    if (period != 0 && amplitude != 0) {
+      for (size_t i = 0; i < n; ++i) {
+        dest_x_[i] +=
+            scaled_amplitude *
+            sin((static_cast<double>(ages_[i]) / period) * (2 * 3.14));
       }
+    }
 
-      // Add the left drift if we have this bit set.
-      if (use_drift) {
-        dest_x -= bounding_box.size().width() *
-                  (static_cast<double>((current_time - particle.start_time) %
-                                       drift_speed) /
-                   static_cast<double>(drift_speed));
+    // Add the left drift if we have this bit set.
+    if (use_drift) {
+      for (size_t i = 0; i < n; ++i) {
+        dest_x_[i] -= area_width * (static_cast<double>(ages_[i] % drift_speed) /
+                                    static_cast<double>(drift_speed));
       }
+    }
 
-      if (dest_x < 0)
-        dest_x += bounding_box.size().width();
+    for (size_t i = 0; i < n; ++i) {
+      if (dest_x_[i] < 0)
+        dest_x_[i] += area_width;
       else
-        dest_x %= bounding_box.size().width();
+        dest_x_[i] %= area_width;
 
-      if (dest_y < 0)
-        dest_y += bounding_box.size().height();
+      if (dest_y_[i] < 0)
+        dest_y_[i] += area_height;
       else
-        dest_y %= bounding_box.size().height();
-      Rect dest(bounding_box.origin() + Size(dest_x, dest_y), src.size());
+        dest_y_[i] %= area_height;
+    }
+
+    // Then draw every particle in one batch.
+    quads_.clear();
+    for (size_t i = 0; i < n; ++i) {
+      int pattern = start_pattern;
+      if (use_animation && end_pattern > start_pattern) {
+        int number_of_patterns = end_pattern - start_pattern + 1;
+        int frame_time = animation_time / number_of_patterns;
+        int frame_number = (ages_[i] / frame_time) % number_of_patterns;
+        pattern = start_pattern + frame_number;
+      }
+      Rect src = surface->GetPattern(pattern).rect;
+      Rect dest(bounding_box.origin() + Size(dest_x_[i], dest_y_[i]),
+                src.size());
 
       if (go.has_clip_rect())
         ClipDestination(go.clip_rect(), src, dest);
 
-      surface->RenderToScreen(src, dest, particle.alpha);
+      quads_.push_back(Surface::Quad{src, dest, particles_.alpha[i]});
     }
+
+    surface->RenderQuadsToScreen(quads_);
   }
 }
 
@@ -192,6 +224,10 @@ void DriftGraphicsObject::Execute(RLMachine& machine) {
   }
 }
 
+unsigned int DriftGraphicsObject::NextWakeupTime() const {
+  return last_rendered_time_ + 11;
+}
+
 std::shared_ptr<const Surface> DriftGraphicsObject::CurrentSurface(
     const GraphicsObject& rp) {
   return surface_;
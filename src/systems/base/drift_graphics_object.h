@@ -36,10 +36,10 @@
 
 #include "machine/rlmachine.h"
 #include "systems/base/graphics_object_data.h"
+#include "systems/base/surface.h"
 #include "machine/serialization.h"
 
 class GraphicsObject;
-class Surface;
 class System;
 
 // Draws a collection of particles to the screen. Used to implement snow and
@@ -66,6 +66,7 @@ class DriftGraphicsObject : public GraphicsObjectData {
   virtual int PixelHeight(const GraphicsObject& rendering_properties) override;
   virtual GraphicsObjectData* Clone() const override;
   virtual void Execute(RLMachine& machine) override;
+  virtual unsigned int NextWakeupTime() const override;
 
  protected:
   virtual std::shared_ptr<const Surface> CurrentSurface(
@@ -73,17 +74,21 @@ class DriftGraphicsObject : public GraphicsObjectData {
   virtual void ObjectInfo(std::ostream& tree) override;
 
  private:
-  // Individual particle on screen.
-  struct Particle {
-    // Randomly generated starting location for this particle.
-    int x;
-    int y;
+  // The particles on screen, stored as parallel arrays so that updating
+  // their positions each frame is a handful of tight loops.
+  struct Particles {
+    size_t size() const { return x.size(); }
+    void Add(int x, int y, int alpha, int start_time);
+
+    // Randomly generated starting location for each particle.
+    std::vector<int> x;
+    std::vector<int> y;
 
     // Current alpha
-    int alpha;
+    std::vector<int> alpha;
 
-    // The number of ticks when this particle was first
-    int start_time;
+    // The number of ticks when each particle was first
+    std::vector<int> start_time;
   };
 
   // Private constructor for cloning.
@@ -102,7 +107,13 @@ class DriftGraphicsObject : public GraphicsObjectData {
   std::shared_ptr<const Surface> surface_;
 
   // The individual particles that make up this drift object.
-  std::vector<Particle> particles_;
+  Particles particles_;
+
+  // Per frame scratch space, kept around so rendering doesn't allocate.
+  std::vector<int> ages_;
+  std::vector<int> dest_x_;
+  std::vector<int> dest_y_;
+  std::vector<Surface::Quad> quads_;
 
   // The last time we were rendered. We keep track of this to make sure we
   // don't force refresh in a loop.
@@ -52,6 +52,10 @@ EventSystem::EventSystem(Gameexe& gexe) : globals_(gexe) {}
 
 EventSystem::~EventSystem() {}
 
+void EventSystem::WaitForInput(unsigned int milliseconds) const {
+  Wait(milliseconds);
+}
+
 RLTimer& EventSystem::GetTimer(int layer, int counter) {
   if (layer >= 2)
     throw rlvm::Exception("Invalid layer in EventSystem::GetTimer.");
@@ -129,6 +129,10 @@ class EventSystem {
   // Idles the program for a certain amount of time in milliseconds.
   virtual void Wait(unsigned int milliseconds) const = 0;
 
+  // Idles for up to |milliseconds|, returning early if input arrives.
+  // Defaults to Wait().
+  virtual void WaitForInput(unsigned int milliseconds) const;
+
   // Keyboard and Mouse Input (Reallive style)
   //
   // RealLive applications poll for input, with all the problems that sort of
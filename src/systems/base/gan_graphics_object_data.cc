@@ -36,6 +36,7 @@
 
 #include <boost/serialization/export.hpp>
 #include <boost/filesystem/fstream.hpp>
+#include <climits>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -266,6 +267,14 @@ void GanGraphicsObjectData::Execute(RLMachine& machine) {
   }
 }
 
+unsigned int GanGraphicsObjectData::NextWakeupTime() const {
+  if (!is_currently_playing() || current_frame_ < 0)
+    return UINT_MAX;
+
+  const vector<Frame>& current_set = animation_sets.at(current_set_);
+  return time_at_last_frame_change_ + current_set[current_frame_].time + 1;
+}
+
 void GanGraphicsObjectData::LoopAnimation() { current_frame_ = 0; }
 
 std::shared_ptr<const Surface> GanGraphicsObjectData::CurrentSurface(
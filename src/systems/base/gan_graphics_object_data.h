@@ -64,6 +64,7 @@ class GanGraphicsObjectData : public GraphicsObjectData {
 
   virtual GraphicsObjectData* Clone() const override;
   virtual void Execute(RLMachine& machine) override;
+  virtual unsigned int NextWakeupTime() const override;
 
   virtual bool IsAnimation() const override { return true; }
   virtual void PlaySet(int set) override;
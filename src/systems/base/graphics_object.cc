@@ -36,6 +36,7 @@
 #include <boost/serialization/shared_ptr.hpp>
 
 #include <algorithm>
+#include <climits>
 #include <iostream>
 #include <numeric>
 #include <sstream>
@@ -429,6 +430,14 @@ GraphicsObjectData& GraphicsObject::GetObjectData() {
   }
 }
 
+const GraphicsObjectData& GraphicsObject::GetObjectData() const {
+  if (object_data_) {
+    return *object_data_;
+  } else {
+    throw rlvm::Exception("null object data");
+  }
+}
+
 void GraphicsObject::SetWipeCopy(const int wipe_copy) {
   MakeImplUnique();
   impl_->wipe_copy_ = wipe_copy;
@@ -805,7 +814,7 @@ void GraphicsObject::AddObjectMutator(std::unique_ptr<ObjectMutator> mutator) {
 }
 
 bool GraphicsObject::IsMutatorRunningMatching(int repno,
-                                              const std::string& name) {
+                                              const std::string& name) const {
   for (auto const& mutator : object_mutators_) {
     if (mutator->OperationMatches(repno, name))
       return true;
@@ -907,6 +916,17 @@ void GraphicsObject::Execute(RLMachine& machine) {
   }
 }
 
+bool GraphicsObject::ChangesOnExecute() const {
+  return !object_mutators_.empty() ||
+         (object_data_ && object_data_->ChangesOnExecute());
+}
+
+unsigned int GraphicsObject::NextWakeupTime() const {
+  if (!object_mutators_.empty())
+    return 0;
+  return object_data_ ? object_data_->NextWakeupTime() : UINT_MAX;
+}
+
 template <class Archive>
 void GraphicsObject::serialize(Archive& ar, unsigned int version) {
   ar& impl_& object_data_;
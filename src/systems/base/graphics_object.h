@@ -190,6 +190,7 @@ class GraphicsObject {
   bool has_object_data() const { return object_data_.get(); }
 
   GraphicsObjectData& GetObjectData();
+  const GraphicsObjectData& GetObjectData() const;
   void SetObjectData(GraphicsObjectData* obj);
 
   // Render!
@@ -213,6 +214,14 @@ class GraphicsObject {
   // to force a redraw, or something.
   void Execute(RLMachine& machine);
 
+  // Whether Execute() could change any saved state of this object: it has
+  // mutators running or its data is playing an animation.
+  bool ChangesOnExecute() const;
+
+  // The tick at which Execute() next has work to do. Objects with running
+  // mutators need to run every frame.
+  unsigned int NextWakeupTime() const;
+
   // Text Object accessors
   void SetTextText(const std::string& utf8str);
   const std::string& GetTextText() const;
@@ -297,7 +306,7 @@ class GraphicsObject {
 
   // Returns true if a mutator matching the following parameters is currently
   // running.
-  bool IsMutatorRunningMatching(int repno, const std::string& name);
+  bool IsMutatorRunningMatching(int repno, const std::string& name) const;
 
   // Ends all mutators that match the given parameters.
   void EndObjectMutatorMatching(RLMachine& machine,
@@ -27,6 +27,7 @@
 
 #include "systems/base/graphics_object_data.h"
 
+#include <climits>
 #include <ostream>
 
 #include "systems/base/graphics_object.h"
@@ -276,6 +277,12 @@ int GraphicsObjectData::GetRenderingAlpha(const GraphicsObject& go,
   }
 }
 
+bool GraphicsObjectData::ChangesOnExecute() const { return currently_playing_; }
+
+unsigned int GraphicsObjectData::NextWakeupTime() const {
+  return currently_playing_ ? 0 : UINT_MAX;
+}
+
 bool GraphicsObjectData::IsAnimation() const { return false; }
 
 void GraphicsObjectData::PlaySet(int set) {}
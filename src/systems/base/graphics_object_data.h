@@ -74,6 +74,15 @@ class GraphicsObjectData {
 
   virtual void Execute(RLMachine& machine) = 0;
 
+  // Whether Execute() could change any saved state. By default only playing
+  // animations advance.
+  virtual bool ChangesOnExecute() const;
+
+  // The tick at which Execute() next has something to do: 0 to run on every
+  // trip through the game loop, UINT_MAX if nothing happens until someone
+  // changes this object. By default, playing animations are polled.
+  virtual unsigned int NextWakeupTime() const;
+
   virtual bool IsAnimation() const;
   virtual void PlaySet(int set);
 
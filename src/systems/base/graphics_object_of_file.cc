@@ -31,6 +31,7 @@
 
 #include "systems/base/graphics_object_of_file.h"
 
+#include <climits>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -39,6 +40,7 @@
 #include "systems/base/event_system.h"
 #include "systems/base/graphics_object.h"
 #include "systems/base/graphics_system.h"
+#include "systems/base/image_info.h"
 #include "systems/base/surface.h"
 #include "systems/base/system.h"
 #include "utilities/file.h"
@@ -60,6 +62,7 @@ GraphicsObjectOfFile::GraphicsObjectOfFile(const GraphicsObjectOfFile& obj)
     : GraphicsObjectData(obj),
       system_(obj.system_),
       filename_(obj.filename_),
+      info_(obj.info_),
       surface_(obj.surface_),
       frame_time_(obj.frame_time_),
       current_frame_(obj.current_frame_),
@@ -84,14 +87,14 @@ GraphicsObjectOfFile::~GraphicsObjectOfFile() {}
 // -----------------------------------------------------------------------
 
 void GraphicsObjectOfFile::LoadFile() {
-  surface_ = system_.graphics().GetSurfaceNamed(filename_);
-  surface_->EnsureUploaded();
+  info_ = system_.graphics().GetImageInfo(filename_);
+  surface_.reset();
 }
 
 // -----------------------------------------------------------------------
 
 int GraphicsObjectOfFile::PixelWidth(const GraphicsObject& rp) {
-  const Surface::GrpRect& rect = surface_->GetPattern(rp.GetPattNo());
+  const Surface::GrpRect& rect = info_->GetPattern(rp.GetPattNo());
   int width = rect.rect.width();
   return int(rp.GetWidthScaleFactor() * width);
 }
@@ -99,7 +102,7 @@ int GraphicsObjectOfFile::PixelWidth(const GraphicsObject& rp) {
 // -----------------------------------------------------------------------
 
 int GraphicsObjectOfFile::PixelHeight(const GraphicsObject& rp) {
-  const Surface::GrpRect& rect = surface_->GetPattern(rp.GetPattNo());
+  const Surface::GrpRect& rect = info_->GetPattern(rp.GetPattNo());
   int height = rect.rect.height();
   return int(rp.GetHeightScaleFactor() * height);
 }
@@ -120,7 +123,7 @@ void GraphicsObjectOfFile::Execute(RLMachine& machine) {
 
     while (time_since_last_frame_change > frame_time_) {
       current_frame_++;
-      if (current_frame_ == surface_->GetNumPatterns()) {
+      if (current_frame_ == info_->GetNumPatterns()) {
         current_frame_--;
         EndAnimation();
       }
@@ -134,8 +137,17 @@ void GraphicsObjectOfFile::Execute(RLMachine& machine) {
 
 // -----------------------------------------------------------------------
 
+unsigned int GraphicsObjectOfFile::NextWakeupTime() const {
+  if (!is_currently_playing())
+    return UINT_MAX;
+
+  return time_at_last_frame_change_ + frame_time_ + 1;
+}
+
+// -----------------------------------------------------------------------
+
 bool GraphicsObjectOfFile::IsAnimation() const {
-  return surface_->GetNumPatterns();
+  return info_->GetNumPatterns();
 }
 
 // -----------------------------------------------------------------------
@@ -146,6 +158,10 @@ void GraphicsObjectOfFile::LoopAnimation() { current_frame_ = 0; }
 
 std::shared_ptr<const Surface> GraphicsObjectOfFile::CurrentSurface(
     const GraphicsObject& rp) {
+  if (!surface_) {
+    surface_ = system_.graphics().GetSurfaceNamed(filename_);
+    surface_->EnsureUploaded();
+  }
   return surface_;
 }
 
@@ -155,10 +171,20 @@ Rect GraphicsObjectOfFile::SrcRect(const GraphicsObject& go) {
   if (time_at_last_frame_change_ != 0) {
     // If we've ever been treated as an animation, we need to continue acting
     // as an animation even if we've stopped.
-    return surface_->GetPattern(current_frame_).rect;
+    return info_->GetPattern(current_frame_).rect;
   }
 
-  return GraphicsObjectData::SrcRect(go);
+  return info_->GetPattern(go.GetPattNo()).rect;
+}
+
+// -----------------------------------------------------------------------
+
+Point GraphicsObjectOfFile::DstOrigin(const GraphicsObject& go) {
+  if (go.origin_x() || go.origin_y())
+    return Point(go.origin_x(), go.origin_y());
+
+  const Surface::GrpRect& rect = info_->GetPattern(go.GetPattNo());
+  return Point(rect.originX, rect.originY);
 }
 
 // -----------------------------------------------------------------------
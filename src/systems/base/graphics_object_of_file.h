@@ -38,6 +38,7 @@
 #include "machine/serialization.h"
 #include "systems/base/graphics_object_data.h"
 
+class ImageInfo;
 class System;
 class Surface;
 class RLMachine;
@@ -48,6 +49,10 @@ class RLMachine;
 //
 // GraphicsObjectOfFile is used for loading individual bitmaps into an
 // object. It has support for normal display, and also
+//
+// Only the image's metadata is read when the object is created; the pixels
+// are decoded and uploaded the first time the object is actually drawn, since
+// scripts build up lots of hidden objects (menus, backgrounds for later).
 class GraphicsObjectOfFile : public GraphicsObjectData {
  public:
   explicit GraphicsObjectOfFile(System& system);
@@ -62,6 +67,7 @@ class GraphicsObjectOfFile : public GraphicsObjectData {
   virtual GraphicsObjectData* Clone() const override;
 
   virtual void Execute(RLMachine& machine) override;
+  virtual unsigned int NextWakeupTime() const override;
 
   virtual bool IsAnimation() const override;
   virtual void PlaySet(int set) override;
@@ -71,6 +77,7 @@ class GraphicsObjectOfFile : public GraphicsObjectData {
   virtual std::shared_ptr<const Surface> CurrentSurface(
       const GraphicsObject& go) override;
   virtual Rect SrcRect(const GraphicsObject& go) override;
+  virtual Point DstOrigin(const GraphicsObject& go) override;
   virtual void ObjectInfo(std::ostream& tree) override;
 
  private:
@@ -86,7 +93,10 @@ class GraphicsObjectOfFile : public GraphicsObjectData {
   // The name of the graphics file that was loaded.
   std::string filename_;
 
-  // The encapsulated surface to render
+  // Size and pattern table of |filename_|.
+  std::shared_ptr<const ImageInfo> info_;
+
+  // The encapsulated surface to render. NULL until we're first drawn.
   std::shared_ptr<const Surface> surface_;
 
   // Number of milliseconds to spend on a single frame in the
@@ -34,11 +34,13 @@
 #include <boost/serialization/vector.hpp>
 
 #include <algorithm>
+#include <climits>
 #include <deque>
 #include <iostream>
 #include <iterator>
 #include <list>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -61,6 +63,7 @@
 #include "systems/base/graphics_stack_frame.h"
 #include "systems/base/hik_renderer.h"
 #include "systems/base/hik_script.h"
+#include "systems/base/image_info.h"
 #include "systems/base/mouse_cursor.h"
 #include "systems/base/object_mutator.h"
 #include "systems/base/object_settings.h"
@@ -174,19 +177,101 @@ GraphicsSystemGlobals::GraphicsSystemGlobals(Gameexe& gameexe)
       cg_table(gameexe),
       tone_curves(gameexe) {}
 
+namespace {
+
+// While fast forwarding, draw at most this many milliseconds apart.
+const unsigned int kFastForwardFrameInterval = 100;
+
+// How many released surfaces BuildPooledSurface() keeps around for reuse.
+const size_t kSurfacePoolSize = 16;
+
+// -----------------------------------------------------------------------
+// ObjectJournal
+// -----------------------------------------------------------------------
+
+// Remembers what a layer of objects looked like at the last savepoint.
+// Savepoints are marked on nearly every textout while games are rarely saved,
+// so instead of copying the whole layer at each savepoint, a slot is copied
+// the first time it's about to change afterwards and the savepoint layer is
+// only rebuilt when saving.
+class ObjectJournal {
+ public:
+  explicit ObjectJournal(int size)
+      : generation_(0), recorded_in_(size, -1), objects_(size) {}
+
+  // Makes the current state of the layer the savepoint state. Copies from
+  // earlier generations are simply ignored.
+  void Reset() { generation_++; }
+
+  // Copies |layer|[slot] unless it has already been copied since the last
+  // Reset(). Must be called before anything changes that slot.
+  void Record(LazyArray<GraphicsObject>& layer, int slot) {
+    if (slot < 0 || slot >= static_cast<int>(recorded_in_.size()) ||
+        recorded_in_[slot] == generation_)
+      return;
+
+    recorded_in_[slot] = generation_;
+    objects_[slot].reset(layer.exists(slot) ? new GraphicsObject(layer[slot])
+                                            : NULL);
+  }
+
+  void RecordAll(LazyArray<GraphicsObject>& layer) {
+    for (int i = 0; i < layer.size(); ++i)
+      Record(layer, i);
+  }
+
+  // Writes the savepoint state of |layer| to |out|.
+  void Rebuild(LazyArray<GraphicsObject>& layer,
+               LazyArray<GraphicsObject>& out) const {
+    layer.CopyTo(out);
+
+    int size = std::min(out.size(), static_cast<int>(recorded_in_.size()));
+    for (int i = 0; i < size; ++i) {
+      if (recorded_in_[i] != generation_)
+        continue;
+
+      if (objects_[i])
+        out[i] = *objects_[i];
+      else
+        out.DeleteAt(i);
+    }
+  }
+
+ private:
+  int generation_;
+
+  // The generation in which each slot was last copied.
+  std::vector<int> recorded_in_;
+
+  // The copy of each slot; NULL if the slot was empty.
+  std::vector<std::unique_ptr<GraphicsObject>> objects_;
+};
+
+}  // namespace
+
 // -----------------------------------------------------------------------
 // GraphicsObjectImpl
 // -----------------------------------------------------------------------
 struct GraphicsSystem::GraphicsObjectImpl {
   explicit GraphicsObjectImpl(int objects_in_layer);
 
+  // Copies the graphics stack if it's still shared with
+  // |saved_graphics_stack|, and returns it for modification.
+  std::deque<std::string>& MutableGraphicsStack();
+
   // Foreground objects
   LazyArray<GraphicsObject> foreground_objects;
 
   // Background objects
   LazyArray<GraphicsObject> background_objects;
 
-  // Foreground objects (at the time of the last save)
+  // The state of each layer at the last savepoint, relative to the layers
+  // above.
+  ObjectJournal foreground_journal;
+  ObjectJournal background_journal;
+
+  // Foreground objects (at the time of the last save). Only filled in from
+  // the journals when saving.
   LazyArray<GraphicsObject> saved_foreground_objects;
 
   // Background objects (at the time of the last save)
@@ -198,13 +283,17 @@ struct GraphicsSystem::GraphicsObjectImpl {
 
   // List of commands in RealLive bytecode to rebuild the graphics stack at the
   // current moment.
-  std::deque<std::string> graphics_stack;
+  std::shared_ptr<std::deque<std::string>> graphics_stack;
 
-  // Commands to rebuild the graphics stack (at the time of the last savepoint)
-  std::deque<std::string> saved_graphics_stack;
+  // Commands to rebuild the graphics stack (at the time of the last
+  // savepoint). Shares its storage with |graphics_stack| until that changes.
+  std::shared_ptr<const std::deque<std::string>> saved_graphics_stack;
 
   // Old style graphics stack implementation.
   std::vector<GraphicsStackFrame> old_graphics_stack;
+
+  // Stands in for unallocated slots in the const GetObject().
+  const GraphicsObject empty_object;
 };
 
 // -----------------------------------------------------------------------
@@ -212,9 +301,20 @@ struct GraphicsSystem::GraphicsObjectImpl {
 GraphicsSystem::GraphicsObjectImpl::GraphicsObjectImpl(int size)
     : foreground_objects(size),
       background_objects(size),
+      foreground_journal(size),
+      background_journal(size),
       saved_foreground_objects(size),
       saved_background_objects(size),
-      use_old_graphics_stack(false) {}
+      use_old_graphics_stack(false),
+      graphics_stack(std::make_shared<std::deque<std::string>>()),
+      saved_graphics_stack(graphics_stack) {}
+
+std::deque<std::string>&
+GraphicsSystem::GraphicsObjectImpl::MutableGraphicsStack() {
+  if (graphics_stack.use_count() > 1)
+    graphics_stack = std::make_shared<std::deque<std::string>>(*graphics_stack);
+  return *graphics_stack;
+}
 
 // -----------------------------------------------------------------------
 // GraphicsSystem
@@ -229,6 +329,7 @@ GraphicsSystem::GraphicsSystem(System& system, Gameexe& gameexe)
       interface_hidden_(false),
       globals_(gameexe),
       time_at_last_queue_change_(0),
+      time_of_last_fast_forward_frame_(0),
       graphics_object_settings_(new GraphicsObjectSettings(gameexe)),
       graphics_object_impl_(new GraphicsObjectImpl(
           graphics_object_settings_->objects_in_a_layer)),
@@ -238,7 +339,8 @@ GraphicsSystem::GraphicsSystem(System& system, Gameexe& gameexe)
       system_(system),
       preloaded_hik_scripts_(32),
       preloaded_g00_(256),
-      image_cache_(10) {}
+      image_cache_(10),
+      image_info_cache_(1024) {}
 
 // -----------------------------------------------------------------------
 
@@ -285,6 +387,23 @@ void GraphicsSystem::OnScreenRefreshed() {
 
 // -----------------------------------------------------------------------
 
+bool GraphicsSystem::ShouldRefreshScreen() {
+  if (!is_responsible_for_update() || !screen_needs_refresh())
+    return false;
+
+  if (!system().ShouldFastForward())
+    return true;
+
+  unsigned int now = system().event().GetTicks();
+  if (now - time_of_last_fast_forward_frame_ < kFastForwardFrameInterval)
+    return false;
+
+  time_of_last_fast_forward_frame_ = now;
+  return true;
+}
+
+// -----------------------------------------------------------------------
+
 void GraphicsSystem::SetScreenUpdateMode(DCScreenUpdateMode u) {
   screen_update_mode_ = u;
 }
@@ -342,8 +461,11 @@ int GraphicsSystem::CurrentShakingFrameTime() const {
 // -----------------------------------------------------------------------
 
 int GraphicsSystem::ShouldUseCustomCursor() {
+  // Called every frame.
+  static constexpr GameexeKey kMouseCursor("MOUSE_CURSOR");
+  static constexpr GameexeKey kName("NAME");
   return use_custom_mouse_cursor_ &&
-         system().gameexe()("MOUSE_CURSOR", cursor_, "NAME").ToString("") != "";
+         system().gameexe()(kMouseCursor, cursor_, kName).ToString("") != "";
 }
 
 // -----------------------------------------------------------------------
@@ -356,12 +478,13 @@ void GraphicsSystem::SetCursor(int cursor) {
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::AddGraphicsStackCommand(const std::string& command) {
-  graphics_object_impl_->graphics_stack.push_back(command);
+  std::deque<std::string>& stack = graphics_object_impl_->MutableGraphicsStack();
+  stack.push_back(command);
 
   // RealLive only allows 127 commands to be on the stack so game programmers
   // can be lazy and not clear it.
-  if (graphics_object_impl_->graphics_stack.size() > 127)
-    graphics_object_impl_->graphics_stack.pop_front();
+  if (stack.size() > 127)
+    stack.pop_front();
 }
 
 // -----------------------------------------------------------------------
@@ -374,21 +497,27 @@ int GraphicsSystem::StackSize() const {
   //   x = stackSize()
   //   ... large graphics demo
   //   stackTrunk(x)
-  return graphics_object_impl_->graphics_stack.size();
+  return graphics_object_impl_->graphics_stack->size();
 }
 
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::ClearStack() {
-  graphics_object_impl_->graphics_stack.clear();
+  if (!graphics_object_impl_->graphics_stack->empty())
+    graphics_object_impl_->graphics_stack =
+        std::make_shared<std::deque<std::string>>();
 }
 
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::StackPop(int items) {
+  if (items <= 0 || graphics_object_impl_->graphics_stack->empty())
+    return;
+
+  std::deque<std::string>& stack = graphics_object_impl_->MutableGraphicsStack();
   for (int i = 0; i < items; ++i) {
-    if (graphics_object_impl_->graphics_stack.size()) {
-      graphics_object_impl_->graphics_stack.pop_back();
+    if (stack.size()) {
+      stack.pop_back();
     }
   }
 }
@@ -404,11 +533,13 @@ void GraphicsSystem::ReplayGraphicsStack(RLMachine& machine) {
     ReplayDepricatedGraphicsStackVector(machine, stack_to_replay);
     graphics_object_impl_->use_old_graphics_stack = false;
   } else {
-    std::deque<std::string> stack_to_replay;
-    stack_to_replay.swap(graphics_object_impl_->graphics_stack);
+    std::shared_ptr<std::deque<std::string>> stack_to_replay =
+        graphics_object_impl_->graphics_stack;
+    graphics_object_impl_->graphics_stack =
+        std::make_shared<std::deque<std::string>>();
 
     machine.set_replaying_graphics_stack(true);
-    ReplayGraphicsStackCommand(machine, stack_to_replay);
+    ReplayGraphicsStackCommand(machine, *stack_to_replay);
     machine.set_replaying_graphics_stack(false);
   }
 }
@@ -518,8 +649,13 @@ void GraphicsSystem::DrawFrame(std::ostream* tree) {
 void GraphicsSystem::ExecuteGraphicsSystem(RLMachine& machine) {
   // Check to see if any of the graphics objects are reporting that
   // they want to force a redraw
-  for (GraphicsObject& obj : GetForegroundObjects())
-    obj.Execute(machine);
+  LazyArray<GraphicsObject>& foreground =
+      graphics_object_impl_->foreground_objects;
+  for (auto it = foreground.begin(); it != foreground.end(); ++it) {
+    if (it->ChangesOnExecute())
+      graphics_object_impl_->foreground_journal.Record(foreground, it.pos());
+    it->Execute(machine);
+  }
 
   if (mouse_cursor_)
     mouse_cursor_->Execute(system());
@@ -542,16 +678,40 @@ void GraphicsSystem::ExecuteGraphicsSystem(RLMachine& machine) {
   }
 }
 
+unsigned int GraphicsSystem::NextWakeupTime() {
+  if (screen_needs_refresh_ || !screen_shake_queue_.empty())
+    return 0;
+
+  unsigned int wakeup = UINT_MAX;
+  LazyArray<GraphicsObject>& foreground =
+      graphics_object_impl_->foreground_objects;
+  for (auto it = foreground.begin(); it != foreground.end(); ++it) {
+    wakeup = std::min(wakeup, it->NextWakeupTime());
+    if (wakeup == 0)
+      return 0;
+  }
+
+  if (mouse_cursor_)
+    wakeup = std::min(wakeup, mouse_cursor_->NextWakeupTime());
+
+  if (hik_renderer_ && background_type_ == BACKGROUND_HIK)
+    wakeup = std::min(wakeup, hik_renderer_->NextWakeupTime());
+
+  return wakeup;
+}
+
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::Reset() {
+  RecordAllObjects();
   graphics_object_impl_->foreground_objects.Clear();
   graphics_object_impl_->background_objects.Clear();
 
   ClearAllDCs();
 
   preloaded_hik_scripts_.Clear();
-  preloaded_g00_.Clear();
+  ClearAllPreloadedG00();
+  surface_pool_.clear();
   hik_renderer_.reset();
   background_type_ = BACKGROUND_DC0;
 
@@ -619,25 +779,53 @@ void GraphicsSystem::PreloadG00(int slot, const std::string& name) {
   // We first check our implicit cache just in case so we don't load it twice.
   std::shared_ptr<const Surface> surface = image_cache_.fetch(name);
   if (!surface)
-    surface = LoadSurfaceFromFile(name);
-
-  if (surface)
-    surface->EnsureUploaded();
+    PrefetchSurface(name);
 
+  // The surface is loaded (and later uploaded) the first time someone asks
+  // for it through GetPreloadedG00().
+  std::string replaced = preloaded_g00_[slot].first;
   preloaded_g00_[slot] = std::make_pair(name, surface);
+  CancelUnusedPrefetch(replaced);
 }
 
 void GraphicsSystem::ClearPreloadedG00(int slot) {
+  std::string name = preloaded_g00_[slot].first;
   preloaded_g00_[slot] = std::make_pair("", std::shared_ptr<const Surface>());
+  CancelUnusedPrefetch(name);
 }
 
-void GraphicsSystem::ClearAllPreloadedG00() { preloaded_g00_.Clear(); }
+void GraphicsSystem::ClearAllPreloadedG00() {
+  std::vector<std::string> names;
+  for (G00ArrayItem& item : preloaded_g00_) {
+    if (!item.first.empty())
+      names.push_back(item.first);
+  }
+
+  preloaded_g00_.Clear();
+  for (const std::string& name : names)
+    CancelPrefetch(name);
+}
+
+void GraphicsSystem::CancelUnusedPrefetch(const std::string& name) {
+  if (name.empty())
+    return;
+
+  for (G00ArrayItem& item : preloaded_g00_) {
+    if (item.first == name)
+      return;
+  }
+
+  CancelPrefetch(name);
+}
 
 std::shared_ptr<const Surface> GraphicsSystem::GetPreloadedG00(
     const std::string& name) {
   for (G00ArrayItem& item : preloaded_g00_) {
-    if (item.first == name)
+    if (item.first == name) {
+      if (!item.second)
+        item.second = LoadSurfaceFromFile(name);
       return item.second;
+    }
   }
 
   return std::shared_ptr<const Surface>();
@@ -677,20 +865,90 @@ std::shared_ptr<const Surface> GraphicsSystem::GetSurfaceNamed(
 
 // -----------------------------------------------------------------------
 
+std::shared_ptr<const ImageInfo> GraphicsSystem::GetImageInfo(
+    const std::string& short_filename) {
+  std::shared_ptr<const ImageInfo> info =
+      image_info_cache_.fetch(short_filename);
+  if (info)
+    return info;
+
+  // If the pixels are already in memory, there's no need to go back to disk.
+  std::shared_ptr<const Surface> surface;
+  for (G00ArrayItem& item : preloaded_g00_) {
+    if (item.first == short_filename)
+      surface = item.second;
+  }
+  if (!surface)
+    surface = image_cache_.fetch(short_filename);
+
+  if (surface)
+    info = std::make_shared<ImageInfo>(*surface);
+  else
+    info = LoadImageInfoFromFile(short_filename);
+
+  image_info_cache_.insert(short_filename, info);
+  return info;
+}
+
+// -----------------------------------------------------------------------
+
+std::shared_ptr<Surface> GraphicsSystem::BuildPooledSurface(const Size& size) {
+  for (auto it = surface_pool_.begin(); it != surface_pool_.end(); ++it) {
+    if ((*it)->GetSize() == size) {
+      std::shared_ptr<Surface> surface = std::move(*it);
+      surface_pool_.erase(it);
+      return surface;
+    }
+  }
+
+  return BuildSurface(size);
+}
+
+// -----------------------------------------------------------------------
+
+void GraphicsSystem::RecycleSurface(std::shared_ptr<Surface> surface) {
+  // Someone else can still see this surface's pixels.
+  if (!surface || surface.use_count() != 1)
+    return;
+
+  if (surface_pool_.size() >= kSurfacePoolSize)
+    surface_pool_.erase(surface_pool_.begin());
+  surface_pool_.push_back(std::move(surface));
+}
+
+// -----------------------------------------------------------------------
+
+std::shared_ptr<const ImageInfo> GraphicsSystem::LoadImageInfoFromFile(
+    const std::string& short_filename) {
+  return std::make_shared<ImageInfo>(*GetSurfaceNamed(short_filename));
+}
+
+// -----------------------------------------------------------------------
+
+void GraphicsSystem::PrefetchSurface(const std::string& short_filename) {}
+
+void GraphicsSystem::CancelPrefetch(const std::string& short_filename) {}
+
+// -----------------------------------------------------------------------
+
 void GraphicsSystem::ClearAndPromoteObjects() {
   typedef LazyArray<GraphicsObject>::full_iterator FullIterator;
 
-  FullIterator bg = graphics_object_impl_->background_objects.full_begin();
-  FullIterator bg_end = graphics_object_impl_->background_objects.full_end();
-  FullIterator fg = graphics_object_impl_->foreground_objects.full_begin();
-  FullIterator fg_end = graphics_object_impl_->foreground_objects.full_end();
+  GraphicsObjectImpl& impl = *graphics_object_impl_;
+  FullIterator bg = impl.background_objects.full_begin();
+  FullIterator bg_end = impl.background_objects.full_end();
+  FullIterator fg = impl.foreground_objects.full_begin();
+  FullIterator fg_end = impl.foreground_objects.full_end();
   for (; bg != bg_end && fg != fg_end; bg++, fg++) {
     if (fg.valid() && !fg->wipe_copy()) {
+      impl.foreground_journal.Record(impl.foreground_objects, fg.pos());
       fg->InitializeParams();
       fg->FreeObjectData();
     }
 
     if (bg.valid()) {
+      impl.foreground_journal.Record(impl.foreground_objects, fg.pos());
+      impl.background_journal.Record(impl.background_objects, bg.pos());
       *fg = *bg;
       bg->InitializeParams();
       bg->FreeObjectData();
@@ -704,10 +962,31 @@ GraphicsObject& GraphicsSystem::GetObject(int layer, int obj_number) {
   if (layer < 0 || layer > 1)
     throw rlvm::Exception("Invalid layer number");
 
-  if (layer == OBJ_BG)
+  if (layer == OBJ_BG) {
+    graphics_object_impl_->background_journal.Record(
+        graphics_object_impl_->background_objects, obj_number);
     return graphics_object_impl_->background_objects[obj_number];
-  else
+  } else {
+    graphics_object_impl_->foreground_journal.Record(
+        graphics_object_impl_->foreground_objects, obj_number);
     return graphics_object_impl_->foreground_objects[obj_number];
+  }
+}
+
+const GraphicsObject& GraphicsSystem::GetObject(int layer,
+                                                int obj_number) const {
+  if (layer < 0 || layer > 1)
+    throw rlvm::Exception("Invalid layer number");
+
+  const LazyArray<GraphicsObject>& objects =
+      layer == OBJ_BG ? graphics_object_impl_->background_objects
+                      : graphics_object_impl_->foreground_objects;
+  if (obj_number < 0 || obj_number >= objects.size())
+    throw std::out_of_range("GraphicsSystem::GetObject");
+
+  // Don't allocate the slot just to look at it.
+  return objects.exists(obj_number) ? objects[obj_number]
+                                     : graphics_object_impl_->empty_object;
 }
 
 // -----------------------------------------------------------------------
@@ -716,15 +995,21 @@ void GraphicsSystem::SetObject(int layer, int obj_number, GraphicsObject& obj) {
   if (layer < 0 || layer > 1)
     throw rlvm::Exception("Invalid layer number");
 
-  if (layer == OBJ_BG)
+  if (layer == OBJ_BG) {
+    graphics_object_impl_->background_journal.Record(
+        graphics_object_impl_->background_objects, obj_number);
     graphics_object_impl_->background_objects[obj_number] = obj;
-  else
+  } else {
+    graphics_object_impl_->foreground_journal.Record(
+        graphics_object_impl_->foreground_objects, obj_number);
     graphics_object_impl_->foreground_objects[obj_number] = obj;
+  }
 }
 
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::FreeObjectData(int obj_number) {
+  RecordObject(obj_number);
   graphics_object_impl_->foreground_objects[obj_number].FreeObjectData();
   graphics_object_impl_->background_objects[obj_number].FreeObjectData();
 }
@@ -732,6 +1017,7 @@ void GraphicsSystem::FreeObjectData(int obj_number) {
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::FreeAllObjectData() {
+  RecordAllObjects();
   for (GraphicsObject& object : graphics_object_impl_->foreground_objects)
     object.FreeObjectData();
 
@@ -742,6 +1028,7 @@ void GraphicsSystem::FreeAllObjectData() {
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::InitializeObjectParams(int obj_number) {
+  RecordObject(obj_number);
   graphics_object_impl_->foreground_objects[obj_number].InitializeParams();
   graphics_object_impl_->background_objects[obj_number].InitializeParams();
 }
@@ -749,6 +1036,7 @@ void GraphicsSystem::InitializeObjectParams(int obj_number) {
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::InitializeAllObjectParams() {
+  RecordAllObjects();
   for (GraphicsObject& object : graphics_object_impl_->foreground_objects)
     object.InitializeParams();
 
@@ -765,12 +1053,29 @@ int GraphicsSystem::GetObjectLayerSize() {
 // -----------------------------------------------------------------------
 
 LazyArray<GraphicsObject>& GraphicsSystem::GetBackgroundObjects() {
+  // The caller can change anything in the layer.
+  graphics_object_impl_->background_journal.RecordAll(
+      graphics_object_impl_->background_objects);
   return graphics_object_impl_->background_objects;
 }
 
 // -----------------------------------------------------------------------
 
 LazyArray<GraphicsObject>& GraphicsSystem::GetForegroundObjects() {
+  graphics_object_impl_->foreground_journal.RecordAll(
+      graphics_object_impl_->foreground_objects);
+  return graphics_object_impl_->foreground_objects;
+}
+
+// -----------------------------------------------------------------------
+
+const LazyArray<GraphicsObject>& GraphicsSystem::GetBackgroundObjects() const {
+  return graphics_object_impl_->background_objects;
+}
+
+// -----------------------------------------------------------------------
+
+const LazyArray<GraphicsObject>& GraphicsSystem::GetForegroundObjects() const {
   return graphics_object_impl_->foreground_objects;
 }
 
@@ -791,14 +1096,34 @@ bool GraphicsSystem::AnimationsPlaying() const {
 // -----------------------------------------------------------------------
 
 void GraphicsSystem::TakeSavepointSnapshot() {
-  GetForegroundObjects().CopyTo(graphics_object_impl_->saved_foreground_objects);
-  GetBackgroundObjects().CopyTo(graphics_object_impl_->saved_background_objects);
+  // Nothing is copied here; the journals and the shared graphics stack copy
+  // what changes from now on.
+  graphics_object_impl_->foreground_journal.Reset();
+  graphics_object_impl_->background_journal.Reset();
   graphics_object_impl_->saved_graphics_stack =
       graphics_object_impl_->graphics_stack;
 }
 
 // -----------------------------------------------------------------------
 
+void GraphicsSystem::RecordObject(int obj_number) {
+  graphics_object_impl_->foreground_journal.Record(
+      graphics_object_impl_->foreground_objects, obj_number);
+  graphics_object_impl_->background_journal.Record(
+      graphics_object_impl_->background_objects, obj_number);
+}
+
+// -----------------------------------------------------------------------
+
+void GraphicsSystem::RecordAllObjects() {
+  graphics_object_impl_->foreground_journal.RecordAll(
+      graphics_object_impl_->foreground_objects);
+  graphics_object_impl_->background_journal.RecordAll(
+      graphics_object_impl_->background_objects);
+}
+
+// -----------------------------------------------------------------------
+
 void GraphicsSystem::ClearAllDCs() {
   GetDC(0)->Fill(RGBAColour::Black());
 
@@ -917,9 +1242,15 @@ GraphicsObjectData* GraphicsSystem::BuildObjOfFile(
 
 template <class Archive>
 void GraphicsSystem::save(Archive& ar, unsigned int version) const {
-  ar& subtitle_& default_grp_name_& default_bgr_name_& graphics_object_impl_
-      ->saved_graphics_stack& graphics_object_impl_->saved_background_objects&
-            graphics_object_impl_->saved_foreground_objects;
+  GraphicsObjectImpl& impl = *graphics_object_impl_;
+  impl.background_journal.Rebuild(impl.background_objects,
+                                  impl.saved_background_objects);
+  impl.foreground_journal.Rebuild(impl.foreground_objects,
+                                  impl.saved_foreground_objects);
+
+  ar& subtitle_& default_grp_name_& default_bgr_name_;
+  ar&(*impl.saved_graphics_stack);
+  ar& impl.saved_background_objects& impl.saved_foreground_objects;
 }
 
 // -----------------------------------------------------------------------
@@ -931,7 +1262,9 @@ void GraphicsSystem::load(Archive& ar, unsigned int version) {
     ar& default_grp_name_;
     ar& default_bgr_name_;
     graphics_object_impl_->use_old_graphics_stack = false;
-    ar& graphics_object_impl_->graphics_stack;
+    graphics_object_impl_->graphics_stack =
+        std::make_shared<std::deque<std::string>>();
+    ar&(*graphics_object_impl_->graphics_stack);
   } else {
     graphics_object_impl_->use_old_graphics_stack = true;
     ar& graphics_object_impl_->old_graphics_stack;
@@ -939,6 +1272,8 @@ void GraphicsSystem::load(Archive& ar, unsigned int version) {
 
   ar& graphics_object_impl_->background_objects& graphics_object_impl_
       ->foreground_objects;
+  graphics_object_impl_->foreground_journal.Reset();
+  graphics_object_impl_->background_journal.Reset();
 
   // Now alert all subclasses that we've set the subtitle
   SetWindowSubtitle(subtitle_,
@@ -57,6 +57,7 @@ class GraphicsObjectData;
 class GraphicsStackFrame;
 class HIKRenderer;
 class HIKScript;
+class ImageInfo;
 class MouseCursor;
 class Renderable;
 class RGBAColour;
@@ -324,6 +325,12 @@ class GraphicsSystem : public EventListener {
   bool screen_needs_refresh() const { return screen_needs_refresh_; }
   void OnScreenRefreshed();
 
+  // Whether the screen should be redrawn on this pass through the game loop.
+  // While fast forwarding, frames are replaced almost as soon as they're
+  // drawn, so pending refreshes are only drawn every 100ms; the last one is
+  // drawn as soon as skipping stops.
+  bool ShouldRefreshScreen();
+
   // We keep a separate state about whether object state has been modified. We
   // do this so that background object mutation in automatic mode plays nicely
   // with LongOperations.
@@ -345,6 +352,12 @@ class GraphicsSystem : public EventListener {
   // things up.
   virtual void ExecuteGraphicsSystem(RLMachine& machine);
 
+  // The tick at which ExecuteGraphicsSystem() next has work to do: the
+  // earliest animation frame of any foreground object, the mouse cursor or the
+  // HIK background. Returns 0 while a redraw or screen shake is pending. See
+  // System::NextWakeupTime().
+  unsigned int NextWakeupTime();
+
   // Returns the size of the window in pixels.
   const Size& screen_size() const { return screen_size_; }
 
@@ -367,12 +380,26 @@ class GraphicsSystem : public EventListener {
   std::shared_ptr<const Surface> GetSurfaceNamed(
       const std::string& short_filename);
 
+  // Returns the size and pattern table of an image, reading only the file
+  // header if the image hasn't already been decoded.
+  std::shared_ptr<const ImageInfo> GetImageInfo(
+      const std::string& short_filename);
+
   virtual std::shared_ptr<Surface> GetHaikei() = 0;
 
   virtual std::shared_ptr<Surface> GetDC(int dc) = 0;
 
   virtual std::shared_ptr<Surface> BuildSurface(const Size& size) = 0;
 
+  // Returns a surface of exactly |size| with undefined contents, reusing one
+  // handed back through RecycleSurface() when possible. Meant for objects
+  // which rebuild their surface every time the value they display changes.
+  std::shared_ptr<Surface> BuildPooledSurface(const Size& size);
+
+  // Offers |surface| for reuse by BuildPooledSurface(). Surfaces that anyone
+  // else still holds a reference to are simply dropped.
+  void RecycleSurface(std::shared_ptr<Surface> surface);
+
   virtual ColourFilter* BuildColourFiller() = 0;
 
   // Clears and promotes objects.
@@ -387,8 +414,11 @@ class GraphicsSystem : public EventListener {
   GraphicsObjectData* BuildObjOfFile(const std::string& filename);
 
   // Object getters
-  // layer == 0 for fg, layer == 1 for bg.
+  // layer == 0 for fg, layer == 1 for bg. The non-const version copies the
+  // object into the savepoint journal first, so only use it to change the
+  // object.
   GraphicsObject& GetObject(int layer, int obj_number);
+  const GraphicsObject& GetObject(int layer, int obj_number) const;
   void SetObject(int layer, int obj_number, GraphicsObject& object);
 
   // Frees the object data (but not the parameters).
@@ -404,8 +434,13 @@ class GraphicsSystem : public EventListener {
   // overridden with #OBJECT_MAX.
   int GetObjectLayerSize();
 
+  // Direct access to a whole layer. Since callers may change any object in
+  // it, the non-const versions copy every object that hasn't changed since
+  // the last savepoint; prefer GetObject() where possible.
   LazyArray<GraphicsObject>& GetBackgroundObjects();
   LazyArray<GraphicsObject>& GetForegroundObjects();
+  const LazyArray<GraphicsObject>& GetBackgroundObjects() const;
+  const LazyArray<GraphicsObject>& GetForegroundObjects() const;
 
   // Returns true if there's a currently playing animation.
   bool AnimationsPlaying() const;
@@ -414,9 +449,9 @@ class GraphicsSystem : public EventListener {
   // instead of the current state of the graphics, since RealLive is a savepoint
   // based system.
   //
-  // (This operation isn't exceptionally expensive; internally GraphicsObject
-  // has multiple copy-on-write data structs to make this and object promotion a
-  // relativly cheap operation.)
+  // (This operation doesn't copy anything; objects are copied into a journal
+  // the first time they change afterwards, and the snapshot is only rebuilt
+  // from that journal when saving.)
   void TakeSavepointSnapshot();
 
   // Sets DC0 to black and frees up DCs 1 through 16.
@@ -450,7 +485,9 @@ class GraphicsSystem : public EventListener {
       const std::string& name,
       const boost::filesystem::path& file);
 
-  // We have a cache of preloaded g00 files.
+  // We have a cache of preloaded g00 files. Preloading is a hint that the
+  // image will be used soon; systems which can decode in the background
+  // start doing so, and the surface is picked up on first use.
   void PreloadG00(int slot, const std::string& name);
   void ClearPreloadedG00(int slot);
   void ClearAllPreloadedG00();
@@ -470,11 +507,32 @@ class GraphicsSystem : public EventListener {
 
   void DrawFrame(std::ostream* tree);
 
+  // Reads an image's metadata. The default implementation decodes the whole
+  // image; systems that can parse the header on its own should override this.
+  virtual std::shared_ptr<const ImageInfo> LoadImageInfoFromFile(
+      const std::string& short_filename);
+
+  // Starts decoding |short_filename| off the main thread, if the system
+  // supports that. A later LoadSurfaceFromFile() call collects the result.
+  virtual void PrefetchSurface(const std::string& short_filename);
+
+  // Throws away the result of a PrefetchSurface() call that nobody is going
+  // to collect.
+  virtual void CancelPrefetch(const std::string& short_filename);
+
  private:
+  // Cancels the prefetch of |name| unless a preload slot still refers to it.
+  void CancelUnusedPrefetch(const std::string& name);
+
   // Gets a platform appropriate surface loaded.
   virtual std::shared_ptr<const Surface> LoadSurfaceFromFile(
       const std::string& short_filename) = 0;
 
+  // Copies object |obj_number| in both layers (or every object) into the
+  // savepoint journals before it changes.
+  void RecordObject(int obj_number);
+  void RecordAllObjects();
+
   // Default grp name (used in grp* and rec* functions where filename
   // is '???')
   std::string default_grp_name_;
@@ -527,6 +585,10 @@ class GraphicsSystem : public EventListener {
   // The last time |screen_shake_queue_| was modified.
   unsigned int time_at_last_queue_change_;
 
+  // When ShouldRefreshScreen() last let a frame through while fast
+  // forwarding.
+  unsigned int time_of_last_fast_forward_frame_;
+
   // Immutable
   struct GraphicsObjectSettings;
   // Immutable global data that's constructed from the Gameexe.ini file.
@@ -578,6 +640,14 @@ class GraphicsSystem : public EventListener {
   // This cache's contents are assumed to be immutable.
   LRUCache<std::string, std::shared_ptr<const Surface>> image_cache_;
 
+  // Metadata is tiny compared to the decoded images, so we keep a lot more of
+  // it around.
+  LRUCache<std::string, std::shared_ptr<const ImageInfo>> image_info_cache_;
+
+  // Released surfaces waiting to be handed out again by
+  // BuildPooledSurface(), oldest first.
+  std::vector<std::shared_ptr<Surface>> surface_pool_;
+
   // Possible background script which drives graphics to the screen.
   std::unique_ptr<HIKRenderer> hik_renderer_;
 
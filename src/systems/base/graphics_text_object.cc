@@ -35,6 +35,7 @@
 #include <vector>
 
 #include "systems/base/graphics_object.h"
+#include "systems/base/graphics_system.h"
 #include "systems/base/surface.h"
 #include "systems/base/system.h"
 #include "systems/base/text_system.h"
@@ -58,33 +59,39 @@ GraphicsTextObject::~GraphicsTextObject() {}
 // -----------------------------------------------------------------------
 
 void GraphicsTextObject::UpdateSurface(const GraphicsObject& rp) {
+  static constexpr GameexeKey kColorTable("COLOR_TABLE");
   cached_utf8_str_ = rp.GetTextText();
 
-  // Get the correct colour
+  // Get the correct colour. Changing only the text (such as with a score
+  // counter) doesn't need to go back to the Gameexe.
   Gameexe& gexe = system_.gameexe();
-  std::vector<int> vec = gexe("COLOR_TABLE", rp.GetTextColour());
-  cached_text_colour_ = rp.GetTextColour();
-  RGBColour colour(vec.at(0), vec.at(1), vec.at(2));
+  if (rp.GetTextColour() != cached_text_colour_) {
+    text_colour_ = RGBColour(gexe(kColorTable, rp.GetTextColour()));
+    cached_text_colour_ = rp.GetTextColour();
+  }
 
   RGBColour* shadow = NULL;
-  RGBColour shadow_impl;
-  cached_shadow_colour_ = rp.GetTextShadowColour();
-  if (rp.GetTextShadowColour() != -1) {
-    vec = gexe("COLOR_TABLE", rp.GetTextShadowColour());
-    shadow_impl = RGBColour(vec.at(0), vec.at(1), vec.at(2));
-    shadow = &shadow_impl;
+  if (rp.GetTextShadowColour() != cached_shadow_colour_) {
+    if (rp.GetTextShadowColour() != -1)
+      shadow_colour_ = RGBColour(gexe(kColorTable, rp.GetTextShadowColour()));
+    cached_shadow_colour_ = rp.GetTextShadowColour();
   }
+  if (cached_shadow_colour_ != -1)
+    shadow = &shadow_colour_;
 
   cached_text_size_ = rp.GetTextSize();
   cached_x_space_ = rp.GetTextXSpace();
   cached_y_space_ = rp.GetTextYSpace();
   cached_char_count_ = rp.GetTextCharCount();
 
+  // Hand our old surface back so RenderText() can reuse it if the new text
+  // comes out the same size.
+  system_.graphics().RecycleSurface(std::move(surface_));
   surface_ = system_.text().RenderText(cached_utf8_str_,
                                        rp.GetTextSize(),
                                        rp.GetTextXSpace(),
                                        rp.GetTextYSpace(),
-                                       colour,
+                                       text_colour_,
                                        shadow,
                                        cached_char_count_);
   surface_->EnsureUploaded();
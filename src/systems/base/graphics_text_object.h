@@ -35,6 +35,7 @@
 
 #include "machine/rlmachine.h"
 #include "machine/serialization.h"
+#include "systems/base/colour.h"
 #include "systems/base/graphics_object_data.h"
 
 class GraphicsObject;
@@ -74,6 +75,11 @@ class GraphicsTextObject : public GraphicsObjectData {
   int cached_char_count_;
   std::string cached_utf8_str_;
 
+  // The COLOR_TABLE entries for |cached_text_colour_| and
+  // |cached_shadow_colour_|.
+  RGBColour text_colour_;
+  RGBColour shadow_colour_;
+
   std::shared_ptr<Surface> surface_;
 
   bool NeedsUpdate(const GraphicsObject& rendering_properties);
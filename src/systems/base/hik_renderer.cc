@@ -26,7 +26,11 @@
 
 #include "systems/base/hik_renderer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
 
 #include "machine/rlmachine.h"
 #include "systems/base/event_system.h"
@@ -36,8 +40,34 @@
 #include "systems/base/system.h"
 #include "utilities/graphics.h"
 
+namespace {
+
+// Returns how far a layer that scrolls |distance| pixels every |period| ms has
+// moved |time| ms after starting, and lowers |next_change| to the tick at
+// which that next changes.
+int ScrollOffset(int distance, int period, int time, int now,
+                 int* next_change) {
+  int phase = time % period;
+  double percent = phase / static_cast<float>(period);
+  int offset = distance * percent;
+
+  if (distance != 0) {
+    // The phase at which we reach the next whole pixel, or wrap around.
+    int64_t pixels = std::abs(offset) + 1;
+    int64_t next_phase = (pixels * period + std::abs(distance) - 1) /
+                         std::abs(distance);
+    next_phase = std::min<int64_t>(next_phase, period);
+    next_phase = std::max<int64_t>(next_phase, phase + 1);
+    *next_change = std::min<int64_t>(*next_change, now + next_phase - phase);
+  }
+
+  return offset;
+}
+
+}  // namespace
+
 HIKRenderer::LayerData::LayerData(int time)
-    : animation_num_(0), animation_start_time_(time) {}
+    : animation_num_(0), animation_start_time_(time), frame_(0) {}
 
 HIKRenderer::HIKRenderer(System& system,
                          const std::shared_ptr<const HIKScript>& script)
@@ -45,7 +75,9 @@ HIKRenderer::HIKRenderer(System& system,
       script_(script),
       creation_time_(system_.event().GetTicks()),
       x_offset_(0),
-      y_offset_(0) {
+      y_offset_(0),
+      next_change_time_(creation_time_),
+      needs_redraw_(true) {
   layer_to_animation_num_.insert(layer_to_animation_num_.begin(),
                                  script->layers().size(),
                                  LayerData(creation_time_));
@@ -54,12 +86,18 @@ HIKRenderer::HIKRenderer(System& system,
 HIKRenderer::~HIKRenderer() {}
 
 void HIKRenderer::Execute(RLMachine& machine) {
-  machine.system().graphics().MarkScreenAsDirty(GUT_DRAW_HIK);
+  int current_ticks = system_.event().GetTicks();
+  if (current_ticks < next_change_time_ && !needs_redraw_)
+    return;
+
+  if (UpdateLayers(current_ticks) || needs_redraw_) {
+    machine.system().graphics().MarkScreenAsDirty(GUT_DRAW_HIK);
+    needs_redraw_ = false;
+  }
 }
 
 void HIKRenderer::Render(std::ostream* tree) {
-  int current_ticks = system_.event().GetTicks();
-  int time_since_creation = current_ticks - creation_time_;
+  UpdateLayers(system_.event().GetTicks());
 
   if (tree) {
     *tree << "  HIK Script:" << std::endl;
@@ -70,8 +108,87 @@ void HIKRenderer::Render(std::ostream* tree) {
            it = script_->layers().begin();
        it != script_->layers().end();
        ++it, ++layer_num) {
-    // Calculate the source rectangle
+    const LayerData& layer_data = layer_to_animation_num_.at(layer_num);
+    const HIKScript::Animation* animation =
+        &it->animations.at(layer_data.animation_num_);
+    size_t frame_to_use = layer_data.frame_;
+    const HIKScript::Frame& frame = animation->frames.at(frame_to_use);
+
+    int pattern_to_use = 0;
+    if (frame.grp_pattern != -1)
+      pattern_to_use = frame.grp_pattern;
+
+    Rect src_rect = frame.surface->GetPattern(pattern_to_use).rect;
+    src_rect =
+        Rect(src_rect.origin() + Size(x_offset_, y_offset_), src_rect.size());
+    Rect dest_rect(layer_data.dest_point_, src_rect.size());
+    if (it->use_clip_area)
+      ClipDestination(it->clip_area, src_rect, dest_rect);
+
+    frame.surface->RenderToScreen(src_rect, dest_rect, frame.opacity);
+
+    if (tree) {
+      *tree << "    [L:" << (std::distance(script_->layers().begin(), it) + 1)
+            << "/" << script_->layers().size()
+            << ", A:" << (layer_data.animation_num_ + 1) << "/"
+            << it->animations.size() << ", F:" << (frame_to_use + 1) << "/"
+            << animation->frames.size() << ", P:" << pattern_to_use
+            << ", ??: " << animation->use_multiframe_animation << "/"
+            << animation->i_30101 << "/" << animation->i_30102
+            << ", O:" << frame.opacity << ", Image: " << frame.image << "]"
+            << std::endl;
+    }
+  }
+}
+
+void HIKRenderer::NextAnimationFrame() {
+  int time = system_.event().GetTicks();
+
+  int idx = 0;
+  for (std::vector<LayerData>::iterator it = layer_to_animation_num_.begin();
+       it != layer_to_animation_num_.end();
+       ++it, ++idx) {
+    it->animation_num_++;
+    if (it->animation_num_ == script_->layers().at(idx).animations.size())
+      it->animation_num_ = 0;
+
+    it->animation_start_time_ = time;
+  }
+
+  next_change_time_ = time;
+  needs_redraw_ = true;
+}
 
+unsigned int HIKRenderer::NextWakeupTime() const {
+  if (needs_redraw_)
+    return 0;
+  if (next_change_time_ == std::numeric_limits<int>::max())
+    return std::numeric_limits<unsigned int>::max();
+  return next_change_time_;
+}
+
+void HIKRenderer::set_x_offset(int offset) {
+  x_offset_ = offset;
+  needs_redraw_ = true;
+}
+
+void HIKRenderer::set_y_offset(int offset) {
+  y_offset_ = offset;
+  needs_redraw_ = true;
+}
+
+bool HIKRenderer::UpdateLayers(int current_ticks) {
+  int time_since_creation = current_ticks - creation_time_;
+  int next_change = std::numeric_limits<int>::max();
+  bool changed = false;
+
+  int layer_num = 0;
+  for (std::vector<HIKScript::Layer>::const_iterator
+           it = script_->layers().begin();
+       it != script_->layers().end();
+       ++it, ++layer_num) {
+    // Scrolling layers move linearly, so their position is a function of
+    // the time alone.
     Point dest_point = it->top_offset;
     if (it->use_scrolling) {
       dest_point += it->start_point;
@@ -80,30 +197,33 @@ void HIKRenderer::Render(std::ostream* tree) {
       int x_difference = 0;
       int y_difference = 0;
       if (it->x_scroll_time_ms) {
-        double x_percent = (time_since_creation % it->x_scroll_time_ms) /
-                           static_cast<float>(it->x_scroll_time_ms);
-        x_difference = difference.width() * x_percent;
+        x_difference = ScrollOffset(difference.width(), it->x_scroll_time_ms,
+                                    time_since_creation, current_ticks,
+                                    &next_change);
       }
       if (it->y_scroll_time_ms) {
-        double y_percent = (time_since_creation % it->y_scroll_time_ms) /
-                           static_cast<float>(it->y_scroll_time_ms);
-        y_difference = difference.height() * y_percent;
+        y_difference = ScrollOffset(difference.height(), it->y_scroll_time_ms,
+                                    time_since_creation, current_ticks,
+                                    &next_change);
       }
 
       dest_point += Point(x_difference, y_difference);
     }
 
     LayerData& layer_data = layer_to_animation_num_.at(layer_num);
+    int previous_animation = layer_data.animation_num_;
     const HIKScript::Animation* animation =
         &it->animations.at(layer_data.animation_num_);
     size_t frame_to_use = 0;
-    if (animation->use_multiframe_animation) {
+    // An animation with no running time just holds its first frame.
+    if (animation->use_multiframe_animation && animation->total_time > 0) {
       int ticks_since_animation_began =
           current_ticks - layer_data.animation_start_time_;
 
       // Advance to the correct animation.
       bool advanced = false;
-      while (ticks_since_animation_began > animation->total_time) {
+      while (ticks_since_animation_began > animation->total_time &&
+             animation->total_time > 0) {
         switch (animation->i_30101) {
           case 0:
             // Don't change the animation number.
@@ -123,62 +243,27 @@ void HIKRenderer::Render(std::ostream* tree) {
         advanced = true;
       }
 
-      if (advanced)
-        layer_data.animation_start_time_ = current_ticks;
-
-      while (ticks_since_animation_began > 0) {
-        ticks_since_animation_began -=
-            animation->frames.at(frame_to_use).frame_length_ms;
+      frame_to_use = animation->FrameAt(ticks_since_animation_began);
 
-        if (ticks_since_animation_began > 0) {
-          frame_to_use++;
-          if (frame_to_use > animation->frames.size()) {
-            frame_to_use = 0;
-          }
-        }
+      if (advanced) {
+        // The animation's clock restarts now, so look again next tick.
+        layer_data.animation_start_time_ = current_ticks;
+        next_change = std::min(next_change, current_ticks + 1);
+      } else if (frame_to_use < animation->frame_end_times.size()) {
+        next_change = std::min(
+            next_change,
+            layer_data.animation_start_time_ +
+                animation->frame_end_times[frame_to_use] + 1);
       }
     }
 
-    const HIKScript::Frame& frame = animation->frames.at(frame_to_use);
-
-    int pattern_to_use = 0;
-    if (frame.grp_pattern != -1)
-      pattern_to_use = frame.grp_pattern;
-
-    Rect src_rect = frame.surface->GetPattern(pattern_to_use).rect;
-    src_rect =
-        Rect(src_rect.origin() + Size(x_offset_, y_offset_), src_rect.size());
-    Rect dest_rect(dest_point, src_rect.size());
-    if (it->use_clip_area)
-      ClipDestination(it->clip_area, src_rect, dest_rect);
-
-    frame.surface->RenderToScreen(src_rect, dest_rect, frame.opacity);
-
-    if (tree) {
-      *tree << "    [L:" << (std::distance(script_->layers().begin(), it) + 1)
-            << "/" << script_->layers().size()
-            << ", A:" << (layer_data.animation_num_ + 1) << "/"
-            << it->animations.size() << ", F:" << (frame_to_use + 1) << "/"
-            << animation->frames.size() << ", P:" << pattern_to_use
-            << ", ??: " << animation->use_multiframe_animation << "/"
-            << animation->i_30101 << "/" << animation->i_30102
-            << ", O:" << frame.opacity << ", Image: " << frame.image << "]"
-            << std::endl;
-    }
+    changed = changed || dest_point != layer_data.dest_point_ ||
+              frame_to_use != layer_data.frame_ ||
+              layer_data.animation_num_ != previous_animation;
+    layer_data.dest_point_ = dest_point;
+    layer_data.frame_ = frame_to_use;
   }
-}
-
-void HIKRenderer::NextAnimationFrame() {
-  int time = system_.event().GetTicks();
-
-  int idx = 0;
-  for (std::vector<LayerData>::iterator it = layer_to_animation_num_.begin();
-       it != layer_to_animation_num_.end();
-       ++it, ++idx) {
-    it->animation_num_++;
-    if (it->animation_num_ == script_->layers().at(idx).animations.size())
-      it->animation_num_ = 0;
 
-    it->animation_start_time_ = time;
-  }
+  next_change_time_ = next_change;
+  return changed;
 }
@@ -30,6 +30,8 @@
 #include <memory>
 #include <vector>
 
+#include "systems/base/rect.h"
+
 class HIKScript;
 class RLMachine;
 class System;
@@ -40,7 +42,8 @@ class HIKRenderer {
   HIKRenderer(System& system, const std::shared_ptr<const HIKScript>& script);
   ~HIKRenderer();
 
-  // Run once per tick.
+  // Run once per tick. Only asks for a redraw when some layer's frame or
+  // position has actually changed.
   void Execute(RLMachine& machine);
 
   void Render(std::ostream* os);
@@ -50,10 +53,19 @@ class HIKRenderer {
 
   // RL bytecode controlled offsets from the top left corner of the source
   // image.
-  void set_x_offset(int offset) { x_offset_ = offset; }
-  void set_y_offset(int offset) { y_offset_ = offset; }
+  void set_x_offset(int offset);
+  void set_y_offset(int offset);
+
+  // The tick at which the next frame change or scroll step happens; 0 if a
+  // redraw is already pending.
+  unsigned int NextWakeupTime() const;
 
  private:
+  // Brings every layer's animation, frame and position up to |current_ticks|
+  // and recomputes |next_change_time_|. Returns whether anything visible
+  // changed.
+  bool UpdateLayers(int current_ticks);
+
   System& system_;
 
   // The script data.
@@ -67,10 +79,20 @@ class HIKRenderer {
   int x_offset_;
   int y_offset_;
 
+  // Nothing about the layers can change before this tick.
+  int next_change_time_;
+
+  // Set when bytecode changes what we display behind UpdateLayers()'s back.
+  bool needs_redraw_;
+
   struct LayerData {
     explicit LayerData(int time);
     int animation_num_;
     int animation_start_time_;
+
+    // The frame and screen position as of the last UpdateLayers().
+    size_t frame_;
+    Point dest_point_;
   };
 
   // Which animation frame to use per layer. Defaults to zero.
@@ -27,6 +27,7 @@
 #include "systems/base/hik_script.h"
 
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -256,12 +257,14 @@ void HIKScript::LoadHikFile(System& system, const fs::path& file) {
     }
   }
 
-  // For every Animation, sum up the frame_length_ms.
+  // For every Animation, build the timeline of when each frame ends.
   for (Layer& layer : layers_) {
     for (Animation& animation : layer.animations) {
       animation.total_time = 0;
+      animation.frame_end_times.clear();
       for (Frame& frame : animation.frames) {
         animation.total_time += frame.frame_length_ms;
+        animation.frame_end_times.push_back(animation.total_time);
       }
     }
   }
@@ -281,6 +284,17 @@ void HIKScript::EnsureUploaded() {
   }
 }
 
+size_t HIKScript::Animation::FrameAt(int ms) const {
+  // The first frame that hasn't ended by |ms|.
+  size_t frame = std::lower_bound(frame_end_times.begin(),
+                                  frame_end_times.end(),
+                                  ms) -
+                 frame_end_times.begin();
+  if (frame >= frame_end_times.size() && frame > 0)
+    frame = frame_end_times.size() - 1;
+  return frame;
+}
+
 HIKScript::Layer& HIKScript::CurrentLayer() {
   if (layers_.size() == 0) {
     throw rlvm::Exception("Invalid layer reference");
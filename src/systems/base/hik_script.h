@@ -81,6 +81,13 @@ class HIKScript {
 
     // The sum of all |frame_length_ms| in frames.
     int total_time;
+
+    // For each frame, the time since the start of the animation at which it
+    // stops being displayed. Computed at load time.
+    std::vector<int> frame_end_times;
+
+    // Returns the frame that is displayed |ms| into this animation.
+    size_t FrameAt(int ms) const;
   };
 
   // The contents of the 20000 keys.
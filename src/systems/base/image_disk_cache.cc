@@ -0,0 +1,371 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#include "systems/base/image_disk_cache.h"
+
+#include <zlib.h>
+
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "libreallive/filemap.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const char kMagic[8] = {'R', 'L', 'V', 'M', 'I', 'M', 'G', '1'};
+const char kExtension[] = ".img";
+
+enum Compression { COMPRESSION_NONE = 0, COMPRESSION_ZLIB = 1 };
+
+// Followed by |key_size| bytes of key, padding up to
+// AssetPack::kAlignment and then |stored_size| bytes of payload, which
+// inflates to |payload_size| bytes when compressed.
+struct FileHeader {
+  char magic[8];
+  uint32_t compression;
+  uint32_t key_size;
+  uint64_t payload_size;
+  uint64_t stored_size;
+};
+
+size_t PayloadOffset(size_t key_size) {
+  size_t offset = sizeof(FileHeader) + key_size;
+  return (offset + AssetPack::kAlignment - 1) / AssetPack::kAlignment *
+         AssetPack::kAlignment;
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+// ImageDiskCache::Image
+// -----------------------------------------------------------------------
+ImageDiskCache::Image::Image() : header_(), pixels_(NULL) {}
+
+ImageDiskCache::Image::~Image() {}
+
+// -----------------------------------------------------------------------
+// ImageDiskCache
+// -----------------------------------------------------------------------
+ImageDiskCache::ImageDiskCache(const fs::path& directory,
+                               uint64_t max_bytes,
+                               bool compress)
+    : directory_(directory),
+      max_bytes_(max_bytes),
+      compress_(compress),
+      index_loaded_(false),
+      total_bytes_(0) {}
+
+ImageDiskCache::~ImageDiskCache() { Flush(); }
+
+bool ImageDiskCache::Contains(const fs::path& file,
+                              const std::string& variant) {
+  std::string key;
+  std::string name = EntryName(file, variant, &key);
+  if (name.empty())
+    return false;
+
+  std::lock_guard<std::mutex> lock(lock_);
+  LoadIndexLocked();
+  return index_.count(name) != 0;
+}
+
+std::shared_ptr<const ImageDiskCache::Image> ImageDiskCache::Fetch(
+    const fs::path& file,
+    const std::string& variant) {
+  std::string key;
+  std::string name = EntryName(file, variant, &key);
+  if (name.empty())
+    return std::shared_ptr<const Image>();
+
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    LoadIndexLocked();
+    auto it = index_.find(name);
+    if (it == index_.end())
+      return std::shared_ptr<const Image>();
+    it->second.last_used = std::time(NULL);
+  }
+
+  fs::path path = directory_ / name;
+  std::shared_ptr<Image> image(new Image);
+  try {
+    image->mapping_.reset(
+        new libreallive::Mapping(path.string(), libreallive::Read));
+  } catch (std::exception&) {
+    Discard(name);
+    return std::shared_ptr<const Image>();
+  }
+
+  const char* data = image->mapping_->get();
+  size_t size = image->mapping_->size();
+  FileHeader header;
+  if (size < sizeof(header)) {
+    Discard(name);
+    return std::shared_ptr<const Image>();
+  }
+  memcpy(&header, data, sizeof(header));
+
+  size_t payload_offset = PayloadOffset(header.key_size);
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      payload_offset > size || size - payload_offset < header.stored_size ||
+      header.key_size != key.size() ||
+      memcmp(data + sizeof(header), key.data(), key.size()) != 0) {
+    // A stale file from another version or a hash collision.
+    Discard(name);
+    return std::shared_ptr<const Image>();
+  }
+
+  const char* payload = data + payload_offset;
+  size_t payload_size = header.stored_size;
+  if (header.compression == COMPRESSION_ZLIB) {
+    image->inflated_.resize(header.payload_size);
+    uLongf inflated_size = header.payload_size;
+    if (uncompress(reinterpret_cast<Bytef*>(image->inflated_.data()),
+                   &inflated_size,
+                   reinterpret_cast<const Bytef*>(payload),
+                   header.stored_size) != Z_OK ||
+        inflated_size != header.payload_size) {
+      Discard(name);
+      return std::shared_ptr<const Image>();
+    }
+    image->mapping_.reset();
+    payload = image->inflated_.data();
+    payload_size = inflated_size;
+  }
+
+  image->pixels_ = AssetPack::ParseImage(payload, payload_size,
+                                         &image->header_, &image->regions_);
+  if (!image->pixels_) {
+    Discard(name);
+    return std::shared_ptr<const Image>();
+  }
+
+  // The modification time doubles as the LRU timestamp in later sessions.
+  boost::system::error_code ec;
+  fs::last_write_time(path, std::time(NULL), ec);
+  return image;
+}
+
+void ImageDiskCache::Store(const fs::path& file,
+                           const std::string& variant,
+                           AssetPack::ImageHeader header,
+                           const std::vector<AssetPack::ImageRegion>& regions,
+                           const char* pixels) {
+  std::string key;
+  std::string name = EntryName(file, variant, &key);
+  if (name.empty())
+    return;
+
+  // Copy the pixels now; compressing and writing happen in the background.
+  auto payload = std::make_shared<std::vector<char>>(
+      AssetPack::SerializeImage(header, regions, pixels));
+  if (payload->size() > max_bytes_)
+    return;
+
+  std::lock_guard<std::mutex> lock(lock_);
+  pending_writes_.erase(
+      std::remove_if(pending_writes_.begin(), pending_writes_.end(),
+                     [](const std::future<void>& write) {
+                       return write.wait_for(std::chrono::seconds(0)) ==
+                              std::future_status::ready;
+                     }),
+      pending_writes_.end());
+  pending_writes_.push_back(
+      std::async(std::launch::async, [this, name, key, payload]() {
+        WriteEntry(name, key, *payload);
+      }));
+}
+
+void ImageDiskCache::Flush() {
+  std::vector<std::future<void>> writes;
+  {
+    std::lock_guard<std::mutex> lock(lock_);
+    writes.swap(pending_writes_);
+  }
+  for (std::future<void>& write : writes)
+    write.wait();
+}
+
+uint64_t ImageDiskCache::size() {
+  std::lock_guard<std::mutex> lock(lock_);
+  LoadIndexLocked();
+  return total_bytes_;
+}
+
+// static
+std::string ImageDiskCache::EntryName(const fs::path& file,
+                                      const std::string& variant,
+                                      std::string* key) {
+  // Files inside an asset pack change when the pack does.
+  AssetPack::Entry entry;
+  std::shared_ptr<AssetPack> pack = AssetPack::FindMounted(file, &entry);
+  boost::system::error_code ec;
+  std::time_t mtime = fs::last_write_time(pack ? pack->file() : file, ec);
+  if (ec)
+    return std::string();
+
+  std::ostringstream oss;
+  oss << file.string() << '\n' << mtime << '\n' << variant;
+  *key = oss.str();
+
+  std::ostringstream name;
+  name << std::hex << std::setw(16) << std::setfill('0')
+       << static_cast<uint64_t>(std::hash<std::string>()(*key)) << kExtension;
+  return name.str();
+}
+
+void ImageDiskCache::LoadIndexLocked() {
+  if (index_loaded_)
+    return;
+  index_loaded_ = true;
+
+  boost::system::error_code ec;
+  fs::create_directories(directory_, ec);
+  for (fs::directory_iterator it(directory_, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    const fs::path& path = it->path();
+    if (path.extension() != kExtension)
+      continue;
+
+    boost::system::error_code stat_ec;
+    uint64_t size = fs::file_size(path, stat_ec);
+    std::time_t last_used = fs::last_write_time(path, stat_ec);
+    if (stat_ec)
+      continue;
+
+    index_[path.filename().string()] = IndexEntry{size, last_used};
+    total_bytes_ += size;
+  }
+
+  EvictLocked();
+}
+
+void ImageDiskCache::EvictLocked() {
+  if (total_bytes_ <= max_bytes_)
+    return;
+
+  std::vector<std::pair<std::time_t, std::string>> by_age;
+  for (auto const& entry : index_)
+    by_age.emplace_back(entry.second.last_used, entry.first);
+  std::sort(by_age.begin(), by_age.end());
+
+  for (auto const& entry : by_age) {
+    if (total_bytes_ <= max_bytes_)
+      break;
+
+    boost::system::error_code ec;
+    fs::remove(directory_ / entry.second, ec);
+    total_bytes_ -= index_[entry.second].size;
+    index_.erase(entry.second);
+  }
+}
+
+void ImageDiskCache::Discard(const std::string& name) {
+  std::lock_guard<std::mutex> lock(lock_);
+  auto it = index_.find(name);
+  if (it == index_.end())
+    return;
+
+  boost::system::error_code ec;
+  fs::remove(directory_ / name, ec);
+  total_bytes_ -= it->second.size;
+  index_.erase(it);
+}
+
+void ImageDiskCache::WriteEntry(const std::string& name,
+                                const std::string& key,
+                                const std::vector<char>& payload) {
+  FileHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.compression = COMPRESSION_NONE;
+  header.key_size = key.size();
+  header.payload_size = payload.size();
+  header.stored_size = payload.size();
+
+  const char* stored = payload.data();
+  std::vector<char> compressed;
+  if (compress_) {
+    uLongf compressed_size = compressBound(payload.size());
+    compressed.resize(compressed_size);
+    if (compress2(reinterpret_cast<Bytef*>(compressed.data()),
+                  &compressed_size,
+                  reinterpret_cast<const Bytef*>(payload.data()),
+                  payload.size(),
+                  Z_BEST_SPEED) == Z_OK) {
+      header.compression = COMPRESSION_ZLIB;
+      header.stored_size = compressed_size;
+      stored = compressed.data();
+    }
+  }
+
+  // Write under a temporary name so that a concurrent Fetch() never maps a
+  // partial entry.
+  fs::path path = directory_ / name;
+  fs::path temp_path = directory_ / (name + ".tmp");
+  boost::system::error_code ec;
+  fs::create_directories(directory_, ec);
+
+  static const char kPadding[AssetPack::kAlignment] = {0};
+  fs::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(key.data(), key.size());
+  out.write(kPadding, PayloadOffset(key.size()) - sizeof(header) - key.size());
+  out.write(stored, header.stored_size);
+  out.close();
+
+  bool written = !out.fail();
+  if (written)
+    fs::rename(temp_path, path, ec);
+  if (!written || ec) {
+    fs::remove(temp_path, ec);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(lock_);
+  LoadIndexLocked();
+  uint64_t size = PayloadOffset(key.size()) + header.stored_size;
+  auto it = index_.find(name);
+  if (it != index_.end())
+    total_bytes_ -= it->second.size;
+  index_[name] = IndexEntry{size, std::time(NULL)};
+  total_bytes_ += size;
+  EvictLocked();
+}
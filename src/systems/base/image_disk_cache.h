@@ -0,0 +1,157 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_SYSTEMS_BASE_IMAGE_DISK_CACHE_H_
+#define SRC_SYSTEMS_BASE_IMAGE_DISK_CACHE_H_
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstdint>
+#include <ctime>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utilities/asset_pack.h"
+
+namespace libreallive {
+class Mapping;
+}  // namespace libreallive
+
+// An opt-in cache of decoded, display ready images that persists between
+// sessions, so that the second run through a route doesn't run the g00/pdt
+// converters again. Each entry is one file in |directory| (normally next to
+// the save games) holding the pixels in AssetPack's ENCODING_RGBA layout,
+// either as is, so that a hit is just a memory mapping, or zlib compressed.
+//
+// Entries are keyed by the source file's path and modification time plus a
+// variant string, which callers use for the tone curve suffix since the
+// cached pixels have the tone curve applied. Once the directory grows past
+// |max_bytes|, the least recently used entries are deleted.
+//
+// All methods are safe to call from any thread.
+class ImageDiskCache {
+ public:
+  // An image read back from the cache.
+  class Image {
+   public:
+    ~Image();
+
+    int width() const { return header_.width; }
+    int height() const { return header_.height; }
+    bool is_mask() const { return header_.is_mask; }
+    const std::vector<AssetPack::ImageRegion>& regions() const {
+      return regions_;
+    }
+
+    // width() * height() 32-bit pixels.
+    const char* pixels() const { return pixels_; }
+
+   private:
+    friend class ImageDiskCache;
+    Image();
+
+    AssetPack::ImageHeader header_;
+    std::vector<AssetPack::ImageRegion> regions_;
+    const char* pixels_;
+
+    // What |pixels_| points into: the mapped entry, or the inflated copy of a
+    // compressed one.
+    std::unique_ptr<libreallive::Mapping> mapping_;
+    std::vector<char> inflated_;
+  };
+
+  ImageDiskCache(const boost::filesystem::path& directory,
+                 uint64_t max_bytes,
+                 bool compress);
+  ~ImageDiskCache();
+
+  // Whether there's an entry for the current version of |file|.
+  bool Contains(const boost::filesystem::path& file,
+                const std::string& variant);
+
+  // Returns the cached image for the current version of |file|, or NULL.
+  std::shared_ptr<const Image> Fetch(const boost::filesystem::path& file,
+                                     const std::string& variant);
+
+  // Writes an entry for |file| on a worker thread.
+  void Store(const boost::filesystem::path& file,
+             const std::string& variant,
+             AssetPack::ImageHeader header,
+             const std::vector<AssetPack::ImageRegion>& regions,
+             const char* pixels);
+
+  // Waits until every Store() has reached the disk.
+  void Flush();
+
+  // Bytes used by the entries on disk.
+  uint64_t size();
+
+ private:
+  struct IndexEntry {
+    uint64_t size;
+    std::time_t last_used;
+  };
+
+  // Returns the name of the entry file for |file| and |variant|, and the full
+  // key that is stored inside it to detect hash collisions. Returns an empty
+  // string if |file| doesn't exist.
+  static std::string EntryName(const boost::filesystem::path& file,
+                               const std::string& variant,
+                               std::string* key);
+
+  // Lists the entries already on disk the first time it's called. Requires
+  // |lock_|.
+  void LoadIndexLocked();
+
+  // Deletes least recently used entries until we're under |max_bytes_|.
+  // Requires |lock_|.
+  void EvictLocked();
+
+  // Deletes the entry |name|, which turned out to be unreadable.
+  void Discard(const std::string& name);
+
+  void WriteEntry(const std::string& name,
+                  const std::string& key,
+                  const std::vector<char>& payload);
+
+  boost::filesystem::path directory_;
+  uint64_t max_bytes_;
+  bool compress_;
+
+  std::mutex lock_;
+  bool index_loaded_;
+  std::map<std::string, IndexEntry> index_;
+  uint64_t total_bytes_;
+  std::vector<std::future<void>> pending_writes_;
+};
+
+#endif  // SRC_SYSTEMS_BASE_IMAGE_DISK_CACHE_H_
@@ -0,0 +1,59 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#include "systems/base/image_info.h"
+
+#include <vector>
+
+ImageInfo::ImageInfo(const Size& size,
+                     const std::vector<Surface::GrpRect>& regions)
+    : size_(size), regions_(regions) {
+  if (regions_.empty()) {
+    Surface::GrpRect rect;
+    rect.rect = Rect(Point(0, 0), size);
+    rect.originX = 0;
+    rect.originY = 0;
+    regions_.push_back(rect);
+  }
+}
+
+ImageInfo::ImageInfo(const Surface& surface) : size_(surface.GetSize()) {
+  for (int i = 0; i < surface.GetNumPatterns(); ++i)
+    regions_.push_back(surface.GetPattern(i));
+  if (regions_.empty())
+    regions_.push_back(surface.GetPattern(0));
+}
+
+ImageInfo::~ImageInfo() {}
+
+const Surface::GrpRect& ImageInfo::GetPattern(int patt_no) const {
+  if (patt_no >= 0 && patt_no < regions_.size())
+    return regions_[patt_no];
+  else
+    return regions_[0];
+}
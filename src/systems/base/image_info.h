@@ -0,0 +1,65 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_SYSTEMS_BASE_IMAGE_INFO_H_
+#define SRC_SYSTEMS_BASE_IMAGE_INFO_H_
+
+#include <vector>
+
+#include "systems/base/rect.h"
+#include "systems/base/surface.h"
+
+// The parts of an image file that can be read out of its header: its size and
+// its table of pattern regions. Lets graphics objects answer layout questions
+// (object sizes, animation lengths, hit testing) without decoding the pixels,
+// which only happens once the object is actually drawn.
+class ImageInfo {
+ public:
+  ImageInfo(const Size& size, const std::vector<Surface::GrpRect>& regions);
+
+  // Copies the metadata out of an already decoded surface.
+  explicit ImageInfo(const Surface& surface);
+
+  ~ImageInfo();
+
+  const Size& size() const { return size_; }
+
+  // Same semantics as Surface::GetNumPatterns() / Surface::GetPattern();
+  // out of range patterns fall back to the first one.
+  int GetNumPatterns() const { return regions_.size(); }
+  const Surface::GrpRect& GetPattern(int patt_no) const;
+
+ private:
+  Size size_;
+
+  // Never empty; an image without a region table has one region covering
+  // the whole image.
+  std::vector<Surface::GrpRect> regions_;
+};
+
+#endif  // SRC_SYSTEMS_BASE_IMAGE_INFO_H_
@@ -57,19 +57,18 @@
 
 #include "systems/base/koepac_voice_archive.h"
 
-#include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/path.hpp>
 
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
-#include <fstream>
 #include <sstream>
 #include <vector>
 
 #include "utilities/exception.h"
+#include "utilities/file.h"
 #include "xclannad/endian.hpp"
 
-using std::ifstream;
 using std::ostringstream;
 namespace fs = boost::filesystem;
 
@@ -149,7 +148,7 @@ uint8_t koe_ad_trans_tbl[256] = {
 class KOEPACVoiceSample : public VoiceSample {
  public:
   KOEPACVoiceSample(fs::path file, int offset, int length, int rate)
-      : stream_(std::fopen(file.native().c_str(), "rb")),
+      : stream_(OpenFile(file)),
         offset_(offset),
         length_(length),
         rate_(rate) {}
@@ -277,8 +276,8 @@ std::shared_ptr<VoiceSample> KOEPACVoiceArchive::FindSample(int sample_num) {
 // -----------------------------------------------------------------------
 
 void KOEPACVoiceArchive::ReadTable(boost::filesystem::path file) {
-  fs::ifstream ifs(file, ifstream::in | ifstream::binary);
-  if (!ifs) {
+  FILE* stream = OpenFile(file);
+  if (!stream) {
     std::ostringstream oss;
     oss << "Could not open file \"" << file << "\".";
     throw rlvm::Exception(oss.str());
@@ -286,8 +285,9 @@ void KOEPACVoiceArchive::ReadTable(boost::filesystem::path file) {
 
   // Copied from koedec.cc
   char head[0x20];
-  ifs.read(head, 0x20);
-  if (strncmp(head, "KOEPAC", 7) != 0) {
+  if (fread(head, 1, 0x20, stream) != 0x20 ||
+      strncmp(head, "KOEPAC", 7) != 0) {
+    fclose(stream);
     std::ostringstream oss;
     oss << file << " does not appear to be in KOEPAC format";
     throw rlvm::Exception(oss.str());
@@ -302,7 +302,15 @@ void KOEPACVoiceArchive::ReadTable(boost::filesystem::path file) {
   }
 
   char* buf = new char[table_len * 8];
-  ifs.read(buf, table_len * 8);
+  size_t read = fread(buf, 8, table_len, stream);
+  fclose(stream);
+  if (read != static_cast<size_t>(table_len)) {
+    delete[] buf;
+    std::ostringstream oss;
+    oss << "Truncated KOEPAC table in " << file;
+    throw rlvm::Exception(oss.str());
+  }
+
   for (int i = 0; i < table_len; i++) {
     int koe_num = read_little_endian_short(buf + i * 8);
     int length = read_little_endian_short(buf + i * 8 + 2);
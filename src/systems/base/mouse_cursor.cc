@@ -80,6 +80,10 @@ void MouseCursor::Execute(System& system) {
   }
 }
 
+unsigned int MouseCursor::NextWakeupTime() const {
+  return last_time_frame_incremented_ + frame_speed_ + 1;
+}
+
 void MouseCursor::RenderHotspotAt(const Point& mouse_location) {
   Point render_point = GetTopLeftForHotspotAt(mouse_location);
   cursor_surface_->RenderToScreen(
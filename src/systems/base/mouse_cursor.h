@@ -48,6 +48,9 @@ class MouseCursor {
   // Updates the MouseCursor.
   void Execute(System& system);
 
+  // Returns the tick at which Execute() will next advance the animation.
+  unsigned int NextWakeupTime() const;
+
   // Renders the cursor to the screen, taking the hotspot offset into account.
   void RenderHotspotAt(const Point& mouse_pt);
 
@@ -26,8 +26,10 @@
 
 #include "systems/base/nwk_voice_archive.h"
 
-#include <cstdio>
+#include <memory>
 
+#include "libreallive/filemap.h"
+#include "utilities/asset_pack.h"
 #include "utilities/exception.h"
 #include "xclannad/endian.hpp"
 #include "xclannad/wavfile.h"
@@ -40,39 +42,47 @@ namespace {
 // NWA files thrown together with
 class NWKVoiceSample : public VoiceSample {
  public:
-  NWKVoiceSample(boost::filesystem::path file, int offset, int length);
+  NWKVoiceSample(std::shared_ptr<const char> archive,
+                 size_t archive_size,
+                 int offset,
+                 int length);
   virtual ~NWKVoiceSample();
 
   // Overridden from VoiceSample:
   virtual char* Decode(int* size) override;
 
  private:
-  FILE* stream_;
+  // The whole archive, mapped into memory and shared by every sample.
+  std::shared_ptr<const char> archive_;
+  size_t archive_size_;
   int offset_;
   int length_;
 };
 
-NWKVoiceSample::NWKVoiceSample(boost::filesystem::path file,
+NWKVoiceSample::NWKVoiceSample(std::shared_ptr<const char> archive,
+                               size_t archive_size,
                                int offset,
                                int length)
-    : stream_(std::fopen(file.native().c_str(), "rb")),
+    : archive_(archive),
+      archive_size_(archive_size),
       offset_(offset),
       length_(length) {}
 
-NWKVoiceSample::~NWKVoiceSample() {
-  if (stream_)
-    fclose(stream_);
-}
+NWKVoiceSample::~NWKVoiceSample() {}
 
 char* NWKVoiceSample::Decode(int* size) {
+  if (offset_ < 0 || length_ <= 0 ||
+      static_cast<size_t>(offset_) + length_ > archive_size_)
+    return NULL;
+
   // Defined in nwatowav.cc
-  return decode_koe_nwa(stream_, offset_, length_, size);
+  return decode_nwa(archive_.get() + offset_, length_, size);
 }
 
 }  // namespace
 
 NWKVoiceArchive::NWKVoiceArchive(fs::path file, int file_no)
-    : VoiceArchive(file_no), file_(file) {
+    : VoiceArchive(file_no), file_(file), archive_size_(0) {
   ReadVisualArtsTable(file, 12, entries_);
 }
 
@@ -82,8 +92,23 @@ std::shared_ptr<VoiceSample> NWKVoiceArchive::FindSample(int sample_num) {
   std::vector<Entry>::const_iterator it =
       std::lower_bound(entries_.begin(), entries_.end(), sample_num);
   if (it != entries_.end()) {
-    return std::shared_ptr<VoiceSample>(
-        new NWKVoiceSample(file_, it->offset, it->length));
+    if (!archive_) {
+      // Point into either the AssetPack or our own mapping, keeping
+      // whichever it is alive for as long as any sample needs it.
+      AssetPack::Entry entry;
+      if (std::shared_ptr<AssetPack> pack =
+              AssetPack::FindMounted(file_, &entry)) {
+        archive_ = std::shared_ptr<const char>(pack, entry.data);
+        archive_size_ = entry.size;
+      } else {
+        auto mapping = std::make_shared<libreallive::Mapping>(
+            file_.string(), libreallive::Read);
+        archive_ = std::shared_ptr<const char>(mapping, mapping->get());
+        archive_size_ = mapping->size();
+      }
+    }
+    return std::shared_ptr<VoiceSample>(new NWKVoiceSample(
+        archive_, archive_size_, it->offset, it->length));
   }
 
   throw rlvm::Exception("Couldn't find sample in NWKVoiceArchive");
@@ -29,6 +29,7 @@
 
 #include <boost/filesystem/path.hpp>
 
+#include <memory>
 #include <vector>
 
 #include "systems/base/voice_archive.h"
@@ -46,6 +47,11 @@ class NWKVoiceArchive : public VoiceArchive {
   // The file to read from
   boost::filesystem::path file_;
 
+  // The bytes of |file_|, either mapped into memory or inside an AssetPack;
+  // set up when the first sample is requested.
+  std::shared_ptr<const char> archive_;
+  size_t archive_size_;
+
   std::vector<Entry> entries_;
 };
 
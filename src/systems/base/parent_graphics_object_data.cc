@@ -28,6 +28,9 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/serialization/export.hpp>
 
+#include <algorithm>
+#include <climits>
+
 #include "systems/base/parent_graphics_object_data.h"
 
 #include "systems/base/graphics_object.h"
@@ -53,6 +56,10 @@ LazyArray<GraphicsObject>& ParentGraphicsObjectData::objects() {
   return objects_;
 }
 
+const LazyArray<GraphicsObject>& ParentGraphicsObjectData::objects() const {
+  return objects_;
+}
+
 void ParentGraphicsObjectData::Render(const GraphicsObject& go,
                                       const GraphicsObject* parent,
                                       std::ostream* tree) {
@@ -91,6 +98,23 @@ void ParentGraphicsObjectData::Execute(RLMachine& machine) {
     obj.Execute(machine);
 }
 
+bool ParentGraphicsObjectData::ChangesOnExecute() const {
+  for (int i = 0; i < objects_.size(); ++i) {
+    if (objects_.exists(i) && objects_[i].ChangesOnExecute())
+      return true;
+  }
+  return false;
+}
+
+unsigned int ParentGraphicsObjectData::NextWakeupTime() const {
+  unsigned int wakeup = UINT_MAX;
+  for (int i = 0; i < objects_.size(); ++i) {
+    if (objects_.exists(i))
+      wakeup = std::min(wakeup, objects_[i].NextWakeupTime());
+  }
+  return wakeup;
+}
+
 bool ParentGraphicsObjectData::IsAnimation() const { return false; }
 
 void ParentGraphicsObjectData::PlaySet(int set) {
@@ -47,6 +47,7 @@ class ParentGraphicsObjectData : public GraphicsObjectData {
   void SetObject(int obj_number, GraphicsObject& object);
 
   LazyArray<GraphicsObject>& objects();
+  const LazyArray<GraphicsObject>& objects() const;
 
   virtual void Render(const GraphicsObject& go,
                       const GraphicsObject* parent,
@@ -55,6 +56,8 @@ class ParentGraphicsObjectData : public GraphicsObjectData {
   virtual int PixelHeight(const GraphicsObject& rendering_properties) override;
   virtual GraphicsObjectData* Clone() const override;
   virtual void Execute(RLMachine& machine) override;
+  virtual unsigned int NextWakeupTime() const override;
+  virtual bool ChangesOnExecute() const override;
   virtual bool IsAnimation() const override;
   virtual void PlaySet(int set) override;
 
@@ -110,8 +110,13 @@ bool Gloss::Contains(const Point& point) {
 // -----------------------------------------------------------------------
 // RlBabelDLL
 // -----------------------------------------------------------------------
+RlBabelDLL::AdvanceTable::AdvanceTable() {
+  std::fill(ascii, ascii + 128, -1);
+}
+
 RlBabelDLL::RlBabelDLL(RLMachine& machine)
     : add_is_italic(false),
+      advance_encoding_(-1),
       gloss_start_x_(0),
       gloss_start_y_(0),
       machine_(machine) {}
@@ -573,28 +578,45 @@ int RlBabelDLL::TestGlosses(int x,
 }
 
 int RlBabelDLL::GetCharWidth(uint16_t cp932_char, bool as_xmod) {
-  Codepage& cp = Cp::instance(machine_.GetTextEncoding());
-  uint16_t native_char = cp.JisDecode(cp932_char);
-  uint16_t unicode_codepoint = cp.Convert(native_char);
   std::shared_ptr<TextWindow> window = GetWindow(-1);
-  int font_size = window->font_size_in_pixels();
-  // TODO(erg): Can I somehow modify this to try to do proper kerning?
-  int width = machine_.system().text().GetCharWidth(font_size, unicode_codepoint);
+  int width = GetAdvance(cp932_char, window->font_size_in_pixels());
   return as_xmod ? window->insertion_point_x() + width : width;
 }
 
+int RlBabelDLL::GetAdvance(uint16_t cp932_char, int font_size) {
+  int encoding = machine_.GetTextEncoding();
+  if (encoding != advance_encoding_) {
+    advance_tables_.clear();
+    advance_encoding_ = encoding;
+  }
+
+  AdvanceTable& table = advance_tables_[font_size];
+  int* width;
+  if (cp932_char < 128)
+    width = &table.ascii[cp932_char];
+  else
+    width = &table.other.emplace(cp932_char, -1).first->second;
+
+  if (*width < 0) {
+    Codepage& cp = Cp::instance(encoding);
+    uint16_t native_char = cp.JisDecode(cp932_char);
+    uint16_t unicode_codepoint = cp.Convert(native_char);
+    // TODO(erg): Can I somehow modify this to try to do proper kerning?
+    *width = machine_.system().text().GetCharWidth(font_size, unicode_codepoint);
+  }
+
+  return *width;
+}
+
 bool RlBabelDLL::LineBreakRequired() {
   std::shared_ptr<TextWindow> window = GetWindow(-1);
+  int font_size = window->font_size_in_pixels();
 
   int width = 0;
   std::string::size_type ptr = text_index;
   while (ptr < end_token_index) {
     uint16_t cp932_char = ConsumeNextCharacter(ptr);
-    if (text_index < end_token_index) {
-      width += GetCharWidth(cp932_char, false);
-    } else {
-      width += window->font_size_in_pixels();
-    }
+    width += GetAdvance(cp932_char, font_size);
   }
 
   int max_space = window->GetTextWindowSize().width();
@@ -610,14 +632,14 @@ bool RlBabelDLL::LineBreakRequired() {
   if (width >= max_space) {
     ptr = text_index;
     uint16_t cp932_char = ConsumeNextCharacter(ptr);
-    width = GetCharWidth(cp932_char, false);
+    width = GetAdvance(cp932_char, font_size);
 
     // If the first character will fit on the current line, a line break is not
     // required.
     if (width < remaining_space) {
       while (ptr < end_token_index) {
         cp932_char = ConsumeNextCharacter(ptr);
-        int cw = GetCharWidth(cp932_char, false);
+        int cw = GetAdvance(cp932_char, font_size);
         if (width + cw >= remaining_space)
           break;
         ptr += 1 + (cp932_char > 0xff);
@@ -637,7 +659,7 @@ bool RlBabelDLL::LineBreakRequired() {
     // next line, and a break is required.
     while (ptr < end_token_index) {
       cp932_char = ConsumeNextCharacter(ptr);
-      int cw = GetCharWidth(cp932_char, false);
+      int cw = GetAdvance(cp932_char, font_size);
       if (width + cw >= remaining_space)
         break;
       ptr += 1 + (cp932_char > 0xff);
@@ -29,8 +29,10 @@
 #define SRC_SYSTEMS_BASE_RLBABEL_DLL_H_
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "machine/reallive_dll.h"
@@ -190,6 +192,10 @@ class RlBabelDLL : public RealLiveDLL {
 
   int GetCharWidth(uint16_t full_char, bool as_xmod);
 
+  // Returns the advance of |cp932_char| at |font_size|, asking the
+  // TextSystem only the first time we see it.
+  int GetAdvance(uint16_t cp932_char, int font_size);
+
   bool LineBreakRequired();
 
   uint16_t ConsumeNextCharacter(std::string::size_type& index);
@@ -232,6 +238,20 @@ class RlBabelDLL : public RealLiveDLL {
   // End of the current token being processed in |cp932_text_buffer|.
   std::string::size_type end_token_index;
 
+  // Advance widths of the characters we've measured at one font size. Asking
+  // the font is expensive, and western text asks about the same few
+  // characters over and over. -1 until measured.
+  struct AdvanceTable {
+    AdvanceTable();
+
+    int ascii[128];
+    std::unordered_map<uint16_t, int> other;
+  };
+
+  // Measured advances keyed by font size, for |advance_encoding_|.
+  std::map<int, AdvanceTable> advance_tables_;
+  int advance_encoding_;
+
   // Clickable on screen areas that display a message.
   std::vector<Gloss> glosses_;
 
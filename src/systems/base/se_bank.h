@@ -0,0 +1,80 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_SYSTEMS_BASE_SE_BANK_H_
+#define SRC_SYSTEMS_BASE_SE_BANK_H_
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Decides which sound effects are kept decoded in memory. |files| is a list
+// of (SE number, file) in #SE table order, and |decode| turns a file into a
+// chunk with a size() in bytes, or NULL. Entries that name the same file
+// share one chunk, and each file is decoded at most once.
+//
+// A file that doesn't fit in what's left of |limit| is left out, but later
+// (smaller) files are still tried, and entries for files that are already
+// banked are always mapped. Once the bank is full, nothing more is decoded.
+// Sound effects that aren't in the returned bank are loaded on demand.
+template <typename ChunkPtr, typename Decode>
+std::unordered_map<int, ChunkPtr> FillSeBank(
+    const std::vector<std::pair<int, boost::filesystem::path>>& files,
+    size_t limit,
+    Decode decode) {
+  std::unordered_map<int, ChunkPtr> bank;
+  size_t used = 0;
+
+  // NULL for files that couldn't be banked.
+  std::map<boost::filesystem::path, ChunkPtr> chunks;
+  for (auto const& entry : files) {
+    auto it = chunks.find(entry.second);
+    if (it == chunks.end()) {
+      ChunkPtr chunk;
+      if (used < limit) {
+        ChunkPtr sample = decode(entry.second);
+        if (sample && sample->size() != 0 && sample->size() <= limit - used) {
+          used += sample->size();
+          chunk = sample;
+        }
+      }
+      it = chunks.emplace(entry.second, chunk).first;
+    }
+
+    if (it->second)
+      bank.emplace(entry.first, it->second);
+  }
+
+  return bank;
+}
+
+#endif  // SRC_SYSTEMS_BASE_SE_BANK_H_
@@ -32,6 +32,7 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <climits>
 #include <map>
 #include <sstream>
 #include <string>
@@ -227,6 +228,12 @@ void SoundSystem::ExecuteSoundSystem() {
   }
 }
 
+unsigned int SoundSystem::NextWakeupTime() const {
+  if (!pcm_adjustment_tasks_.empty() || bgm_adjustment_task_)
+    return 0;
+  return UINT_MAX;
+}
+
 void SoundSystem::SetSoundQuality(const int quality) {
   globals_.sound_quality = quality;
 }
@@ -354,6 +361,11 @@ void SoundSystem::set_bgm_koe_fadeVolume(const int level) {
 
 int SoundSystem::bgm_koe_fadeVolume() const { return globals_.bgm_koe_fade_vol; }
 
+void SoundSystem::PlaySe(const int se_num) {
+  if (!system_.ShouldFastForward())
+    PlaySeImpl(se_num);
+}
+
 void SoundSystem::KoePlay(int id) {
   if (!system_.ShouldFastForward())
     KoePlayImpl(id);
@@ -195,6 +195,10 @@ class SoundSystem {
   // it to handle volume adjustment tasks.
   virtual void ExecuteSoundSystem();
 
+  // The tick at which ExecuteSoundSystem() next has work to do. Volume fades
+  // are stepped every frame. See System::NextWakeupTime().
+  virtual unsigned int NextWakeupTime() const;
+
   // ---------------------------------------------------------------------
 
   // Sets how much sound hertz.
@@ -296,7 +300,8 @@ class SoundSystem {
   virtual void SetSeVolumeMod(const int in);
 
   // Plays an interface sound effect. |se_num| is an index into the #SE table.
-  virtual void PlaySe(const int se_num) = 0;
+  // Sound effects are dropped while fast forwarding.
+  void PlaySe(const int se_num);
 
   // Returns whether there is a sound effect |se_num| in the table.
   virtual bool HasSe(const int se_num) = 0;
@@ -368,6 +373,9 @@ class SoundSystem {
     return (channel_volume * system_volume) / 255;
   }
 
+  // Plays an interface sound effect.
+  virtual void PlaySeImpl(const int se_num) = 0;
+
   // Plays a voice sample.
   virtual void KoePlayImpl(int id) = 0;
 
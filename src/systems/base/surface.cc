@@ -43,6 +43,13 @@ Rect Surface::GetRect() const { return Rect(Point(0, 0), GetSize()); }
 
 // -----------------------------------------------------------------------
 
+void Surface::RenderQuadsToScreen(const std::vector<Quad>& quads) const {
+  for (const Quad& quad : quads)
+    RenderToScreen(quad.src, quad.dst, quad.alpha);
+}
+
+// -----------------------------------------------------------------------
+
 void Surface::Dump() {
   throw rlvm::Exception("Unimplemented function Surface::Dump()");
 }
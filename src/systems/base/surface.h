@@ -29,6 +29,7 @@
 #define SRC_SYSTEMS_BASE_SURFACE_H_
 
 #include <memory>
+#include <vector>
 
 #include "systems/base/rect.h"
 #include "systems/base/tone_curve.h"
@@ -50,6 +51,13 @@ class Surface : public std::enable_shared_from_this<Surface> {
     int originX, originY;
   };
 
+  // One piece of this surface drawn to the screen as part of a batch.
+  struct Quad {
+    Rect src;
+    Rect dst;
+    int alpha;
+  };
+
  public:
   Surface();
   virtual ~Surface();
@@ -111,6 +119,12 @@ class Surface : public std::enable_shared_from_this<Surface> {
                                       const Rect& dst,
                                       int alpha) const = 0;
 
+  // Draws all of |quads| to the screen in order. Particle systems and effects
+  // that draw many pieces of one surface each frame should use this; the
+  // default implementation calls RenderToScreen() for each quad, but
+  // subclasses can submit the whole batch in one go.
+  virtual void RenderQuadsToScreen(const std::vector<Quad>& quads) const;
+
   virtual int GetNumPatterns() const;
   virtual const GrpRect& GetPattern(int patt_no) const;
 
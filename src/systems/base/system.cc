@@ -45,6 +45,7 @@
 #include "machine/long_operation.h"
 #include "machine/rlmachine.h"
 #include "machine/serialization.h"
+#include "machine/startup_profile.h"
 #include "modules/module_sys.h"
 #include "systems/base/event_system.h"
 #include "systems/base/graphics_system.h"
@@ -53,6 +54,7 @@
 #include "systems/base/sound_system.h"
 #include "systems/base/system_error.h"
 #include "systems/base/text_system.h"
+#include "utilities/asset_pack.h"
 #include "utilities/exception.h"
 #include "utilities/string_utilities.h"
 
@@ -63,10 +65,6 @@ namespace fs = boost::filesystem;
 
 namespace {
 
-const std::vector<std::string> ALL_FILETYPES = {"g00", "pdt", "anm", "gan",
-                                                "hik", "wav", "ogg", "nwa",
-                                                "mp3", "ovk", "koe", "nwk"};
-
 struct LoadingGameFromStream : public LoadGameLongOperation {
   LoadingGameFromStream(RLMachine& machine,
                         const std::shared_ptr<std::stringstream>& selection)
@@ -85,6 +83,9 @@ struct LoadingGameFromStream : public LoadGameLongOperation {
 
 }  // namespace
 
+const std::vector<std::string> ALL_FILETYPES = {"g00", "pdt", "anm", "gan",
+                                                "hik", "wav", "ogg", "nwa",
+                                                "mp3", "ovk", "koe", "nwk"};
 // I assume GAN files can't go through the OBJ_FILETYPES path.
 const std::vector<std::string> OBJ_FILETYPES = {"anm", "g00", "pdt"};
 const std::vector<std::string> IMAGE_FILETYPES = {"g00", "pdt"};
@@ -130,7 +131,10 @@ System::System()
             SYSCOM_VISIBLE);
 }
 
-System::~System() {}
+System::~System() {
+  if (asset_pack_)
+    AssetPack::Unmount(asset_pack_);
+}
 
 void System::SetPlatform(const std::shared_ptr<Platform>& platform) {
   platform_ = platform;
@@ -330,6 +334,8 @@ void System::ShowSystemInfo(RLMachine& machine) {
 boost::filesystem::path System::FindFile(
     const std::string& file_name,
     const std::vector<std::string>& extensions) {
+  if (pending_filesystem_cache_.valid())
+    filesystem_cache_ = pending_filesystem_cache_.get();
   if (filesystem_cache_.empty())
     BuildFileSystemCache();
 
@@ -387,6 +393,21 @@ bool System::ShouldFastForward() {
          text().CurrentlySkipping() || force_fast_forward_;
 }
 
+unsigned int System::NextWakeupTime(RLMachine& machine) {
+  std::shared_ptr<LongOperation> long_op = machine.CurrentLongOperation();
+  if (!long_op || in_menu_ || ShouldFastForward())
+    return 0;
+
+  unsigned int wakeup = long_op->NextWakeupTime(machine);
+  if (wakeup == 0)
+    return 0;
+
+  wakeup = std::min(wakeup, graphics().NextWakeupTime());
+  wakeup = std::min(wakeup, text().NextWakeupTime());
+  wakeup = std::min(wakeup, sound().NextWakeupTime());
+  return wakeup;
+}
+
 void System::DumpRenderTree(RLMachine& machine) {
   std::ostringstream oss;
   oss << "Dump_SEEN" << std::setw(4) << std::setfill('0')
@@ -445,8 +466,40 @@ void System::CheckSyscomIndex(int index, const char* function) {
   }
 }
 
+void System::StartFileSystemScan() {
+  // The Gameexe isn't safe to read from two threads, so pull out what the
+  // scan needs here.
+  fs::path gamepath(gameexe()("__GAMEPATH").ToString());
+  std::vector<std::string> valid_directories = GetValidDirectories();
+  MountAssetPack(gamepath);
+  std::shared_ptr<AssetPack> pack = asset_pack_;
+  pending_filesystem_cache_ =
+      std::async(std::launch::async, [gamepath, valid_directories, pack]() {
+        ScopedStartupStage stage("File index");
+        return ScanGameDirectories(gamepath, valid_directories, pack);
+      });
+}
+
 void System::BuildFileSystemCache() {
-  // First retrieve all the directories defined in the #FOLDNAME section.
+  fs::path gamepath(gameexe()("__GAMEPATH").ToString());
+  MountAssetPack(gamepath);
+  filesystem_cache_ =
+      ScanGameDirectories(gamepath, GetValidDirectories(), asset_pack_);
+}
+
+void System::MountAssetPack(const fs::path& gamepath) {
+  if (asset_pack_)
+    return;
+
+  fs::path pack_path = gamepath / AssetPack::kFileName;
+  if (fs::is_regular_file(pack_path)) {
+    asset_pack_ = std::make_shared<AssetPack>(pack_path);
+    AssetPack::Mount(asset_pack_);
+  }
+}
+
+std::vector<std::string> System::GetValidDirectories() {
+  // Retrieve all the directories defined in the #FOLDNAME section.
   std::vector<std::string> valid_directories;
   Gameexe& gexe = gameexe();
   GameexeFilteringIterator it = gexe.filtering_begin("FOLDNAME");
@@ -458,8 +511,15 @@ void System::BuildFileSystemCache() {
       valid_directories.push_back(dir);
     }
   }
+  return valid_directories;
+}
 
-  fs::path gamepath(gexe("__GAMEPATH").ToString());
+// static
+System::FileSystemCache System::ScanGameDirectories(
+    const fs::path& gamepath,
+    const std::vector<std::string>& valid_directories,
+    const std::shared_ptr<AssetPack>& pack) {
+  FileSystemCache cache;
   fs::directory_iterator dir_end;
   for (fs::directory_iterator dir(gamepath); dir != dir_end; ++dir) {
     if (fs::is_directory(dir->status())) {
@@ -467,31 +527,53 @@ void System::BuildFileSystemCache() {
       to_lower(lowername);
       if (find(valid_directories.begin(), valid_directories.end(), lowername) !=
           valid_directories.end()) {
-        AddDirectoryToCache(dir->path());
+        AddDirectoryToCache(dir->path(), &cache);
+      }
+    }
+  }
+
+  // The multimap keeps equal keys in insertion order, so adding the packed
+  // files last lets loose files override them.
+  if (pack) {
+    for (const std::string& name : pack->GetNames()) {
+      std::string directory = name.substr(0, name.find('/'));
+      if (directory.size() < name.size() &&
+          find(valid_directories.begin(), valid_directories.end(),
+               directory) != valid_directories.end()) {
+        AddFileToCache(pack->file() / name, &cache);
       }
     }
   }
+
+  return cache;
 }
 
-void System::AddDirectoryToCache(const fs::path& directory) {
+// static
+void System::AddDirectoryToCache(const fs::path& directory,
+                                 FileSystemCache* cache) {
   fs::directory_iterator dir_end;
   for (fs::directory_iterator dir(directory); dir != dir_end; ++dir) {
     if (fs::is_directory(dir->status())) {
-      AddDirectoryToCache(dir->path());
+      AddDirectoryToCache(dir->path(), cache);
     } else {
-      std::string extension = dir->path().extension().string();
-      if (extension.size() > 1 && extension[0] == '.')
-        extension = extension.substr(1);
-      to_lower(extension);
+      AddFileToCache(dir->path(), cache);
+    }
+  }
+}
 
-      if (find(ALL_FILETYPES.begin(), ALL_FILETYPES.end(), extension) !=
-          ALL_FILETYPES.end()) {
-        std::string stem = dir->path().stem().string();
-        to_lower(stem);
+// static
+void System::AddFileToCache(const fs::path& file, FileSystemCache* cache) {
+  std::string extension = file.extension().string();
+  if (extension.size() > 1 && extension[0] == '.')
+    extension = extension.substr(1);
+  to_lower(extension);
 
-        filesystem_cache_.emplace(stem, make_pair(extension, dir->path()));
-      }
-    }
+  if (find(ALL_FILETYPES.begin(), ALL_FILETYPES.end(), extension) !=
+      ALL_FILETYPES.end()) {
+    std::string stem = file.stem().string();
+    to_lower(stem);
+
+    cache->emplace(stem, make_pair(extension, file));
   }
 }
 
@@ -32,6 +32,7 @@
 #include <boost/serialization/version.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include <future>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -39,6 +40,7 @@
 #include <utility>
 #include <vector>
 
+class AssetPack;
 class GraphicsSystem;
 class EventSystem;
 class TextSystem;
@@ -94,6 +96,7 @@ const int SYSCOM_SHOW_BACKGROUND = 31;
 // These constant, externed vectors are passed as parameters to
 // FindFile to control which file types are searched for. Defaults to
 // all.
+extern const std::vector<std::string> ALL_FILETYPES;
 extern const std::vector<std::string> OBJ_FILETYPES;
 extern const std::vector<std::string> IMAGE_FILETYPES;
 extern const std::vector<std::string> PDT_IMAGE_FILETYPES;
@@ -261,6 +264,12 @@ class System {
   // text.
   bool ShouldFastForward();
 
+  // Returns the earliest tick at which another trip through the game loop
+  // could change anything, assuming no input arrives before then. 0 means
+  // "call me every frame"; UINT_MAX means that only input can wake us. Only
+  // meaningful while a LongOperation is blocking the bytecode.
+  unsigned int NextWakeupTime(RLMachine& machine);
+
   // Renders the screen and dumps a textual representation of the screen.
   void DumpRenderTree(RLMachine& machine);
 
@@ -275,6 +284,11 @@ class System {
   virtual SoundSystem& sound() = 0;
 
  protected:
+  // Starts indexing the #FOLDNAME directories on a worker thread, so that
+  // subclasses can overlap the disk scan with their own initialization. The
+  // first FindFile() waits for it. Must be called after gameexe() works.
+  void StartFileSystemScan();
+
   // Native widget drawer. Can be NULL. This field is protected instead of
   // private because we need to be destroy the Platform before we destroy SDL.
   std::shared_ptr<Platform> platform_;
@@ -299,9 +313,29 @@ class System {
   // #FOLDNAME part of the Gameexe.ini file.
   void BuildFileSystemCache();
 
-  // Recurses on |directory| and adds all filetypes that we can read to our
-  // FileSystemCache.
-  void AddDirectoryToCache(const boost::filesystem::path& directory);
+  // Mounts the game's AssetPack, if it ships one.
+  void MountAssetPack(const boost::filesystem::path& gamepath);
+
+  // Returns the lowercased #FOLDNAME directories.
+  std::vector<std::string> GetValidDirectories();
+
+  // Indexes the subdirectories of |gamepath| named in |valid_directories|,
+  // along with the entries of |pack| (which may be NULL) that live in those
+  // directories. Loose files take precedence over packed ones. Doesn't touch
+  // the Gameexe, so it can run on any thread.
+  static FileSystemCache ScanGameDirectories(
+      const boost::filesystem::path& gamepath,
+      const std::vector<std::string>& valid_directories,
+      const std::shared_ptr<AssetPack>& pack);
+
+  // Adds |file| to |cache| if it's a type that we can read.
+  static void AddFileToCache(const boost::filesystem::path& file,
+                             FileSystemCache* cache);
+
+  // Recurses on |directory| and adds all filetypes that we can read to
+  // |cache|.
+  static void AddDirectoryToCache(const boost::filesystem::path& directory,
+                                  FileSystemCache* cache);
 
   // The visibility status for all syscom entries
   int syscom_status_[NUM_SYSCOM_ENTRIES];
@@ -324,6 +358,12 @@ class System {
   // extension and the local file path for that file.
   FileSystemCache filesystem_cache_;
 
+  // The result of StartFileSystemScan(), until FindFile() collects it.
+  std::future<FileSystemCache> pending_filesystem_cache_;
+
+  // The game's rlvm.pack, mounted for as long as we live.
+  std::shared_ptr<AssetPack> asset_pack_;
+
   SystemGlobals globals_;
 
   // A stream with the save game data at the time of the last selection. Used
@@ -27,6 +27,7 @@
 
 #include "systems/base/text_key_cursor.h"
 
+#include <climits>
 #include <string>
 #include <vector>
 
@@ -80,6 +81,13 @@ void TextKeyCursor::Execute() {
   }
 }
 
+unsigned int TextKeyCursor::NextWakeupTime() const {
+  if (!cursor_image_)
+    return UINT_MAX;
+
+  return last_time_frame_incremented_ + frame_speed_ + 1;
+}
+
 // -----------------------------------------------------------------------
 
 void TextKeyCursor::Render(TextWindow& text_window, std::ostream* tree) {
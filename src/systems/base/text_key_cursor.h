@@ -53,6 +53,9 @@ class TextKeyCursor {
   // displayed on the screen.
   void Execute();
 
+  // Returns the tick at which Execute() will next advance the animation.
+  unsigned int NextWakeupTime() const;
+
   // Render this key cursor to the specified window, which owns
   // positional information.
   void Render(TextWindow& text_window, std::ostream* tree);
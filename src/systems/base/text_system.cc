@@ -31,6 +31,7 @@
 #include "systems/base/text_system.h"
 
 #include <algorithm>
+#include <climits>
 #include <map>
 #include <sstream>
 #include <string>
@@ -174,6 +175,28 @@ void TextSystem::ExecuteTextSystem() {
   }
 }
 
+unsigned int TextSystem::NextWakeupTime() const {
+  unsigned int wakeup = UINT_MAX;
+  if (ShowWindow(active_window_)) {
+    WindowMap::const_iterator it = text_window_.find(active_window_);
+    if (it != text_window_.end() && it->second->is_visible() &&
+        in_pause_state_ && !IsReadingBacklog()) {
+      // The key cursor is lazily created on the first ExecuteTextSystem().
+      if (!text_key_cursor_)
+        return 0;
+      wakeup = text_key_cursor_->NextWakeupTime();
+    }
+  }
+
+  for (WindowMap::const_iterator it = text_window_.begin();
+       it != text_window_.end(); ++it) {
+    if (ShowWindow(it->first))
+      wakeup = std::min(wakeup, it->second->NextWakeupTime());
+  }
+
+  return wakeup;
+}
+
 void TextSystem::Render(std::ostream* tree) {
   if (system_visible()) {
     if (tree) {
@@ -648,7 +671,7 @@ std::shared_ptr<Surface> TextSystem::RenderText(const std::string& utf8str,
   // TODO(erg): Surely there's a way to allocate with something other than
   // black, right?
   std::shared_ptr<Surface> surface(
-      system().graphics().BuildSurface(Size(max_width, total_height)));
+      system().graphics().BuildPooledSurface(Size(max_width, total_height)));
   surface->Fill(RGBAColour::Clear());
 
   RGBColour current_colour = colour;
@@ -690,8 +713,9 @@ std::shared_ptr<Surface> TextSystem::RenderText(const std::string& utf8str,
           // Consume an integer. Or don't.
           int val;
           if (parseInteger(cur_end, strend, val)) {
+            static constexpr GameexeKey kColorTable("COLOR_TABLE");
             Gameexe& gexe = system().gameexe();
-            current_colour = RGBColour(gexe("COLOR_TABLE", val));
+            current_colour = RGBColour(gexe(kColorTable, val));
           } else {
             current_colour = colour;
           }
@@ -861,10 +885,11 @@ template void TextSystem::load<boost::archive::text_iarchive>(
 
 // -----------------------------------------------------------------------
 
-void parseNames(const Memory& memory,
+bool parseNames(const Memory& memory,
                 const std::string& input,
                 std::string& output) {
   const char* cur = input.c_str();
+  bool replaced = false;
 
   const char LOWER_BYTE_FULLWIDTH_ASTERISK = 0x96;
   const char LOWER_BYTE_FULLWIDTH_PERCENT = 0x93;
@@ -891,10 +916,13 @@ void parseNames(const Memory& memory,
         output += memory.GetName(index);
       else
         output += memory.GetLocalName(index);
+      replaced = true;
     } else {
       CopyOneShiftJisCharacter(cur, output);
     }
   }
+
+  return replaced;
 }
 
 bool TextSystem::CurrentlySkipping() const {
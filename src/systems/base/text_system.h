@@ -102,6 +102,10 @@ class TextSystem : public EventListener {
 
   void ExecuteTextSystem();
 
+  // The tick at which ExecuteTextSystem() next has work to do; the key
+  // cursor animation and held window buttons. See System::NextWakeupTime().
+  unsigned int NextWakeupTime() const;
+
   void Render(std::ostream* tree);
   void HideTextWindow(int win_number);
   void HideAllTextWindows();
@@ -260,6 +264,18 @@ class TextSystem : public EventListener {
 
   void set_in_selection_mode(const bool in) { in_selection_mode_ = in; }
 
+  // Character timing for TextoutLongOperation. This must stay the same
+  // between individual TextoutLongOperations; rlBabel compiled games will
+  // always display one character per TextoutLongOperation.
+  struct TextoutTiming {
+    // The tick count the last time a TextoutLongOperation was run.
+    unsigned int time_at_last_pass = 0;
+
+    // A countdown in milliseconds until we display the next character.
+    int next_character_countdown = 0;
+  };
+  TextoutTiming& textout_timing() { return textout_timing_; }
+
   // Overridden from EventListener
   virtual bool MouseButtonStateChanged(MouseButton mouse_button,
                                        bool pressed) override;
@@ -347,6 +363,8 @@ class TextSystem : public EventListener {
   // Whether we are currently paused at a user choice.
   bool in_selection_mode_;
 
+  TextoutTiming textout_timing_;
+
   // Contains overrides for showing or hiding the text windows.
   std::map<int, bool> window_visual_override_;
 
@@ -373,8 +391,9 @@ class TextSystem : public EventListener {
 // Name parser. Takes a raw, local machine encoded string and replaces name
 // variable placeholders with the names from Memory. This function assumes that
 // text is in CP932 encoding, and will need to be generalized when we try to
-// support other hacks on top of cp932.
-void parseNames(const Memory& memory,
+// support other hacks on top of cp932. Returns whether any placeholders were
+// replaced.
+bool parseNames(const Memory& memory,
                 const std::string& input,
                 std::string& output);
 
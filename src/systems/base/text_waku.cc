@@ -26,6 +26,8 @@
 
 #include "systems/base/text_waku.h"
 
+#include <climits>
+
 #include "systems/base/system.h"
 #include "systems/base/text_waku_normal.h"
 #include "systems/base/text_waku_type4.h"
@@ -46,6 +48,8 @@ TextWaku* TextWaku::Create(System& system,
 
 TextWaku::~TextWaku() {}
 
+unsigned int TextWaku::NextWakeupTime() const { return UINT_MAX; }
+
 void TextWaku::SetMousePosition(const Point& pos) {}
 
 bool TextWaku::HandleMouseClick(RLMachine& machine,
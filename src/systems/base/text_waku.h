@@ -48,6 +48,7 @@ class TextWaku {
   virtual ~TextWaku();
 
   virtual void Execute() = 0;
+  virtual unsigned int NextWakeupTime() const;
   virtual void Render(std::ostream* tree,
                       Point box_location,
                       Size namebox_size) = 0;
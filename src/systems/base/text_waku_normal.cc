@@ -26,6 +26,8 @@
 
 #include "systems/base/text_waku_normal.h"
 
+#include <algorithm>
+#include <climits>
 #include <functional>
 #include <iomanip>
 #include <sstream>
@@ -94,6 +96,15 @@ void TextWakuNormal::Execute() {
   }
 }
 
+unsigned int TextWakuNormal::NextWakeupTime() const {
+  unsigned int wakeup = UINT_MAX;
+  for (int i = 0; BUTTON_INFO[i].index != -1; ++i) {
+    if (button_map_[i])
+      wakeup = std::min(wakeup, button_map_[i]->NextWakeupTime());
+  }
+  return wakeup;
+}
+
 void TextWakuNormal::Render(std::ostream* tree,
                             Point box_location,
                             Size namebox_size) {
@@ -51,6 +51,7 @@ class TextWakuNormal : public TextWaku {
   virtual ~TextWakuNormal();
 
   virtual void Execute() override;
+  virtual unsigned int NextWakeupTime() const override;
   virtual void Render(std::ostream* tree,
                       Point box_location,
                       Size namebox_size) override;
@@ -28,6 +28,7 @@
 #include "systems/base/text_window.h"
 
 #include <algorithm>
+#include <climits>
 #include <iomanip>
 #include <ostream>
 #include <string>
@@ -189,6 +190,12 @@ void TextWindow::Execute() {
   }
 }
 
+unsigned int TextWindow::NextWakeupTime() const {
+  if (is_visible() && !system_.graphics().is_interface_hidden())
+    return textbox_waku_->NextWakeupTime();
+  return UINT_MAX;
+}
+
 void TextWindow::SetTextboxPadding(const vector<int>& pos_data) {
   upper_box_padding_ = pos_data.at(0);
   lower_box_padding_ = pos_data.at(1);
@@ -422,6 +429,7 @@ void TextWindow::NextCharIsItalic() {
 // TODO(erg): Make this pass the #WINDOW_ATTR colour off wile rendering the
 // waku_backing.
 void TextWindow::Render(std::ostream* tree) {
+  FlushPendingGlyphs();
   std::shared_ptr<Surface> text_surface = GetTextSurface();
 
   if (text_surface && is_visible()) {
@@ -523,6 +531,7 @@ void TextWindow::ClearWin() {
   ruby_begin_point_ = -1;
   font_colour_ = default_colour_;
   koe_replay_button_.clear();
+  pending_glyphs_.clear();
 }
 
 bool TextWindow::DisplayCharacter(const std::string& current,
@@ -560,15 +569,25 @@ bool TextWindow::DisplayCharacter(const std::string& current,
         return false;
     }
 
-    RGBColour shadow = RGBAColour::Black().rgb();
-    text_system_.RenderGlyphOnto(current,
-                                 font_size_in_pixels(),
-                                 next_char_italic_,
-                                 font_colour_,
-                                 &shadow,
-                                 text_insertion_point_x_,
-                                 text_insertion_point_y_,
-                                 GetTextSurface());
+    if (system_.ShouldFastForward()) {
+      pending_glyphs_.push_back(PendingGlyph{current,
+                                             font_size_in_pixels(),
+                                             next_char_italic_,
+                                             font_colour_,
+                                             text_insertion_point_x_,
+                                             text_insertion_point_y_});
+    } else {
+      FlushPendingGlyphs();
+      RGBColour shadow = RGBAColour::Black().rgb();
+      text_system_.RenderGlyphOnto(current,
+                                   font_size_in_pixels(),
+                                   next_char_italic_,
+                                   font_colour_,
+                                   &shadow,
+                                   text_insertion_point_x_,
+                                   text_insertion_point_y_,
+                                   GetTextSurface());
+    }
     next_char_italic_ = false;
     text_wrapping_point_x_ += GetWrappingWidthFor(cur_codepoint);
 
@@ -785,3 +804,22 @@ int TextWindow::GetWrappingWidthFor(int cur_codepoint) {
     return font_size_in_pixels_ + x_spacing_;
   }
 }
+
+void TextWindow::FlushPendingGlyphs() {
+  if (pending_glyphs_.empty())
+    return;
+
+  std::shared_ptr<Surface> text_surface = GetTextSurface();
+  RGBColour shadow = RGBAColour::Black().rgb();
+  for (PendingGlyph const& pending : pending_glyphs_) {
+    text_system_.RenderGlyphOnto(pending.glyph,
+                                 pending.font_size,
+                                 pending.italic,
+                                 pending.colour,
+                                 &shadow,
+                                 pending.x,
+                                 pending.y,
+                                 text_surface);
+  }
+  pending_glyphs_.clear();
+}
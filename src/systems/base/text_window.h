@@ -67,6 +67,9 @@ class TextWindow {
 
   void Execute();
 
+  // The tick at which Execute() next has work to do.
+  unsigned int NextWakeupTime() const;
+
   int window_number() const { return window_num_; }
 
   // TODO(erg): This is nowhere near good enough and handling waku better needs
@@ -204,9 +207,11 @@ class TextWindow {
   // point.
   virtual void ClearWin();
 
-  // Displays one character, and performs line breaking logic based on the next
-  // character. Returns true if the character fits on the screen. False if it
-  // does not and was not displayed.
+  // Displays one character, and performs line breaking logic based on the
+  // characters in |rest|. Only the run of kinsoku and wrapping roman
+  // characters at the start of |rest| matters, so callers may pass just that
+  // (see TextLayout::Lookahead()). Returns true if the character fits on the
+  // screen. False if it does not and was not displayed.
   virtual bool DisplayCharacter(const std::string& current,
                                 const std::string& rest);
 
@@ -261,6 +266,11 @@ class TextWindow {
 
   int GetWrappingWidthFor(int cur_codepoint);
 
+  // Rasterizes any glyphs that DisplayCharacter() queued up while fast
+  // forwarding. Must be called before anything else draws onto the text
+  // surface.
+  void FlushPendingGlyphs();
+
  protected:
   // We cache the size of the screen so we don't need the machine in
   // some accessors.
@@ -419,6 +429,18 @@ class TextWindow {
   };
   std::unique_ptr<KoeReplayInfo> koe_replay_info_;
 
+  // While fast forwarding, most pages are cleared before they are ever shown,
+  // so glyphs are only recorded here and rasterized when the window is next
+  // rendered. ClearWin() throws away anything nobody looked at.
+  struct PendingGlyph {
+    std::string glyph;
+    int font_size;
+    bool italic;
+    RGBColour colour;
+    int x, y;
+  };
+  std::vector<PendingGlyph> pending_glyphs_;
+
   System& system_;
   TextSystem& text_system_;
 };
@@ -295,6 +295,11 @@ void RepeatActionWhileHoldingWindowButton::Execute() {
   }
 }
 
+unsigned int RepeatActionWhileHoldingWindowButton::NextWakeupTime() const {
+  // Nothing generates events while the button is simply held.
+  return held_down_ ? 0 : UINT_MAX;
+}
+
 void RepeatActionWhileHoldingWindowButton::ButtonReleased(RLMachine& machine) {
   held_down_ = false;
 }
@@ -28,6 +28,7 @@
 #ifndef SRC_SYSTEMS_BASE_TEXT_WINDOW_BUTTON_H_
 #define SRC_SYSTEMS_BASE_TEXT_WINDOW_BUTTON_H_
 
+#include <climits>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -78,6 +79,10 @@ class TextWindowButton {
   // turn to do any updating
   virtual void Execute() {}
 
+  // The tick at which Execute() next has work to do. See
+  // System::NextWakeupTime().
+  virtual unsigned int NextWakeupTime() const { return UINT_MAX; }
+
   // Called when the button is released
   virtual void ButtonReleased(RLMachine& machine) {}
 
@@ -162,6 +167,7 @@ class RepeatActionWhileHoldingWindowButton : public TextWindowButton {
 
   virtual void ButtonPressed() override;
   virtual void Execute() override;
+  virtual unsigned int NextWakeupTime() const override;
   virtual void ButtonReleased(RLMachine& machine) override;
 
  private:
@@ -26,14 +26,13 @@
 
 #include "systems/base/voice_archive.h"
 
-#include <boost/filesystem/fstream.hpp>
-
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
-#include <fstream>
 #include <sstream>
 
 #include "utilities/exception.h"
+#include "utilities/file.h"
 #include "xclannad/endian.hpp"
 
 namespace fs = boost::filesystem;
@@ -87,8 +86,8 @@ VoiceArchive::~VoiceArchive() {}
 void VoiceArchive::ReadVisualArtsTable(boost::filesystem::path file,
                                        int entry_length,
                                        std::vector<Entry>& entries) {
-  fs::ifstream ifs(file, fs::ifstream::in | fs::ifstream::binary);
-  if (!ifs) {
+  FILE* stream = OpenFile(file);
+  if (!stream) {
     std::ostringstream oss;
     oss << "Could not open file \"" << file << "\".";
     throw rlvm::Exception(oss.str());
@@ -96,17 +95,21 @@ void VoiceArchive::ReadVisualArtsTable(boost::filesystem::path file,
 
   // Copied from koedec.
   char head[0x20];
-  ifs.read(head, 4);
-  int table_len = read_little_endian_int(head);
+  int table_len = 0;
+  if (fread(head, 1, 4, stream) == 4)
+    table_len = read_little_endian_int(head);
   entries.reserve(table_len);
 
   for (int i = 0; i < table_len; ++i) {
-    ifs.read(head, entry_length);
+    if (fread(head, 1, entry_length, stream) !=
+        static_cast<size_t>(entry_length))
+      break;
     int length = read_little_endian_int(head);
     int offset = read_little_endian_int(head + 4);
     int koe_num = read_little_endian_int(head + 8);
     entries.emplace_back(koe_num, length, offset);
   }
+  fclose(stream);
 
   std::sort(entries.begin(), entries.end());
 }
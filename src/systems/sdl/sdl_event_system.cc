@@ -39,6 +39,23 @@
 using std::bind;
 using std::placeholders::_1;
 
+namespace {
+
+// SDL_USEREVENT code of the event that ends WaitForInput() at its deadline.
+const int kWaitForInputWakeup = 1;
+
+Uint32 PushWakeupEvent(Uint32 interval, void* param) {
+  SDL_Event event;
+  event.type = SDL_USEREVENT;
+  event.user.code = kWaitForInputWakeup;
+  event.user.data1 = NULL;
+  event.user.data2 = NULL;
+  SDL_PushEvent(&event);
+  return 0;
+}
+
+}  // namespace
+
 SDLEventSystem::SDLEventSystem(SDLSystem& sys, Gameexe& gexe)
     : EventSystem(gexe),
       shift_pressed_(false),
@@ -96,6 +113,9 @@ void SDLEventSystem::ExecuteEventSystem(RLMachine& machine) {
         machine.system().graphics().ForceRefresh();
         break;
       }
+      case SDL_USEREVENT:
+        // A WaitForInput() deadline; it has done its job by now.
+        break;
     }
   }
 }
@@ -131,6 +151,23 @@ void SDLEventSystem::Wait(unsigned int milliseconds) const {
   SDL_Delay(milliseconds);
 }
 
+void SDLEventSystem::WaitForInput(unsigned int milliseconds) const {
+  if (milliseconds == 0)
+    return;
+
+  // SDL 1.2 has no SDL_WaitEventTimeout(), so have a timer post an event at
+  // the deadline and block until that or real input shows up. Passing NULL
+  // leaves the event queued for the next ExecuteEventSystem().
+  SDL_TimerID timer = SDL_AddTimer(milliseconds, &PushWakeupEvent, NULL);
+  if (!timer) {
+    SDL_Delay(milliseconds);
+    return;
+  }
+
+  SDL_WaitEvent(NULL);
+  SDL_RemoveTimer(timer);
+}
+
 bool SDLEventSystem::ShiftPressed() const { return shift_pressed_; }
 
 void SDLEventSystem::InjectMouseMovement(RLMachine& machine, const Point& loc) {
@@ -60,6 +60,7 @@ class SDLEventSystem : public EventSystem {
   virtual void ExecuteEventSystem(RLMachine& machine) override;
   virtual unsigned int GetTicks() const override;
   virtual void Wait(unsigned int milliseconds) const override;
+  virtual void WaitForInput(unsigned int milliseconds) const override;
   virtual bool ShiftPressed() const override;
   virtual bool CtrlPressed() const override;
   virtual Point GetCursorPos() override;
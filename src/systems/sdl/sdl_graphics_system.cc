@@ -41,6 +41,9 @@
 
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <future>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <string>
@@ -53,6 +56,8 @@
 #include "systems/base/colour.h"
 #include "systems/base/event_system.h"
 #include "systems/base/graphics_object.h"
+#include "systems/base/image_disk_cache.h"
+#include "systems/base/image_info.h"
 #include "systems/base/mouse_cursor.h"
 #include "systems/base/renderable.h"
 #include "systems/base/system.h"
@@ -66,7 +71,9 @@
 #include "systems/sdl/sdl_utils.h"
 #include "systems/sdl/shaders.h"
 #include "systems/sdl/texture.h"
+#include "utilities/asset_pack.h"
 #include "utilities/exception.h"
+#include "utilities/file.h"
 #include "utilities/graphics.h"
 #include "utilities/lazy_array.h"
 #include "utilities/string_utilities.h"
@@ -231,6 +238,14 @@ SDLGraphicsSystem::SDLGraphicsSystem(System& system, Gameexe& gameexe)
   SetScreenSize(GetScreenSize(gameexe));
   Texture::SetScreenSize(screen_size());
 
+  int image_cache_size = gameexe("__IMAGE_CACHE_SIZE").ToInt(0);
+  if (image_cache_size > 0) {
+    image_disk_cache_.reset(new ImageDiskCache(
+        system.GameSaveDirectory() / "image_cache",
+        uint64_t(image_cache_size) << 20,
+        gameexe("__IMAGE_CACHE_COMPRESS").ToInt(0)));
+  }
+
   // Grab the caption
   std::string cp932caption = gameexe("CAPTION").ToString();
   int name_enc = gameexe("NAME_ENC").ToInt(0);
@@ -373,7 +388,7 @@ SDLGraphicsSystem::~SDLGraphicsSystem() {}
 void SDLGraphicsSystem::ExecuteGraphicsSystem(RLMachine& machine) {
   // For now, nothing, but later, we need to put all code each cycle
   // here.
-  if (is_responsible_for_update() && screen_needs_refresh()) {
+  if (ShouldRefreshScreen()) {
     Refresh(NULL);
     OnScreenRefreshed();
     redraw_last_frame_ = false;
@@ -569,18 +584,13 @@ static SDLSurface::GrpRect xclannadRegionToGrpRect(
   return rect;
 }
 
-std::shared_ptr<const Surface> SDLGraphicsSystem::LoadSurfaceFromFile(
-    const std::string& short_filename) {
-  boost::filesystem::path filename =
-      system().FindFile(short_filename, IMAGE_FILETYPES);
-  if (filename.empty()) {
-    std::ostringstream oss;
-    oss << "Could not find image file \"" << short_filename << "\".";
-    throw rlvm::Exception(oss.str());
-  }
-
+// Reads |filename| into |data| and picks the right converter for it. The
+// converter points into |data|, which must outlive it.
+static std::unique_ptr<GRPCONV> OpenImageFile(
+    const boost::filesystem::path& filename,
+    std::unique_ptr<char[]>* data) {
   // Glue code to allow my stuff to work with Jagarl's loader
-  FILE* file = fopen(filename.string().c_str(), "rb");
+  FILE* file = OpenFile(filename);
   if (!file) {
     std::ostringstream oss;
     oss << "Could not open file: " << filename;
@@ -589,24 +599,149 @@ std::shared_ptr<const Surface> SDLGraphicsSystem::LoadSurfaceFromFile(
 
   fseek(file, 0, SEEK_END);
   size_t size = ftell(file);
-  std::unique_ptr<char[]> d(new char[size + 1]);
+  data->reset(new char[size + 1]);
   fseek(file, 0, SEEK_SET);
-  fread(d.get(), size, 1, file);
+  fread(data->get(), size, 1, file);
   fclose(file);
 
   std::unique_ptr<GRPCONV> conv(
-      GRPCONV::AssignConverter(d.get(), size, "???"));
+      GRPCONV::AssignConverter(data->get(), size, "???"));
   if (conv == 0) {
     throw SystemError("Failure in GRPCONV.");
   }
-  // do not free until SDL_FreeSurface() is called on the surface using it
-  char* mem = (char*)malloc(conv->Width() * conv->Height() * 4 + 1024);
-  SDL_Surface* s = 0;
-  if (conv->Read(mem)) {
+  return conv;
+}
+
+// Grab the Type-2 information out of the converter or create one default
+// region if none exist
+static std::vector<SDLSurface::GrpRect> RegionTableOf(GRPCONV& conv) {
+  std::vector<SDLSurface::GrpRect> region_table;
+  if (conv.region_table.size()) {
+    std::transform(conv.region_table.begin(),
+                   conv.region_table.end(),
+                   std::back_inserter(region_table),
+                   xclannadRegionToGrpRect);
+  } else {
+    SDLSurface::GrpRect rect;
+    rect.rect = Rect(Point(0, 0), Size(conv.Width(), conv.Height()));
+    rect.originX = 0;
+    rect.originY = 0;
+    region_table.push_back(rect);
+  }
+  return region_table;
+}
+
+// The same, for images that were decoded ahead of time.
+static std::vector<SDLSurface::GrpRect> RegionTableOf(
+    const std::vector<AssetPack::ImageRegion>& regions,
+    int width,
+    int height) {
+  std::vector<SDLSurface::GrpRect> region_table;
+  for (const AssetPack::ImageRegion& region : regions) {
+    SDLSurface::GrpRect rect;
+    rect.rect =
+        Rect(Point(region.x1, region.y1), Point(region.x2 + 1, region.y2 + 1));
+    rect.originX = region.origin_x;
+    rect.originY = region.origin_y;
+    region_table.push_back(rect);
+  }
+  if (region_table.empty()) {
+    SDLSurface::GrpRect rect;
+    rect.rect = Rect(Point(0, 0), Size(width, height));
+    rect.originX = 0;
+    rect.originY = 0;
+    region_table.push_back(rect);
+  }
+  return region_table;
+}
+
+// Parses an AssetPack::ENCODING_RGBA entry. Fills in |header| and
+// |region_table| and returns a pointer to the pixels inside the pack.
+static const char* ReadPackedImage(
+    const AssetPack::Entry& entry,
+    AssetPack::ImageHeader* header,
+    std::vector<SDLSurface::GrpRect>* region_table) {
+  std::vector<AssetPack::ImageRegion> regions;
+  const char* pixels =
+      AssetPack::ParseImage(entry.data, entry.size, header, &regions);
+  if (!pixels)
+    throw rlvm::Exception("Truncated image in asset pack.");
+
+  *region_table = RegionTableOf(regions, header->width, header->height);
+  return pixels;
+}
+
+static bool IsPredecodedImage(const boost::filesystem::path& filename) {
+  AssetPack::Entry entry;
+  return AssetPack::FindMounted(filename, &entry) &&
+         entry.encoding == AssetPack::ENCODING_RGBA;
+}
+
+// Returns the tone curve suffix of names like "NAME?010", or "" if there
+// isn't one.
+static std::string ToneCurveSuffix(const std::string& short_filename) {
+  size_t question_mark = short_filename.find('?');
+  if (question_mark == std::string::npos)
+    return std::string();
+  return short_filename.substr(question_mark + 1);
+}
+
+// The CPU side of loading an image. Building one doesn't touch SDL or OpenGL,
+// so it can happen on a worker thread.
+struct SDLGraphicsSystem::DecodedImage {
+  int width;
+  int height;
+
+  // RGBA pixel data, or NULL if the converter couldn't read the image.
+  std::unique_ptr<char[]> pixels;
+  MaskType is_mask;
+
+  std::vector<SDLSurface::GrpRect> region_table;
+
+  // Set instead of |pixels| when the image came out of the ImageDiskCache,
+  // whose pixels already have the tone curve applied.
+  std::shared_ptr<const ImageDiskCache::Image> cached;
+
+  char* data() const {
+    return cached ? const_cast<char*>(cached->pixels()) : pixels.get();
+  }
+};
+
+// static
+std::shared_ptr<SDLGraphicsSystem::DecodedImage>
+SDLGraphicsSystem::DecodeImageFile(const boost::filesystem::path& filename) {
+  AssetPack::Entry entry;
+  if (AssetPack::FindMounted(filename, &entry) &&
+      entry.encoding == AssetPack::ENCODING_RGBA) {
+    // rlvm-pack already ran the converter and the alpha scan below.
+    AssetPack::ImageHeader header;
+    std::shared_ptr<DecodedImage> image(new DecodedImage);
+    const char* pixels = ReadPackedImage(entry, &header, &image->region_table);
+    image->width = header.width;
+    image->height = header.height;
+    image->is_mask = header.is_mask ? ALPHA_MASK : NO_MASK;
+    size_t pixel_bytes = size_t(header.width) * header.height * 4;
+    image->pixels.reset(new char[pixel_bytes]);
+    memcpy(image->pixels.get(), pixels, pixel_bytes);
+    return image;
+  }
+
+  std::unique_ptr<char[]> data;
+  std::unique_ptr<GRPCONV> conv = OpenImageFile(filename, &data);
+
+  std::shared_ptr<DecodedImage> image(new DecodedImage);
+  image->width = conv->Width();
+  image->height = conv->Height();
+  image->is_mask = NO_MASK;
+  image->region_table = RegionTableOf(*conv);
+
+  std::unique_ptr<char[]> mem(new char[conv->Width() * conv->Height() * 4 +
+                                       1024]);
+  if (conv->Read(mem.get())) {
     MaskType is_mask = conv->IsMask() ? ALPHA_MASK : NO_MASK;
     if (is_mask == ALPHA_MASK) {
       int len = conv->Width() * conv->Height();
-      unsigned int* d = (unsigned int*)mem;
+      unsigned int* d = (unsigned int*)mem.get();
       int i;
       for (i = 0; i < len; i++) {
         if ((*d & 0xff000000) != 0xff000000)
@@ -618,30 +753,107 @@ std::shared_ptr<const Surface> SDLGraphicsSystem::LoadSurfaceFromFile(
       }
     }
 
-    s = newSurfaceFromRGBAData(conv->Width(), conv->Height(), mem, is_mask);
+    image->is_mask = is_mask;
+    image->pixels = std::move(mem);
   }
-  free(mem);
 
-  // Grab the Type-2 information out of the converter or create one
-  // default region if none exist
-  std::vector<SDLSurface::GrpRect> region_table;
-  if (conv->region_table.size()) {
-    std::transform(conv->region_table.begin(),
-                   conv->region_table.end(),
-                   std::back_inserter(region_table),
-                   xclannadRegionToGrpRect);
+  return image;
+}
+
+// static
+std::shared_ptr<SDLGraphicsSystem::DecodedImage>
+SDLGraphicsSystem::LoadDecodedImage(ImageDiskCache* disk_cache,
+                                    const boost::filesystem::path& filename,
+                                    const std::string& tone_curve) {
+  std::shared_ptr<const ImageDiskCache::Image> cached;
+  if (disk_cache && !IsPredecodedImage(filename))
+    cached = disk_cache->Fetch(filename, tone_curve);
+  if (!cached)
+    return DecodeImageFile(filename);
+
+  std::shared_ptr<DecodedImage> image(new DecodedImage);
+  image->width = cached->width();
+  image->height = cached->height();
+  image->is_mask = cached->is_mask() ? ALPHA_MASK : NO_MASK;
+  image->region_table =
+      RegionTableOf(cached->regions(), cached->width(), cached->height());
+  image->cached = cached;
+  return image;
+}
+
+void SDLGraphicsSystem::StoreInDiskCache(
+    const boost::filesystem::path& filename,
+    const std::string& tone_curve,
+    const DecodedImage& image,
+    SDL_Surface* surface) {
+  AssetPack::ImageHeader header;
+  header.width = surface->w;
+  header.height = surface->h;
+  header.is_mask = image.is_mask == ALPHA_MASK;
+
+  std::vector<AssetPack::ImageRegion> regions;
+  for (const SDLSurface::GrpRect& rect : image.region_table) {
+    regions.push_back({rect.rect.x(), rect.rect.y(), rect.rect.x2() - 1,
+                       rect.rect.y2() - 1, rect.originX, rect.originY});
+  }
+
+  // Read back what SDL_ConvertSurface() and the tone curve produced, in the
+  // layout that newSurfaceFromRGBAData() takes.
+  SDL_LockSurface(surface);
+  int row_bytes = surface->w * 4;
+  if (surface->pitch == row_bytes) {
+    image_disk_cache_->Store(filename, tone_curve, header, regions,
+                             static_cast<const char*>(surface->pixels));
   } else {
-    SDLSurface::GrpRect rect;
-    rect.rect = Rect(Point(0, 0), Size(conv->Width(), conv->Height()));
-    rect.originX = 0;
-    rect.originY = 0;
-    region_table.push_back(rect);
+    std::vector<char> pixels(size_t(row_bytes) * surface->h);
+    for (int y = 0; y < surface->h; ++y) {
+      memcpy(&pixels[size_t(y) * row_bytes],
+             static_cast<const char*>(surface->pixels) + y * surface->pitch,
+             row_bytes);
+    }
+    image_disk_cache_->Store(filename, tone_curve, header, regions,
+                             pixels.data());
+  }
+  SDL_UnlockSurface(surface);
+}
+
+boost::filesystem::path SDLGraphicsSystem::FindImageFile(
+    const std::string& short_filename) {
+  boost::filesystem::path filename =
+      system().FindFile(short_filename, IMAGE_FILETYPES);
+  if (filename.empty()) {
+    std::ostringstream oss;
+    oss << "Could not find image file \"" << short_filename << "\".";
+    throw rlvm::Exception(oss.str());
+  }
+  return filename;
+}
+
+std::shared_ptr<const Surface> SDLGraphicsSystem::LoadSurfaceFromFile(
+    const std::string& short_filename) {
+  std::string tone_curve = ToneCurveSuffix(short_filename);
+  std::shared_ptr<DecodedImage> image;
+  auto pending = pending_decodes_.find(short_filename);
+  if (pending != pending_decodes_.end()) {
+    std::future<std::shared_ptr<DecodedImage>> decode =
+        std::move(pending->second);
+    pending_decodes_.erase(pending);
+    image = decode.get();
+  } else {
+    image = LoadDecodedImage(image_disk_cache_.get(),
+                             FindImageFile(short_filename), tone_curve);
+  }
+
+  SDL_Surface* s = 0;
+  if (image->data()) {
+    s = newSurfaceFromRGBAData(
+        image->width, image->height, image->data(), image->is_mask);
   }
 
   std::shared_ptr<Surface> surface_to_ret(
-      new SDLSurface(this, s, region_table));
+      new SDLSurface(this, s, image->region_table));
   // handle tone curve effect loading
-  if (short_filename.find("?") != short_filename.npos) {
+  if (!tone_curve.empty() && !image->cached) {
     std::string effect_no_str =
         short_filename.substr(short_filename.find("?") + 1);
     int effect_no = std::stoi(effect_no_str);
@@ -655,12 +867,56 @@ std::shared_ptr<const Surface> SDLGraphicsSystem::LoadSurfaceFromFile(
     }
     surface_to_ret.get()->ToneCurve(
         globals().tone_curves.GetEffect(effect_no / 10 - 1),
-        Rect(Point(0, 0), Size(conv->Width(), conv->Height())));
+        Rect(Point(0, 0), Size(image->width, image->height)));
+  }
+
+  if (image_disk_cache_ && s && !image->cached) {
+    boost::filesystem::path filename = FindImageFile(short_filename);
+    if (!IsPredecodedImage(filename))
+      StoreInDiskCache(filename, tone_curve, *image, s);
   }
 
   return surface_to_ret;
 }
 
+std::shared_ptr<const ImageInfo> SDLGraphicsSystem::LoadImageInfoFromFile(
+    const std::string& short_filename) {
+  boost::filesystem::path filename = FindImageFile(short_filename);
+  AssetPack::Entry entry;
+  if (AssetPack::FindMounted(filename, &entry) &&
+      entry.encoding == AssetPack::ENCODING_RGBA) {
+    AssetPack::ImageHeader header;
+    std::vector<SDLSurface::GrpRect> region_table;
+    ReadPackedImage(entry, &header, &region_table);
+    return std::make_shared<ImageInfo>(Size(header.width, header.height),
+                                       region_table);
+  }
+
+  // The converters parse the header (and the region table) in their
+  // constructors; the pixels are only touched by Read().
+  std::unique_ptr<char[]> data;
+  std::unique_ptr<GRPCONV> conv = OpenImageFile(filename, &data);
+  return std::make_shared<ImageInfo>(Size(conv->Width(), conv->Height()),
+                                     RegionTableOf(*conv));
+}
+
+void SDLGraphicsSystem::PrefetchSurface(const std::string& short_filename) {
+  if (pending_decodes_.count(short_filename))
+    return;
+
+  pending_decodes_[short_filename] =
+      std::async(std::launch::async,
+                 &SDLGraphicsSystem::LoadDecodedImage,
+                 image_disk_cache_.get(),
+                 FindImageFile(short_filename),
+                 ToneCurveSuffix(short_filename));
+}
+
+void SDLGraphicsSystem::CancelPrefetch(const std::string& short_filename) {
+  // Destroying the future waits for the decode to finish and frees it.
+  pending_decodes_.erase(short_filename);
+}
+
 std::shared_ptr<Surface> SDLGraphicsSystem::GetHaikei() {
   if (haikei_->rawSurface() == NULL) {
     haikei_->allocate(screen_size(), true);
@@ -692,4 +948,5 @@ void SDLGraphicsSystem::Reset() {
   last_line_number_ = 0;
 
   GraphicsSystem::Reset();
+  pending_decodes_.clear();
 }
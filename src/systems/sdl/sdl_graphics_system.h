@@ -30,6 +30,10 @@
 
 #include <SDL/SDL_opengl.h>
 
+#include <boost/filesystem/path.hpp>
+
+#include <future>
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -42,6 +46,8 @@ struct SDL_Surface;
 
 class Gameexe;
 class GraphicsObject;
+class ImageDiskCache;
+class ImageInfo;
 class SDLGraphicsSystem;
 class SDLSurface;
 class System;
@@ -81,6 +87,10 @@ class SDLGraphicsSystem : public GraphicsSystem, public NotificationObserver {
 
   virtual std::shared_ptr<const Surface> LoadSurfaceFromFile(
       const std::string& short_filename) override;
+  virtual std::shared_ptr<const ImageInfo> LoadImageInfoFromFile(
+      const std::string& short_filename) override;
+  virtual void PrefetchSurface(const std::string& short_filename) override;
+  virtual void CancelPrefetch(const std::string& short_filename) override;
 
   virtual std::shared_ptr<Surface> GetHaikei() override;
   virtual std::shared_ptr<Surface> GetDC(int dc) override;
@@ -110,6 +120,28 @@ class SDLGraphicsSystem : public GraphicsSystem, public NotificationObserver {
 
   void SetWindowTitle();
 
+  struct DecodedImage;
+
+  // Reads and decodes an image file. Safe to call from any thread.
+  static std::shared_ptr<DecodedImage> DecodeImageFile(
+      const boost::filesystem::path& filename);
+
+  // Reads an image out of |disk_cache| (which can be NULL) if it's there,
+  // and decodes it otherwise. Safe to call from any thread.
+  static std::shared_ptr<DecodedImage> LoadDecodedImage(
+      ImageDiskCache* disk_cache,
+      const boost::filesystem::path& filename,
+      const std::string& tone_curve);
+
+  // Writes the final pixels of a freshly decoded image to the disk cache.
+  void StoreInDiskCache(const boost::filesystem::path& filename,
+                        const std::string& tone_curve,
+                        const DecodedImage& image,
+                        SDL_Surface* surface);
+
+  // Resolves |short_filename|, throwing if it doesn't exist.
+  boost::filesystem::path FindImageFile(const std::string& short_filename);
+
   // NotificationObserver:
   virtual void Observe(NotificationType type,
                        const NotificationSource& source,
@@ -161,6 +193,14 @@ class SDLGraphicsSystem : public GraphicsSystem, public NotificationObserver {
   int screen_tex_height_;
 
   NotificationRegistrar registrar_;
+
+  // Decoded images saved between sessions. NULL unless __IMAGE_CACHE_SIZE
+  // is set.
+  std::unique_ptr<ImageDiskCache> image_disk_cache_;
+
+  // Images being decoded in the background because of PrefetchSurface().
+  std::map<std::string, std::future<std::shared_ptr<DecodedImage>>>
+      pending_decodes_;
 };
 
 #endif  // SRC_SYSTEMS_SDL_SDL_GRAPHICS_SYSTEM_H_
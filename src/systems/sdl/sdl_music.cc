@@ -30,6 +30,8 @@
 #include <SDL/SDL_mixer.h>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -40,7 +42,9 @@
 
 #include "systems/base/system.h"
 #include "systems/sdl/sdl_audio_locker.h"
+#include "utilities/asset_pack.h"
 #include "utilities/exception.h"
+#include "utilities/file.h"
 
 namespace fs = boost::filesystem;
 
@@ -49,6 +53,28 @@ const int STOP_NOW = -2;
 
 const int DEFAULT_FADE_MS = 10;
 
+// How much audio the decoder thread keeps ready for the audio callback.
+const int kDecodeAheadMs = 500;
+
+// Number of samples the decoder thread reads from the file at a time.
+const int kDecodeChunkSamples = 4096;
+
+// How often a decoder thread with a full buffer checks for room. The audio
+// callback must not take locks, so it never wakes the decoder itself.
+const int kDecoderPollMs = 10;
+
+namespace {
+
+// Scales interleaved 16-bit samples (WAVFILE::format is the native 16-bit
+// format) by |volume| / SDL_MIX_MAXVOLUME in place. Written as a plain loop
+// over the buffer so the compiler can vectorize it.
+void ApplyVolume(Sint16* samples, int count, int volume) {
+  for (int i = 0; i < count; ++i)
+    samples[i] = static_cast<Sint16>(samples[i] * volume / SDL_MIX_MAXVOLUME);
+}
+
+}  // namespace
+
 std::shared_ptr<SDLMusic> SDLMusic::s_currently_playing;
 bool SDLMusic::s_bgm_enabled = true;
 int SDLMusic::s_computed_bgm_vol = 128;
@@ -59,21 +85,26 @@ int SDLMusic::s_computed_bgm_vol = 128;
 
 SDLMusic::SDLMusic(const SoundSystem::DSTrack& track, WAVFILE* wav)
     : file_(wav),
+      decoded_(WAVFILE::freq * 4 * kDecodeAheadMs / 1000),
+      decoding_finished_(false),
+      stop_decoding_(false),
       track_(track),
       fadetime_total_(0),
       fade_in_ms_(0),
-      music_paused_(false) {
-  // Advance the audio stream to the starting point
-  if (track.from > 0)
-    wav->Seek(track.from);
-}
+      loop_point_(STOP_AT_END),
+      music_paused_(false),
+      finished_(false) {}
 
 SDLMusic::~SDLMusic() {
-  SDLAudioLocker locker;
-  delete file_;
+  {
+    std::lock_guard<std::mutex> lock(decoder_mutex_);
+    stop_decoding_ = true;
+  }
+  decoder_wakeup_.notify_one();
+  if (decoder_.joinable())
+    decoder_.join();
 
-  if (s_currently_playing.get() == this)
-    s_currently_playing.reset();
+  delete file_;
 }
 
 bool SDLMusic::IsLooping() const {
@@ -89,12 +120,16 @@ bool SDLMusic::IsFading() const {
 void SDLMusic::Play(bool loop) { FadeIn(loop, DEFAULT_FADE_MS); }
 
 void SDLMusic::Stop() {
+  // Dropped after the audio lock is released; destroying a track joins its
+  // decoder thread.
+  std::shared_ptr<SDLMusic> stopped;
   SDLAudioLocker locker;
   if (s_currently_playing.get() == this)
-    s_currently_playing.reset();
+    stopped = ReplaceCurrentlyPlaying(std::shared_ptr<SDLMusic>());
 }
 
 void SDLMusic::FadeIn(bool loop, int fade_in_ms) {
+  std::shared_ptr<SDLMusic> replaced;
   SDLAudioLocker locker;
 
   if (loop)
@@ -104,7 +139,9 @@ void SDLMusic::FadeIn(bool loop, int fade_in_ms) {
 
   fade_count_ = 0;
   fade_in_ms_ = fade_in_ms;
-  s_currently_playing = shared_from_this();
+  finished_ = false;
+  StartDecoding();
+  replaced = ReplaceCurrentlyPlaying(shared_from_this());
 }
 
 void SDLMusic::FadeOut(int fade_out_ms) {
@@ -141,27 +178,39 @@ int SDLMusic::BgmStatus() const {
     return 1;
 }
 
+// static
+void SDLMusic::ReleaseFinishedMusic() {
+  std::shared_ptr<SDLMusic> finished;
+  SDLAudioLocker locker;
+  if (s_currently_playing && s_currently_playing->finished_)
+    finished = ReplaceCurrentlyPlaying(std::shared_ptr<SDLMusic>());
+}
+
+// static
+std::shared_ptr<SDLMusic> SDLMusic::ReplaceCurrentlyPlaying(
+    std::shared_ptr<SDLMusic> music) {
+  s_currently_playing.swap(music);
+  return music;
+}
+
 // static
 void SDLMusic::MixMusic(void* udata, Uint8* stream, int len) {
   // Inside an SDL_LockAudio() section set up by SDL_Mixer! Don't lock here!
   SDLMusic* music = s_currently_playing.get();
 
-  int count;
-  if (!s_bgm_enabled || !music || music->music_paused_) {
+  if (!s_bgm_enabled || !music || music->music_paused_ || music->finished_) {
     memset(stream, 0, len);
     return;
   }
-  count = music->file_->Read((char*)stream, 4, len / 4);
 
-  if (count != len / 4) {
-    memset(stream + count * 4, 0, len - count * 4);
-    if (music->loop_point_ == STOP_AT_END) {
-      music->loop_point_ = STOP_NOW;
-      s_currently_playing.reset();
-    } else {
-      music->file_->Seek(music->loop_point_);
-      music->file_->Read((char*)(stream + count * 4), 4, len / 4 - count);
-    }
+  // Never wait on the decoder. If it has fallen behind, play silence for
+  // the rest of this buffer.
+  int count = music->decoded_.Read(reinterpret_cast<char*>(stream), len);
+  bool finished = false;
+  if (count != len) {
+    memset(stream + count, 0, len - count);
+    finished = music->decoding_finished_ &&
+               music->decoded_.ReadAvailable() == 0;
   }
 
   int cur_vol = s_computed_bgm_vol;
@@ -178,7 +227,7 @@ void SDLMusic::MixMusic(void* udata, Uint8* stream, int len) {
     int count_total = music->fadetime_total_ * (WAVFILE::freq / 1000);
     if (music->fade_count_ > count_total) {
       music->loop_point_ = STOP_NOW;
-      s_currently_playing.reset();
+      music->finished_ = true;
       memset(stream, 0, len);
       return;
     }
@@ -187,11 +236,52 @@ void SDLMusic::MixMusic(void* udata, Uint8* stream, int len) {
     music->fade_count_ += len / 4;
   }
 
-  if (cur_vol != SDL_MIX_MAXVOLUME) {
-    char stream_dup[len];  // NOLINT
-    memcpy(stream_dup, stream, len);
-    memset(stream, 0, len);
-    SDL_MixAudio(stream, (Uint8*)stream_dup, len, cur_vol);
+  if (cur_vol != SDL_MIX_MAXVOLUME)
+    ApplyVolume(reinterpret_cast<Sint16*>(stream), len / 2, cur_vol);
+
+  if (finished) {
+    music->loop_point_ = STOP_NOW;
+    music->finished_ = true;
+  }
+}
+
+void SDLMusic::StartDecoding() {
+  if (!decoder_.joinable())
+    decoder_ = std::thread(&SDLMusic::DecodeLoop, this);
+}
+
+void SDLMusic::DecodeLoop() {
+  // Advance the audio stream to the starting point
+  if (track_.from > 0)
+    file_->Seek(track_.from);
+
+  std::vector<char> chunk(kDecodeChunkSamples * 4);
+  bool just_looped = false;
+  std::unique_lock<std::mutex> lock(decoder_mutex_);
+  while (!stop_decoding_) {
+    if (decoded_.WriteAvailable() < chunk.size()) {
+      decoder_wakeup_.wait_for(lock, std::chrono::milliseconds(kDecoderPollMs));
+      continue;
+    }
+    lock.unlock();
+
+    int count = std::max(file_->Read(chunk.data(), 4, kDecodeChunkSamples), 0);
+    decoded_.Write(chunk.data(), count * 4);
+    if (count != kDecodeChunkSamples) {
+      int loop_point = loop_point_;
+      // Give up on loop points that don't produce any audio instead of
+      // spinning on them.
+      if (loop_point < 0 || (just_looped && count == 0)) {
+        decoding_finished_ = true;
+        return;
+      }
+      file_->Seek(loop_point);
+      just_looped = true;
+    } else {
+      just_looped = false;
+    }
+
+    lock.lock();
   }
 }
 
@@ -216,10 +306,16 @@ std::shared_ptr<SDLMusic> SDLMusic::CreateMusic(
     throw rlvm::Exception(oss.str());
   }
 
+  // rlvm-pack may have already decoded an nwa file into a wav file.
+  AssetPack::Entry entry;
+  bool predecoded = AssetPack::FindMounted(file_path, &entry) &&
+                    entry.encoding == AssetPack::ENCODING_WAV;
+
   const std::string& raw_path = file_path.native();
   for (FileTypes::const_iterator it = types.begin(); it != types.end(); ++it) {
-    if (boost::iends_with(raw_path, it->first)) {
-      FILE* f = fopen(raw_path.c_str(), "r");
+    if (predecoded ? it->first == "wav"
+                   : boost::iends_with(raw_path, it->first)) {
+      FILE* f = OpenFile(file_path);
       if (f == 0) {
         std::ostringstream oss;
         oss << "Could not open \"" << file_path << "\" for reading.";
@@ -30,10 +30,15 @@
 
 #include <SDL/SDL_mixer.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "systems/base/sound_system.h"
+#include "utilities/ring_buffer.h"
 #include "xclannad/wavfile.h"
 
 // Encapsulates access to SDLMussic.
@@ -52,6 +57,13 @@
 //
 // So instead of taking just jagarl's nwatowav.cc, I'm also stealing
 // wavfile.{cc,h}, and some binding code.
+//
+// Decoding (and the file IO and loop seeking that goes with it) happens on a
+// per track decoder thread which keeps |decoded_| topped up. The audio
+// callback only drains that buffer and applies the volume, so it never waits
+// on the disk. It also never drops the last reference to a track (which
+// would join the decoder); it marks the track finished and the main thread
+// releases it in ReleaseFinishedMusic().
 class SDLMusic : public std::enable_shared_from_this<SDLMusic> {
  public:
   virtual ~SDLMusic();
@@ -84,11 +96,18 @@ class SDLMusic : public std::enable_shared_from_this<SDLMusic> {
   // Returns the currently playing SDLMusic object. Returns NULL if no
   // music is currently playing.
   static std::shared_ptr<SDLMusic> CurrnetlyPlaying() {
-    return s_currently_playing;
+    return IsCurrentlyPlaying() ? s_currently_playing
+                                : std::shared_ptr<SDLMusic>();
   }
 
   // Whether music is currently playing.
-  static bool IsCurrentlyPlaying() { return s_currently_playing.get(); }
+  static bool IsCurrentlyPlaying() {
+    return s_currently_playing && !s_currently_playing->finished_;
+  }
+
+  // Lets go of the current track if the audio callback has finished playing
+  // it. Must be called from the main thread, outside of any SDLAudioLocker.
+  static void ReleaseFinishedMusic();
 
   // Whether we should output music.
   static void SetBgmEnabled(const int in) { s_bgm_enabled = in; }
@@ -108,12 +127,36 @@ class SDLMusic : public std::enable_shared_from_this<SDLMusic> {
   // the static method WavChunk::callback in music2/music.cc.
   static void MixMusic(void* udata, Uint8* stream, int len);
 
+  // Swaps |music| in as the currently playing track and returns the track it
+  // replaced, so that the caller can drop it after releasing the audio lock.
+  static std::shared_ptr<SDLMusic> ReplaceCurrentlyPlaying(
+      std::shared_ptr<SDLMusic> music);
+
+  // Starts the decoder thread if it isn't already running.
+  void StartDecoding();
+
+  // Body of the decoder thread. Reads from |file_| into |decoded_|, seeking
+  // back to |loop_point_| at the end of the track, until told to stop.
+  void DecodeLoop();
+
   // Strongly coupled because of access to SDLMusic::MixMusic.
   friend class SDLSoundSystem;
 
-  // Underlying data stream. (These classes stolen from xclannad.)
+  // Underlying data stream. (These classes stolen from xclannad.) Only
+  // touched by the decoder thread once it has started.
   WAVFILE* file_;
 
+  // Decoded 16-bit stereo samples waiting for MixMusic().
+  RingBuffer<char> decoded_;
+
+  // Set once the decoder has pushed the last sample of a non looping track.
+  std::atomic<bool> decoding_finished_;
+
+  std::thread decoder_;
+  std::mutex decoder_mutex_;
+  std::condition_variable decoder_wakeup_;
+  bool stop_decoding_;
+
   // The underlying track information
   const SoundSystem::DSTrack& track_;
 
@@ -126,13 +169,20 @@ class SDLMusic : public std::enable_shared_from_this<SDLMusic> {
   // Number of milliseconds to fade in.
   int fade_in_ms_;
 
-  // The starting loop point.
-  int loop_point_;
+  // The starting loop point. Read by the decoder thread when it reaches the
+  // end of the track.
+  std::atomic<int> loop_point_;
 
   // Whether the music is currently paused.
   bool music_paused_;
 
-  // The currently playing track.
+  // Set by the audio callback once this track has played out (or faded out).
+  // The track stays in |s_currently_playing| until the main thread releases
+  // it.
+  std::atomic<bool> finished_;
+
+  // The currently playing track. This mirrors SDL_mixer's single, process
+  // wide music channel, so it is shared between machines on purpose.
   static std::shared_ptr<SDLMusic> s_currently_playing;
 
   // Whether we should even be playing music.
@@ -33,6 +33,7 @@
 
 #include "systems/base/sound_system.h"
 #include "systems/sdl/sdl_audio_locker.h"
+#include "utilities/asset_pack.h"
 #include "xclannad/wavfile.h"
 
 SDLSoundChunk::PlayingTable SDLSoundChunk::s_playing_table;
@@ -50,6 +51,26 @@ SDLSoundChunk::~SDLSoundChunk() {
 }
 
 Mix_Chunk* SDLSoundChunk::LoadSample(const boost::filesystem::path& path) {
+  AssetPack::Entry entry;
+  if (AssetPack::FindMounted(path, &entry)) {
+    if (entry.encoding == AssetPack::ENCODING_RAW &&
+        boost::iequals(path.extension().string(), ".nwa")) {
+      int size = 0;
+      char* data = decode_nwa(entry.data, entry.size, &size);
+      if (!data)
+        return NULL;
+
+      Mix_Chunk* chunk = Mix_LoadWAV_RW(SDL_RWFromMem(data, size), 1);
+      delete[] data;
+      return chunk;
+    }
+
+    // Everything else (including nwa files that rlvm-pack decoded to wav)
+    // is something SDL_mixer reads directly.
+    return Mix_LoadWAV_RW(
+        SDL_RWFromConstMem(entry.data, static_cast<int>(entry.size)), 1);
+  }
+
   if (boost::iequals(path.extension().string(), ".nwa")) {
     // Hack to load NWA sounds into a MixChunk. I was resisted doing this
     // because I assumed there was a better way, but this is essentially what
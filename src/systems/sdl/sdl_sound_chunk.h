@@ -49,6 +49,9 @@ class SDLSoundChunk : public std::enable_shared_from_this<SDLSoundChunk> {
 
   virtual ~SDLSoundChunk();
 
+  // The number of bytes of decoded audio, or 0 if loading failed.
+  size_t size() const { return sample_ ? sample_->alen : 0; }
+
   // Plays the chunk on the given channel. Wraps Mix_PlayChannel. Pass -1 to
   // |loops| for infinite loops.
   //
@@ -31,9 +31,15 @@
 #include <SDL/SDL_mixer.h>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <chrono>
+#include <map>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "machine/startup_profile.h"
+#include "systems/base/se_bank.h"
 #include "systems/base/system.h"
 #include "systems/base/system_error.h"
 #include "systems/base/voice_archive.h"
@@ -41,6 +47,7 @@
 #include "systems/sdl/sdl_music.h"
 #include "systems/sdl/sdl_sound_chunk.h"
 #include "utilities/exception.h"
+#include "libreallive/gameexe.h"
 
 namespace fs = boost::filesystem;
 
@@ -65,6 +72,10 @@ static RealLiveSoundQualities s_real_live_sound_qualities[] = {
     {48000, AUDIO_S16}   // 48 h_kz, 16 bit stereo
 };
 
+// Megabytes of decoded sound effects we keep in memory unless overridden by
+// __SE_BANK_SIZE.
+static const int kDefaultSeBankSize = 16;
+
 // -----------------------------------------------------------------------
 // SDLSoundSystem (private)
 // -----------------------------------------------------------------------
@@ -92,6 +103,61 @@ SDLSoundSystem::SDLSoundChunkPtr SDLSoundSystem::BuildKoeChunk(char* data,
   return SDLSoundChunkPtr(new SDLSoundChunk(data, length));
 }
 
+void SDLSoundSystem::BuildSeBank() {
+  const size_t limit =
+      size_t(system().gameexe()("__SE_BANK_SIZE").ToInt(kDefaultSeBankSize)) *
+      1024 * 1024;
+
+  // FindFile() and the Gameexe belong to this thread; only the decoding
+  // moves to the worker.
+  std::map<std::string, fs::path> paths;
+  std::vector<std::pair<int, fs::path>> files;
+  for (auto const& entry : se_table()) {
+    const std::string& file_name = entry.second.first;
+    if (file_name.empty())
+      continue;
+
+    auto it = paths.find(file_name);
+    if (it == paths.end()) {
+      it = paths.emplace(file_name,
+                         system().FindFile(file_name, SOUND_FILETYPES)).first;
+    }
+    if (!it->second.empty())
+      files.emplace_back(entry.first, it->second);
+  }
+
+  pending_se_bank_ =
+      std::async(std::launch::async, &SDLSoundSystem::DecodeSeBank, files,
+                 limit);
+}
+
+// static
+SDLSoundSystem::SeBank SDLSoundSystem::DecodeSeBank(
+    const std::vector<std::pair<int, fs::path>>& files,
+    size_t limit) {
+  ScopedStartupStage stage("SE bank");
+  return FillSeBank<SDLSoundChunkPtr>(
+      files, limit, [](const fs::path& path) {
+        return SDLSoundChunkPtr(new SDLSoundChunk(path));
+      });
+}
+
+SDLSoundSystem::SDLSoundChunkPtr SDLSoundSystem::GetBankedSe(int se_num) {
+  // Don't hold up a sound effect for the whole bank; it'll be ready soon.
+  if (pending_se_bank_.valid()) {
+    if (pending_se_bank_.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return SDLSoundChunkPtr();
+    }
+    se_bank_ = pending_se_bank_.get();
+  }
+
+  auto it = se_bank_.find(se_num);
+  if (it == se_bank_.end())
+    return SDLSoundChunkPtr();
+  return it->second;
+}
+
 void SDLSoundSystem::WavPlayImpl(const std::string& wav_file,
                                  const int channel,
                                  bool loop) {
@@ -165,9 +231,17 @@ SDLSoundSystem::SDLSoundSystem(System& system)
   Mix_ChannelFinished(&SDLSoundChunk::SoundChunkFinishedPlayback);
 
   SetMusicHook(NULL);
+
+  // Mix_OpenAudio() has fixed the output format, so the bank can be decoded
+  // straight into it.
+  BuildSeBank();
 }
 
 SDLSoundSystem::~SDLSoundSystem() {
+  // The decoder needs the mixer's output format until it's done.
+  if (pending_se_bank_.valid())
+    pending_se_bank_.wait();
+
   Mix_HookMusic(NULL, NULL);
 
   Mix_CloseAudio();
@@ -177,12 +251,21 @@ SDLSoundSystem::~SDLSoundSystem() {
 void SDLSoundSystem::ExecuteSoundSystem() {
   SoundSystem::ExecuteSoundSystem();
 
+  SDLMusic::ReleaseFinishedMusic();
   if (queued_music_ && !SDLMusic::IsCurrentlyPlaying()) {
     queued_music_->FadeIn(queued_music_loop_, queued_music_fadein_);
     queued_music_.reset();
   }
 }
 
+unsigned int SDLSoundSystem::NextWakeupTime() const {
+  // We don't get told when the current track ends, so poll while something
+  // is waiting to play after it.
+  if (queued_music_)
+    return 0;
+  return SoundSystem::NextWakeupTime();
+}
+
 void SDLSoundSystem::SetBgmEnabled(const int in) {
   SDLMusic::SetBgmEnabled(in);
   SoundSystem::SetBgmEnabled(in);
@@ -267,7 +350,7 @@ void SDLSoundSystem::WavFadeOut(const int channel, const int fadetime) {
     SDLSoundChunk::FadeOut(channel, fadetime);
 }
 
-void SDLSoundSystem::PlaySe(const int se_num) {
+void SDLSoundSystem::PlaySeImpl(const int se_num) {
   if (is_se_enabled()) {
     SeTable::const_iterator it = se_table().find(se_num);
     if (it == se_table().end()) {
@@ -287,7 +370,9 @@ void SDLSoundSystem::PlaySe(const int se_num) {
       return;
     }
 
-    SDLSoundChunkPtr sample = GetSoundChunk(file_name, wav_cache_);
+    SDLSoundChunkPtr sample = GetBankedSe(se_num);
+    if (!sample)
+      sample = GetSoundChunk(file_name, wav_cache_);
 
     // SE chunks have no volume other than the modifier.
     Mix_Volume(channel, realLiveVolumeToSDLMixerVolume(se_volume_mod()));
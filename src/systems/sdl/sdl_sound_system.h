@@ -31,8 +31,12 @@
 #include <boost/filesystem/operations.hpp>
 #include <SDL/SDL.h>
 
+#include <future>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "systems/base/sound_system.h"
 #include "lru_cache.hpp"
@@ -46,6 +50,7 @@ class SDLSoundSystem : public SoundSystem {
   ~SDLSoundSystem();
 
   virtual void ExecuteSoundSystem() override;
+  virtual unsigned int NextWakeupTime() const override;
 
   virtual void SetBgmEnabled(const int in) override;
   virtual void SetBgmVolumeMod(const int in) override;
@@ -80,7 +85,6 @@ class SDLSoundSystem : public SoundSystem {
   virtual void WavStopAll() override;
   virtual void WavFadeOut(const int channel, const int fadetime) override;
 
-  virtual void PlaySe(const int se_num) override;
   virtual bool HasSe(const int se_num) override;
 
   virtual bool KoePlaying() const override;
@@ -97,6 +101,7 @@ class SDLSoundSystem : public SoundSystem {
   typedef std::shared_ptr<SDLMusic> SDLMusicPtr;
   typedef LRUCache<std::string, SDLSoundChunkPtr> SoundChunkCache;
 
+  virtual void PlaySeImpl(const int se_num) override;
   virtual void KoePlayImpl(int id) override;
 
   // Retrieves a sound chunk from the passed in cache (or loads it if
@@ -109,6 +114,21 @@ class SDLSoundSystem : public SoundSystem {
   // string to cache on.
   static SDLSoundChunkPtr BuildKoeChunk(char* data, int length);
 
+  typedef std::unordered_map<int, SDLSoundChunkPtr> SeBank;
+
+  // Starts decoding the files named in the #SE table on a worker thread,
+  // until the bank reaches the size given by __SE_BANK_SIZE (in megabytes).
+  void BuildSeBank();
+
+  // Decodes as many of |files| as fit in |limit| bytes; see FillSeBank().
+  static SeBank DecodeSeBank(
+      const std::vector<std::pair<int, boost::filesystem::path>>& files,
+      size_t limit);
+
+  // Returns the banked chunk for |se_num|, or NULL if it isn't banked or the
+  // bank is still being decoded.
+  SDLSoundChunkPtr GetBankedSe(int se_num);
+
   // Implementation to play a wave file. Two wavPlay() versions use this
   // underlying implementation, which is split out so the one that takes a raw
   // channel can verify its input.
@@ -127,6 +147,13 @@ class SDLSoundSystem : public SoundSystem {
   SoundChunkCache se_cache_;
   SoundChunkCache wav_cache_;
 
+  // Sound effects, already converted to the mixer's format, so PlaySe() never
+  // has to go to disk. Entries that didn't fit fall back to |wav_cache_|.
+  SeBank se_bank_;
+
+  // The bank while it's being decoded, until GetBankedSe() collects it.
+  std::future<SeBank> pending_se_bank_;
+
   // The music to play next as soon as the current track finishes.
   SDLMusicPtr queued_music_;
 
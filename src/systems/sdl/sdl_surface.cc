@@ -613,6 +613,21 @@ void SDLSurface::RenderToScreen(const Rect& src,
 
 // -----------------------------------------------------------------------
 
+void SDLSurface::RenderQuadsToScreen(const std::vector<Quad>& quads) const {
+  if (quads.empty())
+    return;
+
+  uploadTextureIfNeeded();
+
+  for (std::vector<TextureRecord>::iterator it = textures_.begin();
+       it != textures_.end();
+       ++it) {
+    it->texture->RenderQuadsToScreen(quads);
+  }
+}
+
+// -----------------------------------------------------------------------
+
 void SDLSurface::RenderToScreenAsObject(const GraphicsObject& rp,
                                         const Rect& src,
                                         const Rect& dst,
@@ -114,6 +114,9 @@ class SDLSurface : public Surface, public NotificationObserver {
                               const int opacity[4]) const override;
 
   // Used internally; not exposed to the general graphics system
+  virtual void RenderQuadsToScreen(
+      const std::vector<Quad>& quads) const override;
+
   virtual void RenderToScreenAsObject(const GraphicsObject& rp,
                                       const Rect& src,
                                       const Rect& dst,
@@ -33,7 +33,9 @@
 
 #include "libreallive/defs.h"
 #include "libreallive/gameexe.h"
+#include "machine/profiler.h"
 #include "machine/rlmachine.h"
+#include "machine/startup_profile.h"
 #include "systems/base/graphics_object.h"
 #include "systems/base/graphics_object_data.h"
 #include "systems/base/platform.h"
@@ -45,18 +47,38 @@
 // -----------------------------------------------------------------------
 
 SDLSystem::SDLSystem(Gameexe& gameexe) : System(), gameexe_(gameexe) {
-  // First, initialize SDL's video subsystem.
-  if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-    std::ostringstream ss;
-    ss << "Video initialization failed: " << SDL_GetError();
-    throw libreallive::Error(ss.str());
+  // Index the game's files while SDL and the subsystems come up; the first
+  // thing that needs them is the sound system's SE bank.
+  StartFileSystemScan();
+
+  // First, initialize SDL's video subsystem. (The timer subsystem wakes
+  // SDLEventSystem::WaitForInput() up.)
+  {
+    ScopedStartupStage stage("SDL video");
+    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER) < 0) {
+      std::ostringstream ss;
+      ss << "Video initialization failed: " << SDL_GetError();
+      throw libreallive::Error(ss.str());
+    }
   }
 
   // Initialize the various subsystems
-  graphics_system_.reset(new SDLGraphicsSystem(*this, gameexe));
-  event_system_.reset(new SDLEventSystem(*this, gameexe));
-  text_system_.reset(new SDLTextSystem(*this, gameexe));
-  sound_system_.reset(new SDLSoundSystem(*this));
+  {
+    ScopedStartupStage stage("Graphics system");
+    graphics_system_.reset(new SDLGraphicsSystem(*this, gameexe));
+  }
+  {
+    ScopedStartupStage stage("Event system");
+    event_system_.reset(new SDLEventSystem(*this, gameexe));
+  }
+  {
+    ScopedStartupStage stage("Text system");
+    text_system_.reset(new SDLTextSystem(*this, gameexe));
+  }
+  {
+    ScopedStartupStage stage("Sound system");
+    sound_system_.reset(new SDLSoundSystem(*this));
+  }
 
   event_system_->AddMouseListener(graphics_system_.get());
   event_system_->AddMouseListener(text_system_.get());
@@ -87,10 +109,22 @@ SDLSystem::~SDLSystem() {
 
 void SDLSystem::Run(RLMachine& machine) {
   // Give the event handler a chance to run.
-  event_system_->ExecuteEventSystem(machine);
-  text_system_->ExecuteTextSystem();
-  sound_system_->ExecuteSoundSystem();
-  graphics_system_->ExecuteGraphicsSystem(machine);
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_EVENT);
+    event_system_->ExecuteEventSystem(machine);
+  }
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_TEXT);
+    text_system_->ExecuteTextSystem();
+  }
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_SOUND);
+    sound_system_->ExecuteSoundSystem();
+  }
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_GRAPHICS);
+    graphics_system_->ExecuteGraphicsSystem(machine);
+  }
 
   if (platform())
     platform()->Run(machine);
@@ -35,6 +35,7 @@
 #include <string>
 #include <vector>
 
+#include "systems/base/colour.h"
 #include "systems/base/graphics_system.h"
 #include "systems/base/rect.h"
 #include "systems/base/system_error.h"
@@ -48,7 +49,9 @@
 #include "libreallive/gameexe.h"
 
 SDLTextSystem::SDLTextSystem(SDLSystem& system, Gameexe& gameexe)
-    : TextSystem(system, gameexe), sdl_system_(system) {
+    : TextSystem(system, gameexe),
+      glyph_cache_(kGlyphCacheSize),
+      sdl_system_(system) {
   if (TTF_Init() == -1) {
     std::ostringstream oss;
     oss << "Error initializing SDL_ttf: " << TTF_GetError();
@@ -83,17 +86,8 @@ Size SDLTextSystem::RenderGlyphOnto(
     const std::shared_ptr<Surface>& destination) {
   SDLSurface* sdl_surface = static_cast<SDLSurface*>(destination.get());
 
-  std::shared_ptr<TTF_Font> font = GetFontOfSize(font_size);
-
-  if (italic) {
-    TTF_SetFontStyle(font.get(), TTF_STYLE_ITALIC);
-  }
-
-  SDL_Color sdl_colour;
-  RGBColourToSDLColor(font_colour, &sdl_colour);
-  std::shared_ptr<SDL_Surface> character(
-      TTF_RenderUTF8_Blended(font.get(), current.c_str(), sdl_colour),
-      SDL_FreeSurface);
+  std::shared_ptr<SDL_Surface> character =
+      RenderGlyph(current, font_size, italic, font_colour);
 
   if (character == NULL) {
     // Bug during Kyou's path. The string is printed "". Regression in parser?
@@ -104,18 +98,8 @@ Size SDLTextSystem::RenderGlyphOnto(
   }
 
   std::shared_ptr<SDL_Surface> shadow;
-  if (shadow_colour && sdl_system_.text().font_shadow()) {
-    SDL_Color sdl_shadow_colour;
-    RGBColourToSDLColor(*shadow_colour, &sdl_shadow_colour);
-
-    shadow.reset(
-        TTF_RenderUTF8_Blended(font.get(), current.c_str(), sdl_shadow_colour),
-        SDL_FreeSurface);
-  }
-
-  if (italic) {
-    TTF_SetFontStyle(font.get(), TTF_STYLE_NORMAL);
-  }
+  if (shadow_colour && sdl_system_.text().font_shadow())
+    shadow = RenderGlyph(current, font_size, italic, *shadow_colour);
 
   Point insertion(insertion_point_x, insertion_point_y);
 
@@ -140,6 +124,34 @@ int SDLTextSystem::GetCharWidth(int size, uint16_t codepoint) {
   return advance;
 }
 
+std::shared_ptr<SDL_Surface> SDLTextSystem::RenderGlyph(
+    const std::string& glyph,
+    int font_size,
+    bool italic,
+    const RGBColour& colour) {
+  GlyphKey key(glyph, font_size, italic,
+               (colour.r() << 16) | (colour.g() << 8) | colour.b());
+  std::shared_ptr<SDL_Surface> surface = glyph_cache_.fetch(key);
+  if (surface)
+    return surface;
+
+  std::shared_ptr<TTF_Font> font = GetFontOfSize(font_size);
+  if (italic)
+    TTF_SetFontStyle(font.get(), TTF_STYLE_ITALIC);
+
+  SDL_Color sdl_colour;
+  RGBColourToSDLColor(colour, &sdl_colour);
+  surface.reset(TTF_RenderUTF8_Blended(font.get(), glyph.c_str(), sdl_colour),
+                SDL_FreeSurface);
+
+  if (italic)
+    TTF_SetFontStyle(font.get(), TTF_STYLE_NORMAL);
+
+  if (surface)
+    glyph_cache_.insert(key, surface);
+  return surface;
+}
+
 std::shared_ptr<TTF_Font> SDLTextSystem::GetFontOfSize(int size) {
   FontSizeMap::iterator it = map_.find(size);
   if (it == map_.end()) {
@@ -31,8 +31,11 @@
 #include <SDL/SDL_ttf.h>
 
 #include <map>
+#include <memory>
 #include <string>
+#include <tuple>
 
+#include "lru_cache.hpp"
 #include "systems/base/text_system.h"
 
 class Point;
@@ -63,10 +66,23 @@ class SDLTextSystem : public TextSystem {
   std::shared_ptr<TTF_Font> GetFontOfSize(int size);
 
  private:
+  // Returns |glyph| rasterized in |colour|. Text windows and text objects
+  // redraw the same few characters over and over, so the results are kept
+  // in |glyph_cache_|.
+  std::shared_ptr<SDL_Surface> RenderGlyph(const std::string& glyph,
+                                           int font_size,
+                                           bool italic,
+                                           const RGBColour& colour);
+
   // Font storage.
   typedef std::map<int, std::shared_ptr<TTF_Font>> FontSizeMap;
   FontSizeMap map_;
 
+  // Rasterized glyphs, keyed on (glyph, size, italic, 0xRRGGBB).
+  static const unsigned long kGlyphCacheSize = 512;
+  typedef std::tuple<std::string, int, bool, int> GlyphKey;
+  LRUCache<GlyphKey, std::shared_ptr<SDL_Surface>> glyph_cache_;
+
   SDLSystem& sdl_system_;
 
   std::unique_ptr<bool> is_monospace_;
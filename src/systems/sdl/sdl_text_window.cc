@@ -133,6 +133,7 @@ void SDLTextWindow::DisplayRubyText(const std::string& utf8str) {
     int width_start =
         int(ruby_begin_point_ + ((end_point - ruby_begin_point_) * 0.5f) -
             (w * 0.5f));
+    FlushPendingGlyphs();
     surface_->blitFROMSurface(
         tmp,
         Rect(Point(0, 0), Size(w, h)),
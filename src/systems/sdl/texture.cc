@@ -53,9 +53,6 @@
 unsigned int Texture::s_screen_width = 0;
 unsigned int Texture::s_screen_height = 0;
 
-unsigned int Texture::s_upload_buffer_size = 0;
-std::unique_ptr<char[]> Texture::s_upload_buffer;
-
 // -----------------------------------------------------------------------
 
 void Texture::SetScreenSize(const Size& s) {
@@ -212,12 +209,17 @@ Texture::~Texture() {
 // -----------------------------------------------------------------------
 
 char* Texture::uploadBuffer(unsigned int size) {
-  if (!s_upload_buffer || size > s_upload_buffer_size) {
-    s_upload_buffer.reset(new char[size]);
-    s_upload_buffer_size = size;
+  // To prevent new-ing in a loop, save the dynamically allocated buffer used
+  // to upload data into.
+  thread_local std::unique_ptr<char[]> upload_buffer;
+  thread_local unsigned int upload_buffer_size = 0;
+
+  if (!upload_buffer || size > upload_buffer_size) {
+    upload_buffer.reset(new char[size]);
+    upload_buffer_size = size;
   }
 
-  return s_upload_buffer.get();
+  return upload_buffer.get();
 }
 
 // -----------------------------------------------------------------------
@@ -303,31 +305,36 @@ std::string readTextFile(const std::string& file) {
 
 // -----------------------------------------------------------------------
 
-// This is really broken and brain dead.
 void Texture::RenderToScreen(const Rect& src, const Rect& dst, int opacity) {
-  int x1 = src.x(), y1 = src.y(), x2 = src.x2(), y2 = src.y2();
-  int fdx1 = dst.x(), fdy1 = dst.y(), fdx2 = dst.x2(), fdy2 = dst.y2();
-  if (!filterCoords(x1, y1, x2, y2, fdx1, fdy1, fdx2, fdy2))
-    return;
-
-  // For the time being, we are dumb and assume that it's one texture
-
-  float thisx1 = float(x1) / texture_width_;
-  float thisy1 = float(y1) / texture_height_;
-  float thisx2 = float(x2) / texture_width_;
-  float thisy2 = float(y2) / texture_height_;
+  RenderQuadsToScreen(std::vector<Surface::Quad>{{src, dst, opacity}});
+}
 
-  if (is_upside_down_) {
-    thisy1 = float(logical_height_ - y1) / texture_height_;
-    thisy2 = float(logical_height_ - y2) / texture_height_;
-  }
+// -----------------------------------------------------------------------
 
+void Texture::RenderQuadsToScreen(const std::vector<Surface::Quad>& quads) {
   glBindTexture(GL_TEXTURE_2D, texture_id_);
 
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   glBegin(GL_QUADS);
-  {
-    glColor4ub(255, 255, 255, opacity);
+  for (const Surface::Quad& quad : quads) {
+    int x1 = quad.src.x(), y1 = quad.src.y(), x2 = quad.src.x2(),
+        y2 = quad.src.y2();
+    int fdx1 = quad.dst.x(), fdy1 = quad.dst.y(), fdx2 = quad.dst.x2(),
+        fdy2 = quad.dst.y2();
+    if (!filterCoords(x1, y1, x2, y2, fdx1, fdy1, fdx2, fdy2))
+      continue;
+
+    float thisx1 = float(x1) / texture_width_;
+    float thisy1 = float(y1) / texture_height_;
+    float thisx2 = float(x2) / texture_width_;
+    float thisy2 = float(y2) / texture_height_;
+
+    if (is_upside_down_) {
+      thisy1 = float(logical_height_ - y1) / texture_height_;
+      thisy2 = float(logical_height_ - y2) / texture_height_;
+    }
+
+    glColor4ub(255, 255, 255, quad.alpha);
     glTexCoord2f(thisx1, thisy1);
     glVertex2i(fdx1, fdy1);
     glTexCoord2f(thisx2, thisy1);
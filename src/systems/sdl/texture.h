@@ -32,6 +32,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
+
+#include "systems/base/surface.h"
 
 struct SDL_Surface;
 class SDLSurface;
@@ -88,6 +91,10 @@ class Texture {
 
   void RenderToScreen(const Rect& src, const Rect& dst, int opacity);
 
+  // Draws the parts of |quads| that fall on this texture between a single
+  // glBegin()/glEnd() pair.
+  void RenderQuadsToScreen(const std::vector<Surface::Quad>& quads);
+
   void RenderToScreenAsColorMask(const Rect& src,
                                  const Rect& dst,
                                  const RGBAColour& rgba,
@@ -96,11 +103,9 @@ class Texture {
   void RenderToScreen(const Rect& src, const Rect& dst, const int opacity[4]);
 
  private:
-  // Returns a shared buffer of at least size. This is not thread safe
-  // or reenterant in the least; it is merely meant to prevent
-  // allocations. This is the proper way to access s_upload_buffer,
-  // since it will automatically reallocate it for you if it isn't
-  // large enough.
+  // Returns a per thread buffer of at least size. This is not reenterant in
+  // the least; it is merely meant to prevent allocations. It will
+  // automatically reallocate the buffer for you if it isn't large enough.
   static char* uploadBuffer(unsigned int size);
 
   void render_to_screen_as_colour_mask_subtractive_glsl(const Rect& src,
@@ -142,16 +147,10 @@ class Texture {
   // Is this texture upside down? (Because it's a screenshot, etc.)
   bool is_upside_down_;
 
-  // Size of the screen. Used during color mask calculations.
+  // Size of the screen. Used during color mask calculations. SDL only gives
+  // us one window per process, so this is shared by every Texture.
   static unsigned int s_screen_width;
   static unsigned int s_screen_height;
-
-  // The size of s_upload_buffer. Initialized to 0.
-  static unsigned int s_upload_buffer_size;
-
-  // To prevent new-ing in a loop, save the dynamically allocated
-  // buffer used to upload data into.
-  static std::unique_ptr<char[]> s_upload_buffer;
 };
 
 #endif  // SRC_SYSTEMS_SDL_TEXTURE_H_
@@ -0,0 +1,301 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+// Builds an rlvm.pack (see utilities/asset_pack.h) out of the loose files in a
+// game's #FOLDNAME directories. rlvm picks the pack up automatically when it
+// sits in the game root; loose files that are still around take precedence
+// over packed ones.
+
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "libreallive/gameexe.h"
+#include "systems/base/system.h"
+#include "utilities/asset_pack.h"
+#include "utilities/exception.h"
+#include "utilities/file.h"
+#include "xclannad/file.h"
+#include "xclannad/wavfile.h"
+
+using namespace std;
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+namespace {
+
+struct PackStats {
+  int files = 0;
+  int images_decoded = 0;
+  int sounds_decoded = 0;
+  uint64_t input_bytes = 0;
+  uint64_t output_bytes = 0;
+};
+
+// Runs |data| through Jagarl's converters and lays the result out as an
+// AssetPack::ENCODING_RGBA entry. Returns false if the image can't be read,
+// in which case the caller should store it raw.
+bool DecodeImage(const char* data, int size, std::vector<char>* out) {
+  std::unique_ptr<GRPCONV> conv(GRPCONV::AssignConverter(data, size, "???"));
+  if (!conv)
+    return false;
+
+  int width = conv->Width();
+  int height = conv->Height();
+  std::unique_ptr<char[]> mem(new char[width * height * 4 + 1024]);
+  if (!conv->Read(mem.get()))
+    return false;
+
+  // Same check as SDLGraphicsSystem::DecodeImageFile(): a mask that's opaque
+  // everywhere isn't a mask.
+  bool is_mask = conv->IsMask();
+  if (is_mask) {
+    const unsigned int* pixels = reinterpret_cast<unsigned int*>(mem.get());
+    is_mask = std::any_of(pixels, pixels + width * height, [](unsigned int p) {
+      return (p & 0xff000000) != 0xff000000;
+    });
+  }
+
+  AssetPack::ImageHeader header;
+  header.width = width;
+  header.height = height;
+  header.is_mask = is_mask;
+  std::vector<AssetPack::ImageRegion> regions;
+  for (auto const& region : conv->region_table) {
+    regions.push_back({region.x1, region.y1, region.x2, region.y2,
+                       region.origin_x, region.origin_y});
+  }
+  *out = AssetPack::SerializeImage(header, regions, mem.get());
+  return true;
+}
+
+void AddFile(AssetPackWriter& writer,
+             const fs::path& file,
+             const std::string& name,
+             const po::variables_map& vm,
+             PackStats* stats) {
+  std::unique_ptr<char[]> data;
+  int size = 0;
+  if (LoadFileData(file, data, size)) {
+    std::ostringstream oss;
+    oss << "Could not read " << file;
+    throw rlvm::Exception(oss.str());
+  }
+
+  stats->files++;
+  stats->input_bytes += size;
+
+  if (vm.count("decode-images") &&
+      (boost::iends_with(name, ".g00") || boost::iends_with(name, ".pdt"))) {
+    std::vector<char> decoded;
+    if (DecodeImage(data.get(), size, &decoded)) {
+      writer.AddEntry(name, AssetPack::ENCODING_RGBA, decoded.data(),
+                      decoded.size());
+      stats->images_decoded++;
+      stats->output_bytes += decoded.size();
+      return;
+    }
+    cerr << "WARNING: Storing undecodable image " << file << " as is." << endl;
+  }
+
+  if (vm.count("decode-sounds") && boost::iends_with(name, ".nwa")) {
+    int wav_size = 0;
+    std::unique_ptr<char[]> wav(decode_nwa(data.get(), size, &wav_size));
+    if (wav) {
+      writer.AddEntry(name, AssetPack::ENCODING_WAV, wav.get(), wav_size);
+      stats->sounds_decoded++;
+      stats->output_bytes += wav_size;
+      return;
+    }
+    cerr << "WARNING: Storing undecodable sound " << file << " as is." << endl;
+  }
+
+  writer.AddEntry(name, AssetPack::ENCODING_RAW, data.get(), size);
+  stats->output_bytes += size;
+}
+
+// Adds every file under |directory| that rlvm would index, named relative to
+// the game root.
+void AddDirectory(AssetPackWriter& writer,
+                  const fs::path& directory,
+                  const std::string& prefix,
+                  const po::variables_map& vm,
+                  PackStats* stats) {
+  std::vector<fs::path> children;
+  std::copy(fs::directory_iterator(directory), fs::directory_iterator(),
+            std::back_inserter(children));
+  // Keep the output stable between runs.
+  std::sort(children.begin(), children.end());
+
+  for (const fs::path& child : children) {
+    std::string name = prefix + "/" + child.filename().string();
+    if (fs::is_directory(child)) {
+      AddDirectory(writer, child, name, vm, stats);
+      continue;
+    }
+
+    std::string extension = child.extension().string();
+    if (extension.size() > 1 && extension[0] == '.')
+      extension = extension.substr(1);
+    boost::to_lower(extension);
+    if (find(ALL_FILETYPES.begin(), ALL_FILETYPES.end(), extension) !=
+        ALL_FILETYPES.end()) {
+      AddFile(writer, child, name, vm, stats);
+    }
+  }
+}
+
+void printUsage(const string& name, po::options_description& opts) {
+  cout << "Usage: " << name << " [options] <game root>" << endl
+       << opts << endl;
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+
+int main(int argc, char* argv[]) {
+  // Declare the supported options.
+  po::options_description opts("Options");
+  opts.add_options()("help", "Produce help message")(
+      "output", po::value<string>(),
+      "Write the pack here instead of <game root>/rlvm.pack")(
+      "decode-images",
+      "Store g00/pdt images as decoded RGBA pixels. Much larger, but rlvm "
+      "skips decoding them")(
+      "decode-sounds",
+      "Store nwa files as decoded PCM wav files. Much larger, but rlvm skips "
+      "decoding them");
+
+  po::options_description hidden("Hidden");
+  hidden.add_options()(
+      "game-root", po::value<string>(), "Location of game root");
+
+  po::positional_options_description p;
+  p.add("game-root", 1);
+
+  po::options_description commandLineOpts;
+  commandLineOpts.add(opts).add(hidden);
+
+  po::variables_map vm;
+  try {
+    po::store(po::basic_command_line_parser<char>(argc, argv)
+                  .options(commandLineOpts)
+                  .positional(p)
+                  .run(),
+              vm);
+    po::notify(vm);
+  } catch (po::error& e) {
+    cerr << "ERROR: " << e.what() << endl;
+    printUsage(argv[0], opts);
+    return -1;
+  }
+
+  if (vm.count("help") || !vm.count("game-root")) {
+    printUsage(argv[0], opts);
+    return vm.count("help") ? 0 : -1;
+  }
+
+  fs::path gamerootPath = vm["game-root"].as<string>();
+  if (!fs::is_directory(gamerootPath)) {
+    cerr << "ERROR: Path '" << gamerootPath << "' is not a directory." << endl;
+    return -1;
+  }
+
+  try {
+    fs::path gameexePath = CorrectPathCase(gamerootPath / "Gameexe.ini");
+    if (gameexePath.empty() || !fs::exists(gameexePath)) {
+      cerr << "ERROR: Could not find Gameexe.ini." << endl;
+      return -1;
+    }
+    Gameexe gameexe(gameexePath);
+
+    std::vector<std::string> valid_directories;
+    for (auto it = gameexe.filtering_begin("FOLDNAME");
+         it != gameexe.filtering_end(); ++it) {
+      std::string dir = it->ToString();
+      if (!dir.empty()) {
+        boost::to_lower(dir);
+        valid_directories.push_back(dir);
+      }
+    }
+
+    fs::path output = vm.count("output")
+                          ? fs::path(vm["output"].as<string>())
+                          : gamerootPath / AssetPack::kFileName;
+    // Build next to the destination and move it into place at the end, so
+    // that a running rlvm never sees half a pack.
+    fs::path temp_output = output;
+    temp_output += ".tmp";
+
+    PackStats stats;
+    AssetPackWriter writer(temp_output);
+    std::vector<fs::path> directories;
+    std::copy(fs::directory_iterator(gamerootPath), fs::directory_iterator(),
+              std::back_inserter(directories));
+    std::sort(directories.begin(), directories.end());
+    for (const fs::path& directory : directories) {
+      std::string name = directory.filename().string();
+      boost::to_lower(name);
+      if (fs::is_directory(directory) &&
+          find(valid_directories.begin(), valid_directories.end(), name) !=
+              valid_directories.end()) {
+        AddDirectory(writer, directory, name, vm, &stats);
+      }
+    }
+    writer.Finish();
+    fs::rename(temp_output, output);
+
+    printf("rlvm-pack: %s\n", output.string().c_str());
+    printf("  Files:           %d\n", stats.files);
+    printf("  Images decoded:  %d\n", stats.images_decoded);
+    printf("  Sounds decoded:  %d\n", stats.sounds_decoded);
+    printf("  Input:           %.1f MB\n", stats.input_bytes / 1048576.0);
+    printf("  Output:          %.1f MB\n", stats.output_bytes / 1048576.0);
+  }
+  catch (rlvm::Exception& e) {
+    cerr << "Fatal RLVM error: " << e.what() << endl;
+    return 1;
+  }
+  catch (std::exception& e) {
+    cerr << "Uncaught exception: " << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
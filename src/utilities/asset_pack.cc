@@ -0,0 +1,338 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#include "utilities/asset_pack.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "libreallive/filemap.h"
+#include "utilities/exception.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const char kMagic[8] = {'R', 'L', 'V', 'M', 'P', 'A', 'K', '1'};
+const uint32_t kVersion = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t entry_count;
+  uint64_t names_offset;
+  uint64_t index_offset;
+};
+
+// Every mounted pack. There's normally at most one.
+std::mutex g_mounted_lock;
+std::vector<std::shared_ptr<AssetPack>> g_mounted;
+
+}  // namespace
+
+struct AssetPack::IndexRecord {
+  uint64_t hash;
+  uint64_t offset;
+  uint64_t size;
+  uint32_t name_offset;
+  uint32_t name_size;
+  uint32_t encoding;
+  uint32_t reserved;
+};
+
+// -----------------------------------------------------------------------
+// AssetPack
+// -----------------------------------------------------------------------
+const char AssetPack::kFileName[] = "rlvm.pack";
+
+AssetPack::AssetPack(const fs::path& file)
+    : file_(file), entry_count_(0), index_(NULL), names_(NULL) {
+  try {
+    mapping_.reset(new libreallive::Mapping(file.string(), libreallive::Read));
+  } catch (std::exception& e) {
+    std::ostringstream oss;
+    oss << "Could not map asset pack " << file << ": " << e.what();
+    throw rlvm::Exception(oss.str());
+  }
+
+  const char* data = mapping_->get();
+  size_t size = mapping_->size();
+  Header header;
+  if (size < sizeof(header)) {
+    std::ostringstream oss;
+    oss << file << " is too small to be an asset pack.";
+    throw rlvm::Exception(oss.str());
+  }
+  memcpy(&header, data, sizeof(header));
+
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion) {
+    std::ostringstream oss;
+    oss << file << " is not a version " << kVersion << " asset pack.";
+    throw rlvm::Exception(oss.str());
+  }
+
+  if (header.names_offset > size || header.index_offset > size ||
+      header.index_offset % alignof(IndexRecord) != 0 ||
+      (size - header.index_offset) / sizeof(IndexRecord) <
+          header.entry_count) {
+    std::ostringstream oss;
+    oss << "Asset pack " << file << " is truncated.";
+    throw rlvm::Exception(oss.str());
+  }
+
+  // Check every record up front so that lookups never have to.
+  const IndexRecord* index =
+      reinterpret_cast<const IndexRecord*>(data + header.index_offset);
+  uint64_t names_size = size - header.names_offset;
+  for (size_t i = 0; i < header.entry_count; ++i) {
+    const IndexRecord& record = index[i];
+    if (record.offset > size || record.size > size - record.offset ||
+        uint64_t(record.name_offset) + record.name_size > names_size) {
+      std::ostringstream oss;
+      oss << "Asset pack " << file << " is corrupt: entry " << i
+          << " is out of bounds.";
+      throw rlvm::Exception(oss.str());
+    }
+  }
+
+  entry_count_ = header.entry_count;
+  index_ = index;
+  names_ = data + header.names_offset;
+}
+
+AssetPack::~AssetPack() {}
+
+bool AssetPack::Find(const std::string& name, Entry* entry) const {
+  std::string lower_name = name;
+  boost::to_lower(lower_name);
+  uint64_t hash = HashName(lower_name);
+
+  const IndexRecord* end = index_ + entry_count_;
+  const IndexRecord* it = std::lower_bound(
+      index_, end, hash, [](const IndexRecord& record, uint64_t hash) {
+        return record.hash < hash;
+      });
+  for (; it != end && it->hash == hash; ++it) {
+    if (lower_name.size() == it->name_size &&
+        memcmp(names_ + it->name_offset, lower_name.data(), it->name_size) ==
+            0) {
+      entry->data = mapping_->get() + it->offset;
+      entry->size = it->size;
+      entry->encoding = static_cast<Encoding>(it->encoding);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::vector<std::string> AssetPack::GetNames() const {
+  std::vector<std::string> names;
+  names.reserve(entry_count_);
+  for (size_t i = 0; i < entry_count_; ++i)
+    names.emplace_back(names_ + index_[i].name_offset, index_[i].name_size);
+  return names;
+}
+
+// static
+std::vector<char> AssetPack::SerializeImage(
+    ImageHeader header,
+    const std::vector<ImageRegion>& regions,
+    const char* pixels) {
+  header.region_count = regions.size();
+  size_t pixel_bytes = size_t(header.width) * header.height * 4;
+  std::vector<char> out(sizeof(header) + regions.size() * sizeof(ImageRegion) +
+                        pixel_bytes);
+  char* cur = out.data();
+  memcpy(cur, &header, sizeof(header));
+  cur += sizeof(header);
+  if (!regions.empty()) {
+    memcpy(cur, regions.data(), regions.size() * sizeof(ImageRegion));
+    cur += regions.size() * sizeof(ImageRegion);
+  }
+  memcpy(cur, pixels, pixel_bytes);
+  return out;
+}
+
+// static
+const char* AssetPack::ParseImage(const char* data,
+                                  size_t size,
+                                  ImageHeader* header,
+                                  std::vector<ImageRegion>* regions) {
+  if (size < sizeof(*header))
+    return NULL;
+  memcpy(header, data, sizeof(*header));
+
+  size_t remaining = size - sizeof(*header);
+  if (remaining / sizeof(ImageRegion) < header->region_count)
+    return NULL;
+  remaining -= header->region_count * sizeof(ImageRegion);
+  if (remaining < size_t(header->width) * header->height * 4)
+    return NULL;
+
+  regions->resize(header->region_count);
+  if (header->region_count) {
+    memcpy(regions->data(), data + sizeof(*header),
+           header->region_count * sizeof(ImageRegion));
+  }
+  return data + sizeof(*header) + header->region_count * sizeof(ImageRegion);
+}
+
+// static
+uint64_t AssetPack::HashName(const std::string& lower_name) {
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char c : lower_name) {
+    hash ^= c;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+// static
+void AssetPack::Mount(const std::shared_ptr<AssetPack>& pack) {
+  std::lock_guard<std::mutex> lock(g_mounted_lock);
+  g_mounted.push_back(pack);
+}
+
+// static
+void AssetPack::Unmount(const std::shared_ptr<AssetPack>& pack) {
+  std::lock_guard<std::mutex> lock(g_mounted_lock);
+  g_mounted.erase(std::remove(g_mounted.begin(), g_mounted.end(), pack),
+                  g_mounted.end());
+}
+
+// static
+std::shared_ptr<AssetPack> AssetPack::FindMounted(const fs::path& path,
+                                                  Entry* entry) {
+  std::lock_guard<std::mutex> lock(g_mounted_lock);
+  for (auto const& pack : g_mounted) {
+    const std::string& pack_path = pack->file().string();
+    const std::string& file_path = path.string();
+    if (file_path.size() > pack_path.size() + 1 &&
+        file_path.compare(0, pack_path.size(), pack_path) == 0 &&
+        file_path[pack_path.size()] == '/' &&
+        pack->Find(file_path.substr(pack_path.size() + 1), entry)) {
+      return pack;
+    }
+  }
+
+  return std::shared_ptr<AssetPack>();
+}
+
+// -----------------------------------------------------------------------
+// AssetPackWriter
+// -----------------------------------------------------------------------
+AssetPackWriter::AssetPackWriter(const fs::path& file)
+    : file_(file),
+      out_(file.string().c_str(), std::ios::binary | std::ios::trunc),
+      offset_(sizeof(Header)) {
+  if (!out_) {
+    std::ostringstream oss;
+    oss << "Could not open " << file << " for writing.";
+    throw rlvm::Exception(oss.str());
+  }
+
+  // Filled in by Finish().
+  Header header = Header();
+  out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+AssetPackWriter::~AssetPackWriter() {}
+
+void AssetPackWriter::AddEntry(const std::string& name,
+                               AssetPack::Encoding encoding,
+                               const char* data,
+                               size_t size) {
+  PadToAlignment();
+
+  std::string lower_name = name;
+  boost::to_lower(lower_name);
+  entries_.push_back(PendingEntry{lower_name, encoding, offset_, size});
+
+  out_.write(data, size);
+  offset_ += size;
+}
+
+void AssetPackWriter::Finish() {
+  Header header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.entry_count = entries_.size();
+
+  std::vector<AssetPack::IndexRecord> index;
+  index.reserve(entries_.size());
+  header.names_offset = offset_;
+  for (auto const& entry : entries_) {
+    AssetPack::IndexRecord record = AssetPack::IndexRecord();
+    record.hash = AssetPack::HashName(entry.name);
+    record.offset = entry.offset;
+    record.size = entry.size;
+    record.name_offset = offset_ - header.names_offset;
+    record.name_size = entry.name.size();
+    record.encoding = entry.encoding;
+    index.push_back(record);
+
+    out_.write(entry.name.data(), entry.name.size());
+    offset_ += entry.name.size();
+  }
+  std::stable_sort(index.begin(), index.end(),
+                   [](const AssetPack::IndexRecord& lhs,
+                      const AssetPack::IndexRecord& rhs) {
+                     return lhs.hash < rhs.hash;
+                   });
+
+  PadToAlignment();
+
+  header.index_offset = offset_;
+  out_.write(reinterpret_cast<const char*>(index.data()),
+             index.size() * sizeof(AssetPack::IndexRecord));
+  out_.seekp(0);
+  out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out_.close();
+
+  if (!out_) {
+    std::ostringstream oss;
+    oss << "Could not write asset pack " << file_;
+    throw rlvm::Exception(oss.str());
+  }
+}
+
+void AssetPackWriter::PadToAlignment() {
+  static const char kPadding[AssetPack::kAlignment] = {0};
+  size_t padding = (AssetPack::kAlignment - offset_ % AssetPack::kAlignment) %
+                   AssetPack::kAlignment;
+  out_.write(kPadding, padding);
+  offset_ += padding;
+}
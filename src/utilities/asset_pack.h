@@ -0,0 +1,190 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_UTILITIES_ASSET_PACK_H_
+#define SRC_UTILITIES_ASSET_PACK_H_
+
+#include <boost/filesystem/path.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace libreallive {
+class Mapping;
+}  // namespace libreallive
+
+// A single, memory mappable file holding the loose assets of a game (the
+// contents of the #FOLDNAME directories), built with the rlvm-pack tool. When
+// a game directory contains an "rlvm.pack", System mounts it and FindFile()
+// hands out virtual paths of the form "<game>/rlvm.pack/<dir>/<file>", which
+// LoadFileData(), OpenFile() and the image and sound loaders resolve against
+// the mapping instead of the filesystem.
+//
+// Layout, with integers in host byte order:
+//
+//   Header      "RLVMPAK1", version, entry count, index and name offsets
+//   Data        Each entry's bytes, starting on a kAlignment boundary
+//   Names       The lowercased relative paths of every entry, back to back
+//   Index       One IndexRecord per entry, sorted by the hash of its name
+class AssetPack {
+ public:
+  // How an entry's bytes are stored.
+  enum Encoding {
+    // A copy of the original file.
+    ENCODING_RAW = 0,
+
+    // A g00/pdt image decoded ahead of time; see ImageHeader.
+    ENCODING_RGBA = 1,
+
+    // An nwa file decoded ahead of time into a PCM wav file.
+    ENCODING_WAV = 2
+  };
+
+  // An entry's bytes inside the mapping.
+  struct Entry {
+    const char* data;
+    size_t size;
+    Encoding encoding;
+  };
+
+  // An ENCODING_RGBA entry starts with this header, followed by
+  // |region_count| ImageRegions and then |width| * |height| 32-bit pixels, in
+  // the same format that GRPCONV::Read() produces.
+  struct ImageHeader {
+    uint32_t width;
+    uint32_t height;
+    // Whether the alpha channel is used; the all opaque check has already
+    // been done.
+    uint32_t is_mask;
+    uint32_t region_count;
+  };
+
+  // Mirrors GRPCONV::REGION; |x2| and |y2| are inclusive.
+  struct ImageRegion {
+    int32_t x1, y1, x2, y2;
+    int32_t origin_x, origin_y;
+  };
+
+  static const char kFileName[];
+  static const size_t kAlignment = 16;
+
+  // Maps |file| into memory. Throws rlvm::Exception if it isn't a pack.
+  explicit AssetPack(const boost::filesystem::path& file);
+  ~AssetPack();
+
+  const boost::filesystem::path& file() const { return file_; }
+  size_t size() const { return entry_count_; }
+
+  // Looks up |name|, a path relative to the game root such as "g00/bg01.g00".
+  // Case insensitive.
+  bool Find(const std::string& name, Entry* entry) const;
+
+  // The lowercased relative paths of every entry.
+  std::vector<std::string> GetNames() const;
+
+  // Lays out an ENCODING_RGBA entry. |pixels| holds |header.width| *
+  // |header.height| 32-bit pixels; |header.region_count| is filled in from
+  // |regions|.
+  static std::vector<char> SerializeImage(
+      ImageHeader header,
+      const std::vector<ImageRegion>& regions,
+      const char* pixels);
+
+  // Reverses SerializeImage(). Returns a pointer to the pixels inside |data|,
+  // or NULL if |data| is truncated.
+  static const char* ParseImage(const char* data,
+                                size_t size,
+                                ImageHeader* header,
+                                std::vector<ImageRegion>* regions);
+
+  // The hash that the index is sorted by (64-bit FNV-1a of the lowercased
+  // name).
+  static uint64_t HashName(const std::string& lower_name);
+
+  // Makes |pack| visible to FindMounted(). Packs stay mapped for as long as
+  // they are mounted.
+  static void Mount(const std::shared_ptr<AssetPack>& pack);
+  static void Unmount(const std::shared_ptr<AssetPack>& pack);
+
+  // If |path| points inside a mounted pack, fills in |entry| and returns that
+  // pack. Returns NULL for ordinary files. Safe to call from any thread.
+  static std::shared_ptr<AssetPack> FindMounted(
+      const boost::filesystem::path& path,
+      Entry* entry);
+
+ private:
+  friend class AssetPackWriter;
+  struct IndexRecord;
+
+  boost::filesystem::path file_;
+  std::unique_ptr<libreallive::Mapping> mapping_;
+
+  size_t entry_count_;
+  const IndexRecord* index_;
+  const char* names_;
+};
+
+// Builds an AssetPack file. Entry data is written out as it is added; only
+// the index is kept in memory until Finish().
+class AssetPackWriter {
+ public:
+  explicit AssetPackWriter(const boost::filesystem::path& file);
+  ~AssetPackWriter();
+
+  // Adds |name| (relative to the game root, using '/' separators).
+  void AddEntry(const std::string& name,
+                AssetPack::Encoding encoding,
+                const char* data,
+                size_t size);
+
+  // Writes the name table, index and header. Throws rlvm::Exception on I/O
+  // errors.
+  void Finish();
+
+ private:
+  struct PendingEntry {
+    std::string name;
+    AssetPack::Encoding encoding;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  // Writes zeros up to the next AssetPack::kAlignment boundary.
+  void PadToAlignment();
+
+  boost::filesystem::path file_;
+  std::ofstream out_;
+  uint64_t offset_;
+  std::vector<PendingEntry> entries_;
+};
+
+#endif  // SRC_UTILITIES_ASSET_PACK_H_
@@ -33,6 +33,8 @@
 
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iterator>
 #include <sstream>
@@ -42,6 +44,7 @@
 
 #include "systems/base/system.h"
 #include "systems/base/system_error.h"
+#include "utilities/asset_pack.h"
 #include "utilities/exception.h"
 
 using boost::to_upper;
@@ -116,6 +119,14 @@ fs::path CorrectPathCase(fs::path Path) {
 bool LoadFileData(const boost::filesystem::path& path,
                   std::unique_ptr<char[]>& fileData,
                   int& fileSize) {
+  AssetPack::Entry entry;
+  if (AssetPack::FindMounted(path, &entry)) {
+    fileSize = entry.size;
+    fileData.reset(new char[fileSize]);
+    memcpy(fileData.get(), entry.data, fileSize);
+    return false;
+  }
+
   fs::ifstream ifs(path, ifstream::in | ifstream::binary);
   if (!ifs) {
     ostringstream oss;
@@ -132,3 +143,11 @@ bool LoadFileData(const boost::filesystem::path& path,
 
   return !ifs.good();
 }
+
+FILE* OpenFile(const boost::filesystem::path& path) {
+  AssetPack::Entry entry;
+  if (AssetPack::FindMounted(path, &entry))
+    return fmemopen(const_cast<char*>(entry.data), entry.size, "rb");
+
+  return fopen(path.native().c_str(), "rb");
+}
@@ -30,6 +30,7 @@
 
 #include <boost/filesystem.hpp>
 
+#include <cstdio>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -50,4 +51,9 @@ bool LoadFileData(const boost::filesystem::path& path,
                   std::unique_ptr<char[]>& fileData,
                   int& fileSize);
 
+// fopen()s |path| for binary reading. Files inside a mounted AssetPack are
+// opened as read only memory streams over the mapping, so callers that go
+// through here don't need to know about packs. Returns NULL on failure.
+FILE* OpenFile(const boost::filesystem::path& path);
+
 #endif  // SRC_UTILITIES_FILE_H_
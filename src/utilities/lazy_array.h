@@ -31,6 +31,7 @@
 #include <memory>
 #include <ostream>
 #include <stdexcept>
+#include <type_traits>
 
 // Forward declaration
 template <typename T>
@@ -98,6 +99,10 @@ class LazyArray {
   AllocatedLazyArrayIterator<T> end() {
     return AllocatedLazyArrayIterator<T>(size_, this);
   }
+  AllocatedLazyArrayIterator<const T> begin() const;
+  AllocatedLazyArrayIterator<const T> end() const {
+    return AllocatedLazyArrayIterator<const T>(size_, this);
+  }
 
  private:
   int size_;
@@ -108,7 +113,7 @@ class LazyArray {
   template <class>
   friend class AllocatedLazyArrayIterator;
 
-  T* rawDeref(int pos);
+  T* rawDeref(int pos) const;
 
   friend class boost::serialization::access;
 
@@ -189,10 +194,16 @@ class AllocatedLazyArrayIterator
     : public boost::iterator_facade<AllocatedLazyArrayIterator<Value>,
                                     Value,
                                     boost::forward_traversal_tag> {
+  // A const LazyArray for AllocatedLazyArrayIterator<const T>.
+  typedef typename std::conditional<
+      std::is_const<Value>::value,
+      const LazyArray<typename std::remove_const<Value>::type>,
+      LazyArray<Value>>::type Array;
+
  public:
   AllocatedLazyArrayIterator() : current_position_(0), array_(0) {}
 
-  explicit AllocatedLazyArrayIterator(int pos, LazyArray<Value>* array)
+  explicit AllocatedLazyArrayIterator(int pos, Array* array)
       : current_position_(pos), array_(array) {}
 
   template <class OtherValue>
@@ -225,7 +236,7 @@ class AllocatedLazyArrayIterator
   Value& dereference() const { return *(array_->rawDeref(current_position_)); }
 
   int current_position_;
-  LazyArray<Value>* array_;
+  Array* array_;
 };
 
 // -----------------------------------------------------------------------
@@ -246,7 +257,7 @@ LazyArray<T>::~LazyArray() {
 }
 
 template <typename T>
-T* LazyArray<T>::rawDeref(int pos) {
+T* LazyArray<T>::rawDeref(int pos) const {
   return array_[pos];
 }
 
@@ -320,4 +331,13 @@ AllocatedLazyArrayIterator<T> LazyArray<T>::begin() {
   return AllocatedLazyArrayIterator<T>(firstEntry, this);
 }
 
+template <typename T>
+AllocatedLazyArrayIterator<const T> LazyArray<T>::begin() const {
+  int firstEntry = 0;
+  while (firstEntry < size_ && array_[firstEntry] == NULL)
+    firstEntry++;
+
+  return AllocatedLazyArrayIterator<const T>(firstEntry, this);
+}
+
 #endif  // SRC_UTILITIES_LAZY_ARRAY_H_
@@ -0,0 +1,125 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_UTILITIES_RING_BUFFER_H_
+#define SRC_UTILITIES_RING_BUFFER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Lock free ring buffer for exactly one producer thread and one consumer
+// thread. Used to hand decoded audio from a decoder thread to the SDL audio
+// callback, where we can't afford to block on a mutex.
+//
+// The positions only ever grow; they are masked into the buffer on use, so
+// the capacity is rounded up to a power of two.
+template <typename T>
+class RingBuffer {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "RingBuffer copies its contents with memcpy");
+
+ public:
+  explicit RingBuffer(size_t min_capacity)
+      : capacity_(RoundUpToPowerOfTwo(min_capacity)),
+        mask_(capacity_ - 1),
+        buffer_(new T[capacity_]),
+        read_pos_(0),
+        write_pos_(0) {}
+
+  size_t capacity() const { return capacity_; }
+
+  // Number of elements that can be read. Exact when called by the consumer,
+  // a lower bound otherwise.
+  size_t ReadAvailable() const {
+    return write_pos_.load(std::memory_order_acquire) -
+           read_pos_.load(std::memory_order_relaxed);
+  }
+
+  // Number of elements that can be written. Exact when called by the
+  // producer, a lower bound otherwise.
+  size_t WriteAvailable() const {
+    return capacity_ - (write_pos_.load(std::memory_order_relaxed) -
+                        read_pos_.load(std::memory_order_acquire));
+  }
+
+  // Producer side: copies up to |count| elements in and returns how many
+  // fit.
+  size_t Write(const T* data, size_t count) {
+    size_t write = write_pos_.load(std::memory_order_relaxed);
+    count = std::min(count, WriteAvailable());
+    CopyIn(write & mask_, data, count);
+    write_pos_.store(write + count, std::memory_order_release);
+    return count;
+  }
+
+  // Consumer side: copies up to |count| elements out and returns how many
+  // were available.
+  size_t Read(T* data, size_t count) {
+    size_t read = read_pos_.load(std::memory_order_relaxed);
+    count = std::min(count, ReadAvailable());
+    CopyOut(read & mask_, data, count);
+    read_pos_.store(read + count, std::memory_order_release);
+    return count;
+  }
+
+ private:
+  static size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t capacity = 1;
+    while (capacity < value)
+      capacity <<= 1;
+    return capacity;
+  }
+
+  void CopyIn(size_t offset, const T* data, size_t count) {
+    size_t first = std::min(count, capacity_ - offset);
+    memcpy(buffer_.get() + offset, data, first * sizeof(T));
+    memcpy(buffer_.get(), data + first, (count - first) * sizeof(T));
+  }
+
+  void CopyOut(size_t offset, T* data, size_t count) const {
+    size_t first = std::min(count, capacity_ - offset);
+    memcpy(data, buffer_.get() + offset, first * sizeof(T));
+    memcpy(data + first, buffer_.get(), (count - first) * sizeof(T));
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<T[]> buffer_;
+
+  // Written only by the consumer.
+  std::atomic<size_t> read_pos_;
+
+  // Written only by the producer.
+  std::atomic<size_t> write_pos_;
+};
+
+#endif  // SRC_UTILITIES_RING_BUFFER_H_
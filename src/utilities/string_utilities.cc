@@ -27,10 +27,12 @@
 
 #include "utilities/string_utilities.h"
 
+#include <bitset>
 #include <string>
 
 #include "encodings/codepage.h"
 #include "utilities/exception.h"
+#include "utilities/text_layout.h"
 #include "utf8cpp/utf8.h"
 
 using std::string;
@@ -66,8 +68,7 @@ string cp932toUTF8(const string& line, int transformation) {
   if (line.empty())
     return line;
 
-  std::wstring ws = cp932toUnicode(line, transformation);
-  return UnicodeToUTF8(ws);
+  return Cp::instance(transformation).ConvertToUTF8(line);
 }
 
 bool IsOpeningQuoteMark(int codepoint) {
@@ -97,11 +98,16 @@ bool IsKinsoku(int codepoint) {
       0xff68, 0xff69, 0xff6a, 0xff6b, 0xff6c, 0xff6d, 0xff6e, 0xff6f, 0xff70,
       0xff9e, 0xff9f, 0x0};
 
-  for (int i = 0; matchingCodepoints[i] != 0x0; ++i)
-    if (matchingCodepoints[i] == codepoint)
-      return true;
+  // Every kinsoku character is in the BMP, so a bit per codepoint there makes
+  // this a single lookup; it's asked about every character we lay out.
+  static const std::bitset<0x10000> table = [] {
+    std::bitset<0x10000> bits;
+    for (int i = 0; matchingCodepoints[i] != 0x0; ++i)
+      bits.set(matchingCodepoints[i]);
+    return bits;
+  }();
 
-  return false;
+  return codepoint >= 0 && codepoint < 0x10000 && table.test(codepoint);
 }
 
 int Codepoint(const string& c) {
@@ -167,20 +173,19 @@ void PrintTextToFunction(
   // Iterate over each incoming character to display (we do this
   // instead of rendering the entire string so that we can perform
   // indentation, et cetera.)
-  string::const_iterator cur = charsToPrint.begin();
-  string::const_iterator tmp = cur;
-  string::const_iterator end = charsToPrint.end();
-  utf8::next(tmp, end);
-  string curChar(cur, tmp);
-  for (cur = tmp; tmp != end; cur = tmp) {
-    // TODO(erg): Do we have to check the return value here?
-    fun(curChar, string(cur, end));
+  TextLayout layout(charsToPrint);
+  if (layout.empty()) {
+    fun("", nextCharForFinal);
+    return;
+  }
 
-    utf8::next(tmp, end);
-    curChar = string(cur, tmp);
+  size_t last = layout.size() - 1;
+  for (size_t i = 0; i < last; ++i) {
+    // TODO(erg): Do we have to check the return value here?
+    fun(layout.Character(i), layout.Lookahead(i));
   }
 
-  fun(curChar, nextCharForFinal);
+  fun(layout.Character(last), nextCharForFinal);
 }
 
 string RemoveQuotes(const string& quotedString) {
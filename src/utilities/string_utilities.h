@@ -59,7 +59,9 @@ std::string TransformationName(int transformation);
 // Converts a UTF-16 string to a UTF-8 one.
 std::string UnicodeToUTF8(const std::wstring& widestring);
 
-// For convenience. Combines the two above functions.
+// Converts a string in the game's native encoding straight to UTF-8. Gives
+// the same result as combining the two functions above, without the
+// intermediate UTF-16 string.
 std::string cp932toUTF8(const std::string& line, int transformation);
 
 // Returns true if codepoint is either of the Japanese quote marks or '('.
@@ -97,7 +99,8 @@ bool ReadFullwidthLatinLetter(const char*& str, std::string& output);
 // an uint16_t.
 void AddShiftJISChar(uint16_t c, std::string& output);
 
-// Feeds each two consecutive pair of characters to |fun|.
+// Feeds each character of |charsToPrint| to |fun|, along with the characters
+// after it that matter for line breaking (see TextLayout::Lookahead()).
 void PrintTextToFunction(
     std::function<bool(const std::string& c, const std::string& nextChar)> fun,
     const std::string& charsToPrint,
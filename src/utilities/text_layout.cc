@@ -0,0 +1,64 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#include "utilities/text_layout.h"
+
+#include <string>
+
+#include "utilities/string_utilities.h"
+#include "utf8cpp/utf8.h"
+
+TextLayout::TextLayout(const std::string& utf8) : utf8_(utf8) {
+  std::string::const_iterator begin = utf8_.begin();
+  std::string::const_iterator cur = begin;
+  std::string::const_iterator end = utf8_.end();
+  while (cur != end) {
+    offsets_.push_back(cur - begin);
+    codepoints_.push_back(utf8::next(cur, end));
+  }
+  offsets_.push_back(utf8_.size());
+
+  // Walk backwards so each run is found in one pass.
+  lookahead_end_.resize(codepoints_.size());
+  for (size_t i = codepoints_.size(); i-- > 0;) {
+    size_t next = i + 1;
+    if (next < codepoints_.size() &&
+        (IsKinsoku(codepoints_[next]) ||
+         IsWrappingRomanCharacter(codepoints_[next]))) {
+      lookahead_end_[i] = lookahead_end_[next];
+    } else {
+      lookahead_end_[i] = next;
+    }
+  }
+}
+
+TextLayout::~TextLayout() {}
+
+std::string TextLayout::Slice(size_t begin, size_t end) const {
+  return utf8_.substr(offsets_[begin], offsets_[end] - offsets_[begin]);
+}
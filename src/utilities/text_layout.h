@@ -0,0 +1,79 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+
+#ifndef SRC_UTILITIES_TEXT_LAYOUT_H_
+#define SRC_UTILITIES_TEXT_LAYOUT_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// A UTF-8 string decoded once into its characters, along with the line
+// breaking lookahead of each one.
+//
+// TextWindow::MustLineBreak() only looks at the run of kinsoku and wrapping
+// roman characters that directly follows the character being placed. Handing
+// it that run instead of the entire rest of the string keeps laying out a
+// message linear in its length instead of quadratic.
+class TextLayout {
+ public:
+  explicit TextLayout(const std::string& utf8);
+  ~TextLayout();
+
+  // The number of characters in the string.
+  size_t size() const { return codepoints_.size(); }
+  bool empty() const { return codepoints_.empty(); }
+
+  int codepoint(size_t i) const { return codepoints_[i]; }
+
+  // The UTF-8 encoding of characters [begin, end).
+  std::string Slice(size_t begin, size_t end) const;
+
+  // The UTF-8 encoding of character |i|.
+  std::string Character(size_t i) const { return Slice(i, i + 1); }
+
+  // The characters after |i| that can affect whether a line break is needed
+  // before |i|.
+  std::string Lookahead(size_t i) const {
+    return Slice(i + 1, lookahead_end_[i]);
+  }
+
+ private:
+  std::string utf8_;
+
+  std::vector<int> codepoints_;
+
+  // Byte offset of each character in |utf8_|, plus a final entry for the end
+  // of the string.
+  std::vector<size_t> offsets_;
+
+  // For each character, the index one past the end of its lookahead run.
+  std::vector<size_t> lookahead_end_;
+};
+
+#endif  // SRC_UTILITIES_TEXT_LAYOUT_H_
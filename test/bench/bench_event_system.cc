@@ -0,0 +1,114 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#include "bench/bench_event_system.h"
+
+#include <functional>
+
+using std::placeholders::_1;
+
+BenchEventSystem::BenchEventSystem(Gameexe& gexe)
+    : TestEventSystem(gexe),
+      button1_state_(0),
+      button2_state_(0),
+      shift_pressed_(false),
+      ctrl_pressed_(false),
+      last_mouse_move_time_(0) {}
+
+BenchEventSystem::~BenchEventSystem() {}
+
+void BenchEventSystem::InjectKeyDown(RLMachine& machine, KeyCode code) {
+  if (code == RLKEY_LSHIFT || code == RLKEY_RSHIFT)
+    shift_pressed_ = true;
+  else if (code == RLKEY_LCTRL || code == RLKEY_RCTRL)
+    ctrl_pressed_ = true;
+
+  DispatchEvent(machine,
+                std::bind(&EventListener::KeyStateChanged, _1, code, true));
+}
+
+void BenchEventSystem::InjectKeyUp(RLMachine& machine, KeyCode code) {
+  if (code == RLKEY_LSHIFT || code == RLKEY_RSHIFT)
+    shift_pressed_ = false;
+  else if (code == RLKEY_LCTRL || code == RLKEY_RCTRL)
+    ctrl_pressed_ = false;
+
+  DispatchEvent(machine,
+                std::bind(&EventListener::KeyStateChanged, _1, code, false));
+}
+
+bool BenchEventSystem::ShiftPressed() const {
+  return shift_pressed_ || TestEventSystem::ShiftPressed();
+}
+
+bool BenchEventSystem::CtrlPressed() const {
+  return ctrl_pressed_ || TestEventSystem::CtrlPressed();
+}
+
+Point BenchEventSystem::GetCursorPos() {
+  return mouse_pos_;
+}
+
+void BenchEventSystem::GetCursorPos(Point& position,
+                                    int& button1,
+                                    int& button2) {
+  position = mouse_pos_;
+  button1 = button1_state_;
+  button2 = button2_state_;
+}
+
+void BenchEventSystem::FlushMouseClicks() {
+  button1_state_ = 0;
+  button2_state_ = 0;
+}
+
+unsigned int BenchEventSystem::TimeOfLastMouseMove() {
+  return last_mouse_move_time_;
+}
+
+void BenchEventSystem::InjectMouseMovement(RLMachine& machine,
+                                           const Point& loc) {
+  mouse_pos_ = loc;
+  last_mouse_move_time_ = GetTicks();
+  BroadcastEvent(machine, std::bind(&EventListener::MouseMotion, _1, loc));
+}
+
+void BenchEventSystem::InjectMouseDown(RLMachine& machine) {
+  button1_state_ = 1;
+  button2_state_ = 0;
+  DispatchEvent(machine,
+                std::bind(&EventListener::MouseButtonStateChanged, _1,
+                          MOUSE_LEFT, true));
+}
+
+void BenchEventSystem::InjectMouseUp(RLMachine& machine) {
+  button1_state_ = 2;
+  button2_state_ = 0;
+  DispatchEvent(machine,
+                std::bind(&EventListener::MouseButtonStateChanged, _1,
+                          MOUSE_LEFT, false));
+}
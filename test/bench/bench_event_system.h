@@ -0,0 +1,72 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#ifndef TEST_BENCH_BENCH_EVENT_SYSTEM_H_
+#define TEST_BENCH_BENCH_EVENT_SYSTEM_H_
+
+#include "systems/base/event_listener.h"
+#include "systems/base/rect.h"
+#include "test_system/test_event_system.h"
+
+// A TestEventSystem which remembers injected input and dispatches it to the
+// event listeners, the way SDLEventSystem does with real input, so that
+// rlvm_bench can replay recorded sessions. The clock is still provided by the
+// mock handler.
+class BenchEventSystem : public TestEventSystem {
+ public:
+  explicit BenchEventSystem(Gameexe& gexe);
+  virtual ~BenchEventSystem();
+
+  // Keyboard injection. Shift and ctrl state set here are combined with the
+  // mock handler's answers.
+  void InjectKeyDown(RLMachine& machine, KeyCode code);
+  void InjectKeyUp(RLMachine& machine, KeyCode code);
+
+  // Overridden from TestEventSystem:
+  virtual bool ShiftPressed() const override;
+  virtual bool CtrlPressed() const override;
+  virtual Point GetCursorPos() override;
+  virtual void GetCursorPos(Point& position,
+                            int& button1,
+                            int& button2) override;
+  virtual void FlushMouseClicks() override;
+  virtual unsigned int TimeOfLastMouseMove() override;
+  virtual void InjectMouseMovement(RLMachine& machine,
+                                   const Point& loc) override;
+  virtual void InjectMouseDown(RLMachine& machine) override;
+  virtual void InjectMouseUp(RLMachine& machine) override;
+
+ private:
+  Point mouse_pos_;
+  int button1_state_;
+  int button2_state_;
+  bool shift_pressed_;
+  bool ctrl_pressed_;
+  unsigned int last_mouse_move_time_;
+};
+
+#endif  // TEST_BENCH_BENCH_EVENT_SYSTEM_H_
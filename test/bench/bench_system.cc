@@ -0,0 +1,179 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#include "bench/bench_system.h"
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "machine/rlmachine.h"
+#include "systems/base/image_info.h"
+#include "test_system/mock_surface.h"
+#include "utilities/exception.h"
+#include "xclannad/file.h"
+
+namespace {
+
+// Reads |path| and picks a converter for it with Jagarl's loader, the same
+// way SDLGraphicsSystem does. |data| must outlive the converter.
+std::unique_ptr<GRPCONV> OpenImageFile(const boost::filesystem::path& path,
+                                       std::unique_ptr<char[]>* data) {
+  FILE* file = fopen(path.string().c_str(), "rb");
+  if (!file) {
+    std::ostringstream oss;
+    oss << "Could not open file: " << path;
+    throw rlvm::Exception(oss.str());
+  }
+
+  fseek(file, 0, SEEK_END);
+  size_t size = ftell(file);
+  data->reset(new char[size + 1]);
+  fseek(file, 0, SEEK_SET);
+  fread(data->get(), size, 1, file);
+  fclose(file);
+
+  std::unique_ptr<GRPCONV> conv(
+      GRPCONV::AssignConverter(data->get(), size, "???"));
+  if (!conv)
+    throw rlvm::Exception("Failure in GRPCONV.");
+  return conv;
+}
+
+// Reads and decodes |path| and returns the image size.
+Size DecodeImageFile(const boost::filesystem::path& path) {
+  std::unique_ptr<char[]> data;
+  std::unique_ptr<GRPCONV> conv = OpenImageFile(path, &data);
+
+  std::unique_ptr<char[]> mem(
+      new char[conv->Width() * conv->Height() * 4 + 1024]);
+  conv->Read(mem.get());
+  return Size(conv->Width(), conv->Height());
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+// BenchStats
+// -----------------------------------------------------------------------
+BenchStats::BenchStats()
+    : frames(0),
+      images_loaded(0),
+      images_missing(0),
+      image_load_us(0),
+      max_image_load_us(0) {}
+
+// -----------------------------------------------------------------------
+// BenchGraphicsSystem
+// -----------------------------------------------------------------------
+BenchGraphicsSystem::BenchGraphicsSystem(System& system,
+                                         Gameexe& gexe,
+                                         BenchStats& stats)
+    : TestGraphicsSystem(system, gexe), stats_(stats), decode_images_(true) {}
+
+BenchGraphicsSystem::~BenchGraphicsSystem() {}
+
+void BenchGraphicsSystem::ExecuteGraphicsSystem(RLMachine& machine) {
+  if (ShouldRefreshScreen()) {
+    Refresh(NULL);
+    OnScreenRefreshed();
+    stats_.frames++;
+  }
+
+  GraphicsSystem::ExecuteGraphicsSystem(machine);
+}
+
+std::shared_ptr<const Surface> BenchGraphicsSystem::LoadSurfaceFromFile(
+    const std::string& short_filename) {
+  if (!decode_images_)
+    return TestGraphicsSystem::LoadSurfaceFromFile(short_filename);
+
+  auto start = std::chrono::steady_clock::now();
+
+  std::string base_name = short_filename.substr(0, short_filename.find('?'));
+  boost::filesystem::path filename =
+      system().FindFile(base_name, IMAGE_FILETYPES);
+  if (filename.empty()) {
+    // Test fixtures reference images that don't ship with them.
+    stats_.images_missing++;
+    return TestGraphicsSystem::LoadSurfaceFromFile(short_filename);
+  }
+  Size size = DecodeImageFile(filename);
+
+  long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+                     std::chrono::steady_clock::now() - start).count();
+  stats_.images_loaded++;
+  stats_.image_load_us += us;
+  if (us > stats_.max_image_load_us) {
+    stats_.max_image_load_us = us;
+    stats_.slowest_image = short_filename;
+  }
+
+  return std::shared_ptr<const Surface>(
+      MockSurface::Create(short_filename, size));
+}
+
+std::shared_ptr<const ImageInfo> BenchGraphicsSystem::LoadImageInfoFromFile(
+    const std::string& short_filename) {
+  std::string base_name = short_filename.substr(0, short_filename.find('?'));
+  boost::filesystem::path filename =
+      decode_images_ ? system().FindFile(base_name, IMAGE_FILETYPES)
+                     : boost::filesystem::path();
+  if (filename.empty())
+    return TestGraphicsSystem::LoadImageInfoFromFile(short_filename);
+
+  std::unique_ptr<char[]> data;
+  std::unique_ptr<GRPCONV> conv = OpenImageFile(filename, &data);
+  std::vector<Surface::GrpRect> regions;
+  for (auto const& region : conv->region_table) {
+    Surface::GrpRect rect;
+    rect.rect = Rect(Point(region.x1, region.y1),
+                     Point(region.x2 + 1, region.y2 + 1));
+    rect.originX = region.origin_x;
+    rect.originY = region.origin_y;
+    regions.push_back(rect);
+  }
+  return std::make_shared<ImageInfo>(Size(conv->Width(), conv->Height()),
+                                     regions);
+}
+
+// -----------------------------------------------------------------------
+// BenchSystem
+// -----------------------------------------------------------------------
+BenchSystem::BenchSystem(const std::string& path_to_gameexe,
+                         BenchStats& stats)
+    : TestSystem(path_to_gameexe),
+      graphics_system_(*this, gameexe(), stats),
+      event_system_(gameexe()) {}
+
+BenchSystem::~BenchSystem() {}
+
+BenchGraphicsSystem& BenchSystem::graphics() { return graphics_system_; }
+BenchEventSystem& BenchSystem::event() { return event_system_; }
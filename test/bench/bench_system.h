@@ -0,0 +1,93 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#ifndef TEST_BENCH_BENCH_SYSTEM_H_
+#define TEST_BENCH_BENCH_SYSTEM_H_
+
+#include <string>
+
+#include "bench/bench_event_system.h"
+#include "test_system/test_graphics_system.h"
+#include "test_system/test_system.h"
+
+// Counters collected while running the benchmark.
+struct BenchStats {
+  BenchStats();
+
+  // Number of screen refreshes performed.
+  int frames;
+
+  // Number of images loaded, and the wall time (in microseconds) spent
+  // finding, reading and decoding them. Images which couldn't be found are
+  // replaced with placeholders and only counted.
+  int images_loaded;
+  int images_missing;
+  long long image_load_us;
+  long long max_image_load_us;
+  std::string slowest_image;
+};
+
+// A TestGraphicsSystem which actually composes frames and, optionally,
+// decodes the image files that the game asks for, so that the cost of those
+// show up in the benchmark.
+class BenchGraphicsSystem : public TestGraphicsSystem {
+ public:
+  BenchGraphicsSystem(System& system, Gameexe& gexe, BenchStats& stats);
+  virtual ~BenchGraphicsSystem();
+
+  void set_decode_images(bool in) { decode_images_ = in; }
+
+  // Overridden from GraphicsSystem:
+  virtual void ExecuteGraphicsSystem(RLMachine& machine) override;
+  virtual std::shared_ptr<const Surface> LoadSurfaceFromFile(
+      const std::string& short_filename) override;
+  virtual std::shared_ptr<const ImageInfo> LoadImageInfoFromFile(
+      const std::string& short_filename) override;
+
+ private:
+  BenchStats& stats_;
+  bool decode_images_;
+};
+
+// Headless System used by rlvm_bench: a TestSystem built on a real game's
+// Gameexe.ini, with a BenchGraphicsSystem and an event system that replays
+// recorded input.
+class BenchSystem : public TestSystem {
+ public:
+  BenchSystem(const std::string& path_to_gameexe, BenchStats& stats);
+  virtual ~BenchSystem();
+
+  // Overridden from TestSystem:
+  virtual BenchGraphicsSystem& graphics() override;
+  virtual BenchEventSystem& event() override;
+
+ private:
+  BenchGraphicsSystem graphics_system_;
+  BenchEventSystem event_system_;
+};
+
+#endif  // TEST_BENCH_BENCH_SYSTEM_H_
@@ -0,0 +1,158 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#include "bench/input_script.h"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "bench/bench_event_system.h"
+#include "utilities/exception.h"
+
+namespace {
+
+const std::map<std::string, KeyCode> kKeyNames = {
+    {"ctrl", RLKEY_LCTRL},    {"shift", RLKEY_LSHIFT}, {"return", RLKEY_RETURN},
+    {"space", RLKEY_SPACE},   {"escape", RLKEY_ESCAPE}, {"up", RLKEY_UP},
+    {"down", RLKEY_DOWN},     {"left", RLKEY_LEFT},     {"right", RLKEY_RIGHT}};
+
+void ThrowParseError(const std::string& filename, int line_no,
+                     const std::string& line) {
+  std::ostringstream oss;
+  oss << filename << ":" << line_no << ": Malformed input event \"" << line
+      << "\"";
+  throw rlvm::Exception(oss.str());
+}
+
+}  // namespace
+
+// -----------------------------------------------------------------------
+// InputScript
+// -----------------------------------------------------------------------
+InputScript::InputScript() : position_(0) {}
+
+InputScript::~InputScript() {}
+
+void InputScript::Load(const std::string& filename) {
+  std::ifstream file(filename.c_str());
+  if (!file) {
+    std::ostringstream oss;
+    oss << "Could not open input script " << filename;
+    throw rlvm::Exception(oss.str());
+  }
+
+  std::string line;
+  int line_no = 0;
+  unsigned int last_time = 0;
+  while (std::getline(file, line)) {
+    line_no++;
+    size_t comment = line.find('#');
+    if (comment != std::string::npos)
+      line.erase(comment);
+
+    std::istringstream iss(line);
+    Event event;
+    std::string command;
+    if (!(iss >> event.time))
+      continue;
+    if (!(iss >> command) || event.time < last_time)
+      ThrowParseError(filename, line_no, line);
+    last_time = event.time;
+    event.key = RLKEY_UNKNOWN;
+
+    int x = 0, y = 0;
+    if (command == "move") {
+      if (!(iss >> x >> y))
+        ThrowParseError(filename, line_no, line);
+      event.type = MOVE;
+      event.location = Point(x, y);
+      events_.push_back(event);
+    } else if (command == "down" || command == "up") {
+      event.type = command == "down" ? MOUSE_DOWN : MOUSE_UP;
+      events_.push_back(event);
+    } else if (command == "click") {
+      if (iss >> x >> y) {
+        event.type = MOVE;
+        event.location = Point(x, y);
+        events_.push_back(event);
+      }
+      event.type = MOUSE_DOWN;
+      events_.push_back(event);
+      event.type = MOUSE_UP;
+      events_.push_back(event);
+    } else if (command == "key") {
+      std::string direction, name;
+      if (!(iss >> direction >> name) ||
+          (direction != "down" && direction != "up"))
+        ThrowParseError(filename, line_no, line);
+      event.type = direction == "down" ? KEY_DOWN : KEY_UP;
+
+      auto it = kKeyNames.find(name);
+      if (it != kKeyNames.end()) {
+        event.key = it->second;
+      } else if (name.size() == 1) {
+        event.key = static_cast<KeyCode>(name[0]);
+      } else {
+        std::istringstream code(name);
+        int keycode;
+        if (!(code >> keycode))
+          ThrowParseError(filename, line_no, line);
+        event.key = static_cast<KeyCode>(keycode);
+      }
+      events_.push_back(event);
+    } else {
+      ThrowParseError(filename, line_no, line);
+    }
+  }
+}
+
+void InputScript::DispatchUntil(unsigned int now,
+                                RLMachine& machine,
+                                BenchEventSystem& event_system) {
+  while (position_ < events_.size() && events_[position_].time <= now) {
+    const Event& event = events_[position_++];
+    switch (event.type) {
+      case MOVE:
+        event_system.InjectMouseMovement(machine, event.location);
+        break;
+      case MOUSE_DOWN:
+        event_system.InjectMouseDown(machine);
+        break;
+      case MOUSE_UP:
+        event_system.InjectMouseUp(machine);
+        break;
+      case KEY_DOWN:
+        event_system.InjectKeyDown(machine, event.key);
+        break;
+      case KEY_UP:
+        event_system.InjectKeyUp(machine, event.key);
+        break;
+    }
+  }
+}
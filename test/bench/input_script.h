@@ -0,0 +1,101 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#ifndef TEST_BENCH_INPUT_SCRIPT_H_
+#define TEST_BENCH_INPUT_SCRIPT_H_
+
+#include <string>
+#include <vector>
+
+#include "systems/base/event_listener.h"
+#include "systems/base/rect.h"
+#include "test_system/test_event_system.h"
+
+class RLMachine;
+class BenchEventSystem;
+
+// A clock which only moves when told to. Installed as the mock handler of the
+// TestEventSystem so that every GetTicks() call in the interpreter sees the
+// same, reproducible, virtual time.
+class VirtualClock : public EventSystemMockHandler {
+ public:
+  VirtualClock() : now_(0) {}
+  virtual ~VirtualClock() {}
+
+  void Advance(unsigned int milliseconds) { now_ += milliseconds; }
+  unsigned int now() const { return now_; }
+
+  // Overridden from EventSystemMockHandler:
+  virtual unsigned int GetTicks() const override { return now_; }
+
+ private:
+  unsigned int now_;
+};
+
+// A recorded list of input events with virtual timestamps, replayed into a
+// BenchEventSystem. The on disk format is line based:
+//
+//   # comment
+//   <ms> move <x> <y>
+//   <ms> down
+//   <ms> up
+//   <ms> click [<x> <y>]
+//   <ms> key down|up <name or keycode>
+//
+// where key names are ctrl, shift, return, space, escape, up, down, left and
+// right. Events must be in nondecreasing time order.
+class InputScript {
+ public:
+  enum EventType { MOVE, MOUSE_DOWN, MOUSE_UP, KEY_DOWN, KEY_UP };
+
+  struct Event {
+    unsigned int time;
+    EventType type;
+    Point location;
+    KeyCode key;
+  };
+
+  InputScript();
+  ~InputScript();
+
+  // Parses |filename|. Throws rlvm::Exception on malformed input.
+  void Load(const std::string& filename);
+
+  // Sends every event whose timestamp is <= |now| to |event_system|.
+  void DispatchUntil(unsigned int now,
+                     RLMachine& machine,
+                     BenchEventSystem& event_system);
+
+  bool finished() const { return position_ == events_.size(); }
+  size_t size() const { return events_.size(); }
+
+ private:
+  std::vector<Event> events_;
+  size_t position_;
+};
+
+#endif  // TEST_BENCH_INPUT_SCRIPT_H_
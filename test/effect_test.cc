@@ -185,3 +185,20 @@ TEST_F(EffectTest, BlindTopToBottomEffect) {
   event_system_impl->setTicks(100);
   EXPECT_TRUE((*effect)(rlmachine)) << "We didn't quit?";
 }
+
+TEST_F(EffectTest, BlindsRenderAsOneBatch) {
+  std::shared_ptr<MockSurface> src(MockSurface::Create("src"));
+  std::shared_ptr<MockSurface> dst(MockSurface::Create("dst"));
+
+  BlindTopToBottomEffect effect(rlmachine, src, dst, Size(640, 480), 100, 50);
+
+  // The default Surface::RenderQuadsToScreen() falls back to one
+  // RenderToScreen() per blind: the last one plus the nine above it.
+  event_system_impl->setTicks(75);
+  EXPECT_CALL(*src, RenderToScreen(_, _, Matcher<int>(255))).Times(9);
+  EXPECT_CALL(*src,
+              RenderToScreen(Rect::GRP(0, 450, 640, 486),
+                             Rect::GRP(0, 450, 640, 486),
+                             Matcher<int>(255))).Times(1);
+  EXPECT_FALSE(effect(rlmachine)) << "Prematurely quit";
+}
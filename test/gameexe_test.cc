@@ -27,10 +27,15 @@
 
 #include "libreallive/gameexe.h"
 
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
 #include "gtest/gtest.h"
 
 #include "test_utils.h"
 
+#include <iomanip>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -136,3 +141,105 @@ TEST(GameexeUnit, DstrackRegression) {
   EXPECT_EQ("dcbgm000", dc.GetStringAt(3));
   EXPECT_EQ("dcbgm000", dc.GetStringAt(4));
 }
+
+// Keys built from precomputed pieces find the same entries as strings.
+TEST(GameexeUnit, PrecomputedKeys) {
+  Gameexe ini(locateTestCase("Gameexe_data/Gameexe.ini"));
+  static constexpr GameexeKey kImagine("IMAGINE");
+  static constexpr GameexeKey kTwo("TWO");
+  EXPECT_EQ(2, ini(kImagine, kTwo));
+  EXPECT_EQ(2, ini(kImagine)("TWO"));
+  EXPECT_EQ("IMAGINE.TWO", ini(kImagine, kTwo).key());
+  EXPECT_FALSE(ini(kImagine, "FOUR").Exists());
+  EXPECT_EQ("IMAGINE.FOUR", ini(kImagine, "FOUR").key());
+
+  // Integer pieces are zero padded to three digits.
+  static constexpr GameexeKey kWindow("WINDOW");
+  EXPECT_TRUE(ini(kWindow, 0, "ATTR_MOD").Exists());
+  EXPECT_EQ("WINDOW.000.ATTR_MOD", ini(kWindow, 0, "ATTR_MOD").key());
+}
+
+// Filtering is case insensitive and stops after the last matching key.
+TEST(GameexeUnit, FilteringIteratorsAreCaseInsensitive) {
+  Gameexe ini;
+  ini.parseLine("#SE.001 = \"one\"");
+  ini.parseLine("#se.002 = \"two\"");
+  ini.parseLine("#SEL.000 = 1");
+  ini.parseLine("#SE.003 = \"three\"");
+
+  std::vector<std::string> keys;
+  for (GameexeFilteringIterator it = ini.filtering_begin("SE.");
+       it != ini.filtering_end(); ++it) {
+    keys.push_back(it->key());
+  }
+  EXPECT_EQ((std::vector<std::string>{"SE.001", "se.002", "SE.003"}), keys);
+}
+
+// Assigning through an interpret object replaces the value in the index.
+TEST(GameexeUnit, AssignmentUpdatesIndex) {
+  Gameexe ini;
+  ini.parseLine("#NAME.A = 1");
+  ini.parseLine("#NAME.A = 2");
+  EXPECT_EQ(1, ini("NAME", "A"));
+
+  GameexeInterpretObject name = ini("NAME.A");
+  name = 5;
+  EXPECT_EQ(5, name.ToInt());
+  EXPECT_EQ(5, ini("NAME", "A"));
+  EXPECT_EQ(1u, ini.size());
+
+  GameexeInterpretObject missing = ini("NAME.B");
+  EXPECT_FALSE(missing.Exists());
+  missing = "Bee";
+  EXPECT_TRUE(missing.Exists());
+  EXPECT_EQ("Bee", ini("NAME", "B").ToString());
+  EXPECT_EQ("B", ini("NAME", "B").GetKeyParts().at(1));
+}
+
+// A key that isn't in the file doesn't find another key with the same hash.
+// A leading NUL doesn't change the hash, which makes colliding keys easy.
+TEST(GameexeUnit, HashCollisionWithMissingKeyIsNotFound) {
+  Gameexe ini;
+  ini.SetIntAt(std::string("\0NAME.007", 9), 7);
+  ini.SetIntAt(std::string("\0SOLO", 5), 1);
+
+  EXPECT_FALSE(ini("NAME", 7).Exists());
+  EXPECT_FALSE(ini("NAME")(7).Exists());
+  EXPECT_FALSE(ini("NAME.007").Exists());
+  EXPECT_FALSE(ini("SOLO").Exists());
+  EXPECT_FALSE(ini.Exists("SOLO"));
+  EXPECT_EQ(1, ini(std::string("\0SOLO", 5)).ToInt());
+
+  ini.SetIntAt("OTHER.001", 3);
+  EXPECT_EQ(3, ini("OTHER", 1).ToInt());
+  EXPECT_FALSE(ini("OTHER", 10).Exists());
+  EXPECT_FALSE(ini("OTHER.00", 1).Exists());
+}
+
+// Large files are parsed on several threads; the result has to match a line
+// by line parse, including which of several duplicate keys wins.
+TEST(GameexeUnit, ParallelParseMatchesSerialParse) {
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                 boost::filesystem::unique_path();
+  Gameexe serial;
+  {
+    boost::filesystem::ofstream out(path);
+    for (int i = 0; i < 20000; ++i) {
+      std::ostringstream line;
+      line << "#KEY." << std::setw(3) << std::setfill('0') << (i % 700)
+           << " = " << i << ", \"Name" << i << "\", -" << i;
+      out << line.str() << "\n";
+      serial.parseLine(line.str());
+    }
+  }
+
+  Gameexe parallel(path);
+  boost::filesystem::remove(path);
+
+  ASSERT_EQ(serial.size(), parallel.size());
+  for (int i = 0; i < 700; ++i) {
+    EXPECT_EQ(serial("KEY", i).ToIntVector(), parallel("KEY", i).ToIntVector());
+    EXPECT_EQ(serial("KEY", i).GetStringAt(1),
+              parallel("KEY", i).GetStringAt(1));
+  }
+}
@@ -34,6 +34,7 @@
 
 #include <boost/scoped_ptr.hpp>
 #include <functional>
+#include <set>
 #include <iostream>
 #include <string>
 #include <tuple>
@@ -48,11 +49,14 @@
 #include "modules/module_obj_management.h"
 #include "modules/module_str.h"
 #include "systems/base/colour_filter_object_data.h"
+#include "systems/base/digits_graphics_object.h"
 #include "systems/base/graphics_object.h"
 #include "systems/base/graphics_object_of_file.h"
+#include "systems/base/image_info.h"
 #include "systems/base/object_mutator.h"
 #include "systems/base/parent_graphics_object_data.h"
 #include "test_system/mock_colour_filter.h"
+#include "test_system/mock_surface.h"
 #include "test_system/test_graphics_system.h"
 #include "test_system/test_system.h"
 #include "utilities/exception.h"
@@ -369,3 +373,141 @@ TEST_F(GraphicsObjectTest, RunMutatorsOnChildObjects) {
   parent.Execute(rlmachine);
   EXPECT_TRUE(mutator_test->called());
 }
+
+// Objects and graphics stack commands changed after a savepoint must not leak
+// into the save.
+TEST_F(GraphicsObjectTest, SavepointSnapshotIgnoresLaterChanges) {
+  GraphicsSystem& graphics = system.graphics();
+  GraphicsObject obj;
+  obj.SetX(10);
+  obj.SetObjectData(new ColourFilterObjectData(graphics, Rect(0, 0, Size(5, 5))));
+  graphics.SetObject(OBJ_FG, 3, obj);
+  graphics.SetObject(OBJ_BG, 7, obj);
+  graphics.AddGraphicsStackCommand("first");
+  graphics.TakeSavepointSnapshot();
+
+  graphics.GetObject(OBJ_FG, 3).SetX(20);
+  graphics.SetObject(OBJ_FG, 4, obj);
+  graphics.FreeObjectData(7);
+  graphics.AddGraphicsStackCommand("second");
+  EXPECT_EQ(20, graphics.GetObject(OBJ_FG, 3).x());
+  EXPECT_EQ(2, graphics.StackSize());
+
+  stringstream ss;
+  Serialization::g_current_machine = &rlmachine;
+  {
+    boost::archive::text_oarchive oa(ss);
+    oa << const_cast<const GraphicsSystem&>(graphics);
+  }
+  graphics.Reset();
+  {
+    boost::archive::text_iarchive ia(ss);
+    ia >> graphics;
+  }
+  Serialization::g_current_machine = NULL;
+
+  EXPECT_EQ(10, graphics.GetObject(OBJ_FG, 3).x());
+  EXPECT_TRUE(graphics.GetObject(OBJ_FG, 3).has_object_data());
+  EXPECT_FALSE(graphics.GetObject(OBJ_FG, 4).has_object_data());
+  EXPECT_TRUE(graphics.GetObject(OBJ_BG, 7).has_object_data());
+  EXPECT_EQ(1, graphics.StackSize());
+}
+
+// Looking at objects through a const GraphicsSystem doesn't copy them into
+// the savepoint journal or allocate empty slots; fetching one to change it
+// does.
+TEST_F(GraphicsObjectTest, ReadOnlyObjectAccessIsNotJournaled) {
+  GraphicsSystem& graphics = system.graphics();
+  const GraphicsSystem& const_graphics = graphics;
+  graphics.GetObject(OBJ_FG, 3).SetX(10);
+  graphics.TakeSavepointSnapshot();
+
+  EXPECT_EQ(10, const_graphics.GetObject(OBJ_FG, 3).x());
+  EXPECT_EQ(1, const_graphics.GetObject(OBJ_FG, 3).reference_count());
+  int count = 0;
+  for (const GraphicsObject& obj : const_graphics.GetForegroundObjects()) {
+    EXPECT_EQ(10, obj.x());
+    ++count;
+  }
+  EXPECT_EQ(1, count);
+  EXPECT_FALSE(const_graphics.GetObject(OBJ_FG, 4).has_object_data());
+  EXPECT_FALSE(const_graphics.GetForegroundObjects().exists(4));
+
+  graphics.GetObject(OBJ_FG, 3);
+  EXPECT_EQ(2, const_graphics.GetObject(OBJ_FG, 3).reference_count());
+}
+
+// Preloading a g00 is only a hint; the image is loaded when it's first used.
+TEST_F(GraphicsObjectTest, PreloadedG00IsLoadedOnFirstUse) {
+  TestGraphicsSystem& graphics =
+      dynamic_cast<TestGraphicsSystem&>(system.graphics());
+  graphics.PreloadG00(0, "preload");
+
+  std::shared_ptr<MockSurface> surface(
+      MockSurface::Create("preload", Size(30, 50)));
+  graphics.InjectSurface("preload", surface);
+  EXPECT_EQ(surface, graphics.GetSurfaceNamed("preload"));
+  EXPECT_EQ(Size(30, 50), graphics.GetImageInfo("preload")->size());
+}
+
+// Prefetches that are never collected are dropped when their preload slots are
+// cleared or the system is reset.
+TEST_F(GraphicsObjectTest, ClearingPreloadedG00CancelsPrefetch) {
+  TestGraphicsSystem& graphics =
+      dynamic_cast<TestGraphicsSystem&>(system.graphics());
+  typedef std::set<std::string> Names;
+
+  graphics.PreloadG00(0, "used");
+  graphics.PreloadG00(1, "shared");
+  graphics.PreloadG00(2, "shared");
+  graphics.PreloadG00(3, "cleared");
+  EXPECT_EQ(Names({"cleared", "shared", "used"}),
+            graphics.pending_prefetches());
+
+  EXPECT_TRUE(graphics.GetPreloadedG00("used"));
+  EXPECT_EQ(Names({"cleared", "shared"}), graphics.pending_prefetches());
+
+  graphics.ClearPreloadedG00(3);
+  graphics.ClearPreloadedG00(1);
+  EXPECT_EQ(Names({"shared"}), graphics.pending_prefetches());
+
+  graphics.PreloadG00(2, "replacement");
+  EXPECT_EQ(Names({"replacement"}), graphics.pending_prefetches());
+
+  graphics.PreloadG00(4, "other");
+  graphics.ClearAllPreloadedG00();
+  EXPECT_TRUE(graphics.pending_prefetches().empty());
+
+  graphics.PreloadG00(5, "reset");
+  graphics.Reset();
+  EXPECT_TRUE(graphics.pending_prefetches().empty());
+}
+
+// Changing a digit object's value only redraws the digits that changed, and
+// the surface is kept as long as the layout doesn't change.
+TEST_F(GraphicsObjectTest, DigitsRedrawOnlyChangedDigits) {
+  TestGraphicsSystem& graphics =
+      dynamic_cast<TestGraphicsSystem&>(system.graphics());
+  std::shared_ptr<MockSurface> font(MockSurface::Create("digits"));
+  graphics.InjectSurface("digits", font);
+
+  GraphicsObject obj;
+  obj.SetObjectData(new DigitsGraphicsObject(system, "digits"));
+  obj.SetDigitOpts(3, 1, 0, 0, 10);
+  obj.SetDigitValue(123);
+
+  EXPECT_CALL(*font, BlitToSurface(_, _, _, 255, false)).Times(3);
+  EXPECT_EQ(30, obj.PixelWidth());
+  ASSERT_TRUE(::testing::Mock::VerifyAndClearExpectations(font.get()));
+
+  obj.SetDigitValue(129);
+  EXPECT_CALL(*font, BlitToSurface(_, _, Rect(20, 0, Size()), 255, false))
+      .Times(1);
+  EXPECT_EQ(30, obj.PixelWidth());
+  ASSERT_TRUE(::testing::Mock::VerifyAndClearExpectations(font.get()));
+
+  // One more digit means a new layout and a full redraw.
+  obj.SetDigitValue(1290);
+  EXPECT_CALL(*font, BlitToSurface(_, _, _, 255, false)).Times(4);
+  EXPECT_EQ(40, obj.PixelWidth());
+}
@@ -0,0 +1,247 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "systems/base/graphics_system.h"
+#include "systems/base/hik_renderer.h"
+#include "systems/base/hik_script.h"
+#include "test_system/test_event_system.h"
+#include "test_utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+// Helper to specify the return value of GetTicks().
+class HIKEventSystemTest : public EventSystemMockHandler {
+ public:
+  HIKEventSystemTest() : ticks(0) {}
+  void setTicks(unsigned int in) { ticks = in; }
+  virtual unsigned int GetTicks() const { return ticks; }
+
+ private:
+  unsigned int ticks;
+};
+
+// Writes a HIK file with a single, non-scrolling layer holding one
+// multiframe animation whose frames last |frame_lengths| ms each.
+class HIKFileWriter {
+ public:
+  explicit HIKFileWriter(const std::vector<int>& frame_lengths)
+      : path_(fs::temp_directory_path() /
+              fs::unique_path("rlvm-%%%%-%%%%-%%%%.hik")),
+        out_(path_.string().c_str(), std::ios::binary) {
+    Write(10000, 10000);
+    Write(10103, 640, 480);
+    Write(20000, 1);
+    Write(20001, 0);
+    Write(21200, 0);
+    Write(21301, 0);
+    Write(30000, 1);
+    Write(30001, 0);
+    Write(30100, 1);
+    Write(30101, 0);
+    Write(30102, 0);
+    Write(40000, frame_lengths.size());
+    for (int length : frame_lengths) {
+      WriteInt(40101);
+      for (int i = 0; i < 31; ++i)
+        WriteInt(0);
+      Write(40102, 255);
+      WriteInt(40100);
+      WriteString("frame");
+      Write(-1, length);
+    }
+    out_.close();
+  }
+
+  ~HIKFileWriter() { fs::remove(path_); }
+
+  const fs::path& path() const { return path_; }
+
+ private:
+  void WriteInt(int32_t value) {
+    unsigned char bytes[4] = {
+        static_cast<unsigned char>(value & 0xff),
+        static_cast<unsigned char>((value >> 8) & 0xff),
+        static_cast<unsigned char>((value >> 16) & 0xff),
+        static_cast<unsigned char>((value >> 24) & 0xff)};
+    out_.write(reinterpret_cast<const char*>(bytes), 4);
+  }
+
+  void Write(int32_t a, int32_t b) {
+    WriteInt(a);
+    WriteInt(b);
+  }
+
+  void Write(int32_t a, int32_t b, int32_t c) {
+    Write(a, b);
+    WriteInt(c);
+  }
+
+  void WriteString(const std::string& str) {
+    WriteInt(str.size() + 1);
+    out_.write(str.c_str(), str.size() + 1);
+  }
+
+  fs::path path_;
+  std::ofstream out_;
+};
+
+HIKScript::Animation AnimationWithFrameEndTimes(
+    const std::vector<int>& end_times) {
+  HIKScript::Animation animation;
+  animation.frame_end_times = end_times;
+  animation.total_time = end_times.empty() ? 0 : end_times.back();
+  return animation;
+}
+
+}  // namespace
+
+TEST(HIKScriptTest, FrameAtFollowsFrameEndTimes) {
+  HIKScript::Animation animation =
+      AnimationWithFrameEndTimes({100, 250, 300});
+
+  EXPECT_EQ(0u, animation.FrameAt(0));
+  EXPECT_EQ(0u, animation.FrameAt(100));
+  EXPECT_EQ(1u, animation.FrameAt(101));
+  EXPECT_EQ(1u, animation.FrameAt(250));
+  EXPECT_EQ(2u, animation.FrameAt(251));
+  EXPECT_EQ(2u, animation.FrameAt(300));
+
+  // Callers wrap time around |total_time|; anything past the end stays on
+  // the last frame rather than reading off the end of the animation.
+  EXPECT_EQ(2u, animation.FrameAt(301));
+  EXPECT_EQ(2u, animation.FrameAt(100000));
+}
+
+TEST(HIKScriptTest, FrameAtSingleFrame) {
+  HIKScript::Animation animation = AnimationWithFrameEndTimes({100});
+
+  EXPECT_EQ(0u, animation.FrameAt(0));
+  EXPECT_EQ(0u, animation.FrameAt(100));
+  EXPECT_EQ(0u, animation.FrameAt(5000));
+}
+
+TEST(HIKScriptTest, FrameAtZeroDuration) {
+  HIKScript::Animation animation = AnimationWithFrameEndTimes({0, 0});
+  EXPECT_EQ(0u, animation.FrameAt(0));
+  EXPECT_EQ(1u, animation.FrameAt(1));
+
+  HIKScript::Animation empty = AnimationWithFrameEndTimes({});
+  EXPECT_EQ(0u, empty.FrameAt(0));
+  EXPECT_EQ(0u, empty.FrameAt(100));
+}
+
+class HIKRendererTest : public FullSystemTest {
+ protected:
+  HIKRendererTest() : event_system_impl(new HIKEventSystemTest) {
+    dynamic_cast<TestEventSystem&>(system.event())
+        .SetMockHandler(event_system_impl);
+  }
+
+  std::unique_ptr<HIKRenderer> BuildRenderer(
+      const std::vector<int>& frame_lengths) {
+    HIKFileWriter writer(frame_lengths);
+    std::shared_ptr<const HIKScript> script(
+        new HIKScript(system, writer.path()));
+    return std::unique_ptr<HIKRenderer>(new HIKRenderer(system, script));
+  }
+
+  // Runs one tick at |ticks| and returns whether it asked for a redraw.
+  bool ExecuteAt(HIKRenderer& renderer, unsigned int ticks) {
+    event_system_impl->setTicks(ticks);
+    system.graphics().OnScreenRefreshed();
+    renderer.Execute(rlmachine);
+    return system.graphics().screen_needs_refresh();
+  }
+
+  std::shared_ptr<HIKEventSystemTest> event_system_impl;
+};
+
+TEST_F(HIKRendererTest, RedrawsOnlyWhenTheFrameChanges) {
+  std::unique_ptr<HIKRenderer> renderer = BuildRenderer({100, 100});
+
+  // A new renderer always draws once, then sleeps until the first frame
+  // ends.
+  EXPECT_EQ(0u, renderer->NextWakeupTime());
+  EXPECT_TRUE(ExecuteAt(*renderer, 0));
+  EXPECT_EQ(101u, renderer->NextWakeupTime());
+
+  EXPECT_FALSE(ExecuteAt(*renderer, 50));
+  EXPECT_FALSE(ExecuteAt(*renderer, 100));
+  EXPECT_EQ(101u, renderer->NextWakeupTime());
+
+  // Second frame.
+  EXPECT_TRUE(ExecuteAt(*renderer, 101));
+  EXPECT_EQ(201u, renderer->NextWakeupTime());
+  EXPECT_FALSE(ExecuteAt(*renderer, 150));
+
+  // Wrapping around to the first frame restarts the animation clock.
+  EXPECT_TRUE(ExecuteAt(*renderer, 201));
+  EXPECT_EQ(202u, renderer->NextWakeupTime());
+  EXPECT_FALSE(ExecuteAt(*renderer, 202));
+  EXPECT_EQ(302u, renderer->NextWakeupTime());
+}
+
+TEST_F(HIKRendererTest, OffsetChangeForcesRedraw) {
+  std::unique_ptr<HIKRenderer> renderer = BuildRenderer({100, 100});
+  EXPECT_TRUE(ExecuteAt(*renderer, 0));
+  EXPECT_FALSE(ExecuteAt(*renderer, 10));
+
+  renderer->set_x_offset(5);
+  EXPECT_EQ(0u, renderer->NextWakeupTime());
+  EXPECT_TRUE(ExecuteAt(*renderer, 20));
+  EXPECT_EQ(101u, renderer->NextWakeupTime());
+  EXPECT_FALSE(ExecuteAt(*renderer, 30));
+}
+
+TEST_F(HIKRendererTest, SingleFrameAnimationNeverRedraws) {
+  std::unique_ptr<HIKRenderer> renderer = BuildRenderer({100});
+  EXPECT_TRUE(ExecuteAt(*renderer, 0));
+
+  // Every lap lands back on the only frame.
+  for (unsigned int ticks = 1; ticks < 1000; ticks += 37)
+    EXPECT_FALSE(ExecuteAt(*renderer, ticks)) << "At " << ticks;
+}
+
+TEST_F(HIKRendererTest, ZeroDurationAnimationDoesNotHang) {
+  std::unique_ptr<HIKRenderer> renderer = BuildRenderer({0, 0});
+  EXPECT_TRUE(ExecuteAt(*renderer, 0));
+  EXPECT_EQ(std::numeric_limits<unsigned int>::max(),
+            renderer->NextWakeupTime());
+  EXPECT_FALSE(ExecuteAt(*renderer, 500));
+}
@@ -27,17 +27,33 @@
 
 #include "gtest/gtest.h"
 
+#include "base/notification_service.h"
 #include "libreallive/archive.h"
+#include "libreallive/bytecode.h"
+#include "libreallive/expression.h"
 #include "libreallive/intmemref.h"
+#include "machine/memory.h"
 #include "machine/rlmachine.h"
+#include "machine/scenario_cfg.h"
+#include "machine/serialization.h"
 #include "modules/module_jmp.h"
 #include "modules/module_msg.h"
 #include "modules/module_str.h"
+#include "modules/modules.h"
 #include "test_system/test_system.h"
+#include "utilities/exception.h"
 
 #include "test_utils.h"
 
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 using namespace std;
 using namespace libreallive;
 
@@ -271,6 +287,80 @@ TEST(LargeJmpTest, goto_case) {
       << "We jumped somewhere unexpected on a bad value!";
 }
 
+// Tests that the compiled case table keeps the first-match-in-order semantics
+// of walking the case list when constant and non-constant labels are mixed.
+TEST(LargeJmpTest, CaseTableMatchesInOrder) {
+  libreallive::Archive arc(locateTestCase("Module_Jmp_SEEN/goto_case_0.TXT"));
+  TestSystem system;
+  RLMachine rlmachine(system, arc);
+
+  vector<string> cases = {
+      // intB[0]
+      PrintableToParsableString("( $ 01 [ $ ff 00 00 00 00 ] )"),
+      // 5
+      PrintableToParsableString("( $ ff 05 00 00 00 )"),
+      // 2 * 3
+      PrintableToParsableString(
+          "( $ ff 02 00 00 00 5c 02 $ ff 03 00 00 00 )"),
+      // 5 again; shadowed by case 1.
+      PrintableToParsableString("( $ ff 05 00 00 00 )"),
+      // default
+      "()",
+      // 7; shadowed by the default case.
+      PrintableToParsableString("( $ ff 07 00 00 00 )")};
+  CaseTable table(rlmachine, cases);
+
+  rlmachine.SetIntValue(IntMemRef('B', 0), 5);
+  EXPECT_EQ(0, table.Find(rlmachine, 5));
+  EXPECT_EQ(2, table.Find(rlmachine, 6));
+  EXPECT_EQ(4, table.Find(rlmachine, 7));
+  EXPECT_EQ(4, table.Find(rlmachine, 99));
+
+  rlmachine.SetIntValue(IntMemRef('B', 0), 6);
+  EXPECT_EQ(1, table.Find(rlmachine, 5));
+  EXPECT_EQ(0, table.Find(rlmachine, 6));
+
+  // Widely spread keys go through the hashed table, and there is no default.
+  vector<string> sparse_cases = {
+      PrintableToParsableString("( $ ff 00 00 00 00 )"),
+      PrintableToParsableString("( $ ff 40 42 0f 00 )")};
+  CaseTable sparse_table(rlmachine, sparse_cases);
+  EXPECT_EQ(0, sparse_table.Find(rlmachine, 0));
+  EXPECT_EQ(1, sparse_table.Find(rlmachine, 1000000));
+  EXPECT_EQ(-1, sparse_table.Find(rlmachine, 3));
+}
+
+// Malformed case labels throw when a lookup reaches them, but not when an
+// earlier case matches first, just like walking the case list in order.
+TEST(LargeJmpTest, CaseTableRejectsMalformedCasesWhenReached) {
+  libreallive::Archive arc(locateTestCase("Module_Jmp_SEEN/goto_case_0.TXT"));
+  TestSystem system;
+  RLMachine rlmachine(system, arc);
+
+  CaseTable empty(rlmachine, {""});
+  EXPECT_THROW(empty.Find(rlmachine, 0), rlvm::Exception);
+  CaseTable unclosed(rlmachine, {"("});
+  EXPECT_THROW(unclosed.Find(rlmachine, 0), rlvm::Exception);
+  CaseTable truncated(
+      rlmachine, {PrintableToParsableString("( $ ff 05 00 00 00")});
+  EXPECT_THROW(truncated.Find(rlmachine, 5), rlvm::Exception);
+
+  // A default case shadows everything after it.
+  CaseTable after_default(rlmachine, {"()", ")("});
+  EXPECT_EQ(0, after_default.Find(rlmachine, 3));
+
+  vector<string> cases = {
+      // 5
+      PrintableToParsableString("( $ ff 05 00 00 00 )"),
+      ")(",
+      // 7
+      PrintableToParsableString("( $ ff 07 00 00 00 )")};
+  CaseTable table(rlmachine, cases);
+  EXPECT_EQ(0, table.Find(rlmachine, 5));
+  EXPECT_THROW(table.Find(rlmachine, 7), rlvm::Exception);
+  EXPECT_THROW(table.Find(rlmachine, 9), rlvm::Exception);
+}
+
 // -----------------------------------------------------------------------
 
 // Tests gosub
@@ -711,6 +801,157 @@ TEST(LargeJmpTest, fibonacci) {
   }
 }
 
+// Runs the fibonacci scenario on several machines at once, each on its own
+// thread, to make sure that no interpreter state is shared between
+// RLMachines in one process. Each machine also saves and reloads itself
+// halfway through.
+TEST(LargeJmpTest, fibonacciOnConcurrentMachines) {
+  const int kThreads = 4;
+  vector<vector<int>> results(kThreads);
+  vector<string> errors(kThreads);
+
+  vector<thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t, &results, &errors]() {
+      // Keep each machine's notifications to itself.
+      NotificationService service;
+      NotificationService::ScopedOverride override_service(&service);
+      try {
+        for (int i = 0; i < 12; ++i) {
+          libreallive::Archive arc(
+              locateTestCase("Module_Jmp_SEEN/fibonacci.TXT"));
+          TestSystem system;
+          RLMachine rlmachine(system, arc);
+          rlmachine.AttachModule(new JmpModule);
+          rlmachine.AttachModule(new StrModule);
+          rlmachine.SetIntValue(IntMemRef('D', 0), (i + t) % 12);
+          for (int step = 0; step < 100 && !rlmachine.halted(); ++step)
+            rlmachine.ExecuteNextInstruction();
+
+          stringstream ss;
+          rlmachine.MarkSavepoint();
+          Serialization::saveGameTo(ss, rlmachine);
+          Serialization::loadGameFrom(ss, rlmachine);
+
+          rlmachine.ExecuteUntilHalted();
+          results[t].push_back(rlmachine.GetIntValue(IntMemRef('E', 0)));
+        }
+      } catch (std::exception& e) {
+        errors[t] = e.what();
+      }
+    });
+  }
+  for (thread& th : threads)
+    th.join();
+
+  for (int t = 0; t < kThreads; ++t) {
+    EXPECT_EQ("", errors[t]) << "Thread " << t << " threw";
+    ASSERT_EQ(12u, results[t].size());
+    for (int i = 0; i < 12; ++i) {
+      EXPECT_EQ(recFib((i + t) % 12), results[t][i])
+          << "Wrong output value for fib(" << (i + t) % 12 << ") on thread "
+          << t;
+    }
+  }
+}
+
+namespace {
+
+// Runs the scenario in |path| with every module attached for a bounded number
+// of instructions, saving and reloading halfway, and returns a dump of the
+// machine's memory and state afterwards.
+string RunScenarioFixture(const string& path) {
+  // This runs on several threads at once; keep each machine's notifications
+  // to itself.
+  NotificationService service;
+  NotificationService::ScopedOverride override_service(&service);
+
+  ostringstream dump;
+  try {
+    libreallive::Archive arc(path);
+    TestSystem system;
+    RLMachine rlmachine(system, arc);
+    AddAllModules(rlmachine);
+
+    const int kSteps = 2000;
+    for (int step = 0; step < kSteps && !rlmachine.halted(); ++step) {
+      if (step == kSteps / 20) {
+        stringstream ss;
+        rlmachine.MarkSavepoint();
+        Serialization::saveGameTo(ss, rlmachine);
+        Serialization::loadGameFrom(ss, rlmachine);
+      }
+      rlmachine.ExecuteNextInstruction();
+    }
+
+    dump << "halted " << rlmachine.halted() << " at "
+         << rlmachine.SceneNumber() << ":" << rlmachine.line_number() << "\n";
+    for (int bank = INTA_LOCATION; bank <= INTZ_LOCATION; ++bank) {
+      for (int i = 0; i < SIZE_OF_MEM_BANK; ++i)
+        dump << rlmachine.GetIntValue(IntMemRef(bank, 0, i)) << ",";
+      dump << "\n";
+    }
+    for (int type : {STRS_LOCATION, STRM_LOCATION}) {
+      for (int i = 0; i < SIZE_OF_MEM_BANK; ++i)
+        dump << rlmachine.GetStringValue(type, i) << "\n";
+    }
+  } catch (std::exception& e) {
+    dump << "threw " << e.what();
+  }
+  return dump.str();
+}
+
+}  // namespace
+
+// Runs every scenario fixture under test/ on several machines at once, each
+// thread going through them in a different order, and checks that each run
+// ends up exactly like a run on its own.
+TEST(LargeJmpTest, ScenarioFixturesOnConcurrentMachines) {
+  vector<string> fixtures;
+  for (const char* dir : {"ExpressionTest_SEEN", "Module_Jmp_SEEN",
+                          "Module_Mem_SEEN", "Module_Str_SEEN",
+                          "Module_Sys_SEEN"}) {
+    boost::filesystem::path root(locateTestCase(dir));
+    for (boost::filesystem::directory_iterator it(root), end; it != end;
+         ++it) {
+      // builtins.TXT exercises rnd(), which is seeded from the clock.
+      if (boost::filesystem::is_regular_file(it->path()) &&
+          it->path().extension() == ".TXT" &&
+          it->path().filename() != "builtins.TXT") {
+        fixtures.push_back(it->path().string());
+      }
+    }
+  }
+  std::sort(fixtures.begin(), fixtures.end());
+  ASSERT_LT(50u, fixtures.size());
+
+  vector<string> serial;
+  for (const string& fixture : fixtures)
+    serial.push_back(RunScenarioFixture(fixture));
+
+  const int kThreads = 4;
+  vector<vector<string>> results(kThreads, vector<string>(fixtures.size()));
+  vector<thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([t, &fixtures, &results]() {
+      size_t offset = t * fixtures.size() / kThreads;
+      for (size_t i = 0; i < fixtures.size(); ++i) {
+        size_t index = (i + offset) % fixtures.size();
+        results[t][index] = RunScenarioFixture(fixtures[index]);
+      }
+    });
+  }
+  for (thread& th : threads)
+    th.join();
+
+  for (int t = 0; t < kThreads; ++t) {
+    for (size_t i = 0; i < fixtures.size(); ++i) {
+      EXPECT_TRUE(serial[i] == results[t][i])
+          << fixtures[i] << " differs on thread " << t;
+    }
+  }
+}
+
 // -----------------------------------------------------------------------
 
 // Tests farcall_with()/rtl_with().
@@ -769,3 +1010,75 @@ TEST(LargeJmpTest, pushStringValueUp) {
 
   EXPECT_EQ("GOOD", rlmachine.GetStringValue(STRM_LOCATION, 0));
 }
+
+// -----------------------------------------------------------------------
+
+// Tests the control flow graph of gosub_0.ke: the gosub and goto split the
+// scenario into blocks, and the subroutine's block returns.
+TEST(LargeJmpTest, ControlFlowGraphOfGosub) {
+  libreallive::Archive arc(locateTestCase("Module_Jmp_SEEN/gosub_0.TXT"));
+  ArchiveCFG archive_cfg(arc, boost::filesystem::path());
+  ASSERT_EQ(1u, archive_cfg.size());
+  const ScenarioCFG* cfg = archive_cfg.GetScenario(arc.begin()->first);
+  ASSERT_TRUE(cfg);
+
+  const std::vector<ScenarioCFG::Block>& blocks = cfg->blocks();
+  ASSERT_LE(4u, blocks.size());
+  EXPECT_EQ(0, cfg->GetBlockContaining(0));
+
+  // The first block ends in the gosub, which comes back to the next block.
+  ASSERT_EQ(2u, blocks[0].successors.size());
+  EXPECT_EQ(ScenarioCFG::EDGE_GOSUB, blocks[0].successors[0].type);
+  EXPECT_EQ(ScenarioCFG::EDGE_FALLTHROUGH, blocks[0].successors[1].type);
+  EXPECT_EQ(1, blocks[0].successors[1].target);
+  const ScenarioCFG::Block& sub = blocks[blocks[0].successors[0].target];
+  EXPECT_TRUE(sub.returns);
+  EXPECT_TRUE(sub.successors.empty());
+
+  // The second block jumps over the subroutine.
+  ASSERT_EQ(1u, blocks[1].successors.size());
+  EXPECT_EQ(ScenarioCFG::EDGE_GOTO, blocks[1].successors[0].type);
+  EXPECT_LT(blocks[0].successors[0].target, blocks[1].successors[0].target);
+}
+
+// Tests that computed jump targets, entrypoints and resources are recorded,
+// and that the graph survives a round trip through the cache.
+TEST(LargeJmpTest, ControlFlowGraphEntrypointsAndResources) {
+  boost::filesystem::path cache_file =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("rlvm_cfg_%%%%%%%%.cache");
+
+  libreallive::Archive jump_arc(locateTestCase("Module_Jmp_SEEN/jump_0.TXT"));
+  ArchiveCFG jump_cfg(jump_arc, boost::filesystem::path());
+  const ScenarioCFG* jump = jump_cfg.GetScenario(jump_arc.begin()->first);
+  ASSERT_TRUE(jump);
+  ASSERT_FALSE(jump->blocks().empty());
+  ASSERT_EQ(1u, jump->blocks()[0].successors.size());
+  const ScenarioCFG::Edge& edge = jump->blocks()[0].successors[0];
+  EXPECT_EQ(ScenarioCFG::EDGE_JUMP, edge.type);
+  EXPECT_EQ(1, edge.scenario);
+  EXPECT_EQ(-1, edge.target);
+  for (int i = 1; i <= 3; ++i)
+    EXPECT_NE(-1, jump->GetEntrypointBlock(i)) << "Entrypoint " << i;
+
+  libreallive::Archive arc(locateTestCase("Module_Jmp_SEEN/graphics.TXT"));
+  for (int pass = 0; pass < 2; ++pass) {
+    ArchiveCFG archive_cfg(arc, cache_file);
+    EXPECT_EQ(pass, archive_cfg.cache_hits());
+    const ScenarioCFG* cfg = archive_cfg.GetScenario(arc.begin()->first);
+    ASSERT_TRUE(cfg);
+
+    std::vector<ScenarioCFG::Resource> resources =
+        cfg->GetResourcesReachableFrom(0, 100);
+    std::vector<std::string> names;
+    for (const ScenarioCFG::Resource& resource : resources) {
+      EXPECT_EQ(ScenarioCFG::RESOURCE_IMAGE, resource.type);
+      names.push_back(resource.name);
+    }
+    EXPECT_EQ(
+        (std::vector<std::string>{"BG053", "FGNY02A", "BG002", "BG003B"}),
+        names);
+  }
+
+  boost::filesystem::remove(cache_file);
+}
@@ -26,11 +26,26 @@
 
 #include "gtest/gtest.h"
 
+#include <climits>
+#include <memory>
+
+#include "long_operations/wait_long_operation.h"
 #include "machine/rlmachine.h"
 #include "modules/module_event_loop.h"
+#include "systems/base/graphics_system.h"
+#include "test_system/test_event_system.h"
 
 #include "test_utils.h"
 
+// Time stands still unless the test moves it.
+class FixedTickCounter : public EventSystemMockHandler {
+ public:
+  explicit FixedTickCounter(unsigned int ticks) : ticks(ticks) {}
+  virtual unsigned int GetTicks() const { return ticks; }
+
+  unsigned int ticks;
+};
+
 class MediumEventLoopTest : public FullSystemTest {
  protected:
   MediumEventLoopTest() { rlmachine.AttachModule(new EventLoopModule); }
@@ -49,3 +64,36 @@ TEST_F(MediumEventLoopTest, TestSkipMode) {
   rlmachine.Exe("SkipMode", 0);
   EXPECT_EQ(0, rlmachine.store_register());
 }
+
+// A plain timed wait with nothing animating lets the game loop sleep until
+// the wait expires instead of polling.
+TEST_F(MediumEventLoopTest, TimedWaitReportsWakeupTime) {
+  std::shared_ptr<FixedTickCounter> clock(new FixedTickCounter(1000));
+  dynamic_cast<TestEventSystem&>(system.event()).SetMockHandler(clock);
+
+  // Nothing blocks the bytecode, so the loop has to keep running.
+  EXPECT_EQ(0u, system.NextWakeupTime(rlmachine));
+
+  WaitLongOperation* wait = new WaitLongOperation(rlmachine);
+  wait->WaitMilliseconds(500);
+  rlmachine.PushLongOperation(wait);
+  system.graphics().OnScreenRefreshed();
+  EXPECT_EQ(1501u, system.NextWakeupTime(rlmachine));
+
+  // A pending redraw has to be serviced on the next frame.
+  system.graphics().ForceRefresh();
+  EXPECT_EQ(0u, system.NextWakeupTime(rlmachine));
+  system.graphics().OnScreenRefreshed();
+
+  // Waiting only on a click is entirely event driven.
+  WaitLongOperation* click = new WaitLongOperation(rlmachine);
+  click->BreakOnClicks();
+  rlmachine.PushLongOperation(click);
+  EXPECT_EQ(UINT_MAX, system.NextWakeupTime(rlmachine));
+
+  // Arbitrary break conditions are polled.
+  WaitLongOperation* event = new WaitLongOperation(rlmachine);
+  event->BreakOnEvent([]() { return false; });
+  rlmachine.PushLongOperation(event);
+  EXPECT_EQ(0u, system.NextWakeupTime(rlmachine));
+}
@@ -133,3 +133,20 @@ TEST_F(MediumGrpTest, TestFade_7) {
   rlmachine.Exe(
       "recFade", 7, TestMachine::Arg(10, 10, 20, 20, 128, 128, 128, 0));
 }
+
+// A timed fade becomes a transition effect, unless we're fast forwarding.
+TEST_F(MediumGrpTest, TestFadeEffectSkippedWhileFastForwarding) {
+  EXPECT_CALL(system.graphics().GetMockDC(0),
+              Fill(RGBAColour(128, 128, 128, 255), Rect(10, 10, Size(20, 20))))
+      .Times(2);
+  int stack_size = rlmachine.GetStackSize();
+  rlmachine.Exe(
+      "recFade", 7, TestMachine::Arg(10, 10, 20, 20, 128, 128, 128, 100));
+  EXPECT_EQ(stack_size + 1, rlmachine.GetStackSize());
+  rlmachine.ClearLongOperationsOffBackOfStack();
+
+  system.set_force_fast_forward();
+  rlmachine.Exe(
+      "recFade", 7, TestMachine::Arg(10, 10, 20, 20, 128, 128, 128, 100));
+  EXPECT_EQ(stack_size, rlmachine.GetStackSize());
+}
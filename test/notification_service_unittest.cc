@@ -8,6 +8,8 @@
 
 #include "gtest/gtest.h"
 
+#include <thread>
+
 namespace {
 
 // Bogus class to act as a NotificationSource for the messages.
@@ -163,3 +165,28 @@ TEST_F(NotificationServiceTest, MultipleRegistration) {
                   NotificationService::NoDetails());
   EXPECT_EQ(3, idle_test_source.notification_count());
 }
+
+// There is one service for the whole process: observers hear about things
+// posted from other threads, unless a thread installs its own service.
+TEST_F(NotificationServiceTest, SharedAcrossThreads) {
+  TestSource test_source;
+  TestObserver observer;
+  registrar_.Add(&observer, NotificationType::IDLE,
+                 NotificationService::AllSources());
+
+  std::thread([&test_source]() {
+    NotificationService::current()->Notify(NotificationType::IDLE,
+                                           Source<TestSource>(&test_source),
+                                           NotificationService::NoDetails());
+  }).join();
+  EXPECT_EQ(1, observer.notification_count());
+
+  std::thread([&test_source]() {
+    NotificationService service;
+    NotificationService::ScopedOverride override_service(&service);
+    NotificationService::current()->Notify(NotificationType::IDLE,
+                                           Source<TestSource>(&test_source),
+                                           NotificationService::NoDetails());
+  }).join();
+  EXPECT_EQ(1, observer.notification_count());
+}
@@ -32,6 +32,8 @@
 #include "libreallive/intmemref.h"
 #include "machine/rlmachine.h"
 #include "systems/base/rlbabel_dll.h"
+#include "systems/base/text_system.h"
+#include "systems/base/text_window.h"
 #include "test_utils.h"
 #include "test_system/test_system.h"
 #include "utilities/exception.h"
@@ -70,3 +72,63 @@ TEST_F(RLBabelTest, Initialization) {
   // TODO: Doing anything real with RLBabel requires that we have working
   // font metrics in TestSystem...
 }
+
+namespace {
+
+// Drives dllTextoutGetChar() the way rlBabel.kh does, moving the insertion
+// point as characters are printed, and returns the laid out text with "\n"
+// for each line break.
+std::string LayOutText(RLMachine& machine, TestSystem& system,
+                       const std::string& text) {
+  const int kBuffer = (libreallive::STRS_LOCATION << 16) | 1;
+  const int kXMod = 0;  // intA[0]
+
+  machine.SetStringValue(libreallive::STRS_LOCATION, 0, text);
+  machine.CallDLL(0, dllTextoutStart, libreallive::STRS_LOCATION << 16, 0, 0,
+                  0);
+
+  std::shared_ptr<TextWindow> window = system.text().GetCurrentWindow();
+  std::string out;
+  for (int i = 0; i < 1000; ++i) {
+    int rv = machine.CallDLL(0, dllTextoutGetChar, kBuffer, kXMod, 0, 0);
+    if (rv == getcEndOfString) {
+      break;
+    } else if (rv == getcPrintChar) {
+      out += machine.GetStringValue(libreallive::STRS_LOCATION, 1);
+      window->set_insertion_point_x(
+          machine.GetIntValue(libreallive::IntMemRef('A', 0)));
+    } else if (rv == getcNewLine) {
+      out += "\n";
+      window->set_insertion_point_x(window->current_indentation());
+    }
+  }
+  return out;
+}
+
+}  // namespace
+
+// Western text is broken between words; a word that doesn't fit on a line by
+// itself is split.
+TEST_F(RLBabelTest, LineBreaking) {
+  rlmachine.LoadDLL(0, rlBabel);
+  rlmachine.CallDLL(0, dllInitialise, 0, 0, 0, 0);
+
+  std::string out = LayOutText(
+      rlmachine, system,
+      "A world, covered in white. The snow falls without end, and "
+      "Supercalifragilisticexpialidocious-extraordinarilylongwordsaredifficult "
+      "to lay out. Pneumonoultramicroscopicsilicovolcanoconiosis"
+      "pneumonoultramicroscopicsilicovolcanoconiosis, really.");
+  EXPECT_EQ(
+      "A world, covered in white.\n"
+      "The snow falls without\n"
+      "end, and Supercalifragilisticexpialidocious-\n"
+      "extraordinarilylongwordsaredifficult \n"
+      "to lay out. Pneumonoultramicroscopicsilic\n"
+      "ovolcanoconiosispneumonoultramicroscopicsilicovolc\n"
+      "anoconiosis, really.",
+      out);
+
+  // Each distinct character is only measured once per font size.
+  EXPECT_GE(30, system.text().char_width_queries());
+}
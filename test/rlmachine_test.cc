@@ -27,14 +27,23 @@
 
 #include "gtest/gtest.h"
 
+#include <boost/filesystem/operations.hpp>
+
+#include <cstdlib>
 #include <iostream>
+#include <map>
+#include <sstream>
 #include <utility>
 #include <string>
 #include <vector>
 
+#include "machine/kidoku_table.h"
+#include "machine/long_operation.h"
 #include "machine/memory.h"
+#include "machine/profiler.h"
 #include "machine/rlmachine.h"
 #include "machine/serialization.h"
+#include "machine/stack_frame.h"
 #include "modules/module_str.h"
 #include "utilities/exception.h"
 #include "libreallive/intmemref.h"
@@ -242,6 +251,102 @@ TEST_F(RLMachineTest, SerializationOfKidoku) {
   }
 }
 
+// Markers that exist in the archive go in the flat kidoku table, and bits from
+// older saves are moved into it when loaded.
+TEST_F(RLMachineTest, KidokuTableHoldsArchiveMarkers) {
+  libreallive::Archive arc(locateTestCase("Module_Str_SEEN/strcpy_0.TXT"));
+  std::map<int, int> sizes = arc.GetKidokuTableSizes();
+  ASSERT_FALSE(sizes.empty());
+  int scenario = sizes.begin()->first;
+  ASSERT_LT(0, sizes.begin()->second);
+
+  RLMachine machine(system, arc);
+  GlobalMemory& global = machine.memory().global();
+  machine.memory().RecordKidoku(scenario, 0);
+  EXPECT_TRUE(global.kidoku_table.Test(scenario, 0));
+  EXPECT_TRUE(global.kidoku_data.empty());
+
+  global.kidoku_data[scenario].resize(sizes.begin()->second + 1);
+  global.kidoku_data[scenario].set(sizes.begin()->second - 1);
+  global.kidoku_data[scenario].set(sizes.begin()->second);
+  global.kidoku_table.Absorb(&global.kidoku_data);
+  EXPECT_TRUE(global.kidoku_table.Test(scenario, sizes.begin()->second - 1));
+  ASSERT_EQ(1u, global.kidoku_data.size());
+  EXPECT_EQ(1u, global.kidoku_data[scenario].count());
+  EXPECT_TRUE(machine.memory().HasBeenRead(scenario,
+                                           sizes.begin()->second));
+}
+
+// Read state written through the mapped file survives into a later run, even
+// when the archive's layout has changed in between.
+TEST_F(RLMachineTest, KidokuTableFile) {
+  boost::filesystem::path path =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("rlvm_kidoku_%%%%%%%%.dat");
+
+  {
+    KidokuTable table;
+    table.SetLayout({{1, 70}, {5, 3}});
+    table.Set(1, 65);
+    table.AttachFile(path.string());
+    table.Set(5, 2);
+  }
+
+  {
+    KidokuTable table;
+    table.SetLayout({{1, 66}, {5, 3}, {7, 4}});
+    table.AttachFile(path.string());
+    EXPECT_TRUE(table.Test(1, 65));
+    EXPECT_FALSE(table.Test(1, 64));
+    EXPECT_TRUE(table.Test(5, 2));
+    EXPECT_FALSE(table.Test(7, 0));
+    EXPECT_FALSE(table.Contains(1, 66));
+    EXPECT_FALSE(table.Contains(3, 0));
+  }
+
+  boost::filesystem::remove(path);
+}
+
+// Resetting global memory also clears the read state kept in kidoku.dat, so
+// that saving doesn't merge it back in.
+TEST_F(RLMachineTest, HardResetClearsKidokuFile) {
+  boost::filesystem::path home =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("rlvm_home_%%%%%%%%");
+  const char* old_home = getenv("HOME");
+  std::string saved_home = old_home ? old_home : "";
+  setenv("HOME", home.string().c_str(), 1);
+  system.gameexe()("REGNAME") = "rlvm_test";
+
+  libreallive::Archive arc(locateTestCase("Module_Str_SEEN/strcpy_0.TXT"));
+  int scenario = arc.GetKidokuTableSizes().begin()->first;
+  {
+    RLMachine machine(system, arc);
+    Serialization::loadGlobalMemory(machine);
+    machine.memory().RecordKidoku(scenario, 0);
+    Serialization::saveGlobalMemory(machine);
+    EXPECT_TRUE(machine.memory().HasBeenRead(scenario, 0));
+
+    machine.HardResetMemory();
+    EXPECT_FALSE(machine.memory().HasBeenRead(scenario, 0));
+    EXPECT_TRUE(machine.memory().global().kidoku_table.attached());
+    Serialization::saveGlobalMemory(machine);
+    EXPECT_FALSE(machine.memory().HasBeenRead(scenario, 0));
+  }
+
+  {
+    RLMachine machine(system, arc);
+    Serialization::loadGlobalMemory(machine);
+    EXPECT_FALSE(machine.memory().HasBeenRead(scenario, 0));
+  }
+
+  if (old_home)
+    setenv("HOME", saved_home.c_str(), 1);
+  else
+    unsetenv("HOME");
+  boost::filesystem::remove_all(home);
+}
+
 TEST_F(RLMachineTest, SerializationOfSavepointValues) {
   stringstream ss;
   libreallive::Archive arc(locateTestCase("Module_Str_SEEN/strcpy_0.TXT"));
@@ -276,3 +381,226 @@ TEST_F(RLMachineTest, SerializationOfSavepointValues) {
     verifyStrMemoryCountingFrom(loadMachine, STRS_LOCATION, 0);
   }
 }
+
+// Tests that the profiler aggregates opcode calls and writes them out in both
+// the summary and the Chrome trace.
+TEST_F(RLMachineTest, ProfilerRecordsOpcodes) {
+  Profiler profiler;
+  profiler.RecordOpcode(0x100000012, "Jmp", "goto", 0, 5);
+  profiler.RecordOpcode(0x100000012, "Jmp", "goto", 10, 7);
+  profiler.RecordLine(1, 4, 12);
+  profiler.RecordSubsystem(Profiler::SUBSYSTEM_GRAPHICS, 20, 3);
+
+  std::ostringstream summary;
+  profiler.WriteSummary(summary);
+  EXPECT_NE(std::string::npos, summary.str().find("Jmp::goto"));
+  EXPECT_NE(std::string::npos, summary.str().find("SEEN0001(4)"));
+  EXPECT_NE(std::string::npos, summary.str().find("Graphics"));
+
+  std::ostringstream trace;
+  profiler.WriteChromeTrace(trace);
+  const std::string json = trace.str();
+  EXPECT_EQ(0u, json.find("{\"displayTimeUnit\""));
+  EXPECT_NE(std::string::npos, json.find("\"name\":\"Jmp::goto\""));
+  EXPECT_NE(std::string::npos, json.find("\"dur\":7"));
+}
+
+// The machine only hands out a profiler when the hooks were compiled in.
+TEST_F(RLMachineTest, StartProfiling) {
+  rlmachine.StartProfiling();
+  EXPECT_EQ(Profiler::IsCompiledIn(), rlmachine.profiler() != NULL);
+  std::unique_ptr<Profiler> profiler = rlmachine.StopProfiling();
+  EXPECT_EQ(Profiler::IsCompiledIn(), profiler != NULL);
+  EXPECT_EQ(NULL, rlmachine.profiler());
+}
+
+// Reading a range of intL doesn't unshare the bank from the savepoint call
+// stack; only writing does.
+TEST_F(RLMachineTest, IntRangeReadsKeepIntLShared) {
+  Memory& memory = rlmachine.memory();
+  IntMemRef intl(libreallive::INTL_LOCATION_IN_BYTECODE, 0);
+  rlmachine.MarkSavepoint();
+
+  const int* shared = rlmachine.CurrentIntLBank();
+  int out[4];
+  memory.GetIntRange(intl, 4, out);
+  memory.SumIntRange(intl, 4);
+  EXPECT_EQ(shared, rlmachine.CurrentIntLBank());
+
+  memory.FillIntRange(intl, 4, 1, 7);
+  EXPECT_NE(shared, rlmachine.CurrentIntLBank());
+  EXPECT_EQ(28, memory.SumIntRange(intl, 4));
+  EXPECT_EQ(0, shared[0]);
+}
+
+// The Memory range kernels must agree with element by element access for the
+// plain and every bit packed view of a bank.
+TEST_F(RLMachineTest, IntRangeKernelsMatchElementAccess) {
+  Memory& memory = rlmachine.memory();
+  // intB, intB1b, intB2b, intB4b, intB8b
+  for (int type = 0; type <= 4; ++type) {
+    int bytecode = type * 26 + libreallive::INTB_LOCATION;
+    int mask = type == 0 ? -1 : (1 << (1 << (type - 1))) - 1;
+
+    memory.FillIntRange(IntMemRef(bytecode, 3), 45, 1, 0x5a5a5a5a);
+    for (int i = 0; i < 50; ++i) {
+      int expected = (i >= 3 && i < 48) ? (0x5a5a5a5a & mask) : 0;
+      EXPECT_EQ(expected, memory.GetIntValue(IntMemRef(bytecode, i)))
+          << "type " << type << " location " << i;
+    }
+
+    int total = 0;
+    for (int i = 1; i < 40; ++i)
+      total += memory.GetIntValue(IntMemRef(bytecode, i));
+    EXPECT_EQ(total, memory.SumIntRange(IntMemRef(bytecode, 1), 39));
+
+    std::vector<int> values = {1, 2, 3, 4, 5, 6, 7};
+    memory.SetIntRange(IntMemRef(bytecode, 60), 3, values.data(),
+                       values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(values[i] & mask,
+                memory.GetIntValue(IntMemRef(bytecode, 60 + i * 3)));
+    }
+
+    // Overlapping copy forward by one.
+    memory.CopyIntRange(IntMemRef(bytecode, 60), IntMemRef(bytecode, 61), 19);
+    EXPECT_EQ(1 & mask, memory.GetIntValue(IntMemRef(bytecode, 61)));
+    EXPECT_EQ(2 & mask, memory.GetIntValue(IntMemRef(bytecode, 64)));
+
+    memory.FillIntRange(IntMemRef(bytecode, 0), 100, 1, 0);
+  }
+
+  EXPECT_THROW(memory.FillIntRange(IntMemRef('B', 1990), 20, 1, 1),
+               rlvm::Exception);
+  EXPECT_EQ(0, memory.GetIntValue(IntMemRef('B', 1990)));
+}
+
+// Range writes must still be undone when saving the last savepoint.
+TEST_F(RLMachineTest, IntRangeKernelsRecordSavepointValues) {
+  Memory& memory = rlmachine.memory();
+  memory.FillIntRange(IntMemRef('A', 0), 10, 1, 7);
+  rlmachine.MarkSavepoint();
+
+  memory.FillIntRange(IntMemRef('A', 5), 100, 1, 9);
+  memory.FillIntRange(IntMemRef('A', "b", 0), 64, 1, 0);
+
+  stringstream ss;
+  Serialization::saveGameTo(ss, rlmachine);
+  RLMachine loadMachine(system, arc);
+  Serialization::loadGameFrom(ss, loadMachine);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_EQ(7, loadMachine.GetIntValue(IntMemRef('A', i)));
+  EXPECT_EQ(0, loadMachine.GetIntValue(IntMemRef('A', 50)));
+}
+
+// Writes to intL[] and strK[] after a savepoint go to a copy of the stack
+// frame's banks; the save still has the values from the savepoint.
+TEST_F(RLMachineTest, SerializationOfSavepointCallStackBanks) {
+  rlmachine.SetIntValue(IntMemRef('L', 0), 3);
+  rlmachine.SetStringValue(STRK_LOCATION, 1, "before");
+  rlmachine.MarkSavepoint();
+
+  rlmachine.SetIntValue(IntMemRef('L', 0), 4);
+  rlmachine.SetStringValue(STRK_LOCATION, 1, "after");
+  EXPECT_EQ(4, rlmachine.GetIntValue(IntMemRef('L', 0)));
+  EXPECT_EQ("after", rlmachine.GetStringValue(STRK_LOCATION, 1));
+  EXPECT_EQ("", rlmachine.GetStringValue(STRK_LOCATION, 2));
+
+  stringstream ss;
+  Serialization::saveGameTo(ss, rlmachine);
+  RLMachine loadMachine(system, arc);
+  Serialization::loadGameFrom(ss, loadMachine);
+  EXPECT_EQ(3, loadMachine.GetIntValue(IntMemRef('L', 0)));
+  EXPECT_EQ("before", loadMachine.GetStringValue(STRK_LOCATION, 1));
+}
+
+namespace {
+
+// A LongOperation that never finishes on its own.
+struct NeverFinishes : public LongOperation {
+  virtual bool operator()(RLMachine& machine) override { return false; }
+};
+
+// A NeverFinishes that counts how many times it has been destroyed.
+struct CountsDestruction : public NeverFinishes {
+  explicit CountsDestruction(int* destroyed) : destroyed_(destroyed) {}
+  virtual ~CountsDestruction() { ++*destroyed_; }
+
+  int* destroyed_;
+};
+
+}  // namespace
+
+// LongOperations on the stack are skipped when looking up the frame whose
+// instruction pointer and parameter banks are current, even when a gosub gets
+// pushed on top of one.
+TEST_F(RLMachineTest, ScriptFrameLookupsSkipLongOperations) {
+  const libreallive::Scenario* scenario = &rlmachine.Scenario();
+  rlmachine.SetIntValue(IntMemRef('L', 0), 1);
+
+  rlmachine.PushLongOperation(new NeverFinishes);
+  rlmachine.PushStackFrame(
+      StackFrame(scenario, scenario->begin(), StackFrame::TYPE_GOSUB));
+  rlmachine.PushLongOperation(new NeverFinishes);
+  rlmachine.PushLongOperation(new NeverFinishes);
+  EXPECT_EQ(5, rlmachine.GetStackSize());
+
+  // The gosub has its own fresh banks.
+  EXPECT_EQ(0, rlmachine.GetIntValue(IntMemRef('L', 0)));
+  rlmachine.SetIntValue(IntMemRef('L', 0), 2);
+  rlmachine.PushStringValueUp(1, "up");
+  EXPECT_EQ("", rlmachine.GetStringValue(STRK_LOCATION, 1));
+
+  rlmachine.ClearLongOperationsOffBackOfStack();
+  EXPECT_EQ(3, rlmachine.GetStackSize());
+  EXPECT_EQ(2, rlmachine.GetIntValue(IntMemRef('L', 0)));
+
+  rlmachine.ReturnFromGosub();
+  rlmachine.ClearLongOperationsOffBackOfStack();
+  EXPECT_EQ(1, rlmachine.GetStackSize());
+  EXPECT_EQ(1, rlmachine.GetIntValue(IntMemRef('L', 0)));
+  EXPECT_EQ("up", rlmachine.GetStringValue(STRK_LOCATION, 1));
+}
+
+// Reset() pops every LongOperation off the stack, wherever it sits, and
+// releases it.
+TEST_F(RLMachineTest, ResetReleasesLongOperations) {
+  const libreallive::Scenario* scenario = &rlmachine.Scenario();
+  int destroyed = 0;
+  rlmachine.PushLongOperation(new CountsDestruction(&destroyed));
+  rlmachine.PushStackFrame(
+      StackFrame(scenario, scenario->begin(), StackFrame::TYPE_GOSUB));
+  rlmachine.PushLongOperation(new CountsDestruction(&destroyed));
+  EXPECT_EQ(4, rlmachine.GetStackSize());
+
+  rlmachine.Reset();
+  EXPECT_EQ(0, rlmachine.GetStackSize());
+  EXPECT_FALSE(rlmachine.CurrentLongOperation());
+  EXPECT_EQ(2, destroyed);
+}
+
+#if defined(RLVM_ENABLE_PROFILER)
+// Throwing away the call stack (as loading a game does) finishes the
+// LongOperations that were on it instead of leaving them live in the profiler.
+TEST_F(RLMachineTest, ResetFinishesProfiledLongOperations) {
+  rlmachine.StartProfiling();
+  ASSERT_TRUE(rlmachine.profiler());
+
+  rlmachine.PushLongOperation(new NeverFinishes);
+  rlmachine.PushLongOperation(new NeverFinishes);
+  rlmachine.Reset();
+  EXPECT_EQ(0, rlmachine.GetStackSize());
+
+  std::unique_ptr<Profiler> profiler = rlmachine.StopProfiling();
+  std::ostringstream summary;
+  profiler->WriteSummary(summary);
+  const std::string text = summary.str();
+  size_t row = text.find("NeverFinishes");
+  ASSERT_NE(std::string::npos, row);
+  std::istringstream fields(text.substr(row));
+  std::string name;
+  int64_t count = 0;
+  fields >> name >> count;
+  EXPECT_EQ(2, count);
+}
+#endif
@@ -0,0 +1,324 @@
+// -*- Mode: C++; tab-width:2; indent-tabs-mode: nil; c-basic-offset: 2 -*-
+// vi:tw=80:et:ts=2:sts=2
+//
+// -----------------------------------------------------------------------
+//
+// This file is part of RLVM, a RealLive virtual machine clone.
+//
+// -----------------------------------------------------------------------
+//
+// Copyright (C) 2026 rlvm contributors
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA.
+//
+// -----------------------------------------------------------------------
+
+// Headless, deterministic benchmark driver. Runs a RealLive game on top of the
+// null test systems with a virtual clock, optionally replaying a recorded
+// input script, and reports throughput numbers.
+
+#include <sys/resource.h>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "bench/bench_system.h"
+#include "bench/input_script.h"
+#include "libreallive/gameexe.h"
+#include "libreallive/reallive.h"
+#include "machine/game_hacks.h"
+#include "machine/profiler.h"
+#include "machine/rlmachine.h"
+#include "machine/serialization.h"
+#include "modules/module_sys_save.h"
+#include "modules/modules.h"
+#include "systems/base/system.h"
+#include "systems/base/system_error.h"
+#include "utilities/exception.h"
+#include "utilities/file.h"
+
+using namespace std;
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+
+typedef std::chrono::steady_clock Clock;
+
+// -----------------------------------------------------------------------
+
+static double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static double PerSecond(double count, double seconds) {
+  return seconds > 0 ? count / seconds : 0;
+}
+
+void printUsage(const string& name, po::options_description& opts) {
+  cout << "Usage: " << name << " [options] <game root>" << endl
+       << opts << endl;
+}
+
+// -----------------------------------------------------------------------
+
+int main(int argc, char* argv[]) {
+  // Declare the supported options.
+  po::options_description opts("Options");
+  opts.add_options()("help", "Produce help message")(
+      "version", "Display version information")(
+      "start", po::value<int>(), "Start executing at this SEEN number")(
+      "load-save", po::value<int>(), "Load a saved game on start")(
+      "input", po::value<string>(),
+      "Recorded input script of mouse/key events with virtual timestamps")(
+      "gameexe", po::value<string>(),
+      "Use this Gameexe.ini instead of the one in the game root")(
+      "seen", po::value<string>(),
+      "Use this SEEN.TXT instead of the one in the game root")(
+      "global-memory",
+      "Load the user's global memory (read flags, names) before starting")(
+      "no-decode", "Don't decode image files; hand back placeholder surfaces")(
+      "fast-forward",
+      "Skip through text and effects as if the skip key were held down")(
+      "frame-ms", po::value<unsigned int>()->default_value(10),
+      "Virtual milliseconds that pass per trip through the game loop")(
+      "slice", po::value<int>()->default_value(1000),
+      "Maximum number of instructions executed per trip through the loop")(
+      "max-time", po::value<unsigned int>()->default_value(600000),
+      "Stop after this many virtual milliseconds")(
+      "max-instructions", po::value<long long>()->default_value(0),
+      "Stop after this many instructions (0 for no limit)")(
+      "profile", po::value<string>(),
+      "Write a Chrome trace to this file and print the profiler summary "
+      "(needs scons --profiler)");
+
+  po::options_description hidden("Hidden");
+  hidden.add_options()(
+      "game-root", po::value<string>(), "Location of game root");
+
+  po::positional_options_description p;
+  p.add("game-root", 1);
+
+  po::options_description commandLineOpts;
+  commandLineOpts.add(opts).add(hidden);
+
+  po::variables_map vm;
+  try {
+    po::store(po::basic_command_line_parser<char>(argc, argv)
+                  .options(commandLineOpts)
+                  .positional(p)
+                  .run(),
+              vm);
+    po::notify(vm);
+  } catch (po::error& e) {
+    cerr << "ERROR: " << e.what() << endl;
+    printUsage(argv[0], opts);
+    return -1;
+  }
+
+  if (vm.count("help")) {
+    printUsage(argv[0], opts);
+    return 0;
+  }
+
+  if (vm.count("version")) {
+    cout << "rlvm_bench (" << GetRlvmVersionString() << ")" << endl;
+    return 0;
+  }
+
+  if (!vm.count("game-root")) {
+    printUsage(argv[0], opts);
+    return -1;
+  }
+
+  fs::path gamerootPath = vm["game-root"].as<string>();
+  if (!fs::is_directory(gamerootPath)) {
+    cerr << "ERROR: Path '" << gamerootPath << "' is not a directory." << endl;
+    return -1;
+  }
+
+  try {
+    fs::path gameexePath = vm.count("gameexe")
+                               ? fs::path(vm["gameexe"].as<string>())
+                               : CorrectPathCase(gamerootPath / "Gameexe.ini");
+    fs::path seenPath = vm.count("seen")
+                            ? fs::path(vm["seen"].as<string>())
+                            : CorrectPathCase(gamerootPath / "Seen.txt");
+    if (gameexePath.empty() || !fs::exists(gameexePath)) {
+      cerr << "ERROR: Could not find Gameexe.ini." << endl;
+      return -1;
+    }
+    if (seenPath.empty() || !fs::exists(seenPath)) {
+      cerr << "ERROR: Could not find Seen.txt." << endl;
+      return -1;
+    }
+
+    InputScript input;
+    if (vm.count("input"))
+      input.Load(vm["input"].as<string>());
+
+    BenchStats stats;
+    Clock::time_point gameexe_start = Clock::now();
+    BenchSystem system(gameexePath.string(), stats);
+    double gameexe_load_time = SecondsSince(gameexe_start);
+    Gameexe& gameexe = system.gameexe();
+    gameexe("__GAMEPATH") = gamerootPath.string();
+    if (vm.count("start"))
+      gameexe("SEEN_START") = vm["start"].as<int>();
+
+    // Parse every scenario up front so that archive costs are measured
+    // separately from interpretation.
+    Clock::time_point load_start = Clock::now();
+    libreallive::Archive arc(seenPath.string(),
+                             gameexe("REGNAME").ToString(""));
+    int scenarios_loaded = 0;
+    double max_scenario_load = 0;
+    int slowest_scenario = -1;
+    for (auto it = arc.begin(); it != arc.end(); ++it) {
+      Clock::time_point start = Clock::now();
+      arc.GetScenario(it->first);
+      double elapsed = SecondsSince(start);
+      scenarios_loaded++;
+      if (elapsed > max_scenario_load) {
+        max_scenario_load = elapsed;
+        slowest_scenario = it->first;
+      }
+    }
+    double scenario_load_time = SecondsSince(load_start);
+
+    system.graphics().set_decode_images(!vm.count("no-decode"));
+    std::shared_ptr<VirtualClock> clock(new VirtualClock);
+    system.event().SetMockHandler(clock);
+    if (vm.count("fast-forward"))
+      system.set_force_fast_forward();
+
+    RLMachine rlmachine(system, arc);
+    AddAllModules(rlmachine);
+    // Test fixtures don't have a DISKMARK to key game hacks off of.
+    if (gameexe("DISKMARK").Exists())
+      AddGameHacks(rlmachine);
+
+    if (vm.count("global-memory"))
+      Serialization::loadGlobalMemory(rlmachine);
+
+    rlmachine.SetHaltOnException(false);
+
+    if (vm.count("load-save"))
+      Sys_load()(rlmachine, vm["load-save"].as<int>());
+
+    if (vm.count("profile"))
+      rlmachine.StartProfiling();
+
+    const unsigned int frame_ms = vm["frame-ms"].as<unsigned int>();
+    const int slice = vm["slice"].as<int>();
+    const unsigned int max_time = vm["max-time"].as<unsigned int>();
+    const long long max_instructions = vm["max-instructions"].as<long long>();
+
+    long long instructions = 0;
+    long long long_operation_ticks = 0;
+    int scenes_entered = 0;
+    int last_scene = rlmachine.SceneNumber();
+    Clock::time_point run_start = Clock::now();
+    while (!rlmachine.halted() && clock->now() < max_time &&
+           (max_instructions == 0 || instructions < max_instructions)) {
+      input.DispatchUntil(clock->now(), rlmachine, system.event());
+      system.Run(rlmachine);
+
+      // Same shape as RLVMInstance::Run(), except that the time slice is
+      // measured in instructions instead of wall clock time.
+      int executed = 0;
+      do {
+        if (rlmachine.CurrentLongOperation())
+          long_operation_ticks++;
+        else
+          instructions++;
+        rlmachine.ExecuteNextInstruction();
+        if (rlmachine.SceneNumber() != last_scene) {
+          last_scene = rlmachine.SceneNumber();
+          scenes_entered++;
+        }
+      } while (!rlmachine.halted() && !rlmachine.CurrentLongOperation() &&
+               !system.force_wait() && ++executed < slice);
+
+      system.set_force_wait(false);
+      clock->Advance(frame_ms);
+    }
+    double run_time = SecondsSince(run_start);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    printf("rlvm_bench: %s\n", gamerootPath.string().c_str());
+    printf("  Stopped at:          SEEN%04d(%d), %s\n",
+           rlmachine.SceneNumber(), rlmachine.line_number(),
+           rlmachine.halted() ? "halted"
+                              : (clock->now() >= max_time ? "time limit"
+                                                          : "instruction limit"));
+    printf("  Virtual time:        %u ms\n", clock->now());
+    printf("  Wall time:           %.3f s\n", run_time);
+    printf("  Instructions:        %lld (%.0f/s)\n", instructions,
+           PerSecond(instructions, run_time));
+    printf("  Long op ticks:       %lld (%.0f/s)\n", long_operation_ticks,
+           PerSecond(long_operation_ticks, run_time));
+    printf("  Scenes entered:      %d (%.1f/s)\n", scenes_entered,
+           PerSecond(scenes_entered, run_time));
+    printf("  Frames:              %d (%.1f/s)\n", stats.frames,
+           PerSecond(stats.frames, run_time));
+    printf("  Gameexe parsed:      %zu keys in %.3f ms\n", gameexe.size(),
+           gameexe_load_time * 1000);
+    printf("  Scenarios loaded:    %d in %.3f ms (slowest: SEEN%04d, %.3f ms)\n",
+           scenarios_loaded, scenario_load_time * 1000, slowest_scenario,
+           max_scenario_load * 1000);
+    printf("  Images loaded:       %d in %.3f ms (slowest: %s, %.3f ms)\n",
+           stats.images_loaded, stats.image_load_us / 1000.0,
+           stats.slowest_image.c_str(), stats.max_image_load_us / 1000.0);
+    if (stats.images_missing)
+      printf("  Images missing:      %d\n", stats.images_missing);
+    printf("  Input events:        %zu%s\n", input.size(),
+           input.finished() ? "" : " (not all replayed)");
+    printf("  Peak RSS:            %ld KB\n", usage.ru_maxrss);
+
+    std::unique_ptr<Profiler> profiler = rlmachine.StopProfiling();
+    if (profiler) {
+      std::ofstream trace(vm["profile"].as<string>().c_str());
+      profiler->WriteChromeTrace(trace);
+      cout << endl;
+      profiler->WriteSummary(cout);
+    }
+  }
+  catch (rlvm::Exception& e) {
+    cerr << "Fatal RLVM error: " << e.what() << endl;
+    return 1;
+  }
+  catch (libreallive::Error& e) {
+    cerr << "Fatal libreallive error: " << e.what() << endl;
+    return 1;
+  }
+  catch (SystemError& e) {
+    cerr << "Fatal local system error: " << e.what() << endl;
+    return 1;
+  }
+  catch (std::exception& e) {
+    cerr << "Uncaught exception: " << e.what() << endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -34,9 +34,15 @@
 #include "test_system/test_system.h"
 #include "test_system/test_sound_system.h"
 #include "libreallive/gameexe.h"
+#include "systems/base/se_bank.h"
+#include "xclannad/endian.hpp"
+#include "xclannad/wavfile.h"
 
+#include <map>
+#include <memory>
 #include <string>
 #include <sstream>
+#include <vector>
 
 using std::stringstream;
 
@@ -123,3 +129,97 @@ TEST(SoundSystem, SetUseKoeSerialization) {
     EXPECT_EQ(0, sys.globals().character_koe_enabled[105]);
   }
 }
+
+// Sound effects are dropped while skipping, whichever backend plays them.
+TEST(SoundSystem, PlaySeIsDroppedWhileFastForwarding) {
+  TestSystem top;
+  TestSoundSystem& sys = dynamic_cast<TestSoundSystem&>(top.sound());
+
+  sys.PlaySe(1);
+  EXPECT_EQ(std::vector<int>{1}, sys.played_se());
+
+  top.set_force_fast_forward();
+  sys.PlaySe(2);
+  EXPECT_EQ(std::vector<int>{1}, sys.played_se());
+}
+
+namespace {
+
+struct FakeChunk {
+  size_t size() const { return bytes; }
+  size_t bytes;
+};
+
+}  // namespace
+
+// Sound effects that don't fit in the bank are left for the on demand cache,
+// without keeping smaller files or shared entries out of it.
+TEST(SoundSystem, SeBankSkipsFilesThatDontFit) {
+  std::map<std::string, size_t> sizes = {
+      {"small", 10}, {"large", 100}, {"medium", 30}, {"last", 10}};
+  std::vector<std::string> decoded;
+  auto decode = [&](const boost::filesystem::path& path) {
+    decoded.push_back(path.string());
+    return std::make_shared<FakeChunk>(FakeChunk{sizes[path.string()]});
+  };
+
+  std::vector<std::pair<int, boost::filesystem::path>> files = {
+      {0, "small"}, {1, "large"}, {2, "medium"},
+      {3, "small"}, {4, "large"}, {5, "last"}};
+  std::unordered_map<int, std::shared_ptr<FakeChunk>> bank =
+      FillSeBank<std::shared_ptr<FakeChunk>>(files, 40, decode);
+
+  // Hits share the decoded file; 1 and 4 fall back to loading on demand.
+  EXPECT_TRUE(bank.count(0));
+  EXPECT_FALSE(bank.count(1));
+  EXPECT_TRUE(bank.count(2));
+  EXPECT_EQ(bank[0], bank[3]);
+  EXPECT_FALSE(bank.count(4));
+  EXPECT_FALSE(bank.count(5));
+  EXPECT_EQ(3u, bank.size());
+
+  // Each file is decoded once, and "last" isn't decoded at all because the
+  // bank is full by then.
+  EXPECT_EQ((std::vector<std::string>{"small", "large", "medium"}), decoded);
+}
+
+// Builds a mono 16-bit NWA file whose blocks hold nothing but their first
+// sample, so every decoded block is that sample repeated. There are enough
+// blocks for the decoder to spread them over several threads.
+TEST(SoundSystem, DecodeNWAFromMemory) {
+  const int kBlocks = 16, kBlockSize = 4, kRestSize = 2, kCompBlock = 6;
+  const int kSamples = (kBlocks - 1) * kBlockSize + kRestSize;
+  const int data_start = 0x2c + kBlocks * 4;
+  std::vector<char> file(data_start + kBlocks * kCompBlock, 0);
+  char* header = &file[0];
+  write_little_endian_short(header + 0x00, 1);
+  write_little_endian_short(header + 0x02, 16);
+  write_little_endian_int(header + 0x04, 22050);
+  write_little_endian_int(header + 0x08, 0);
+  write_little_endian_int(header + 0x0c, 0);
+  write_little_endian_int(header + 0x10, kBlocks);
+  write_little_endian_int(header + 0x14, kSamples * 2);
+  write_little_endian_int(header + 0x18, file.size());
+  write_little_endian_int(header + 0x1c, kSamples);
+  write_little_endian_int(header + 0x20, kBlockSize);
+  write_little_endian_int(header + 0x24, kRestSize);
+  for (int i = 0; i < kBlocks; ++i) {
+    int offset = data_start + i * kCompBlock;
+    write_little_endian_int(header + 0x2c + i * 4, offset);
+    write_little_endian_short(header + offset, i * 100 - 800);
+  }
+
+  int length = 0;
+  std::unique_ptr<char[]> wav(decode_nwa(&file[0], file.size(), &length));
+  ASSERT_TRUE(wav.get());
+  EXPECT_EQ(0x2c + kSamples * 2, length);
+  EXPECT_EQ(kSamples * 2, read_little_endian_int(wav.get() + 0x28));
+  for (int i = 0; i < kSamples; ++i) {
+    EXPECT_EQ((i / kBlockSize) * 100 - 800,
+              static_cast<int16_t>(
+                  read_little_endian_short(wav.get() + 0x2c + i * 2)));
+  }
+
+  // A truncated file is rejected.
+  EXPECT_EQ(NULL, decode_nwa(&file[0], file.size() - 1, &length));
+}
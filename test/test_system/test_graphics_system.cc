@@ -107,6 +107,8 @@ void TestGraphicsSystem::InjectSurface(
 
 std::shared_ptr<const Surface> TestGraphicsSystem::LoadSurfaceFromFile(
     const std::string& short_filename) {
+  pending_prefetches_.erase(short_filename);
+
   // If we have an injected surface, return it instead of a fresh surface.
   std::map<std::string, std::shared_ptr<const Surface>>::iterator it =
       named_surfaces_.find(short_filename);
@@ -121,6 +123,14 @@ std::shared_ptr<const Surface> TestGraphicsSystem::LoadSurfaceFromFile(
               MockSurface::Create(short_filename, Size(50, 50)))));
 }
 
+void TestGraphicsSystem::PrefetchSurface(const std::string& short_filename) {
+  pending_prefetches_.insert(short_filename);
+}
+
+void TestGraphicsSystem::CancelPrefetch(const std::string& short_filename) {
+  pending_prefetches_.erase(short_filename);
+}
+
 std::shared_ptr<Surface> TestGraphicsSystem::GetHaikei() { return haikei_; }
 
 std::shared_ptr<Surface> TestGraphicsSystem::GetDC(int dc) {
@@ -144,7 +154,8 @@ void TestGraphicsSystem::BeginFrame() {}
 void TestGraphicsSystem::EndFrame() {}
 
 std::shared_ptr<Surface> TestGraphicsSystem::EndFrameToSurface() {
-  return std::shared_ptr<Surface>();
+  return std::shared_ptr<Surface>(
+      MockSurface::Create("EndFrameToSurface", screen_size()));
 }
 
 MockSurface& TestGraphicsSystem::GetMockDC(int dc) {
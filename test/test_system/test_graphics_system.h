@@ -33,6 +33,7 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 
 class System;
@@ -54,6 +55,8 @@ class TestGraphicsSystem : public GraphicsSystem {
   // Make a null Surface object?
   virtual std::shared_ptr<const Surface> LoadSurfaceFromFile(
       const std::string& short_filename) override;
+  virtual void PrefetchSurface(const std::string& short_filename) override;
+  virtual void CancelPrefetch(const std::string& short_filename) override;
   virtual std::shared_ptr<Surface> GetHaikei() override;
   virtual std::shared_ptr<Surface> GetDC(int dc) override;
   virtual std::shared_ptr<Surface> BuildSurface(const Size& s) override;
@@ -66,6 +69,11 @@ class TestGraphicsSystem : public GraphicsSystem {
   // Needed because of covariant issues.
   MockSurface& GetMockDC(int dc);
 
+  // Files that have been prefetched but not yet loaded or cancelled.
+  const std::set<std::string>& pending_prefetches() const {
+    return pending_prefetches_;
+  }
+
  private:
   std::shared_ptr<MockSurface> haikei_;
 
@@ -74,6 +82,8 @@ class TestGraphicsSystem : public GraphicsSystem {
 
   // A list of user injected surfaces to hand back for named files.
   std::map<std::string, std::shared_ptr<const Surface>> named_surfaces_;
+
+  std::set<std::string> pending_prefetches_;
 };
 
 #endif  // TEST_TEST_SYSTEM_TEST_GRAPHICS_SYSTEM_H_
@@ -90,7 +90,9 @@ void TestSoundSystem::WavStopAll() {}
 
 void TestSoundSystem::WavFadeOut(const int channel, const int fadetime) {}
 
-void TestSoundSystem::PlaySe(const int se_num) {}
+void TestSoundSystem::PlaySeImpl(const int se_num) {
+  played_se_.push_back(se_num);
+}
 
 bool TestSoundSystem::HasSe(const int se_num) { return false; }
 
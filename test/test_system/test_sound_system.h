@@ -30,6 +30,7 @@
 
 #include "systems/base/sound_system.h"
 #include <string>
+#include <vector>
 
 class Gameexe;
 
@@ -68,16 +69,20 @@ class TestSoundSystem : public SoundSystem {
   virtual void WavStopAll() override;
   virtual void WavFadeOut(const int channel, const int fadetime) override;
 
-  virtual void PlaySe(const int se_num) override;
   virtual bool HasSe(const int se_num) override;
 
   virtual bool KoePlaying() const override;
   virtual void KoeStop() override;
 
+  // Every sound effect that reached the backend, in order.
+  const std::vector<int>& played_se() const { return played_se_; }
+
  private:
+  virtual void PlaySeImpl(const int se_num) override;
   virtual void KoePlayImpl(int id) override;
 
   std::string bgm_name_;
+  std::vector<int> played_se_;
 };  // end of class TestSoundSystem
 
 #endif  // TEST_TEST_SYSTEM_TEST_SOUND_SYSTEM_H_
@@ -29,6 +29,7 @@
 
 #include <string>
 
+#include "machine/profiler.h"
 #include "systems/base/system_error.h"
 #include "test_utils.h"
 
@@ -54,10 +55,27 @@ TestSystem::TestSystem()
 
 TestSystem::~TestSystem() {}
 
-void TestSystem::Run(RLMachine& machine) {}
+void TestSystem::Run(RLMachine& machine) {
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_EVENT);
+    event().ExecuteEventSystem(machine);
+  }
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_TEXT);
+    text().ExecuteTextSystem();
+  }
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_SOUND);
+    sound().ExecuteSoundSystem();
+  }
+  {
+    PROFILE_SUBSYSTEM(machine, SUBSYSTEM_GRAPHICS);
+    graphics().ExecuteGraphicsSystem(machine);
+  }
+}
 
 TestGraphicsSystem& TestSystem::graphics() { return null_graphics_system; }
 EventSystem& TestSystem::event() { return null_event_system; }
 Gameexe& TestSystem::gameexe() { return gameexe_; }
-TextSystem& TestSystem::text() { return null_text_system; }
+TestTextSystem& TestSystem::text() { return null_text_system; }
 SoundSystem& TestSystem::sound() { return null_sound_system; }
@@ -44,7 +44,7 @@ class TestSystem : public System {
   virtual TestGraphicsSystem& graphics() override;
   virtual EventSystem& event() override;
   virtual Gameexe& gameexe() override;
-  virtual TextSystem& text() override;
+  virtual TestTextSystem& text() override;
   virtual SoundSystem& sound() override;
 
  private:
@@ -72,6 +72,7 @@ Size TestTextSystem::RenderGlyphOnto(
 }
 
 int TestTextSystem::GetCharWidth(int size, uint16_t codepoint) {
+  char_width_queries_++;
   return 20;
 }
 
@@ -62,8 +62,13 @@ class TestTextSystem : public TextSystem {
     return rendered_glyps_;
   }
 
+  // Number of times GetCharWidth() was called.
+  int char_width_queries() const { return char_width_queries_; }
+
  private:
   std::vector<std::tuple<std::string, int, int>> rendered_glyps_;
+
+  int char_width_queries_ = 0;
 };
 
 #endif  // TEST_TEST_SYSTEM_TEST_TEXT_SYSTEM_H_
@@ -116,6 +116,20 @@ TEST_F(TextSystemTest, PrintEmptyString) {
   EXPECT_EQ("", GetTextWindow(0).current_contents());
 }
 
+// While fast forwarding, glyphs aren't rasterized until someone renders the
+// window, and pages that are cleared first never get rasterized at all.
+TEST_F(TextSystemTest, FastForwardDefersGlyphs) {
+  system.set_force_fast_forward();
+
+  WriteString("Skipped.", true);
+  EXPECT_EQ("Skipped.", GetTextWindow(0).current_contents());
+  EXPECT_EQ(0, GetTextSystem().glyphs().size());
+
+  SnapshotAndClear();
+  WriteString("Also.", true);
+  EXPECT_EQ(0, GetTextSystem().glyphs().size());
+}
+
 TEST_F(TextSystemTest, BackLogFunctionality) {
   TextSystem& text = rlmachine.system().text();
 
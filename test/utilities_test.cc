@@ -26,9 +26,30 @@
 
 #include "gtest/gtest.h"
 
+#include <boost/filesystem/fstream.hpp>
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "libreallive/gameexe.h"
+#include "systems/base/image_disk_cache.h"
 #include "systems/base/rect.h"
+#include "systems/base/system.h"
+#include "test_system/test_system.h"
+#include "utilities/asset_pack.h"
+#include "utilities/exception.h"
+#include "utilities/file.h"
 #include "utilities/graphics.h"
+#include "utilities/ring_buffer.h"
+#include "utilities/string_utilities.h"
+#include "utilities/text_layout.h"
 
 TEST(UtilitiesTest, ClipDestination_Superset) {
   Rect clip(Point(5, 5), Size(5, 5));
@@ -64,3 +85,373 @@ TEST(UtilitiesTest, ScreenSizeModKey) {
   me.parseLine("#SCREENSIZE_MOD=999,800,600");
   EXPECT_EQ(Size(800, 600), GetScreenSize(me));
 }
+
+// The direct UTF-8 transcoder must agree with going through UTF-16 for every
+// double byte character, in every codepage, including ASCII runs around them.
+TEST(UtilitiesTest, cp932toUTF8MatchesUnicodePath) {
+  for (int transformation = 0; transformation < 4; ++transformation) {
+    std::string native = "ASCII prefix, long enough for a whole word. ";
+    for (int lead = 0x81; lead <= 0xfc; ++lead) {
+      for (int trail = 0x41; trail <= 0xfc; ++trail) {
+        std::string ch;
+        ch += static_cast<char>(lead);
+        ch += static_cast<char>(trail);
+
+        // Some unassigned characters map into the surrogate range, which the
+        // UTF-16 path can't encode.
+        std::wstring wide = cp932toUnicode(ch, transformation);
+        if (std::any_of(wide.begin(), wide.end(), [](wchar_t c) {
+              return c >= 0xd800 && c <= 0xdfff;
+            })) {
+          continue;
+        }
+        native += ch;
+      }
+      native += "abc";
+    }
+    for (int c = 0x01; c <= 0xff; ++c)
+      native += static_cast<char>(transformation == 2 || c < 0x80 ? c : ' ');
+
+    EXPECT_EQ(UnicodeToUTF8(cp932toUnicode(native, transformation)),
+              cp932toUTF8(native, transformation))
+        << "Mismatch in " << TransformationName(transformation);
+  }
+}
+
+TEST(UtilitiesTest, RingBufferWrapsAround) {
+  RingBuffer<int> ring(6);
+  EXPECT_EQ(8u, ring.capacity());
+
+  int in[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+  int out[10] = {0};
+  EXPECT_EQ(6u, ring.Write(in, 6));
+  EXPECT_EQ(4u, ring.Read(out, 4));
+  EXPECT_EQ(6u, ring.WriteAvailable());
+
+  // Only six more elements fit; the write straddles the end of the buffer.
+  EXPECT_EQ(6u, ring.Write(in + 4, 6));
+  EXPECT_EQ(0u, ring.WriteAvailable());
+  EXPECT_EQ(8u, ring.Read(out + 2, 10));
+  EXPECT_EQ(0u, ring.ReadAvailable());
+
+  int expected[] = {1, 2, 5, 6, 5, 6, 7, 8, 9, 10};
+  EXPECT_TRUE(std::equal(out, out + 10, expected));
+}
+
+TEST(UtilitiesTest, RingBufferAcrossThreads) {
+  const int kCount = 100000;
+  RingBuffer<int> ring(64);
+
+  std::thread producer([&ring, kCount]() {
+    int next = 0;
+    while (next < kCount) {
+      int chunk[7];
+      int n = std::min(7, kCount - next);
+      for (int i = 0; i < n; ++i)
+        chunk[i] = next + i;
+      int written = ring.Write(chunk, n);
+      next += written;
+      if (!written)
+        std::this_thread::yield();
+    }
+  });
+
+  std::vector<int> received;
+  while (received.size() < static_cast<size_t>(kCount)) {
+    int chunk[5];
+    int n = ring.Read(chunk, 5);
+    received.insert(received.end(), chunk, chunk + n);
+    if (!n)
+      std::this_thread::yield();
+  }
+  producer.join();
+
+  for (int i = 0; i < kCount; ++i)
+    ASSERT_EQ(i, received[i]);
+}
+
+// The lookahead of each character is the run of kinsoku and wrapping roman
+// characters that follows it.
+TEST(UtilitiesTest, TextLayoutLookahead) {
+  // "あ", "、", "」", "あ", " ", "ab-c", "."
+  TextLayout layout(
+      "\xe3\x81\x82\xe3\x80\x81\xe3\x80\x8d\xe3\x81\x82 ab-c.");
+  ASSERT_EQ(10u, layout.size());
+  EXPECT_EQ(0x3001, layout.codepoint(1));
+  EXPECT_EQ("\xe3\x80\x8d", layout.Character(2));
+
+  EXPECT_EQ("\xe3\x80\x81\xe3\x80\x8d", layout.Lookahead(0));
+  EXPECT_EQ("\xe3\x80\x8d", layout.Lookahead(1));
+  EXPECT_EQ("", layout.Lookahead(2));
+  EXPECT_EQ("", layout.Lookahead(3));
+  EXPECT_EQ("ab-c.", layout.Lookahead(4));
+  EXPECT_EQ("-c.", layout.Lookahead(6));
+  EXPECT_EQ("", layout.Lookahead(9));
+  EXPECT_EQ(" ab", layout.Slice(4, 7));
+
+  EXPECT_TRUE(TextLayout("").empty());
+}
+
+TEST(UtilitiesTest, IsKinsoku) {
+  EXPECT_TRUE(IsKinsoku(0x3001));
+  EXPECT_TRUE(IsKinsoku(0xff9f));
+  EXPECT_TRUE(IsKinsoku('.'));
+  EXPECT_FALSE(IsKinsoku(0x3042));
+  EXPECT_FALSE(IsKinsoku('a'));
+  EXPECT_FALSE(IsKinsoku(0));
+  EXPECT_FALSE(IsKinsoku(0x1f600));
+}
+
+TEST(UtilitiesTest, AssetPackRoundTrip) {
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                 boost::filesystem::unique_path();
+  {
+    AssetPackWriter writer(path);
+    writer.AddEntry("G00/BG01.g00", AssetPack::ENCODING_RAW, "abc", 3);
+    writer.AddEntry("bgm/track.nwa", AssetPack::ENCODING_WAV, "RIFF....", 8);
+    for (int i = 0; i < 100; ++i) {
+      std::string name = "koe/z" + std::to_string(i) + ".ovk";
+      writer.AddEntry(name, AssetPack::ENCODING_RAW, name.data(), name.size());
+    }
+    writer.Finish();
+  }
+
+  AssetPack pack(path);
+  EXPECT_EQ(102u, pack.size());
+  EXPECT_EQ(102u, pack.GetNames().size());
+
+  AssetPack::Entry entry;
+  ASSERT_TRUE(pack.Find("g00/bg01.G00", &entry));
+  EXPECT_EQ("abc", std::string(entry.data, entry.size));
+  EXPECT_EQ(AssetPack::ENCODING_RAW, entry.encoding);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(entry.data) %
+                    AssetPack::kAlignment);
+
+  ASSERT_TRUE(pack.Find("bgm/track.nwa", &entry));
+  EXPECT_EQ(AssetPack::ENCODING_WAV, entry.encoding);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(entry.data) %
+                    AssetPack::kAlignment);
+
+  for (int i = 0; i < 100; ++i) {
+    std::string name = "koe/z" + std::to_string(i) + ".ovk";
+    ASSERT_TRUE(pack.Find(name, &entry)) << name;
+    EXPECT_EQ(name, std::string(entry.data, entry.size));
+  }
+
+  EXPECT_FALSE(pack.Find("g00/bg02.g00", &entry));
+  EXPECT_FALSE(pack.Find("bg01.g00", &entry));
+
+  boost::filesystem::remove(path);
+}
+
+// Packs whose index points outside the file are rejected when they're opened,
+// instead of being read out of bounds later.
+TEST(UtilitiesTest, AssetPackRejectsTruncatedPack) {
+  boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+                                 boost::filesystem::unique_path();
+  {
+    AssetPackWriter writer(path);
+    writer.AddEntry("g00/bg01.g00", AssetPack::ENCODING_RAW, "abc", 3);
+    writer.AddEntry("g00/bg02.g00", AssetPack::ENCODING_RAW, "defg", 4);
+    writer.Finish();
+  }
+
+  // Read the good pack and find the index at the end of it.
+  std::string contents;
+  {
+    boost::filesystem::ifstream file(path, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+  }
+  uint64_t index_offset;
+  memcpy(&index_offset, contents.data() + 24, sizeof(index_offset));
+  ASSERT_LT(index_offset, contents.size());
+
+  auto write_pack = [&](const std::string& data) {
+    boost::filesystem::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+  };
+
+  // Cut off part of the index.
+  write_pack(contents.substr(0, contents.size() - 8));
+  EXPECT_THROW(AssetPack pack(path), rlvm::Exception);
+
+  // Point the first entry's data past the end of the file. The index records
+  // are (hash, offset, size, name offset, name size, ...).
+  std::string corrupt = contents;
+  uint64_t offset = contents.size();
+  memcpy(&corrupt[index_offset + 8], &offset, sizeof(offset));
+  write_pack(corrupt);
+  EXPECT_THROW(AssetPack pack(path), rlvm::Exception);
+
+  // An offset and size that only fit when their sum overflows.
+  corrupt = contents;
+  uint64_t size = ~uint64_t(0);
+  memcpy(&corrupt[index_offset + 16], &size, sizeof(size));
+  write_pack(corrupt);
+  EXPECT_THROW(AssetPack pack(path), rlvm::Exception);
+
+  // A name that runs off the end of the file.
+  corrupt = contents;
+  uint32_t name_size = contents.size();
+  memcpy(&corrupt[index_offset + 28], &name_size, sizeof(name_size));
+  write_pack(corrupt);
+  EXPECT_THROW(AssetPack pack(path), rlvm::Exception);
+
+  write_pack(contents);
+  AssetPack pack(path);
+  EXPECT_EQ(2u, pack.size());
+
+  boost::filesystem::remove(path);
+}
+
+// Packed files are found through System::FindFile() and read through the
+// normal file helpers, while loose files override them.
+TEST(UtilitiesTest, AssetPackMountedIntoFileSystem) {
+  boost::filesystem::path root = boost::filesystem::temp_directory_path() /
+                                 boost::filesystem::unique_path();
+  boost::filesystem::create_directories(root / "G00");
+  boost::filesystem::ofstream(root / "G00" / "loose.g00") << "loose file";
+  {
+    AssetPackWriter writer(root / AssetPack::kFileName);
+    writer.AddEntry("g00/packed.g00", AssetPack::ENCODING_RAW, "packed", 6);
+    writer.AddEntry("g00/loose.g00", AssetPack::ENCODING_RAW, "stale", 5);
+    writer.AddEntry("notindexed/other.g00", AssetPack::ENCODING_RAW, "x", 1);
+    writer.Finish();
+  }
+
+  boost::filesystem::path packed;
+  {
+    TestSystem system;
+    system.gameexe()("__GAMEPATH") = root.string();
+
+    packed = system.FindFile("PACKED", IMAGE_FILETYPES);
+    ASSERT_FALSE(packed.empty());
+    EXPECT_EQ(root / AssetPack::kFileName / "g00/packed.g00", packed);
+
+    std::unique_ptr<char[]> data;
+    int size = 0;
+    ASSERT_FALSE(LoadFileData(packed, data, size));
+    EXPECT_EQ("packed", std::string(data.get(), size));
+
+    FILE* file = OpenFile(packed);
+    ASSERT_TRUE(file);
+    char buf[16] = {0};
+    EXPECT_EQ(6u, fread(buf, 1, sizeof(buf), file));
+    fclose(file);
+    EXPECT_EQ("packed", std::string(buf));
+
+    EXPECT_EQ(root / "G00" / "loose.g00",
+              system.FindFile("loose", IMAGE_FILETYPES));
+    EXPECT_TRUE(system.FindFile("other", IMAGE_FILETYPES).empty());
+  }
+
+  // Destroying the System unmounts the pack.
+  AssetPack::Entry entry;
+  EXPECT_FALSE(AssetPack::FindMounted(packed, &entry));
+
+  boost::filesystem::remove_all(root);
+}
+
+namespace {
+
+// Stores a 4x4 image filled with |fill| under |file| and waits for it.
+void StoreTestImage(ImageDiskCache& cache,
+                    const boost::filesystem::path& file,
+                    const std::string& variant,
+                    char fill) {
+  AssetPack::ImageHeader header;
+  header.width = 4;
+  header.height = 4;
+  header.is_mask = 1;
+  std::vector<AssetPack::ImageRegion> regions = {{0, 0, 1, 3, 1, 2},
+                                                 {2, 0, 3, 3, 0, 0}};
+  std::vector<char> pixels(4 * 4 * 4, fill);
+  cache.Store(file, variant, header, regions, pixels.data());
+  cache.Flush();
+}
+
+}  // namespace
+
+TEST(UtilitiesTest, ImageDiskCacheRoundTrip) {
+  boost::filesystem::path root = boost::filesystem::temp_directory_path() /
+                                 boost::filesystem::unique_path();
+  boost::filesystem::create_directories(root);
+  boost::filesystem::path source = root / "BG01.g00";
+  boost::filesystem::ofstream(source) << "not really a g00";
+
+  for (bool compress : {false, true}) {
+    boost::filesystem::path directory =
+        root / (compress ? "compressed" : "raw");
+    {
+      ImageDiskCache cache(directory, 1 << 20, compress);
+      EXPECT_FALSE(cache.Fetch(source, "010"));
+      StoreTestImage(cache, source, "010", 'x');
+      EXPECT_TRUE(cache.Contains(source, "010"));
+      EXPECT_FALSE(cache.Contains(source, ""));
+    }
+
+    // A new session reads the entry back from disk.
+    ImageDiskCache cache(directory, 1 << 20, compress);
+    EXPECT_LT(0u, cache.size());
+    std::shared_ptr<const ImageDiskCache::Image> image =
+        cache.Fetch(source, "010");
+    ASSERT_TRUE(image) << compress;
+    EXPECT_EQ(4, image->width());
+    EXPECT_EQ(4, image->height());
+    EXPECT_TRUE(image->is_mask());
+    ASSERT_EQ(2u, image->regions().size());
+    EXPECT_EQ(3, image->regions()[0].y2);
+    EXPECT_EQ(2, image->regions()[0].origin_y);
+    EXPECT_EQ(2, image->regions()[1].x1);
+    EXPECT_EQ(std::string(4 * 4 * 4, 'x'),
+              std::string(image->pixels(), 4 * 4 * 4));
+
+    EXPECT_FALSE(cache.Fetch(source, "011"));
+  }
+
+  // Editing the source file invalidates what we cached for it.
+  boost::filesystem::last_write_time(
+      source, boost::filesystem::last_write_time(source) + 10);
+  ImageDiskCache cache(root / "raw", 1 << 20, false);
+  EXPECT_FALSE(cache.Fetch(source, "010"));
+
+  boost::filesystem::remove_all(root);
+}
+
+TEST(UtilitiesTest, ImageDiskCacheEvictsLeastRecentlyUsed) {
+  boost::filesystem::path root = boost::filesystem::temp_directory_path() /
+                                 boost::filesystem::unique_path();
+  boost::filesystem::path directory = root / "cache";
+  boost::filesystem::create_directories(root);
+  boost::filesystem::path sources[3] = {root / "a.g00", root / "b.g00",
+                                        root / "c.g00"};
+  for (const boost::filesystem::path& source : sources)
+    boost::filesystem::ofstream(source) << "image";
+
+  uint64_t entry_size = 0;
+  {
+    ImageDiskCache cache(directory, 1 << 20, false);
+    StoreTestImage(cache, sources[0], "", 'a');
+    StoreTestImage(cache, sources[1], "", 'b');
+    entry_size = cache.size() / 2;
+  }
+
+  // Pretend both entries were last used a while ago.
+  std::time_t past = std::time(NULL) - 100;
+  for (boost::filesystem::directory_iterator it(directory), end; it != end;
+       ++it) {
+    boost::filesystem::last_write_time(it->path(), past);
+  }
+
+  ImageDiskCache cache(directory, entry_size * 2 + entry_size / 2, false);
+  EXPECT_TRUE(cache.Fetch(sources[0], ""));
+  StoreTestImage(cache, sources[2], "", 'c');
+
+  EXPECT_TRUE(cache.Contains(sources[0], ""));
+  EXPECT_FALSE(cache.Contains(sources[1], ""));
+  EXPECT_TRUE(cache.Contains(sources[2], ""));
+  EXPECT_LE(cache.size(), entry_size * 2 + entry_size / 2);
+
+  boost::filesystem::remove_all(root);
+}